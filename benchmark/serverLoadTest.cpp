@@ -0,0 +1,155 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+/*!
+ * Load test of a running solver server (madlinsolv started with "--server <socket path>").
+ * It connects to the server and, for the given number of rounds, sends a random right-hand side,
+ * solves and fetches the solution, measuring the latency of every request on the client side.
+ * It prints the 50th, 90th and 99th percentiles and the maximum of the latency of every request type,
+ * of the whole round and of the solve time on the server, then the throughput in rounds per second.
+ * With --shutdown, the server is stopped at the end.
+ *
+ * Usage: server_loadtest socket_path [number_of_rounds] [--shutdown]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "solverClient.hpp"
+
+namespace {
+
+double elapsed(const std::chrono::steady_clock::time_point & start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+double percentile(const std::vector<double> & sorted, double fraction)
+{
+    std::size_t index = static_cast<std::size_t>(fraction * (sorted.size() - 1) + 0.5);
+    return sorted[index];
+}
+
+void report(const std::string & label, std::vector<double> times)
+{
+    std::sort(times.begin(), times.end());
+    std::cout << std::left << std::setw(16) << label << std::right << std::fixed << std::setprecision(3)
+            << std::setw(12) << 1.e3 * percentile(times, 0.50)
+            << std::setw(12) << 1.e3 * percentile(times, 0.90)
+            << std::setw(12) << 1.e3 * percentile(times, 0.99)
+            << std::setw(12) << 1.e3 * times.back() << std::endl;
+}
+
+int fail(const SolverClient & client)
+{
+    std::cerr << "Request failed: " << client.getLastError() << std::endl;
+    return 1;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    if(argc < 2) {
+        std::cerr << "Usage: server_loadtest socket_path [number_of_rounds] [--shutdown]" << std::endl;
+        return 1;
+    }
+    std::string socketPath = argv[1];
+    long nRounds = 100;
+    bool isShutdown = false;
+    for(int i = 2; i < argc; ++i) {
+        if(std::string(argv[i]) == "--shutdown") {
+            isShutdown = true;
+        } else {
+            nRounds = std::max(std::atol(argv[i]), 1L);
+        }
+    }
+
+    SolverClient client;
+    if(!client.connect(socketPath)) {
+        return fail(client);
+    }
+    long nRows, nNz;
+    if(!client.getInfo(nRows, nNz)) {
+        return fail(client);
+    }
+    std::cout << "Server system: " << nRows << " rows, " << nNz << " non-zeros" << std::endl;
+
+    std::mt19937_64 generator(42);
+    std::uniform_real_distribution<double> distribution(-1., 1.);
+    std::vector<double> rhs(nRows), solution;
+    std::vector<double> rhsTimes, solveTimes, fetchTimes, roundTimes, serverSolveTimes;
+    long iterations = 0;
+    std::chrono::steady_clock::time_point testStart = std::chrono::steady_clock::now();
+    for(long round = 0; round < nRounds; ++round) {
+        for(double & value : rhs) {
+            value = distribution(generator);
+        }
+
+        std::chrono::steady_clock::time_point roundStart = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::time_point start = roundStart;
+        if(!client.setRHS(rhs)) {
+            return fail(client);
+        }
+        rhsTimes.push_back(elapsed(start));
+
+        start = std::chrono::steady_clock::now();
+        ServerProtocol::SolveReply result;
+        if(!client.solve(result)) {
+            return fail(client);
+        }
+        solveTimes.push_back(elapsed(start));
+        serverSolveTimes.push_back(result.time);
+        iterations += result.iterations;
+
+        start = std::chrono::steady_clock::now();
+        if(!client.fetchSolution(solution) || static_cast<long>(solution.size()) != nRows) {
+            return fail(client);
+        }
+        fetchTimes.push_back(elapsed(start));
+        roundTimes.push_back(elapsed(roundStart));
+    }
+    double testTime = elapsed(testStart);
+
+    std::cout << "Latency [ms] over " << nRounds << " rounds" << std::endl;
+    std::cout << std::left << std::setw(16) << "request" << std::right
+            << std::setw(12) << "p50" << std::setw(12) << "p90" << std::setw(12) << "p99" << std::setw(12) << "max" << std::endl;
+    report("NEW_RHS", rhsTimes);
+    report("SOLVE", solveTimes);
+    report("FETCH_SOLUTION", fetchTimes);
+    report("round", roundTimes);
+    report("server solve", serverSolveTimes);
+    std::cout << "Throughput = " << nRounds / testTime << " rounds/s, mean iterations = "
+            << static_cast<double>(iterations) / nRounds << std::endl;
+
+    if(isShutdown && !client.shutdown()) {
+        return fail(client);
+    }
+
+    return 0;
+}
@@ -0,0 +1,174 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+/*!
+ * Microbenchmark of the ASCII input parsing.
+ * It generates in memory a right-hand side body (one value per line) and a CSR matrix body
+ * (pattern and values lines), then it parses them with iostream extraction, as the readers did,
+ * and with the Tokenizer class, printing the throughput of both in MB/s.
+ *
+ * Usage: tokenizer_benchmark [number_of_rows] [non_zeros_per_row]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "tokenizer.hpp"
+
+namespace {
+
+std::string generateVector(long nRows, std::mt19937_64 & generator)
+{
+    std::uniform_real_distribution<double> distribution(-1.e3, 1.e3);
+    std::string text;
+    char buffer[64];
+    for(long i = 0; i < nRows; ++i) {
+        int length = std::snprintf(buffer, sizeof(buffer), "%.15e\n", distribution(generator));
+        text.append(buffer, length);
+    }
+
+    return text;
+}
+
+std::string generateMatrix(long nRows, int nNzPerRow, std::mt19937_64 & generator)
+{
+    std::uniform_int_distribution<long> columns(0, nRows - 1);
+    std::uniform_real_distribution<double> values(-1.e3, 1.e3);
+    std::string text;
+    char buffer[64];
+    for(long i = 0; i < nRows; ++i) {
+        for(int k = 0; k < nNzPerRow; ++k) {
+            int length = std::snprintf(buffer, sizeof(buffer), k == 0 ? "%ld" : " %ld", columns(generator));
+            text.append(buffer, length);
+        }
+        text.push_back('\n');
+        for(int k = 0; k < nNzPerRow; ++k) {
+            int length = std::snprintf(buffer, sizeof(buffer), k == 0 ? "%.12g" : " %.12g", values(generator));
+            text.append(buffer, length);
+        }
+        text.push_back('\n');
+    }
+
+    return text;
+}
+
+void report(const std::string & label, std::size_t bytes, double iostreamTime, double tokenizerTime, bool match)
+{
+    double megaBytes = static_cast<double>(bytes) / (1024. * 1024.);
+    std::cout << label << ": " << megaBytes << " MB" << std::endl;
+    std::cout << "    iostream  " << megaBytes / iostreamTime << " MB/s" << std::endl;
+    std::cout << "    tokenizer " << megaBytes / tokenizerTime << " MB/s" << std::endl;
+    std::cout << "    speed-up  " << iostreamTime / tokenizerTime << (match ? "" : " (VALUES DIFFER)") << std::endl;
+}
+
+double elapsed(const std::chrono::steady_clock::time_point & start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    long nRows = (argc > 1) ? std::atol(argv[1]) : 1000000;
+    int nNzPerRow = (argc > 2) ? std::atoi(argv[2]) : 7;
+    std::mt19937_64 generator(42);
+
+    //Right-hand side like body
+    {
+        std::string text = generateVector(nRows, generator);
+        std::vector<double> before(nRows), after(nRows);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::istringstream iostreamInput(text);
+        for(long i = 0; i < nRows; ++i) {
+            iostreamInput >> before[i];
+        }
+        double iostreamTime = elapsed(start);
+
+        start = std::chrono::steady_clock::now();
+        std::istringstream tokenizerInput(text);
+        Tokenizer tokenizer(tokenizerInput);
+        for(long i = 0; i < nRows; ++i) {
+            tokenizer.readValue(after[i]);
+        }
+        double tokenizerTime = elapsed(start);
+
+        report("Vector body", text.size(), iostreamTime, tokenizerTime, before == after);
+    }
+
+    //CSR matrix body
+    {
+        std::string text = generateMatrix(nRows, nNzPerRow, generator);
+        std::vector<long> pattern;
+        std::vector<double> values;
+        long checksumPatternBefore = 0, checksumPatternAfter = 0;
+        double checksumValuesBefore = 0., checksumValuesAfter = 0.;
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::istringstream iostreamInput(text);
+        std::string line;
+        for(long i = 0; i < nRows; ++i) {
+            pattern.clear();
+            values.clear();
+            std::getline(iostreamInput, line);
+            std::istringstream patternStream(line);
+            long column;
+            while(patternStream >> column) {
+                pattern.push_back(column);
+            }
+            std::getline(iostreamInput, line);
+            std::istringstream valuesStream(line);
+            double value;
+            while(valuesStream >> value) {
+                values.push_back(value);
+            }
+            checksumPatternBefore += pattern.back();
+            checksumValuesBefore += values.back();
+        }
+        double iostreamTime = elapsed(start);
+
+        start = std::chrono::steady_clock::now();
+        std::istringstream tokenizerInput(text);
+        Tokenizer tokenizer(tokenizerInput);
+        for(long i = 0; i < nRows; ++i) {
+            pattern.clear();
+            values.clear();
+            tokenizer.readLine(pattern);
+            tokenizer.readLine(values);
+            checksumPatternAfter += pattern.back();
+            checksumValuesAfter += values.back();
+        }
+        double tokenizerTime = elapsed(start);
+
+        report("CSR matrix body", text.size(), iostreamTime, tokenizerTime,
+                checksumPatternBefore == checksumPatternAfter && checksumValuesBefore == checksumValuesAfter);
+    }
+
+    return 0;
+}
@@ -0,0 +1,252 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include "sharedSegmentWriter.hpp"
+
+/*!
+ * Default constructor. No segment is created.
+ */
+SharedSegmentWriter::SharedSegmentWriter()
+    : m_data(nullptr), m_size(0)
+{
+    std::memset(&m_matrixHeader, 0, sizeof(m_matrixHeader));
+    std::memset(&m_rhsHeader, 0, sizeof(m_rhsHeader));
+    std::memset(&m_solutionHeader, 0, sizeof(m_solutionHeader));
+}
+
+/*!
+ * Destructor. It unmaps the segment, which stays available to the consumer until unlinked.
+ */
+SharedSegmentWriter::~SharedSegmentWriter()
+{
+    close();
+}
+
+/*!
+ * It creates, or replaces, the segment sized for a system and writes the headers of its parts, in EMPTY state.
+ * \param[in] name name of the segment, a leading '/' is added if missing
+ * \param[in] nRows global number of rows of the matrix and of the vectors
+ * \param[in] nCols global number of columns of the matrix, zero with nNz for no matrix
+ * \param[in] nNz global number of non-zeros of the matrix
+ * \param[in] nRhsColumns number of right-hand sides, zero for none
+ * \param[in] hasSolution true to provide an initial solution
+ * \return true if the segment has been created and mapped
+ */
+bool SharedSegmentWriter::create(const std::string & name, int64_t nRows, int64_t nCols, int64_t nNz, int64_t nRhsColumns, bool hasSolution)
+{
+    close();
+    m_name = (!name.empty() && name[0] == '/') ? name : "/" + name;
+
+    SharedSegmentHeader header = SharedSegmentFormat::buildHeader(nRows, nCols, nNz, nRhsColumns, hasSolution);
+    std::size_t size = SharedSegmentFormat::getSegmentSize(header);
+
+    int fd = shm_open(m_name.c_str(), O_CREAT | O_RDWR, 0600);
+    if(fd < 0) {
+        m_lastError = "segment " + m_name + " not created: " + std::strerror(errno);
+        return false;
+    }
+    if(ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        m_lastError = "segment " + m_name + " not resized: " + std::strerror(errno);
+        ::close(fd);
+        return false;
+    }
+    void *address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if(address == MAP_FAILED) {
+        m_lastError = "segment " + m_name + " not mapped: " + std::strerror(errno);
+        return false;
+    }
+    m_data = static_cast<char *>(address);
+    m_size = size;
+
+    //The state is reset first, so that a consumer never sees a stale publication
+    SharedSegmentFormat::storeState(reinterpret_cast<SharedSegmentHeader *>(m_data), SharedSegmentFormat::State::EMPTY);
+    std::memcpy(m_data, &header, sizeof(header));
+    if(header.matrixOffset != 0) {
+        m_matrixHeader = CSRBinaryFormat::buildHeader(nRows, nCols, nNz);
+        std::memcpy(m_data + header.matrixOffset, &m_matrixHeader, sizeof(m_matrixHeader));
+    }
+    if(header.rhsOffset != 0) {
+        m_rhsHeader = VectorBinaryFormat::buildHeader(nRows, nRhsColumns);
+        std::memcpy(m_data + header.rhsOffset, &m_rhsHeader, sizeof(m_rhsHeader));
+    }
+    if(header.solutionOffset != 0) {
+        m_solutionHeader = VectorBinaryFormat::buildHeader(nRows);
+        std::memcpy(m_data + header.solutionOffset, &m_solutionHeader, sizeof(m_solutionHeader));
+    }
+
+    return true;
+}
+
+/*!
+ * It unmaps the segment, which stays available to the consumer until unlinked.
+ */
+void SharedSegmentWriter::close()
+{
+    if(m_data != nullptr) {
+        munmap(m_data, m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+}
+
+/*!
+ * It removes the segment name, the memory being freed once no process maps it anymore.
+ * \return true if the segment has been removed
+ */
+bool SharedSegmentWriter::unlink()
+{
+    if(m_name.empty() || shm_unlink(m_name.c_str()) != 0) {
+        m_lastError = "segment " + m_name + " not removed";
+        return false;
+    }
+
+    return true;
+}
+
+/*!
+ * \return the row pointer array of the matrix, nRows + 1 elements starting from zero, null without matrix
+ */
+int64_t * SharedSegmentWriter::getRowPtr()
+{
+    return reinterpret_cast<int64_t *>(getPart(reinterpret_cast<SharedSegmentHeader *>(m_data)->matrixOffset, m_matrixHeader.rowPtrOffset));
+}
+
+/*!
+ * \return the global column indices array of the matrix, nNz elements, null without matrix
+ */
+int64_t * SharedSegmentWriter::getColIdx()
+{
+    return reinterpret_cast<int64_t *>(getPart(reinterpret_cast<SharedSegmentHeader *>(m_data)->matrixOffset, m_matrixHeader.colIdxOffset));
+}
+
+/*!
+ * \return the values array of the matrix, nNz elements, null without matrix
+ */
+double * SharedSegmentWriter::getValues()
+{
+    return reinterpret_cast<double *>(getPart(reinterpret_cast<SharedSegmentHeader *>(m_data)->matrixOffset, m_matrixHeader.valuesOffset));
+}
+
+/*!
+ * \param[in] column the right-hand side
+ * \return the array of a right-hand side, nRows elements, null without right-hand sides
+ */
+double * SharedSegmentWriter::getRHS(int64_t column)
+{
+    double *values = reinterpret_cast<double *>(getPart(reinterpret_cast<SharedSegmentHeader *>(m_data)->rhsOffset, m_rhsHeader.valuesOffset));
+    if(values == nullptr || column < 0 || column >= m_rhsHeader.nColumns) {
+        return nullptr;
+    }
+
+    return values + column * m_rhsHeader.nRows;
+}
+
+/*!
+ * \return the initial solution array, nRows elements, null without initial solution
+ */
+double * SharedSegmentWriter::getSolution()
+{
+    return reinterpret_cast<double *>(getPart(reinterpret_cast<SharedSegmentHeader *>(m_data)->solutionOffset, m_solutionHeader.valuesOffset));
+}
+
+/*!
+ * It publishes the arrays filled so far: the consumer may read them from now on and they must not be changed
+ * until the segment is consumed.
+ */
+void SharedSegmentWriter::publish()
+{
+    if(m_data == nullptr) {
+        return;
+    }
+
+    SharedSegmentHeader *header = reinterpret_cast<SharedSegmentHeader *>(m_data);
+    ++header->sequence;
+    SharedSegmentFormat::storeState(header, SharedSegmentFormat::State::READY);
+}
+
+/*!
+ * It waits for the consumer to mark the published arrays consumed, polling with a growing interval up to 10 ms.
+ * \param[in] timeout maximum time to wait [s]
+ * \return true if the segment has been consumed, the arrays may then be filled again
+ */
+bool SharedSegmentWriter::waitConsumed(double timeout)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::chrono::microseconds interval(100);
+    while(getState() != SharedSegmentFormat::State::CONSUMED) {
+        if(m_data == nullptr || std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() > timeout) {
+            m_lastError = "segment " + m_name + " not consumed";
+            return false;
+        }
+        std::this_thread::sleep_for(interval);
+        interval = std::min(interval * 2, std::chrono::microseconds(10000));
+    }
+
+    return true;
+}
+
+/*!
+ * \return the handshake state of the segment, EMPTY if not created
+ */
+SharedSegmentFormat::State SharedSegmentWriter::getState() const
+{
+    if(m_data == nullptr) {
+        return SharedSegmentFormat::State::EMPTY;
+    }
+
+    return SharedSegmentFormat::loadState(reinterpret_cast<const SharedSegmentHeader *>(m_data));
+}
+
+/*!
+ * \return the reason of the last failure
+ */
+const std::string & SharedSegmentWriter::getLastError() const
+{
+    return m_lastError;
+}
+
+/*!
+ * It gets an array of an embedded container
+ * \param[in] offset offset of the container in the segment, zero if absent
+ * \param[in] arrayOffset offset of the array in the container
+ * \return a pointer to the array, null if the segment is not created or the container is absent
+ */
+char * SharedSegmentWriter::getPart(uint64_t offset, uint64_t arrayOffset)
+{
+    if(m_data == nullptr || offset == 0) {
+        return nullptr;
+    }
+
+    return m_data + offset + arrayOffset;
+}
@@ -0,0 +1,86 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_SHAREDSEGMENTWRITER_HPP__
+#define __MADLINSOLV_SHAREDSEGMENTWRITER_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "binaryFormat.hpp"
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The shared-memory input segment writer class
+ *
+ *  This class is intended to
+ *  let a producer process hand its system over to madlinsolv running on the same node through a POSIX shared-memory
+ *  segment (see SharedSegmentFormat class for the layout and the handshake), in place of matrix and vector files.
+ *  The producer creates the segment with the sizes of its system, fills the arrays in place (CSR row pointer,
+ *  column indices and values, right-hand sides column after column, initial solution), then publishes them;
+ *  madlinsolv, with the segment name in the Input section of its dictionary, reads them and marks the segment consumed,
+ *  after which the producer may fill and publish it again for the next run.
+ *  This class depends on POSIX only.
+ */
+class SharedSegmentWriter {
+
+public:
+
+    SharedSegmentWriter();
+    ~SharedSegmentWriter();
+
+    SharedSegmentWriter(SharedSegmentWriter const&) = delete;
+    SharedSegmentWriter & operator=(SharedSegmentWriter const&) = delete;
+
+    bool create(const std::string & name, int64_t nRows, int64_t nCols, int64_t nNz, int64_t nRhsColumns, bool hasSolution);
+    void close();
+    bool unlink();
+
+    int64_t * getRowPtr();
+    int64_t * getColIdx();
+    double * getValues();
+    double * getRHS(int64_t column = 0);
+    double * getSolution();
+
+    void publish();
+    bool waitConsumed(double timeout);
+    SharedSegmentFormat::State getState() const;
+
+    const std::string & getLastError() const;
+
+private:
+
+    char * getPart(uint64_t offset, uint64_t arrayOffset);
+
+    std::string m_name;                                 /**<POSIX name of the segment, starting with '/'*/
+    char *m_data;                                       /**<first byte of the mapped segment, null if not created*/
+    std::size_t m_size;                                 /**<size in bytes of the mapped segment*/
+    CSRBinaryHeader m_matrixHeader;                     /**<header of the embedded matrix container*/
+    VectorBinaryHeader m_rhsHeader;                     /**<header of the embedded right-hand sides container*/
+    VectorBinaryHeader m_solutionHeader;                /**<header of the embedded initial solution container*/
+    std::string m_lastError;                            /**<reason of the last failure*/
+
+};
+
+#endif
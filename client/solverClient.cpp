@@ -0,0 +1,245 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#include <cerrno>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "solverClient.hpp"
+
+/*!
+ * Default constructor. The client is not connected.
+ */
+SolverClient::SolverClient()
+    : m_socket(-1)
+{
+}
+
+/*!
+ * Destructor. It closes the connection, if any.
+ */
+SolverClient::~SolverClient()
+{
+    disconnect();
+}
+
+/*!
+ * It connects the client to a solver server, closing the previous connection, if any.
+ * \param[in] socketPath path of the UNIX-domain socket the server listens on
+ * \return true if the client is connected
+ */
+bool SolverClient::connect(const std::string & socketPath)
+{
+    disconnect();
+
+    sockaddr_un address;
+    if(socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+        m_lastError = "invalid socket path " + socketPath;
+        return false;
+    }
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    m_socket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(m_socket < 0) {
+        m_lastError = std::string("socket creation failed: ") + std::strerror(errno);
+        return false;
+    }
+    if(::connect(m_socket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0) {
+        m_lastError = "connection to " + socketPath + " failed: " + std::strerror(errno);
+        disconnect();
+        return false;
+    }
+
+    return true;
+}
+
+/*!
+ * It closes the connection, if any.
+ */
+void SolverClient::disconnect()
+{
+    if(m_socket >= 0) {
+        close(m_socket);
+        m_socket = -1;
+    }
+}
+
+/*!
+ * \return true if the client is connected
+ */
+bool SolverClient::isConnected() const
+{
+    return m_socket >= 0;
+}
+
+/*!
+ * It gets the sizes of the resident system.
+ * \param[out] nRows global number of rows
+ * \param[out] nNz global number of non-zeros
+ * \return true on success
+ */
+bool SolverClient::getInfo(long & nRows, long & nNz)
+{
+    std::vector<char> reply;
+    if(!request(ServerProtocol::Command::INFO, nullptr, 0, reply)) {
+        return false;
+    }
+    if(reply.size() != sizeof(ServerProtocol::InfoReply)) {
+        m_lastError = "unexpected INFO reply size";
+        return false;
+    }
+
+    ServerProtocol::InfoReply info;
+    std::memcpy(&info, reply.data(), sizeof(info));
+    nRows = info.nRows;
+    nNz = info.nNz;
+
+    return true;
+}
+
+/*!
+ * It replaces the right-hand side of the resident system.
+ * \param[in] rhs the global right-hand side, one element per row
+ * \return true on success
+ */
+bool SolverClient::setRHS(const std::vector<double> & rhs)
+{
+    std::vector<char> reply;
+    return request(ServerProtocol::Command::NEW_RHS, rhs.data(), rhs.size() * sizeof(double), reply);
+}
+
+/*!
+ * It replaces the matrix values of the resident system, keeping its pattern.
+ * The preconditioner is rebuilt by the next solve.
+ * \param[in] values the global non-zero values, in CSR order
+ * \return true on success
+ */
+bool SolverClient::updateValues(const std::vector<double> & values)
+{
+    std::vector<char> reply;
+    return request(ServerProtocol::Command::UPDATE_VALUES, values.data(), values.size() * sizeof(double), reply);
+}
+
+/*!
+ * It solves the resident system, starting from the solution of the previous solve.
+ * \param[out] result iterations, residual and time of the solve on the server
+ * \return true on success
+ */
+bool SolverClient::solve(ServerProtocol::SolveReply & result)
+{
+    std::vector<char> reply;
+    if(!request(ServerProtocol::Command::SOLVE, nullptr, 0, reply)) {
+        return false;
+    }
+    if(reply.size() != sizeof(ServerProtocol::SolveReply)) {
+        m_lastError = "unexpected SOLVE reply size";
+        return false;
+    }
+    std::memcpy(&result, reply.data(), sizeof(result));
+
+    return true;
+}
+
+/*!
+ * It gets the solution of the last solve.
+ * \param[out] solution the global solution, one element per row
+ * \return true on success
+ */
+bool SolverClient::fetchSolution(std::vector<double> & solution)
+{
+    std::vector<char> reply;
+    if(!request(ServerProtocol::Command::FETCH_SOLUTION, nullptr, 0, reply)) {
+        return false;
+    }
+    solution.resize(reply.size() / sizeof(double));
+    std::memcpy(solution.data(), reply.data(), solution.size() * sizeof(double));
+
+    return true;
+}
+
+/*!
+ * It stops the server and closes the connection.
+ * \return true on success
+ */
+bool SolverClient::shutdown()
+{
+    std::vector<char> reply;
+    bool isDone = request(ServerProtocol::Command::SHUTDOWN, nullptr, 0, reply);
+    disconnect();
+
+    return isDone;
+}
+
+/*!
+ * \return the reason of the last failure
+ */
+const std::string & SolverClient::getLastError() const
+{
+    return m_lastError;
+}
+
+/*!
+ * It sends a request and receives its reply. On a transport failure the connection is closed.
+ * \param[in] command the command of the request
+ * \param[in] payload the request payload
+ * \param[in] payloadSize the request payload size in bytes
+ * \param[out] reply the reply payload
+ * \return true if the request succeeded
+ */
+bool SolverClient::request(ServerProtocol::Command command, const void * payload, std::size_t payloadSize, std::vector<char> & reply)
+{
+    if(m_socket < 0) {
+        m_lastError = "not connected";
+        return false;
+    }
+
+    ServerProtocol::RequestHeader header;
+    header.magic = ServerProtocol::MAGIC;
+    header.command = static_cast<uint32_t>(command);
+    header.payloadSize = payloadSize;
+    ServerProtocol::ReplyHeader replyHeader;
+    if(!ServerProtocol::sendAll(m_socket, &header, sizeof(header)) || !ServerProtocol::sendAll(m_socket, payload, payloadSize)
+            || !ServerProtocol::receiveAll(m_socket, &replyHeader, sizeof(replyHeader)) || replyHeader.magic != ServerProtocol::MAGIC) {
+        m_lastError = std::string("connection lost during ") + ServerProtocol::getCommandName(header.command);
+        disconnect();
+        return false;
+    }
+
+    reply.resize(replyHeader.payloadSize);
+    if(!ServerProtocol::receiveAll(m_socket, reply.data(), reply.size())) {
+        m_lastError = std::string("connection lost during ") + ServerProtocol::getCommandName(header.command);
+        disconnect();
+        return false;
+    }
+
+    if(replyHeader.status != static_cast<int32_t>(ServerProtocol::Status::OK)) {
+        m_lastError = std::string(ServerProtocol::getCommandName(header.command)) + " failed with status " + std::to_string(replyHeader.status);
+        return false;
+    }
+
+    return true;
+}
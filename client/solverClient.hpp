@@ -0,0 +1,76 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_SOLVERCLIENT_HPP__
+#define __MADLINSOLV_SOLVERCLIENT_HPP__
+
+#include <string>
+#include <vector>
+
+#include "serverProtocol.hpp"
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The solver client class
+ *
+ *  This class is intended to
+ *  connect an application to a solver server (madlinsolv started with "--server <socket path>", see SolverServer class)
+ *  and send it requests on the resident system: new right-hand sides, new matrix values, solves and solution fetches.
+ *  Vectors are global, in the row order of the matrix; matrix values are global too, in the order of the CSR
+ *  non-zeros of the matrix the server was started with.
+ *  Every request is blocking and returns false on failure, the reason being available through getLastError.
+ *  This class depends on POSIX only.
+ */
+class SolverClient {
+
+public:
+
+    SolverClient();
+    ~SolverClient();
+
+    SolverClient(SolverClient const&) = delete;
+    SolverClient & operator=(SolverClient const&) = delete;
+
+    bool connect(const std::string & socketPath);
+    void disconnect();
+    bool isConnected() const;
+
+    bool getInfo(long & nRows, long & nNz);
+    bool setRHS(const std::vector<double> & rhs);
+    bool updateValues(const std::vector<double> & values);
+    bool solve(ServerProtocol::SolveReply & result);
+    bool fetchSolution(std::vector<double> & solution);
+    bool shutdown();
+
+    const std::string & getLastError() const;
+
+private:
+
+    bool request(ServerProtocol::Command command, const void * payload, std::size_t payloadSize, std::vector<char> & reply);
+
+    int m_socket;                                       /**<connected socket descriptor, -1 if not connected*/
+    std::string m_lastError;                            /**<reason of the last failure*/
+
+};
+
+#endif
@@ -0,0 +1,783 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#if ENABLE_MPI==1
+#    include <mpi.h>
+#endif
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include <bitpit_IO.hpp>
+
+#include "converter.hpp"
+#include "binaryFormat.hpp"
+#include "inputFileStream.hpp"
+#include "localCSR.hpp"
+#include "matrixMarketReader.hpp"
+#include "matrixReader.hpp"
+#include "rowPartition.hpp"
+#include "tokenizer.hpp"
+#include "vectorReader.hpp"
+
+using namespace bitpit;
+
+namespace {
+
+//MPI-IO counts are int, larger ranges are written in several calls
+const uint64_t MAX_CHUNK_SIZE = 1 << 30;
+
+/*!
+ * It splits a path into the folder, name and extension the file handlers of the readers are built with
+ * \param[in] path path of the file
+ * \param[out] dir folder of the file, "." if the path has none
+ * \param[out] name file name without extension
+ * \param[out] app file extension
+ * \return false if the file has no extension, which the file handlers cannot represent
+ */
+bool splitPath(const std::string & path, std::string & dir, std::string & name, std::string & app)
+{
+    std::size_t slash = path.find_last_of('/');
+    dir = (slash == std::string::npos) ? "." : path.substr(0, slash);
+    std::string fileName = (slash == std::string::npos) ? path : path.substr(slash + 1);
+
+    std::size_t dot = fileName.find_last_of('.');
+    if(dot == std::string::npos || dot == 0 || dot + 1 == fileName.size()) {
+        return false;
+    }
+    name = fileName.substr(0, dot);
+    app = fileName.substr(dot + 1);
+
+    return true;
+}
+
+/*!
+ * It gets the size of a file
+ * \param[in] path path of the file
+ * \return the size of the file in bytes, zero if it does not exist
+ */
+uint64_t getFileSize(const std::string & path)
+{
+    struct stat info;
+    if(stat(path.c_str(), &info) != 0) {
+        return 0;
+    }
+
+    return static_cast<uint64_t>(info.st_size);
+}
+
+/*!
+ * It reads the number of rows from the header of an ASCII vector, which the vector reader checks the file against
+ * \param[in] path path of the input vector, possibly gzip compressed
+ * \return the global number of rows, zero if the file cannot be read
+ */
+long readVectorRowCount(const std::string & path)
+{
+    long nRows = 0;
+    InputFileStream inVector(path);
+    std::string line;
+    std::getline(inVector, line);
+    while(std::getline(inVector, line)) {
+        line = utils::string::trim(line);
+        if(line.substr(0,1) != "#") {
+            Tokenizer::parseLong(line.data(), line.data() + line.size(), &nRows);
+            break;
+        }
+    }
+
+    return nRows;
+}
+
+/*!
+ * It hashes a non-zero, so that the sum over all the non-zeros does not depend on how they are distributed
+ * \param[in] row global row of the non-zero
+ * \param[in] col global column of the non-zero
+ * \param[in] value value of the non-zero
+ * \return the hash of the non-zero
+ */
+uint64_t hashEntry(long row, long col, double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    uint64_t hash = static_cast<uint64_t>(row) * 0x9E3779B97F4A7C15ull;
+    hash ^= static_cast<uint64_t>(col) * 0xC2B2AE3D27D4EB4Full;
+    hash ^= bits;
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDull;
+    hash ^= hash >> 33;
+
+    return hash;
+}
+
+/*!
+ * It computes the order independent checksum of CSR rows
+ * \param[in] nRows number of rows
+ * \param[in] rowPtr offset of each row in colIdx and values, nRows + 1 elements
+ * \param[in] colIdx global column indices of the rows
+ * \param[in] values values of the rows
+ * \param[in] rowStart global index of the first row
+ * \return the sum of the hashes of the non-zeros
+ */
+uint64_t computeChecksum(long nRows, const long * rowPtr, const long * colIdx, const double * values, long rowStart)
+{
+    uint64_t checksum = 0;
+    for(long row = 0; row < nRows; ++row) {
+        for(long k = rowPtr[row]; k < rowPtr[row + 1]; ++k) {
+            checksum += hashEntry(rowStart + row, colIdx[k], values[k]);
+        }
+    }
+
+    return checksum;
+}
+
+/*!
+ * It sums a value over all the processes. This function is collective.
+ * \param[in] value the local value
+ * \return the global sum
+ */
+uint64_t sumAll(uint64_t value)
+{
+#if ENABLE_MPI==1
+    uint64_t sum;
+    MPI_Allreduce(&value, &sum, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+    return sum;
+#else
+    return value;
+#endif
+}
+
+/*!
+ * It sums a value over the processes with lower rank. This function is collective.
+ * \param[in] value the local value
+ * \return the sum over the processes with lower rank, zero on the first one
+ */
+uint64_t sumPrevious(uint64_t value)
+{
+#if ENABLE_MPI==1
+    uint64_t sum = 0;
+    MPI_Exscan(&value, &sum, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    return (rank == 0) ? 0 : sum;
+#else
+    (void) value;
+    return 0;
+#endif
+}
+
+/*!
+ * It gets the maximum of a time over all the processes. This function is collective.
+ * \param[in] time the local time
+ * \return the maximum time
+ */
+double maxAll(double time)
+{
+#if ENABLE_MPI==1
+    double maxTime;
+    MPI_Allreduce(&time, &maxTime, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    return maxTime;
+#else
+    return time;
+#endif
+}
+
+/*!
+ * It checks that a condition holds on all the processes. This function is collective.
+ * \param[in] condition the local condition
+ * \return true if the condition holds on all the processes
+ */
+bool allTrue(bool condition)
+{
+#if ENABLE_MPI==1
+    int local = condition ? 1 : 0;
+    int global;
+    MPI_Allreduce(&local, &global, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    return (global == 1);
+#else
+    return condition;
+#endif
+}
+
+/*!
+ * Output file shared by all the processes, each one writing its own byte ranges at their final offset
+ */
+class OutputFile {
+
+public:
+
+    OutputFile() : m_isOpen(false), m_isGood(true), m_file()
+    {
+    }
+
+    ~OutputFile()
+    {
+        if(m_isOpen) {
+            close();
+        }
+    }
+
+    /*!
+     * It creates the file. This method is collective.
+     * \param[in] path path of the file
+     * \return true if the file has been created on all the processes
+     */
+    bool open(const std::string & path)
+    {
+#if ENABLE_MPI==1
+        int error = MPI_File_open(MPI_COMM_WORLD, const_cast<char *>(path.c_str()), MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                MPI_INFO_NULL, &m_file);
+        m_isOpen = (error == MPI_SUCCESS);
+#else
+        m_file = std::fopen(path.c_str(), "wb");
+        m_isOpen = (m_file != nullptr);
+#endif
+        return m_isOpen;
+    }
+
+    /*!
+     * It writes a byte range
+     * \param[in] offset offset of the range in the file
+     * \param[in] data bytes to be written
+     * \param[in] size number of bytes to be written
+     */
+    void write(uint64_t offset, const void * data, uint64_t size)
+    {
+        const char *bytes = static_cast<const char *>(data);
+#if ENABLE_MPI==1
+        for(uint64_t chunkOffset = 0; chunkOffset < size; chunkOffset += MAX_CHUNK_SIZE) {
+            int count = static_cast<int>(std::min(MAX_CHUNK_SIZE, size - chunkOffset));
+            int error = MPI_File_write_at(m_file, static_cast<MPI_Offset>(offset + chunkOffset), const_cast<char *>(bytes + chunkOffset),
+                    count, MPI_BYTE, MPI_STATUS_IGNORE);
+            m_isGood = m_isGood && (error == MPI_SUCCESS);
+        }
+#else
+        m_isGood = m_isGood && (std::fseek(m_file, static_cast<long>(offset), SEEK_SET) == 0);
+        m_isGood = m_isGood && (std::fwrite(bytes, 1, size, m_file) == size);
+#endif
+    }
+
+    /*!
+     * It fills a byte range with zeros, e.g. the padding between aligned arrays
+     * \param[in] begin first byte of the range
+     * \param[in] end byte following the range
+     */
+    void writeZeros(uint64_t begin, uint64_t end)
+    {
+        if(end > begin) {
+            std::vector<char> zeros(end - begin, 0);
+            write(begin, zeros.data(), zeros.size());
+        }
+    }
+
+    /*!
+     * It sets the final size of the file, dropping the tail of an older longer file, and closes it.
+     * This method is collective.
+     * \param[in] size final size of the file in bytes
+     * \return true if all the writes of all the processes succeeded
+     */
+    bool finalize(uint64_t size)
+    {
+#if ENABLE_MPI==1
+        m_isGood = m_isGood && (MPI_File_set_size(m_file, static_cast<MPI_Offset>(size)) == MPI_SUCCESS);
+#else
+        (void) size;
+#endif
+        close();
+
+        return allTrue(m_isGood);
+    }
+
+private:
+
+    void close()
+    {
+#if ENABLE_MPI==1
+        MPI_File_close(&m_file);
+#else
+        m_isGood = m_isGood && (std::fclose(m_file) == 0);
+#endif
+        m_isOpen = false;
+    }
+
+    bool m_isOpen;                                      /**<true if the file is open*/
+    bool m_isGood;                                      /**<false if any write failed*/
+#if ENABLE_MPI==1
+    MPI_File m_file;                                    /**<MPI-IO file handle*/
+#else
+    std::FILE *m_file;                                  /**<C file handle*/
+#endif
+
+};
+
+}
+
+/*!
+ * It detects the kind of an input file: binary containers by signature, Matrix Market files by banner,
+ * otherwise the size line after the comments tells an ASCII CSR matrix (three sizes) from an ASCII vector
+ * (rows and, optionally, columns)
+ * \param[in] path path of the input file, possibly gzip compressed
+ * \return the kind of the input file
+ */
+Converter::InputKind Converter::detectInput(const std::string & path)
+{
+    if(CSRBinaryFormat::hasMagic(path) || VectorBinaryFormat::hasMagic(path)) {
+        return InputKind::BINARY;
+    }
+    if(MatrixMarketReader::hasBanner(path)) {
+        return InputKind::MATRIX_MARKET;
+    }
+
+    InputFileStream inFile(path);
+    if(!inFile.isOpen()) {
+        return InputKind::UNKNOWN;
+    }
+
+    //As the readers, skip the first line and the comments
+    std::string line;
+    std::getline(inFile, line);
+    while(std::getline(inFile, line)) {
+        line = utils::string::trim(line);
+        if(line.substr(0,1) != "#") {
+            long nSizes = Tokenizer::countTokens(line.data(), line.data() + line.size());
+            if(nSizes == 1 || nSizes == 2) {
+                return InputKind::ASCII_VECTOR;
+            } else if(nSizes == 3) {
+                return InputKind::ASCII_CSR;
+            }
+            break;
+        }
+    }
+
+    return InputKind::UNKNOWN;
+}
+
+/*!
+ * Constructor
+ * It sets m_nProcessors and m_rank to values passed from the caller.
+ * Column indices are stored as 64-bit integers by default.
+ * \param[in] nProcessors number of MPI processes
+ * \param[in] rank process MPI rank
+ */
+Converter::Converter(int nProcessors, int rank) :
+        m_nProcessors(nProcessors), m_rank(rank), m_inputOptions(), m_index32(false), m_varint(false), m_valuesOnly(false)
+{
+
+}
+
+/*!
+ * It sets the input settings the input file is read with
+ * \param[in] options input settings
+ */
+void Converter::setInputOptions(const InputOptions & options)
+{
+    m_inputOptions = options;
+}
+
+/*!
+ * It sets if the column indices of the matrix are stored as 32-bit integers
+ * \param[in] index32 true to store the column indices as 32-bit integers
+ */
+void Converter::setIndex32(bool index32)
+{
+    m_index32 = index32;
+}
+
+/*!
+ * It sets if the column indices of the matrix are delta encoded as variable length integers
+ * \param[in] varint true to delta encode the column indices
+ */
+void Converter::setVarint(bool varint)
+{
+    m_varint = varint;
+}
+
+/*!
+ * It sets if only the values of the matrix are written, as the values file of a cached pattern
+ * (see MatrixReader::readMatrixValues)
+ * \param[in] valuesOnly true to write the values array of the matrix into a binary vector container
+ */
+void Converter::setValuesOnly(bool valuesOnly)
+{
+    m_valuesOnly = valuesOnly;
+}
+
+/*!
+ * It converts an input file into the matching binary container. This method is collective.
+ * \param[in] inputPath path of the ASCII CSR, Matrix Market or ASCII vector file
+ * \param[in] outputPath path of the binary container to be written
+ * \return true if the binary container has been written and verified
+ */
+bool Converter::convert(const std::string & inputPath, const std::string & outputPath)
+{
+    InputKind kind = detectInput(inputPath);
+    switch(kind) {
+    case InputKind::ASCII_CSR:
+        log::cout() << "Input format: ASCII CSR matrix" << std::endl;
+        return convertMatrix(kind, inputPath, outputPath);
+    case InputKind::MATRIX_MARKET:
+        log::cout() << "Input format: Matrix Market matrix" << std::endl;
+        return convertMatrix(kind, inputPath, outputPath);
+    case InputKind::ASCII_VECTOR:
+        log::cout() << "Input format: ASCII vector" << std::endl;
+        return convertVector(inputPath, outputPath);
+    case InputKind::BINARY:
+        log::cout() << "File " << inputPath << " is already a binary container" << std::endl;
+        return false;
+    default:
+        log::cout() << "File " << inputPath << " not open or not recognized!" << std::endl;
+        return false;
+    }
+}
+
+/*!
+ * It converts a matrix into the binary CSR container or, with the values only option, into the binary vector container
+ * of its values array. This method is collective.
+ * The matrix is read by the solver reader with a rows consumer, so no SparseMatrix is created:
+ * the local rows are written at their final offsets, which are known once the non-zeros
+ * (and, for the varint layout, the encoded bytes) of the processes with lower rank are summed.
+ * \param[in] kind kind of the input matrix
+ * \param[in] inputPath path of the input matrix
+ * \param[in] outputPath path of the binary container to be written
+ * \return true if the binary container has been written and verified
+ */
+bool Converter::convertMatrix(InputKind kind, const std::string & inputPath, const std::string & outputPath)
+{
+    static_assert(sizeof(long) == sizeof(int64_t), "Binary CSR column indices are written as long without copy");
+
+    std::string dir, name, app;
+    if(!splitPath(inputPath, dir, name, app)) {
+        log::cout() << "File " << inputPath << " has no extension, it cannot be read" << std::endl;
+        return false;
+    }
+
+    uint64_t flags = m_varint ? CSRBinaryFormat::FLAG_VARINT : (m_index32 ? CSRBinaryFormat::FLAG_INDEX32 : 0);
+    std::function<int()> getNCols;
+    bool isWritten = false;
+    uint64_t checksum = 0;
+    uint64_t nValues = 0;
+    double writeTime = 0.;
+    LocalCSR::Consumer consumer = [&](long nRows, const long * rowPtr, const long * colIdx, const double * values, long rowStart) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        long nzBegin = rowPtr[0];
+        uint64_t localNnz = rowPtr[nRows] - nzBegin;
+
+        //The values file is the values array alone, one element per non-zero in CSR order
+        if(m_valuesOnly) {
+            nValues = sumAll(localNnz);
+            uint64_t nzStart = sumPrevious(localNnz);
+            for(uint64_t k = 0; k < localNnz; ++k) {
+                checksum += hashEntry(nzStart + k, 0, values[nzBegin + k]);
+            }
+            checksum = sumAll(checksum);
+
+            VectorBinaryHeader header = VectorBinaryFormat::buildHeader(nValues);
+            OutputFile outFile;
+            if(!outFile.open(outputPath)) {
+                log::cout() << "File " << outputPath << " cannot be created!" << std::endl;
+                return;
+            }
+            if(m_rank == 0) {
+                outFile.write(0, &header, sizeof(header));
+                outFile.writeZeros(sizeof(header), header.valuesOffset);
+            }
+            outFile.write(header.valuesOffset + nzStart * sizeof(double), values + nzBegin, localNnz * sizeof(double));
+            isWritten = outFile.finalize(header.valuesOffset + nValues * sizeof(double));
+
+            writeTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            return;
+        }
+
+        checksum = sumAll(computeChecksum(nRows, rowPtr, colIdx, values, rowStart));
+
+        //Encode the local column indices in the compact layouts
+        std::vector<int32_t> colIdx32;
+        std::vector<int64_t> bytePtr;
+        std::vector<unsigned char> stream;
+        int nCols = getNCols();
+        if(flags & CSRBinaryFormat::FLAG_VARINT) {
+            bytePtr.reserve(nRows + 1);
+            stream.reserve(2 * localNnz);
+            for(long row = 0; row < nRows; ++row) {
+                bytePtr.push_back(static_cast<int64_t>(stream.size()));
+                CSRBinaryFormat::encodeRow(rowStart + row, rowPtr[row + 1] - rowPtr[row], colIdx + rowPtr[row], stream);
+            }
+            bytePtr.push_back(static_cast<int64_t>(stream.size()));
+        } else if(flags & CSRBinaryFormat::FLAG_INDEX32) {
+            colIdx32.assign(colIdx + nzBegin, colIdx + nzBegin + localNnz);
+        }
+
+        uint64_t nRowsGlobal = sumAll(nRows);
+        uint64_t nNzGlobal = sumAll(localNnz);
+        uint64_t nzStart = sumPrevious(localNnz);
+        uint64_t streamSize = sumAll(stream.size());
+        uint64_t streamStart = sumPrevious(stream.size());
+        CSRBinaryHeader header = CSRBinaryFormat::buildHeader(nRowsGlobal, nCols, nNzGlobal, flags, streamSize);
+
+        std::vector<int64_t> localRowPtr(rowPtr, rowPtr + nRows + 1);
+        for(int64_t & offset : localRowPtr) {
+            offset += nzStart - nzBegin;
+        }
+        for(int64_t & offset : bytePtr) {
+            offset += streamStart;
+        }
+        //The closing entries of the row pointers are written by the process owning the last row
+        bool isLast = (static_cast<uint64_t>(rowStart + nRows) == nRowsGlobal);
+
+        OutputFile outFile;
+        if(!outFile.open(outputPath)) {
+            log::cout() << "File " << outputPath << " cannot be created!" << std::endl;
+            return;
+        }
+        if(m_rank == 0) {
+            uint64_t colIdxSize = nNzGlobal * sizeof(int64_t);
+            if(flags & CSRBinaryFormat::FLAG_VARINT) {
+                colIdxSize = (nRowsGlobal + 1) * sizeof(int64_t) + streamSize;
+            } else if(flags & CSRBinaryFormat::FLAG_INDEX32) {
+                colIdxSize = nNzGlobal * sizeof(int32_t);
+            }
+            outFile.write(0, &header, sizeof(header));
+            outFile.writeZeros(sizeof(header), header.rowPtrOffset);
+            outFile.writeZeros(header.rowPtrOffset + (nRowsGlobal + 1) * sizeof(int64_t), header.colIdxOffset);
+            outFile.writeZeros(header.colIdxOffset + colIdxSize, header.valuesOffset);
+        }
+        outFile.write(header.rowPtrOffset + rowStart * sizeof(int64_t), localRowPtr.data(), (nRows + (isLast ? 1 : 0)) * sizeof(int64_t));
+        if(flags & CSRBinaryFormat::FLAG_VARINT) {
+            outFile.write(header.colIdxOffset + rowStart * sizeof(int64_t), bytePtr.data(), (nRows + (isLast ? 1 : 0)) * sizeof(int64_t));
+            outFile.write(header.colIdxOffset + (nRowsGlobal + 1) * sizeof(int64_t) + streamStart, stream.data(), stream.size());
+        } else if(flags & CSRBinaryFormat::FLAG_INDEX32) {
+            outFile.write(header.colIdxOffset + nzStart * sizeof(int32_t), colIdx32.data(), localNnz * sizeof(int32_t));
+        } else {
+            outFile.write(header.colIdxOffset + nzStart * sizeof(int64_t), colIdx + nzBegin, localNnz * sizeof(int64_t));
+        }
+        outFile.write(header.valuesOffset + nzStart * sizeof(double), values + nzBegin, localNnz * sizeof(double));
+        isWritten = outFile.finalize(header.valuesOffset + nNzGlobal * sizeof(double));
+
+        writeTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::unique_ptr<SparseMatrix> matrix;
+    if(kind == InputKind::MATRIX_MARKET) {
+        MatrixMarketReader reader(m_nProcessors, m_rank, dir, name, app);
+        reader.setInputOptions(m_inputOptions);
+        reader.setRowsConsumer(consumer);
+        getNCols = [&reader]() { return reader.getNCols(); };
+        reader.read(matrix);
+    } else {
+        MatrixReader reader(m_nProcessors, m_rank, dir, name, app);
+        reader.setInputOptions(m_inputOptions);
+        reader.setRowsConsumer(consumer);
+        getNCols = [&reader]() { return reader.getNCols(); };
+        reader.readMatrixCSRFormat(matrix);
+    }
+    double readTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() - writeTime;
+
+    if(!isWritten) {
+        log::cout() << "File " << outputPath << " not written!" << std::endl;
+        return false;
+    }
+
+    start = std::chrono::steady_clock::now();
+    bool isVerified = m_valuesOnly ? verifyVector(outputPath, nValues, checksum) : verifyMatrix(outputPath, checksum);
+    double readBackTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    report(inputPath, outputPath, readTime, writeTime, readBackTime);
+
+    return isVerified;
+}
+
+/*!
+ * It converts a right-hand side or an initial solution, possibly with several columns, into the binary vector container.
+ * This method is collective. The vector is read by the solver reader, each process getting an equal share of the rows
+ * of every column, and each process writes its slice of every column at its final offset.
+ * \param[in] inputPath path of the input vector
+ * \param[in] outputPath path of the binary container to be written
+ * \return true if the binary container has been written and verified
+ */
+bool Converter::convertVector(const std::string & inputPath, const std::string & outputPath)
+{
+    std::string dir, name, app;
+    if(!splitPath(inputPath, dir, name, app)) {
+        log::cout() << "File " << inputPath << " has no extension, it cannot be read" << std::endl;
+        return false;
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<std::vector<double>> columns;
+    VectorReader reader(m_nProcessors, m_rank, VectorReader::Target::RHS, dir, name, app);
+    reader.setInputOptions(m_inputOptions);
+    reader.readColumns(readVectorRowCount(inputPath), columns);
+    long nRows = reader.getNRows();
+    RowPartition partition = reader.getPartition();
+    long rowStart = partition.getRowStart(m_rank);
+    long nLocalRows = partition.getRowCount(m_rank);
+
+    uint64_t checksum = 0;
+    for(std::size_t column = 0; column < columns.size(); ++column) {
+        for(long i = 0; i < nLocalRows; ++i) {
+            checksum += hashEntry(rowStart + i, column, columns[column][i]);
+        }
+    }
+    checksum = sumAll(checksum);
+    double readTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    VectorBinaryHeader header = VectorBinaryFormat::buildHeader(nRows, columns.size());
+    OutputFile outFile;
+    if(!outFile.open(outputPath)) {
+        log::cout() << "File " << outputPath << " cannot be created!" << std::endl;
+        return false;
+    }
+    if(m_rank == 0) {
+        outFile.write(0, &header, sizeof(header));
+        outFile.writeZeros(sizeof(header), header.valuesOffset);
+    }
+    for(std::size_t column = 0; column < columns.size(); ++column) {
+        outFile.write(header.valuesOffset + (column * nRows + rowStart) * sizeof(double), columns[column].data(), nLocalRows * sizeof(double));
+    }
+    if(!outFile.finalize(header.valuesOffset + columns.size() * nRows * sizeof(double))) {
+        log::cout() << "File " << outputPath << " not written!" << std::endl;
+        return false;
+    }
+    double writeTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    bool isVerified = verifyVector(outputPath, nRows, checksum);
+    double readBackTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    report(inputPath, outputPath, readTime, writeTime, readBackTime);
+
+    return isVerified;
+}
+
+/*!
+ * It reads back the binary CSR container with the solver reader and compares its checksum with the input one.
+ * This method is collective.
+ * \param[in] outputPath path of the binary container
+ * \param[in] checksum checksum of the input matrix
+ * \return true if the checksums match
+ */
+bool Converter::verifyMatrix(const std::string & outputPath, uint64_t checksum)
+{
+    std::string dir, name, app;
+    if(!splitPath(outputPath, dir, name, app)) {
+        log::cout() << "File " << outputPath << " has no extension, it cannot be read back" << std::endl;
+        return false;
+    }
+
+    uint64_t readChecksum = 0;
+    MatrixReader reader(m_nProcessors, m_rank, dir, name, app);
+    reader.setInputOptions(m_inputOptions);
+    reader.setRowsConsumer([&readChecksum](long nRows, const long * rowPtr, const long * colIdx, const double * values, long rowStart) {
+        readChecksum = sumAll(computeChecksum(nRows, rowPtr, colIdx, values, rowStart));
+    });
+    std::unique_ptr<SparseMatrix> matrix;
+    reader.readMatrixBinaryFormat(matrix);
+
+    bool isVerified = (readChecksum == checksum);
+    log::cout() << "Read back check: " << (isVerified ? "passed" : "FAILED") << std::endl;
+
+    return isVerified;
+}
+
+/*!
+ * It reads back the binary vector container with the solver reader and compares its checksum with the input one.
+ * This method is collective.
+ * \param[in] outputPath path of the binary container
+ * \param[in] nRows global number of rows of the input vector
+ * \param[in] checksum checksum of the input vector
+ * \return true if the checksums match
+ */
+bool Converter::verifyVector(const std::string & outputPath, long nRows, uint64_t checksum)
+{
+    std::string dir, name, app;
+    if(!splitPath(outputPath, dir, name, app)) {
+        log::cout() << "File " << outputPath << " has no extension, it cannot be read back" << std::endl;
+        return false;
+    }
+
+    std::vector<std::vector<double>> columns;
+    VectorReader reader(m_nProcessors, m_rank, VectorReader::Target::RHS, dir, name, app);
+    reader.setInputOptions(m_inputOptions);
+    reader.readColumns(nRows, columns);
+    long rowStart = reader.getPartition().getRowStart(m_rank);
+
+    uint64_t readChecksum = 0;
+    for(std::size_t column = 0; column < columns.size(); ++column) {
+        for(std::size_t i = 0; i < columns[column].size(); ++i) {
+            readChecksum += hashEntry(rowStart + i, column, columns[column][i]);
+        }
+    }
+    readChecksum = sumAll(readChecksum);
+
+    bool isVerified = (readChecksum == checksum);
+    log::cout() << "Read back check: " << (isVerified ? "passed" : "FAILED") << std::endl;
+
+    return isVerified;
+}
+
+/*!
+ * It reports the sizes of the input and of the binary container, the conversion times
+ * and the read speed-up the solver can expect from the binary container.
+ * Times are the maximum over the processes. This method is collective.
+ * \param[in] inputPath path of the input file
+ * \param[in] outputPath path of the binary container
+ * \param[in] readTime time spent reading the input file [s]
+ * \param[in] writeTime time spent writing the binary container [s]
+ * \param[in] readBackTime time spent reading back the binary container [s]
+ */
+void Converter::report(const std::string & inputPath, const std::string & outputPath, double readTime, double writeTime, double readBackTime)
+{
+    readTime = maxAll(readTime);
+    writeTime = maxAll(writeTime);
+    readBackTime = maxAll(readBackTime);
+
+    double inputSize = static_cast<double>(getFileSize(inputPath)) / (1 << 20);
+    double outputSize = static_cast<double>(getFileSize(outputPath)) / (1 << 20);
+
+    log::cout() << "" << std::endl;
+    log::cout() << "Input size = " << inputSize << " MB" << std::endl;
+    log::cout() << "Binary size = " << outputSize << " MB";
+    if(inputSize > 0.) {
+        log::cout() << " (" << 100. * outputSize / inputSize << "% of the input)";
+    }
+    log::cout() << std::endl;
+    log::cout() << "Input read time = " << readTime << " s" << std::endl;
+    log::cout() << "Binary write time = " << writeTime << " s" << std::endl;
+    log::cout() << "Binary read time = " << readBackTime << " s";
+    if(readBackTime > 0.) {
+        log::cout() << " (" << outputSize / readBackTime << " MB/s)";
+    }
+    log::cout() << std::endl;
+    if(readBackTime > 0.) {
+        log::cout() << "Expected read speed-up = " << readTime / readBackTime << std::endl;
+    }
+}
@@ -0,0 +1,94 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_CONVERTER_HPP__
+#define __MADLINSOLV_CONVERTER_HPP__
+
+#include <cstdint>
+#include <string>
+
+#include "inputOptions.hpp"
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The offline converter class
+ *
+ *  This class is intended to
+ *  convert once the ASCII inputs of the solver into the binary containers the solver reads without parsing:
+ *  - ASCII CSR and Matrix Market matrices into the binary CSR container (see CSRBinaryFormat class for details);
+ *  - ASCII right-hand sides and initial solutions, with all their columns, into the binary vector container
+ *    (see VectorBinaryFormat class for details);
+ *  - on request, matrices into the binary vector container of their values array, i.e. the values file
+ *    read with a cached pattern by MatrixReader::readMatrixValues.
+ *
+ *  The input is read in parallel by the solver readers, with the same input options, and each process
+ *  writes its own rows at their final offsets, so that no process ever holds the whole matrix.
+ *  Column indices can be stored as 32-bit integers or delta encoded as variable length integers.
+ *  At the end, the binary file is read back with the solver reader, its content is checked against the input
+ *  and the expected read speed-up is reported together with the file sizes.
+ */
+class Converter {
+
+public:
+
+    /*!
+     * Kinds of input files
+     */
+    enum class InputKind {
+        ASCII_CSR,                                      /**<ASCII CSR matrix, see MatrixReader*/
+        MATRIX_MARKET,                                  /**<Matrix Market coordinate matrix, see MatrixMarketReader*/
+        ASCII_VECTOR,                                   /**<ASCII right-hand side or initial solution, see VectorReader*/
+        BINARY,                                         /**<already converted binary container*/
+        UNKNOWN                                         /**<missing or unreadable file*/
+    };
+
+    static InputKind detectInput(const std::string & path);
+
+    Converter(int nProcessors, int rank);
+
+    void setInputOptions(const InputOptions & options);
+    void setIndex32(bool index32);
+    void setVarint(bool varint);
+    void setValuesOnly(bool valuesOnly);
+
+    bool convert(const std::string & inputPath, const std::string & outputPath);
+
+private:
+
+    bool convertMatrix(InputKind kind, const std::string & inputPath, const std::string & outputPath);
+    bool convertVector(const std::string & inputPath, const std::string & outputPath);
+    bool verifyMatrix(const std::string & outputPath, uint64_t checksum);
+    bool verifyVector(const std::string & outputPath, long nRows, uint64_t checksum);
+    void report(const std::string & inputPath, const std::string & outputPath, double readTime, double writeTime, double readBackTime);
+
+    int m_nProcessors;                                  /**<number of MPI processes*/
+    int m_rank;                                         /**<MPI rank of the process*/
+
+    InputOptions m_inputOptions;                        /**<input settings of the readers*/
+    bool m_index32;                                     /**<true to store the column indices as 32-bit integers*/
+    bool m_varint;                                      /**<true to store the column indices delta encoded as variable length integers*/
+    bool m_valuesOnly;                                  /**<true to write only the values array of the matrix*/
+
+};
+
+#endif
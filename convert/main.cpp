@@ -0,0 +1,146 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#if ENABLE_MPI==1
+#    include <mpi.h>
+#endif
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <bitpit_IO.hpp>
+
+#include "converter.hpp"
+
+using namespace bitpit;
+
+namespace {
+
+/*!
+ * It prints the command line usage
+ */
+void printUsage()
+{
+    log::cout() << "Usage: madlinsolv-convert [options] input output" << std::endl;
+    log::cout() << "  input                 ASCII CSR or Matrix Market matrix, ASCII right-hand side or initial solution (possibly gzip compressed)" << std::endl;
+    log::cout() << "  output                binary container, read by the solver without parsing" << std::endl;
+    log::cout() << "Options:" << std::endl;
+    log::cout() << "  --index32             store the matrix column indices as 32-bit integers" << std::endl;
+    log::cout() << "  --varint              store the matrix column indices delta encoded as variable length integers" << std::endl;
+    log::cout() << "  --values              write only the matrix values, to be read with the pattern of a previous matrix" << std::endl;
+    log::cout() << "  --mode MODE           input mode: stream, mpiio, scatter or nodescatter (default stream)" << std::endl;
+    log::cout() << "  --threads N           parsing threads per process, 0 for all the cores (default 1)" << std::endl;
+    log::cout() << "  --chunk MB            size of the scattered chunks in the scatter modes (default 16)" << std::endl;
+}
+
+}
+
+/*
+ * Main of the offline converter
+ */
+int main(int argc, char *argv[])
+{
+    // Initialize parallel
+    int nProcessors;
+    int rank;
+
+#if ENABLE_MPI==1
+    MPI_Init(&argc, &argv);
+
+    MPI_Comm_size(MPI_COMM_WORLD, &nProcessors);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#else
+    nProcessors = 1;
+    rank = 0;
+#endif
+
+    // Initialize logger
+    log::manager().initialize(log::COMBINED, "MadLinSolvConvert", true, ".", nProcessors, rank);
+#if ENABLE_DEBUG==1
+    log::cout().setVisibility(log::GLOBAL);
+#endif
+
+    //
+    // Command line
+    //
+    InputOptions inputOptions;
+    bool index32 = false;
+    bool varint = false;
+    bool valuesOnly = false;
+    bool isValid = true;
+    std::vector<std::string> paths;
+    for(int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if(arg == "--index32") {
+            index32 = true;
+        } else if(arg == "--varint") {
+            varint = true;
+        } else if(arg == "--values") {
+            valuesOnly = true;
+        } else if(arg == "--mode" && i + 1 < argc) {
+            inputOptions.mode = InputOptions::parseReadMode(argv[++i]);
+        } else if(arg == "--threads" && i + 1 < argc) {
+            inputOptions.nThreads = InputOptions::resolveThreadCount(std::atoi(argv[++i]));
+        } else if(arg == "--chunk" && i + 1 < argc) {
+            inputOptions.chunkSize = InputOptions::resolveChunkSize(std::atoi(argv[++i]));
+        } else if(arg.substr(0, 2) == "--") {
+            log::cout() << "Unknown option " << arg << std::endl;
+            isValid = false;
+        } else {
+            paths.push_back(arg);
+        }
+    }
+    if(index32 && varint) {
+        log::cout() << "Options --index32 and --varint are exclusive" << std::endl;
+        isValid = false;
+    }
+    if(paths.size() != 2) {
+        isValid = false;
+    }
+
+    //
+    // Execution
+    //
+    bool isConverted = false;
+    if(isValid) {
+        Converter converter(nProcessors, rank);
+        converter.setInputOptions(inputOptions);
+        converter.setIndex32(index32);
+        converter.setVarint(varint);
+        converter.setValuesOnly(valuesOnly);
+        isConverted = converter.convert(paths[0], paths[1]);
+    } else {
+        printUsage();
+    }
+
+    //
+    // Finalization
+    //
+
+#if ENABLE_MPI==1
+    // MPI finalization
+    MPI_Finalize();
+#endif
+
+    return isConverted ? 0 : 1;
+}
@@ -0,0 +1,524 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fstream>
+
+#include "binaryFormat.hpp"
+
+namespace {
+
+/*!
+ * It rounds an offset up to the next multiple of the array alignment
+ * \param[in] offset the offset
+ * \return the aligned offset
+ */
+uint64_t alignOffset(uint64_t offset)
+{
+    return (offset + CSRBinaryFormat::ALIGNMENT - 1) / CSRBinaryFormat::ALIGNMENT * CSRBinaryFormat::ALIGNMENT;
+}
+
+/*!
+ * It checks if an array starting at the given offset is contained in a file, without overflowing the size arithmetic
+ * \param[in] offset offset in bytes of the array
+ * \param[in] count number of elements of the array, non-negative
+ * \param[in] elementSize size in bytes of the elements
+ * \param[in] fileSize size in bytes of the file
+ * \return true if the array ends before the end of the file
+ */
+bool fitsInFile(uint64_t offset, int64_t count, uint64_t elementSize, std::size_t fileSize)
+{
+    if(offset > fileSize) {
+        return false;
+    }
+
+    return static_cast<uint64_t>(count) <= (fileSize - offset) / elementSize;
+}
+
+/*!
+ * It checks if a file starts with the given signature
+ * \param[in] path path of the file to be checked
+ * \param[in] magic the signature
+ * \return true if the file starts with the signature
+ */
+bool hasFileMagic(const std::string & path, const char (&magic)[8])
+{
+    char buffer[sizeof(magic)];
+    std::ifstream file(path.c_str(), std::ifstream::in | std::ifstream::binary);
+    if(!file.read(buffer, sizeof(magic))) {
+        return false;
+    }
+
+    return (std::memcmp(buffer, magic, sizeof(magic)) == 0);
+}
+
+}
+
+const char CSRBinaryFormat::MAGIC[8] = {'M', 'L', 'S', 'C', 'S', 'R', '\0', '\1'};
+const uint32_t CSRBinaryFormat::VERSION = 1;
+const uint64_t CSRBinaryFormat::ALIGNMENT = 64;
+const uint64_t CSRBinaryFormat::FLAG_INDEX32 = 1;
+const uint64_t CSRBinaryFormat::FLAG_VARINT = 2;
+
+const char VectorBinaryFormat::MAGIC[8] = {'M', 'L', 'S', 'V', 'E', 'C', '\0', '\1'};
+const uint32_t VectorBinaryFormat::VERSION = 1;
+
+const char SharedSegmentFormat::MAGIC[8] = {'M', 'L', 'S', 'S', 'H', 'M', '\0', '\1'};
+const uint32_t SharedSegmentFormat::VERSION = 1;
+
+/*!
+ * It checks if the file at the given path starts with the binary CSR signature
+ * \param[in] path path of the file to be checked
+ * \return true if the file is a binary CSR container
+ */
+bool CSRBinaryFormat::hasMagic(const std::string & path)
+{
+    return hasFileMagic(path, MAGIC);
+}
+
+/*!
+ * It checks if the given bytes start with the binary CSR signature
+ * \param[in] data pointer to the first byte
+ * \param[in] size number of available bytes
+ * \return true if the bytes start with the binary CSR signature
+ */
+bool CSRBinaryFormat::hasMagic(const char *data, std::size_t size)
+{
+    if(size < sizeof(MAGIC)) {
+        return false;
+    }
+
+    return (std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0);
+}
+
+/*!
+ * It builds the header of a binary CSR container, computing the offsets of the arrays
+ * \param[in] nRows global number of rows
+ * \param[in] nCols global number of columns
+ * \param[in] nNz global number of non-zeros
+ * \param[in] flags layout flags (FLAG_INDEX32 or FLAG_VARINT), zero for the plain layout
+ * \param[in] varintSize size in bytes of the encoded column stream, used with FLAG_VARINT only
+ * \return the header to be written at the beginning of the file
+ */
+CSRBinaryHeader CSRBinaryFormat::buildHeader(int64_t nRows, int64_t nCols, int64_t nNz, uint64_t flags, uint64_t varintSize)
+{
+    CSRBinaryHeader header;
+    std::memset(&header, 0, sizeof(header));
+
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version    = VERSION;
+    header.headerSize = sizeof(CSRBinaryHeader);
+    header.flags      = flags;
+    header.nRows      = nRows;
+    header.nCols      = nCols;
+    header.nNz        = nNz;
+
+    uint64_t colIdxSize = nNz * sizeof(int64_t);
+    if(flags & FLAG_VARINT) {
+        colIdxSize = (nRows + 1) * sizeof(int64_t) + varintSize;
+    } else if(flags & FLAG_INDEX32) {
+        colIdxSize = nNz * sizeof(int32_t);
+    }
+
+    header.rowPtrOffset = alignOffset(sizeof(CSRBinaryHeader));
+    header.colIdxOffset = alignOffset(header.rowPtrOffset + (nRows + 1) * sizeof(int64_t));
+    header.valuesOffset = alignOffset(header.colIdxOffset + colIdxSize);
+
+    return header;
+}
+
+/*!
+ * It checks the consistency of a binary CSR header against the size of the file
+ * \param[in] header the header read from the file
+ * \param[in] fileSize size in bytes of the file
+ * \param[out] error if not null, it is filled with the reason of the failure
+ * \return true if the header describes arrays contained in the file
+ */
+bool CSRBinaryFormat::checkHeader(const CSRBinaryHeader & header, std::size_t fileSize, std::string * error)
+{
+    std::string reason;
+    if(std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        reason = "wrong signature";
+    } else if(header.version != VERSION) {
+        reason = "unsupported version " + std::to_string(header.version);
+    } else if(header.headerSize < sizeof(CSRBinaryHeader)) {
+        reason = "truncated header";
+    } else if((header.flags & ~(FLAG_INDEX32 | FLAG_VARINT)) != 0 || header.flags == (FLAG_INDEX32 | FLAG_VARINT)) {
+        reason = "unsupported layout flags";
+    } else if(header.nRows < 0 || header.nCols < 0 || header.nNz < 0) {
+        reason = "negative sizes";
+    } else if(header.nRows > INT_MAX || header.nCols > INT_MAX || header.nNz > INT_MAX) {
+        reason = "sizes exceed the int range";
+    } else if(header.rowPtrOffset % sizeof(int64_t) != 0 || header.colIdxOffset % sizeof(int64_t) != 0
+            || header.valuesOffset % sizeof(double) != 0) {
+        reason = "misaligned arrays";
+    } else if(!fitsInFile(header.rowPtrOffset, header.nRows + 1, sizeof(int64_t), fileSize)
+            || !fitsInFile(header.valuesOffset, header.nNz, sizeof(double), fileSize)) {
+        reason = "arrays exceed the file size";
+    } else if(header.flags & FLAG_VARINT) {
+        //The encoded stream lies between the byte positions of the rows and the values
+        if(!fitsInFile(header.colIdxOffset, header.nRows + 1, sizeof(int64_t), header.valuesOffset)) {
+            reason = "arrays exceed the file size";
+        }
+    } else if(!fitsInFile(header.colIdxOffset, header.nNz, (header.flags & FLAG_INDEX32) ? sizeof(int32_t) : sizeof(int64_t), fileSize)) {
+        reason = "arrays exceed the file size";
+    }
+
+    if(error != nullptr) {
+        *error = reason;
+    }
+
+    return reason.empty();
+}
+
+/*!
+ * It appends the encoded column indices of a row to the stream of the FLAG_VARINT layout
+ * \param[in] row global index of the row
+ * \param[in] nRowNz number of non-zeros of the row
+ * \param[in] cols global column indices of the row
+ * \param[in,out] stream the encoded stream
+ */
+void CSRBinaryFormat::encodeRow(long row, long nRowNz, const long * cols, std::vector<unsigned char> & stream)
+{
+    long previous = row;
+    for(long k = 0; k < nRowNz; ++k) {
+        int64_t delta = static_cast<int64_t>(cols[k]) - static_cast<int64_t>(previous);
+        uint64_t zigzag = (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+        while(zigzag >= 0x80) {
+            stream.push_back(static_cast<unsigned char>(zigzag | 0x80));
+            zigzag >>= 7;
+        }
+        stream.push_back(static_cast<unsigned char>(zigzag));
+        previous = cols[k];
+    }
+}
+
+/*!
+ * It decodes the column indices of a row from the stream of the FLAG_VARINT layout
+ * \param[in] row global index of the row
+ * \param[in] nRowNz number of non-zeros of the row
+ * \param[in] data the encoded bytes of the row
+ * \param[in] end the byte following the last encoded byte of the row
+ * \param[out] cols the decoded global column indices, nRowNz elements
+ * \return the byte following the encoded row, null if the row is not contained in [data, end)
+ */
+const unsigned char * CSRBinaryFormat::decodeRow(long row, long nRowNz, const unsigned char * data, const unsigned char * end, long * cols)
+{
+    long previous = row;
+    for(long k = 0; k < nRowNz; ++k) {
+        uint64_t zigzag = 0;
+        int shift = 0;
+        unsigned char byte;
+        do {
+            if(data == end || shift > 63) {
+                return nullptr;
+            }
+            byte = *data++;
+            zigzag |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            shift += 7;
+        } while(byte & 0x80);
+        int64_t delta = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+        cols[k] = static_cast<long>(previous + delta);
+        previous = cols[k];
+    }
+
+    return data;
+}
+
+/*!
+ * It checks the row pointers of a range of rows of a binary CSR container before they are used to address its arrays.
+ * The row pointers must be non-decreasing and within [0, nNz], the first one must be zero and the last one nNz;
+ * with the FLAG_VARINT layout the byte positions of the rows must be non-decreasing and within the encoded stream.
+ * The header must have been validated by checkHeader.
+ * \param[in] header the header of the file
+ * \param[in] fileData pointer to the first byte of the file
+ * \param[in] startRow first global row of the range
+ * \param[in] nRows number of rows of the range
+ * \param[out] error if not null, it is filled with the reason of the failure
+ * \return true if the row pointers of the range are consistent
+ */
+bool CSRBinaryFormat::checkRows(const CSRBinaryHeader & header, const char * fileData, long startRow, long nRows, std::string * error)
+{
+    const int64_t *rowPtr = reinterpret_cast<const int64_t *>(fileData + header.rowPtrOffset);
+    const int64_t *bytePtr = reinterpret_cast<const int64_t *>(fileData + header.colIdxOffset);
+    int64_t streamSize = static_cast<int64_t>(header.valuesOffset - header.colIdxOffset) - (header.nRows + 1) * static_cast<int64_t>(sizeof(int64_t));
+
+    std::string reason;
+    if((startRow == 0 && rowPtr[0] != 0) || (startRow + nRows == header.nRows && rowPtr[header.nRows] != header.nNz)) {
+        reason = "row pointers do not start at zero and end at nNz";
+    } else if(rowPtr[startRow] < 0 || rowPtr[startRow + nRows] > header.nNz) {
+        reason = "row pointers exceed the non-zeros of row " + std::to_string(startRow);
+    }
+    for(long row = startRow; row < startRow + nRows && reason.empty(); ++row) {
+        if(rowPtr[row + 1] < rowPtr[row]) {
+            reason = "decreasing row pointers at row " + std::to_string(row);
+        } else if((header.flags & FLAG_VARINT) && (bytePtr[row] < 0 || bytePtr[row + 1] < bytePtr[row] || bytePtr[row + 1] > streamSize)) {
+            reason = "encoded column indices out of the stream at row " + std::to_string(row);
+        }
+    }
+
+    if(error != nullptr) {
+        *error = reason;
+    }
+
+    return reason.empty();
+}
+
+/*!
+ * It decodes the column indices of a range of rows stored with the FLAG_INDEX32 or FLAG_VARINT layout.
+ * The row pointers of the range must have been validated by checkRows.
+ * \param[in] header the header of the file
+ * \param[in] fileData pointer to the first byte of the file
+ * \param[in] startRow first global row of the range
+ * \param[in] nRows number of rows of the range
+ * \param[out] colIdx the global column indices of the non-zeros of the range
+ * \return false if the encoded columns of a row overflow its bytes
+ */
+bool CSRBinaryFormat::decodeColumns(const CSRBinaryHeader & header, const char * fileData, long startRow, long nRows, std::vector<long> & colIdx)
+{
+    const int64_t *rowPtr = reinterpret_cast<const int64_t *>(fileData + header.rowPtrOffset);
+    int64_t nzBegin = rowPtr[startRow];
+    colIdx.resize(rowPtr[startRow + nRows] - nzBegin);
+
+    if(header.flags & FLAG_VARINT) {
+        const int64_t *bytePtr = reinterpret_cast<const int64_t *>(fileData + header.colIdxOffset);
+        const unsigned char *stream = reinterpret_cast<const unsigned char *>(fileData + header.colIdxOffset + (header.nRows + 1) * sizeof(int64_t));
+        for(long row = startRow; row < startRow + nRows; ++row) {
+            if(!decodeRow(row, rowPtr[row + 1] - rowPtr[row], stream + bytePtr[row], stream + bytePtr[row + 1], colIdx.data() + (rowPtr[row] - nzBegin))) {
+                return false;
+            }
+        }
+    } else {
+        const int32_t *cols = reinterpret_cast<const int32_t *>(fileData + header.colIdxOffset) + nzBegin;
+        std::copy(cols, cols + colIdx.size(), colIdx.begin());
+    }
+
+    return true;
+}
+
+/*!
+ * It checks if the file at the given path starts with the binary vector signature
+ * \param[in] path path of the file to be checked
+ * \return true if the file is a binary vector container
+ */
+bool VectorBinaryFormat::hasMagic(const std::string & path)
+{
+    return hasFileMagic(path, MAGIC);
+}
+
+/*!
+ * It checks if the given bytes start with the binary vector signature
+ * \param[in] data pointer to the first byte
+ * \param[in] size number of available bytes
+ * \return true if the bytes start with the binary vector signature
+ */
+bool VectorBinaryFormat::hasMagic(const char *data, std::size_t size)
+{
+    if(size < sizeof(MAGIC)) {
+        return false;
+    }
+
+    return (std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0);
+}
+
+/*!
+ * It builds the header of a binary vector container, computing the offset of the values
+ * \param[in] nRows global number of rows
+ * \param[in] nColumns number of vectors (columns)
+ * \return the header to be written at the beginning of the file
+ */
+VectorBinaryHeader VectorBinaryFormat::buildHeader(int64_t nRows, int64_t nColumns)
+{
+    VectorBinaryHeader header;
+    std::memset(&header, 0, sizeof(header));
+
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version      = VERSION;
+    header.headerSize   = sizeof(VectorBinaryHeader);
+    header.flags        = 0;
+    header.nRows        = nRows;
+    header.valuesOffset = alignOffset(sizeof(VectorBinaryHeader));
+    header.nColumns     = nColumns;
+
+    return header;
+}
+
+/*!
+ * It checks the consistency of a binary vector header against the size of the file
+ * \param[in] header the header read from the file
+ * \param[in] fileSize size in bytes of the file
+ * \param[out] error if not null, it is filled with the reason of the failure
+ * \return true if the header describes values contained in the file
+ */
+bool VectorBinaryFormat::checkHeader(const VectorBinaryHeader & header, std::size_t fileSize, std::string * error)
+{
+    std::string reason;
+    if(std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        reason = "wrong signature";
+    } else if(header.version != VERSION) {
+        reason = "unsupported version " + std::to_string(header.version);
+    } else if(header.headerSize < offsetof(VectorBinaryHeader, nColumns)) {
+        reason = "truncated header";
+    } else if(header.flags != 0) {
+        reason = "unsupported layout flags";
+    } else if(header.nRows < 0 || getColumnCount(header) < 1) {
+        reason = "negative sizes";
+    } else if(header.valuesOffset % sizeof(double) != 0) {
+        reason = "misaligned arrays";
+    } else if(header.valuesOffset + getColumnCount(header) * header.nRows * sizeof(double) > fileSize) {
+        reason = "arrays exceed the file size";
+    }
+
+    if(error != nullptr) {
+        *error = reason;
+    }
+
+    return reason.empty();
+}
+
+/*!
+ * It gets the number of vectors (columns) stored in a binary vector container
+ * \param[in] header the header read from the file
+ * \return the number of columns, one for headers written before the field was introduced
+ */
+int64_t VectorBinaryFormat::getColumnCount(const VectorBinaryHeader & header)
+{
+    if(header.headerSize < sizeof(VectorBinaryHeader)) {
+        return 1;
+    }
+
+    return header.nColumns;
+}
+
+/*!
+ * It builds the header of a shared-memory segment, placing the parts one after the other
+ * \param[in] nRows global number of rows of the matrix and of the vectors
+ * \param[in] nCols global number of columns of the matrix
+ * \param[in] nNz global number of non-zeros of the matrix, no matrix is placed if nNz and nCols are zero
+ * \param[in] nRhsColumns number of right-hand sides, zero for none
+ * \param[in] hasSolution true to place an initial solution
+ * \return the header, in EMPTY state
+ */
+SharedSegmentHeader SharedSegmentFormat::buildHeader(int64_t nRows, int64_t nCols, int64_t nNz, int64_t nRhsColumns, bool hasSolution)
+{
+    SharedSegmentHeader header;
+    std::memset(&header, 0, sizeof(header));
+
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version    = VERSION;
+    header.headerSize = sizeof(SharedSegmentHeader);
+    header.state      = static_cast<uint32_t>(State::EMPTY);
+
+    uint64_t offset = alignOffset(sizeof(SharedSegmentHeader));
+    if(nCols > 0 || nNz > 0) {
+        header.matrixOffset = offset;
+        header.matrixSize = CSRBinaryFormat::buildHeader(nRows, nCols, nNz).valuesOffset + nNz * sizeof(double);
+        offset = alignOffset(offset + header.matrixSize);
+    }
+    if(nRhsColumns > 0) {
+        header.rhsOffset = offset;
+        header.rhsSize = VectorBinaryFormat::buildHeader(nRows, nRhsColumns).valuesOffset + nRhsColumns * nRows * sizeof(double);
+        offset = alignOffset(offset + header.rhsSize);
+    }
+    if(hasSolution) {
+        header.solutionOffset = offset;
+        header.solutionSize = VectorBinaryFormat::buildHeader(nRows).valuesOffset + nRows * sizeof(double);
+    }
+
+    return header;
+}
+
+/*!
+ * It checks the consistency of a shared-memory segment header against the size of the segment.
+ * The embedded containers are checked by their readers.
+ * \param[in] header the header read from the segment
+ * \param[in] segmentSize size in bytes of the segment
+ * \param[out] error if not null, it is filled with the reason of the failure
+ * \return true if the header describes parts contained in the segment
+ */
+bool SharedSegmentFormat::checkHeader(const SharedSegmentHeader & header, std::size_t segmentSize, std::string * error)
+{
+    std::string reason;
+    if(std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        reason = "wrong signature";
+    } else if(header.version != VERSION) {
+        reason = "unsupported version " + std::to_string(header.version);
+    } else if(header.headerSize < sizeof(SharedSegmentHeader)) {
+        reason = "truncated header";
+    } else if(header.matrixOffset % CSRBinaryFormat::ALIGNMENT != 0 || header.rhsOffset % CSRBinaryFormat::ALIGNMENT != 0
+            || header.solutionOffset % CSRBinaryFormat::ALIGNMENT != 0) {
+        reason = "misaligned parts";
+    } else if(getSegmentSize(header) > segmentSize) {
+        reason = "parts exceed the segment size";
+    }
+
+    if(error != nullptr) {
+        *error = reason;
+    }
+
+    return reason.empty();
+}
+
+/*!
+ * It gets the size a segment needs to hold the parts of a header
+ * \param[in] header the segment header
+ * \return the size in bytes, at least the size of the header
+ */
+uint64_t SharedSegmentFormat::getSegmentSize(const SharedSegmentHeader & header)
+{
+    uint64_t size = sizeof(SharedSegmentHeader);
+    if(header.matrixOffset != 0) {
+        size = std::max(size, header.matrixOffset + header.matrixSize);
+    }
+    if(header.rhsOffset != 0) {
+        size = std::max(size, header.rhsOffset + header.rhsSize);
+    }
+    if(header.solutionOffset != 0) {
+        size = std::max(size, header.solutionOffset + header.solutionSize);
+    }
+
+    return size;
+}
+
+/*!
+ * It loads the handshake state of a segment with acquire semantics,
+ * so that the parts written by the other side before storing it are visible
+ * \param[in] header the header in the shared segment
+ * \return the state
+ */
+SharedSegmentFormat::State SharedSegmentFormat::loadState(const SharedSegmentHeader * header)
+{
+    return static_cast<State>(__atomic_load_n(&header->state, __ATOMIC_ACQUIRE));
+}
+
+/*!
+ * It stores the handshake state of a segment with release semantics,
+ * so that the parts written before are visible to the other side once it loads the state
+ * \param[in] header the header in the shared segment
+ * \param[in] state the new state
+ */
+void SharedSegmentFormat::storeState(SharedSegmentHeader * header, State state)
+{
+    __atomic_store_n(&header->state, static_cast<uint32_t>(state), __ATOMIC_RELEASE);
+}
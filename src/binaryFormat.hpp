@@ -0,0 +1,222 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_BINARYFORMAT_HPP__
+#define __MADLINSOLV_BINARYFORMAT_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*!
+ *  \brief Header of the binary CSR matrix container
+ *
+ *  All the fields are stored in the native byte order of the machine which wrote the file.
+ *  Offsets are in bytes from the beginning of the file.
+ */
+struct CSRBinaryHeader {
+    char     magic[8];                                  /**<file signature, see CSRBinaryFormat::MAGIC*/
+    uint32_t version;                                   /**<container version*/
+    uint32_t headerSize;                                /**<size in bytes of this header*/
+    uint64_t flags;                                     /**<layout flags, zero for the plain layout, see CSRBinaryFormat*/
+    int64_t  nRows;                                     /**<global number of rows*/
+    int64_t  nCols;                                     /**<global number of columns*/
+    int64_t  nNz;                                       /**<global number of non-zeros*/
+    uint64_t rowPtrOffset;                              /**<offset of the row pointer array*/
+    uint64_t colIdxOffset;                              /**<offset of the column indices array*/
+    uint64_t valuesOffset;                              /**<offset of the values array*/
+};
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The binary CSR matrix container description
+ *
+ *  This class collects the layout of the binary Compressed Sparse Rows container
+ *  and the helpers to recognize, validate, write and decode it.
+ *  The arrays are stored one after the other, each one starting at a multiple of ALIGNMENT bytes,
+ *  so each process can address its own rows and the matching non-zeros by offset, without parsing the rest of the file:
+ *
+ *  \verbatim
+ *                                   binary CSR file format
+ *            -----------------------------------------------------------------------------
+ *  header    | CSRBinaryHeader (magic, version, sizes and array offsets)                 |
+ *  row_ptr   | int64[nRows+1], row_ptr[i] is the global position of the first row i     |
+ *            | non-zero, row_ptr[0] = 0 and row_ptr[nRows] = nNz                         |
+ *  col_idx   | int64[nNz], global column indices of the non-zeros, row after row         |
+ *  values    | double[nNz], values of the non-zeros, row after row                       |
+ *            -----------------------------------------------------------------------------
+ *  \endverbatim
+ *
+ *  The layout flags change the column indices array only:
+ *  - FLAG_INDEX32: int32[nNz] column indices, for matrices with less than 2^31 columns;
+ *  - FLAG_VARINT: int64[nRows+1] byte position of each row in the encoded stream, followed by the stream.
+ *    The first column of row i is stored as col-i, the others as the difference with the previous column,
+ *    all zigzag mapped and written as LEB128 variable length integers, so banded rows take one or two bytes per non-zero.
+ */
+class CSRBinaryFormat {
+
+public:
+
+    static const char MAGIC[8];
+    static const uint32_t VERSION;
+    static const uint64_t ALIGNMENT;
+    static const uint64_t FLAG_INDEX32;
+    static const uint64_t FLAG_VARINT;
+
+    static bool hasMagic(const std::string & path);
+    static bool hasMagic(const char *data, std::size_t size);
+
+    static CSRBinaryHeader buildHeader(int64_t nRows, int64_t nCols, int64_t nNz, uint64_t flags = 0, uint64_t varintSize = 0);
+    static bool checkHeader(const CSRBinaryHeader & header, std::size_t fileSize, std::string * error = nullptr);
+
+    static void encodeRow(long row, long nRowNz, const long * cols, std::vector<unsigned char> & stream);
+    static const unsigned char * decodeRow(long row, long nRowNz, const unsigned char * data, const unsigned char * end, long * cols);
+    static bool checkRows(const CSRBinaryHeader & header, const char * fileData, long startRow, long nRows, std::string * error = nullptr);
+    static bool decodeColumns(const CSRBinaryHeader & header, const char * fileData, long startRow, long nRows, std::vector<long> & colIdx);
+
+};
+
+/*!
+ *  \brief Header of the binary vector container
+ *
+ *  All the fields are stored in the native byte order of the machine which wrote the file.
+ *  Offsets are in bytes from the beginning of the file.
+ */
+struct VectorBinaryHeader {
+    char     magic[8];                                  /**<file signature, see VectorBinaryFormat::MAGIC*/
+    uint32_t version;                                   /**<container version*/
+    uint32_t headerSize;                                /**<size in bytes of this header*/
+    uint64_t flags;                                     /**<layout flags, zero for the plain layout*/
+    int64_t  nRows;                                     /**<global number of rows*/
+    uint64_t valuesOffset;                              /**<offset of the values array*/
+    int64_t  nColumns;                                  /**<number of vectors (columns), absent in headers shorter than this structure*/
+};
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The binary vector container description
+ *
+ *  This class collects the layout of the binary container of the right-hand side and of the initial solution
+ *  and the helpers to recognize and validate it. Each process copies its own slice of values without any parsing:
+ *
+ *  \verbatim
+ *                                  binary vector file format
+ *            -----------------------------------------------------------------------------
+ *  header    | VectorBinaryHeader (magic, version, sizes and array offset)               |
+ *  values    | double[nColumns*nRows], values column after column, starting at a         |
+ *            | multiple of ALIGNMENT                                                     |
+ *            -----------------------------------------------------------------------------
+ *  \endverbatim
+ *
+ *  Each column is contiguous, so each process copies its slice of every column with one copy per column.
+ *  Headers written before the number of columns was introduced are shorter and hold one column.
+ */
+class VectorBinaryFormat {
+
+public:
+
+    static const char MAGIC[8];
+    static const uint32_t VERSION;
+
+    static bool hasMagic(const std::string & path);
+    static bool hasMagic(const char *data, std::size_t size);
+
+    static VectorBinaryHeader buildHeader(int64_t nRows, int64_t nColumns = 1);
+    static bool checkHeader(const VectorBinaryHeader & header, std::size_t fileSize, std::string * error = nullptr);
+    static int64_t getColumnCount(const VectorBinaryHeader & header);
+
+};
+
+/*!
+ *  \brief Header of the shared-memory input segment
+ *
+ *  All the fields are stored in the native byte order of the machine, producer and consumer being on the same node.
+ *  Offsets are in bytes from the beginning of the segment.
+ */
+struct SharedSegmentHeader {
+    char     magic[8];                                  /**<segment signature, see SharedSegmentFormat::MAGIC*/
+    uint32_t version;                                   /**<segment version*/
+    uint32_t headerSize;                                /**<size in bytes of this header*/
+    uint32_t state;                                     /**<handshake state, see SharedSegmentFormat::State, accessed atomically*/
+    uint32_t reserved;                                  /**<padding, zero*/
+    uint64_t sequence;                                  /**<number of the inputs published, incremented by the producer at every publication*/
+    uint64_t matrixOffset;                              /**<offset of the binary CSR container of the matrix, zero if absent*/
+    uint64_t matrixSize;                                /**<size in bytes of the binary CSR container*/
+    uint64_t rhsOffset;                                 /**<offset of the binary vector container of the right-hand sides, zero if absent*/
+    uint64_t rhsSize;                                   /**<size in bytes of the right-hand sides container*/
+    uint64_t solutionOffset;                            /**<offset of the binary vector container of the initial solution, zero if absent*/
+    uint64_t solutionSize;                              /**<size in bytes of the initial solution container*/
+};
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The shared-memory input segment description
+ *
+ *  This class collects the layout of the POSIX shared-memory segment through which a producer process running on the
+ *  same node hands the inputs over, and the helpers to build, validate and synchronize it.
+ *  The segment embeds the binary containers of the files, each one starting at a multiple of CSRBinaryFormat::ALIGNMENT
+ *  bytes with its own offsets relative to its beginning, so that the readers use the arrays in place:
+ *
+ *  \verbatim
+ *                                 shared-memory segment layout
+ *            -----------------------------------------------------------------------------
+ *  header    | SharedSegmentHeader (magic, version, state, sequence and part offsets)    |
+ *  matrix    | binary CSR container, plain layout (optional)                             |
+ *  rhs       | binary vector container, one or more columns (optional)                   |
+ *  solution  | binary vector container, one column (optional)                            |
+ *            -----------------------------------------------------------------------------
+ *  \endverbatim
+ *
+ *  The handshake goes through the state field: the producer fills the parts while the state is EMPTY or CONSUMED,
+ *  increments the sequence and stores READY; the consumer waits for READY, reads the parts and stores CONSUMED,
+ *  after which the producer may fill the segment again. States are stored with release and loaded with acquire semantics.
+ */
+class SharedSegmentFormat {
+
+public:
+
+    /*!
+     * Handshake states of the segment
+     */
+    enum class State : uint32_t {
+        EMPTY = 0,                                      /**<the producer is filling the segment*/
+        READY = 1,                                      /**<the inputs are published, the consumer may read them*/
+        CONSUMED = 2                                    /**<the consumer has read the inputs, the producer may fill the segment again*/
+    };
+
+    static const char MAGIC[8];
+    static const uint32_t VERSION;
+
+    static SharedSegmentHeader buildHeader(int64_t nRows, int64_t nCols, int64_t nNz, int64_t nRhsColumns, bool hasSolution);
+    static bool checkHeader(const SharedSegmentHeader & header, std::size_t segmentSize, std::string * error = nullptr);
+    static uint64_t getSegmentSize(const SharedSegmentHeader & header);
+
+    static State loadState(const SharedSegmentHeader * header);
+    static void storeState(SharedSegmentHeader * header, State state);
+
+};
+
+#endif
@@ -0,0 +1,181 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#if ENABLE_MPI==1
+#    include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+#include <bitpit_IO.hpp>
+
+#include "collectiveReader.hpp"
+
+using namespace bitpit;
+
+namespace {
+
+//MPI-IO counts are int, larger ranges are read in several collective calls
+const uint64_t MAX_CHUNK_SIZE = 1 << 30;
+
+}
+
+/*!
+ * Constructor
+ * Nothing is read until readRange or readLines is called.
+ * \param[in] path path of the file
+ */
+CollectiveReader::CollectiveReader(const std::string & path) :
+        m_path(path), m_buffer(), m_streamBuffer(), m_elapsed(0.)
+{
+
+}
+
+/*!
+ * It loads in memory the given byte range of the file. The range is clipped to the file size.
+ * This method is collective.
+ * \param[in] offset first byte of the range
+ * \param[in] length number of bytes of the range
+ * \return true if the file has been opened and read by all the processes
+ */
+bool CollectiveReader::readRange(uint64_t offset, uint64_t length)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    bool success = true;
+
+#if ENABLE_MPI==1
+    MPI_Info info;
+    MPI_Info_create(&info);
+    MPI_Info_set(info, const_cast<char *>("romio_cb_read"), const_cast<char *>("enable"));
+
+    MPI_File fileHandle;
+    int error = MPI_File_open(MPI_COMM_WORLD, const_cast<char *>(m_path.c_str()), MPI_MODE_RDONLY, info, &fileHandle);
+    MPI_Info_free(&info);
+    if(error != MPI_SUCCESS) {
+        m_buffer.clear();
+        m_streamBuffer.reset(nullptr, 0, offset);
+        return false;
+    }
+
+    MPI_Offset fileSize;
+    MPI_File_get_size(fileHandle, &fileSize);
+    offset = std::min<uint64_t>(offset, fileSize);
+    length = std::min<uint64_t>(length, fileSize - offset);
+    m_buffer.resize(length);
+
+    //All the processes must take part in the same number of collective reads
+    uint64_t nChunks = (length + MAX_CHUNK_SIZE - 1) / MAX_CHUNK_SIZE;
+    uint64_t maxChunks;
+    MPI_Allreduce(&nChunks, &maxChunks, 1, MPI_UINT64_T, MPI_MAX, MPI_COMM_WORLD);
+    for(uint64_t chunk = 0; chunk < maxChunks; ++chunk) {
+        uint64_t chunkOffset = std::min(chunk * MAX_CHUNK_SIZE, length);
+        int count = static_cast<int>(std::min(MAX_CHUNK_SIZE, length - chunkOffset));
+        error = MPI_File_read_at_all(fileHandle, static_cast<MPI_Offset>(offset + chunkOffset),
+                m_buffer.data() + chunkOffset, count, MPI_CHAR, MPI_STATUS_IGNORE);
+        success = success && (error == MPI_SUCCESS);
+    }
+
+    MPI_File_close(&fileHandle);
+
+    //A failed read on any process fails the read on all of them, so that they stop together
+    int isRead = success ? 1 : 0;
+    MPI_Allreduce(MPI_IN_PLACE, &isRead, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    success = (isRead == 1);
+#else
+    std::ifstream in(m_path.c_str(), std::ifstream::in | std::ifstream::binary);
+    if(!in.is_open()) {
+        m_buffer.clear();
+        m_streamBuffer.reset(nullptr, 0, offset);
+        return false;
+    }
+
+    in.seekg(0, std::ifstream::end);
+    uint64_t fileSize = static_cast<uint64_t>(in.tellg());
+    offset = std::min<uint64_t>(offset, fileSize);
+    length = std::min<uint64_t>(length, fileSize - offset);
+    m_buffer.resize(length);
+
+    in.seekg(static_cast<std::streamoff>(offset));
+    success = static_cast<bool>(in.read(m_buffer.data(), static_cast<std::streamsize>(length)));
+#endif
+
+    m_streamBuffer.reset(m_buffer.data(), m_buffer.size(), offset);
+    m_elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return success;
+}
+
+/*!
+ * It loads in memory the byte range containing the given body lines.
+ * The range is widened to the closest index entries, so it may start some lines before
+ * the first requested one: seek the stream buffer through the index before parsing.
+ * This method is collective.
+ * \param[in] index the line index of the file body
+ * \param[in] firstLine zero-based number of the first body line
+ * \param[in] nLines number of body lines
+ * \return true if the file has been opened and read by all the processes
+ */
+bool CollectiveReader::readLines(const LineIndex & index, uint64_t firstLine, uint64_t nLines)
+{
+    if(nLines == 0) {
+        return readRange(index.getFloorOffset(firstLine), 0);
+    }
+
+    uint64_t begin = index.getFloorOffset(firstLine);
+    uint64_t end = index.getCeilOffset(firstLine + nLines);
+
+    return readRange(begin, end - begin);
+}
+
+/*!
+ * It gets the stream buffer on the loaded range
+ * \return a reference to the stream buffer, whose positions are file offsets
+ */
+MemoryStreamBuffer & CollectiveReader::getStreamBuffer()
+{
+    return m_streamBuffer;
+}
+
+/*!
+ * It logs the aggregate read bandwidth of the last read, i.e. the total number of bytes
+ * read by all the processes divided by the time of the slowest one.
+ * This method is collective.
+ * \param[in] label name of the file content to be printed in the log
+ */
+void CollectiveReader::logBandwidth(const std::string & label) const
+{
+    double bytes = static_cast<double>(m_buffer.size());
+    double elapsed = m_elapsed;
+#if ENABLE_MPI==1
+    MPI_Allreduce(MPI_IN_PLACE, &bytes, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+#endif
+
+    double megaBytes = bytes / (1024. * 1024.);
+    log::cout() << label << " read: " << megaBytes << " MB in " << elapsed << " s";
+    if(elapsed > 0.) {
+        log::cout() << " (" << megaBytes / elapsed << " MB/s aggregate)";
+    }
+    log::cout() << std::endl;
+}
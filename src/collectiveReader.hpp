@@ -0,0 +1,71 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_COLLECTIVEREADER_HPP__
+#define __MADLINSOLV_COLLECTIVEREADER_HPP__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "lineIndex.hpp"
+#include "memoryStreamBuffer.hpp"
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The collective file reader class
+ *
+ *  This class is intended to
+ *  load in memory the byte range of a file owned by each process with a single collective call.
+ *  In parallel runs the file is opened once by all the processes with MPI_File_open and read with
+ *  MPI_File_read_at_all, with collective buffering enabled, so the MPI-IO layer aggregates the requests
+ *  instead of letting hundreds of independent streams hit the same file.
+ *  In serial runs the range is read with a plain positioned read.
+ *  The loaded range is exposed as a MemoryStreamBuffer, whose positions are file offsets.
+ *  All the methods but the getters are collective: every process must call them, even with an empty range.
+ */
+class CollectiveReader {
+
+public:
+
+    explicit CollectiveReader(const std::string & path);
+
+    bool readRange(uint64_t offset, uint64_t length);
+    bool readLines(const LineIndex & index, uint64_t firstLine, uint64_t nLines);
+
+    MemoryStreamBuffer & getStreamBuffer();
+
+    void logBandwidth(const std::string & label) const;
+
+private:
+
+    std::string m_path;                                 /**<path of the file*/
+
+    std::vector<char> m_buffer;                         /**<bytes of the loaded range*/
+    MemoryStreamBuffer m_streamBuffer;                  /**<stream buffer on the loaded range*/
+
+    double m_elapsed;                                   /**<time spent in the last read [s]*/
+
+};
+
+#endif
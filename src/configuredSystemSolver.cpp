@@ -0,0 +1,141 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#include <cctype>
+#include <sstream>
+
+#include <petscksp.h>
+
+#include <bitpit_IO.hpp>
+
+#include "configuredSystemSolver.hpp"
+
+using namespace bitpit;
+
+/*!
+ * Constructor
+ * The bitpit setup is used until setOptions is called.
+ * \param[in] debug boolean to activate the PETSc debug output
+ */
+ConfiguredSystemSolver::ConfiguredSystemSolver(bool debug) :
+        SystemSolver(debug), m_options(), m_isSetUp(false)
+{
+
+}
+
+/*!
+ * It sets the Krylov method and preconditioner settings, inserting them into the PETSc options database
+ * in place of those of the previous settings.
+ * Before the first solve, the KSP reads them while it is set up. Afterwards, the KSP is set up again at once
+ * and the preconditioner is rebuilt by the next solve, e.g. to try several solvers on the same system (see SolverTuner class).
+ * \param[in] options the settings
+ */
+void ConfiguredSystemSolver::setOptions(const SolverOptions & options)
+{
+    clearPetscOptions();
+    m_options = options;
+
+    std::string petscOptions = m_options.getPetscOptions();
+    if(!petscOptions.empty()) {
+        log::cout() << "PETSc solver options: " << petscOptions << std::endl;
+        PetscOptionsInsertString(NULL, petscOptions.c_str());
+    }
+
+    if(m_isSetUp) {
+        //Switching the type drops the preconditioner built so far, even if the chosen type is the current one
+        PC preconditioner;
+        KSPGetPC(m_KSP, &preconditioner);
+        PCSetType(preconditioner, "none");
+        setupKrylov();
+        setupPreconditioner();
+    }
+}
+
+/*!
+ * It gets the Krylov method and preconditioner settings
+ * \return a constant reference to the settings
+ */
+const SolverOptions & ConfiguredSystemSolver::getOptions() const
+{
+    return m_options;
+}
+
+/*!
+ * It gets the residual norm of the last solve, as computed by the Krylov method
+ * (the preconditioned one for left preconditioned methods)
+ * \return the residual norm, zero before the first solve
+ */
+double ConfiguredSystemSolver::getResidualNorm() const
+{
+    if(!m_isSetUp) {
+        return 0.;
+    }
+
+    PetscReal norm;
+    KSPGetResidualNorm(m_KSP, &norm);
+
+    return norm;
+}
+
+/*!
+ * It sets the preconditioner up. Without options, it is the bitpit setup.
+ * Otherwise, the preconditioner type is set, ASM if not chosen, and the rest is read from the options database.
+ */
+void ConfiguredSystemSolver::setupPreconditioner()
+{
+    if(m_options.isEmpty()) {
+        SystemSolver::setupPreconditioner();
+        return;
+    }
+
+    PC preconditioner;
+    KSPGetPC(m_KSP, &preconditioner);
+    PCSetType(preconditioner, m_options.pcType.empty() ? "asm" : m_options.pcType.c_str());
+    KSPSetFromOptions(m_KSP);
+}
+
+/*!
+ * It sets the Krylov method up: the bitpit setup, then, with options, the options database on top of it.
+ */
+void ConfiguredSystemSolver::setupKrylov()
+{
+    SystemSolver::setupKrylov();
+    m_isSetUp = true;
+
+    if(!m_options.isEmpty()) {
+        KSPSetFromOptions(m_KSP);
+    }
+}
+
+/*!
+ * It removes the entries of the current settings from the PETSc options database
+ */
+void ConfiguredSystemSolver::clearPetscOptions()
+{
+    std::istringstream petscOptions(m_options.getPetscOptions());
+    std::string token;
+    while(petscOptions >> token) {
+        if(token.size() > 1 && token[0] == '-' && std::isalpha(static_cast<unsigned char>(token[1]))) {
+            PetscOptionsClearValue(NULL, token.c_str());
+        }
+    }
+}
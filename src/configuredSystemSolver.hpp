@@ -0,0 +1,71 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_CONFIGUREDSYSTEMSOLVER_HPP__
+#define __MADLINSOLV_CONFIGUREDSYSTEMSOLVER_HPP__
+
+#include <bitpit_LA.hpp>
+
+#include "solverOptions.hpp"
+
+using namespace bitpit;
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The configured system solver class
+ *
+ *  This class is intended to
+ *  solve the linear system with the Krylov method and the preconditioner chosen by the user
+ *  (see SolverOptions structure), instead of the fixed bitpit setup (FGMRES with ASM and ILU sub-domains).
+ *  The options are inserted into the PETSc options database and the KSP reads them while it is set up;
+ *  as long as no option is set, the bitpit setup is left untouched.
+ *  When options are set, the bitpit preconditioner setup, which builds ASM and its ILU factorizations at once,
+ *  is skipped, so that nothing is factorized before the chosen preconditioner is known.
+ *  Options can be changed after a solve as well: the KSP is then set up again with them.
+ *  The residual norm of the last solve is read from the KSP, the bitpit status holding only its error code.
+ */
+class ConfiguredSystemSolver : public SystemSolver {
+
+public:
+
+    ConfiguredSystemSolver(bool debug = false);
+
+    void setOptions(const SolverOptions & options);
+    const SolverOptions & getOptions() const;
+    double getResidualNorm() const;
+
+protected:
+
+    void setupPreconditioner() override;
+    void setupKrylov() override;
+
+private:
+
+    void clearPetscOptions();
+
+    SolverOptions m_options;                            /**<Krylov method and preconditioner settings*/
+    bool m_isSetUp;                                     /**<true once the KSP has been set up*/
+
+};
+
+#endif
@@ -20,6 +20,9 @@
  *
  \*---------------------------------------------------------------------------*/
 
+#include <cstdlib>
+#include <sstream>
+
 #include <libxml/parser.h>
 #include <libxml/tree.h>
 
@@ -69,6 +72,50 @@ void Dictionary::readXML(std::string filename)
                                  content = reinterpret_cast<const char*>(children->children->content);
                                  setDebug(content == "true");
                              }
+                             else if (name == "backend") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setSolverBackend(content);
+                             }
+                             else if (name == "ksp") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setSolverKsp(content);
+                             }
+                             else if (name == "pc") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setSolverPc(content);
+                             }
+                             else if (name == "subpc") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setSolverSubPc(content);
+                             }
+                             else if (name == "levels") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setSolverLevels(std::atoi(content.c_str()));
+                             }
+                             else if (name == "overlap") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setSolverOverlap(std::atoi(content.c_str()));
+                             }
+                             else if (name == "restart") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setSolverRestart(std::atoi(content.c_str()));
+                             }
+                             else if (name == "rtol") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setSolverRtol(std::atof(content.c_str()));
+                             }
+                             else if (name == "atol") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setSolverAtol(std::atof(content.c_str()));
+                             }
+                             else if (name == "maxit") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setSolverMaxIterations(std::atoi(content.c_str()));
+                             }
+                             else if (name == "options") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setSolverOptions(content);
+                             }
                              else {
                                  log::cout() << "No other settings are allowed for Solver!" << std::endl;
                              }
@@ -91,6 +138,14 @@ void Dictionary::readXML(std::string filename)
                                  content = reinterpret_cast<const char*>(children->children->content);
                                  setMatrixApp(content);
                              }
+                             else if (name == "format") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setMatrixFormat(content);
+                             }
+                             else if (name == "shards") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setMatrixShards(content);
+                             }
                              else {
                                  log::cout() << "No other settings are allowed for Matrix!" << std::endl;
                              }
@@ -113,6 +168,10 @@ void Dictionary::readXML(std::string filename)
                                  content = reinterpret_cast<const char*>(children->children->content);
                                  setRhsApp(content);
                              }
+                             else if (name == "shards") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setRhsShards(content);
+                             }
                              else {
                                  log::cout() << "No other settings are allowed for RHS!" << std::endl;
                              }
@@ -139,12 +198,132 @@ void Dictionary::readXML(std::string filename)
                                  content = reinterpret_cast<const char*>(children->children->content);
                                  setInitialSolutionApp(content);
                              }
+                             else if (name == "shards") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setInitialSolutionShards(content);
+                             }
                              else {
                                  log::cout() << "No other settings are allowed for InitialSolution!" << std::endl;
                              }
                          }
                      }
                  }
+                 else if (name == "Solution") {
+                     for (children = cur_node->children; children != NULL; children = children->next) {
+                         if (children->type == XML_ELEMENT_NODE) {
+                             name = reinterpret_cast<const char*>(children->name);
+                             if( name == "on") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setSolutionOn(content == "true");
+                             }
+                             else if(name == "directory") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setSolutionDir(content);
+                             }
+                             else if (name == "name") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setSolutionName(content);
+                             }
+                             else if (name == "appendix") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setSolutionApp(content);
+                             }
+                             else {
+                                 log::cout() << "No other settings are allowed for Solution!" << std::endl;
+                             }
+                         }
+                     }
+                 }
+                 else if (name == "Sequence") {
+                     for (children = cur_node->children; children != NULL; children = children->next) {
+                         if (children->type == XML_ELEMENT_NODE) {
+                             name = reinterpret_cast<const char*>(children->name);
+                             if( name == "manifest") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setSequenceManifest(content);
+                             }
+                             else if (name == "rebuild") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setSequenceRebuild(std::atoi(content.c_str()));
+                             }
+                             else if (name == "growth") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setSequenceGrowth(std::atof(content.c_str()));
+                             }
+                             else {
+                                 log::cout() << "No other settings are allowed for Sequence!" << std::endl;
+                             }
+                         }
+                     }
+                 }
+                 else if (name == "Tuning") {
+                     for (children = cur_node->children; children != NULL; children = children->next) {
+                         if (children->type == XML_ELEMENT_NODE) {
+                             name = reinterpret_cast<const char*>(children->name);
+                             if( name == "on") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setTuningOn(content == "true");
+                             }
+                             else if (name == "candidates") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setTuningCandidates(content);
+                             }
+                             else if (name == "maxit") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setTuningMaxIterations(std::atoi(content.c_str()));
+                             }
+                             else if (name == "cache") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setTuningCache(content);
+                             }
+                             else {
+                                 log::cout() << "No other settings are allowed for Tuning!" << std::endl;
+                             }
+                         }
+                     }
+                 }
+                 else if (name == "Input") {
+                     for (children = cur_node->children; children != NULL; children = children->next) {
+                         if (children->type == XML_ELEMENT_NODE) {
+                             name = reinterpret_cast<const char*>(children->name);
+                             if( name == "mode") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setInputMode(content);
+                             }
+                             else if (name == "threads") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setInputThreads(std::atoi(content.c_str()));
+                             }
+                             else if (name == "partition") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setInputPartition(content);
+                             }
+                             else if (name == "weight") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setInputPartitionWeight(std::atof(content.c_str()));
+                             }
+                             else if (name == "chunk") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setInputChunkSize(std::atoi(content.c_str()));
+                             }
+                             else if (name == "shared") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setInputShared(content);
+                             }
+                             else if (name == "timeout") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setInputSharedTimeout(std::atof(content.c_str()));
+                             }
+                             else if (name == "cache") {
+                                 content = reinterpret_cast<const char*>(children->children->content);
+                                 setInputCache(content);
+                             }
+                             else {
+                                 log::cout() << "No other settings are allowed for Input!" << std::endl;
+                             }
+                         }
+                     }
+                 }
                  else if (name == "Dump") {
                      for (children = cur_node->children; children != NULL; children = children->next) {
                          if (children->type == XML_ELEMENT_NODE) {
@@ -168,7 +347,7 @@ void Dictionary::readXML(std::string filename)
                      }
                  }
                  else {
-                     log::cout() << "Only Solver, Matrix, RHS, InitialSolution and Dump are available..." << std::endl;
+                     log::cout() << "Only Solver, Matrix, RHS, InitialSolution, Solution, Sequence, Tuning, Input and Dump are available..." << std::endl;
                  }
              }
          }
@@ -198,6 +377,25 @@ void Dictionary::absorboption<bool>(bitpit::Config::Section & blockXML, std::str
     }
 }
 
+/*!
+ * It gets the value XML block option and set the value of the var variable
+ * The whole trimmed value is kept, so that blank separated lists (e.g. right-hand side names or PETSc options) are not cut
+ * @param blockXML the XML block containing the option
+ * @param option the name of the option
+ * @param var the string variable to be set at option value
+ */
+template<>
+void Dictionary::absorboption<std::string>(bitpit::Config::Section & blockXML, std::string option, std::string & var)
+{
+    if(blockXML.hasOption(option)){
+        std::string input = blockXML.get(option);
+        input = bitpit::utils::string::trim(input);
+        if(!input.empty()){
+            var = input;
+        }
+    }
+}
+
 /*!
  * It reads the XML dictionary using bitpit API based on libxml2 C API and sets the values for Dictionary members.
  * Beware: libxml2 has C and not C++ API
@@ -211,18 +409,32 @@ void Dictionary::readXMLbitpit(std::string filename)
     if(bitpit::config::root.hasSection("Solver")){
         bitpit::Config::Section & blockXML = bitpit::config::root.getSection("Solver");
         absorboption(blockXML, "debug", debug);
+        absorboption(blockXML, "backend", solver_backend);
+        absorboption(blockXML, "ksp", solver_ksp);
+        absorboption(blockXML, "pc", solver_pc);
+        absorboption(blockXML, "subpc", solver_subpc);
+        absorboption(blockXML, "levels", solver_levels);
+        absorboption(blockXML, "overlap", solver_overlap);
+        absorboption(blockXML, "restart", solver_restart);
+        absorboption(blockXML, "rtol", solver_rtol);
+        absorboption(blockXML, "atol", solver_atol);
+        absorboption(blockXML, "maxit", solver_maxit);
+        absorboption(blockXML, "options", solver_options);
     }
     if(bitpit::config::root.hasSection("Matrix")){
         bitpit::Config::Section & blockXML = bitpit::config::root.getSection("Matrix");
         absorboption(blockXML, "directory", matrix_dir);
         absorboption(blockXML, "name", matrix_name);
         absorboption(blockXML, "appendix", matrix_app);
+        absorboption(blockXML, "format", matrix_format);
+        absorboption(blockXML, "shards", matrix_shards);
     }
     if(bitpit::config::root.hasSection("RHS")){
         bitpit::Config::Section & blockXML = bitpit::config::root.getSection("RHS");
         absorboption(blockXML, "directory", rhs_dir);
         absorboption(blockXML, "name", rhs_name);
         absorboption(blockXML, "appendix", rhs_app);
+        absorboption(blockXML, "shards", rhs_shards);
     }
     if(bitpit::config::root.hasSection("InitialSolution")){
         bitpit::Config::Section & blockXML = bitpit::config::root.getSection("InitialSolution");
@@ -230,6 +442,38 @@ void Dictionary::readXMLbitpit(std::string filename)
         absorboption(blockXML, "directory", initialSolution_dir);
         absorboption(blockXML, "name", initialSolution_name);
         absorboption(blockXML, "appendix", initialSolution_app);
+        absorboption(blockXML, "shards", initialSolution_shards);
+    }
+    if(bitpit::config::root.hasSection("Solution")){
+        bitpit::Config::Section & blockXML = bitpit::config::root.getSection("Solution");
+        absorboption(blockXML, "on", solutionOn);
+        absorboption(blockXML, "directory", solution_dir);
+        absorboption(blockXML, "name", solution_name);
+        absorboption(blockXML, "appendix", solution_app);
+    }
+    if(bitpit::config::root.hasSection("Sequence")){
+        bitpit::Config::Section & blockXML = bitpit::config::root.getSection("Sequence");
+        absorboption(blockXML, "manifest", sequence_manifest);
+        absorboption(blockXML, "rebuild", sequence_rebuild);
+        absorboption(blockXML, "growth", sequence_growth);
+    }
+    if(bitpit::config::root.hasSection("Tuning")){
+        bitpit::Config::Section & blockXML = bitpit::config::root.getSection("Tuning");
+        absorboption(blockXML, "on", tuning_on);
+        absorboption(blockXML, "candidates", tuning_candidates);
+        absorboption(blockXML, "maxit", tuning_maxit);
+        absorboption(blockXML, "cache", tuning_cache);
+    }
+    if(bitpit::config::root.hasSection("Input")){
+        bitpit::Config::Section & blockXML = bitpit::config::root.getSection("Input");
+        absorboption(blockXML, "mode", input_mode);
+        absorboption(blockXML, "threads", input_threads);
+        absorboption(blockXML, "partition", input_partition);
+        absorboption(blockXML, "weight", input_partition_weight);
+        absorboption(blockXML, "chunk", input_chunk_size);
+        absorboption(blockXML, "shared", input_shared);
+        absorboption(blockXML, "timeout", input_shared_timeout);
+        absorboption(blockXML, "cache", input_cache);
     }
     if(bitpit::config::root.hasSection("Dump")){
         bitpit::Config::Section & blockXML = bitpit::config::root.getSection("Dump");
@@ -257,6 +501,204 @@ void Dictionary::setDebug(bool debug)
     this->debug = debug;
 }
 
+/*!
+ * It gets the solver backend
+ * @return a constant reference to the solver backend string
+ */
+const std::string& Dictionary::getSolverBackend() const
+{
+    return solver_backend;
+}
+
+/*!
+ * It sets the solver backend
+ * \param[in] solverBackend petsc for bitpit and PETSc, native for the native Krylov engine
+ */
+void Dictionary::setSolverBackend(const std::string& solverBackend)
+{
+    solver_backend = solverBackend;
+}
+
+/*!
+ * It gets the Krylov method
+ * @return a constant reference to the Krylov method string
+ */
+const std::string& Dictionary::getSolverKsp() const
+{
+    return solver_ksp;
+}
+
+/*!
+ * It sets the Krylov method
+ * \param[in] solverKsp the PETSc KSP type, empty for the bitpit default
+ */
+void Dictionary::setSolverKsp(const std::string& solverKsp)
+{
+    solver_ksp = solverKsp;
+}
+
+/*!
+ * It gets the preconditioner
+ * @return a constant reference to the preconditioner string
+ */
+const std::string& Dictionary::getSolverPc() const
+{
+    return solver_pc;
+}
+
+/*!
+ * It sets the preconditioner
+ * \param[in] solverPc the PETSc PC type, empty for the bitpit default
+ */
+void Dictionary::setSolverPc(const std::string& solverPc)
+{
+    solver_pc = solverPc;
+}
+
+/*!
+ * It gets the sub-domain preconditioner of ASM and block Jacobi
+ * @return a constant reference to the sub-domain preconditioner of ASM and block Jacobi string
+ */
+const std::string& Dictionary::getSolverSubPc() const
+{
+    return solver_subpc;
+}
+
+/*!
+ * It sets the sub-domain preconditioner of ASM and block Jacobi
+ * \param[in] solverSubPc the PETSc PC type, empty for ILU
+ */
+void Dictionary::setSolverSubPc(const std::string& solverSubPc)
+{
+    solver_subpc = solverSubPc;
+}
+
+/*!
+ * It gets the fill levels of the incomplete factorization
+ * @return a copy of the fill levels of the incomplete factorization
+ */
+int Dictionary::getSolverLevels() const
+{
+    return solver_levels;
+}
+
+/*!
+ * It sets the fill levels of the incomplete factorization
+ * \param[in] solverLevels the number of levels, negative for the default
+ */
+void Dictionary::setSolverLevels(int solverLevels)
+{
+    solver_levels = solverLevels;
+}
+
+/*!
+ * It gets the overlap of the ASM sub-domains
+ * @return a copy of the overlap of the ASM sub-domains
+ */
+int Dictionary::getSolverOverlap() const
+{
+    return solver_overlap;
+}
+
+/*!
+ * It sets the overlap of the ASM sub-domains
+ * \param[in] solverOverlap the number of layers, negative for the default
+ */
+void Dictionary::setSolverOverlap(int solverOverlap)
+{
+    solver_overlap = solverOverlap;
+}
+
+/*!
+ * It gets the restart length of the GMRES methods
+ * @return a copy of the restart length of the GMRES methods
+ */
+int Dictionary::getSolverRestart() const
+{
+    return solver_restart;
+}
+
+/*!
+ * It sets the restart length of the GMRES methods
+ * \param[in] solverRestart the number of iterations, non-positive for the default
+ */
+void Dictionary::setSolverRestart(int solverRestart)
+{
+    solver_restart = solverRestart;
+}
+
+/*!
+ * It gets the relative tolerance of the Krylov method
+ * @return a copy of the relative tolerance of the Krylov method
+ */
+double Dictionary::getSolverRtol() const
+{
+    return solver_rtol;
+}
+
+/*!
+ * It sets the relative tolerance of the Krylov method
+ * \param[in] solverRtol the tolerance, non-positive for the default
+ */
+void Dictionary::setSolverRtol(double solverRtol)
+{
+    solver_rtol = solverRtol;
+}
+
+/*!
+ * It gets the absolute tolerance of the Krylov method
+ * @return a copy of the absolute tolerance of the Krylov method
+ */
+double Dictionary::getSolverAtol() const
+{
+    return solver_atol;
+}
+
+/*!
+ * It sets the absolute tolerance of the Krylov method
+ * \param[in] solverAtol the tolerance, non-positive for the default
+ */
+void Dictionary::setSolverAtol(double solverAtol)
+{
+    solver_atol = solverAtol;
+}
+
+/*!
+ * It gets the maximum number of iterations of the Krylov method
+ * @return a copy of the maximum number of iterations of the Krylov method
+ */
+int Dictionary::getSolverMaxIterations() const
+{
+    return solver_maxit;
+}
+
+/*!
+ * It sets the maximum number of iterations of the Krylov method
+ * \param[in] solverMaxIterations the number of iterations, non-positive for the default
+ */
+void Dictionary::setSolverMaxIterations(int solverMaxIterations)
+{
+    solver_maxit = solverMaxIterations;
+}
+
+/*!
+ * It gets the free-form PETSc options
+ * @return a constant reference to the free-form PETSc options string
+ */
+const std::string& Dictionary::getSolverOptions() const
+{
+    return solver_options;
+}
+
+/*!
+ * It sets the free-form PETSc options
+ * \param[in] solverOptions the options as on the PETSc command line, empty for none
+ */
+void Dictionary::setSolverOptions(const std::string& solverOptions)
+{
+    solver_options = solverOptions;
+}
+
 /*!
  * It gets the dump folder path
  * @return a constant reference to the dump folder path string
@@ -383,6 +825,24 @@ void Dictionary::setInitialSolutionName(const std::string& initialSolutionName)
     initialSolution_name = initialSolutionName;
 }
 
+/*!
+ * It gets the initial solution shard file pattern
+ * @return a constant reference to the initial solution shard file pattern string, empty for a single file
+ */
+const std::string& Dictionary::getInitialSolutionShards() const
+{
+    return initialSolution_shards;
+}
+
+/*!
+ * It sets the initial solution shard file pattern
+ * \param[in] initialSolutionShards initial solution shard file name, '*' standing for the shard number
+ */
+void Dictionary::setInitialSolutionShards(const std::string& initialSolutionShards)
+{
+    initialSolution_shards = initialSolutionShards;
+}
+
 /*!
  * It gets the initial solution extension
  * @return a constant reference to the initial solution extension string
@@ -437,6 +897,312 @@ void Dictionary::setMatrixName(const std::string& matrixName)
     matrix_name = matrixName;
 }
 
+/*!
+ * It gets the matrix file format
+ * @return a constant reference to the matrix file format string
+ */
+const std::string& Dictionary::getMatrixFormat() const
+{
+    return matrix_format;
+}
+
+/*!
+ * It sets the matrix file format
+ * \param[in] matrixFormat matrix file format (auto, csr, binary or mtx)
+ */
+void Dictionary::setMatrixFormat(const std::string& matrixFormat)
+{
+    matrix_format = matrixFormat;
+}
+
+/*!
+ * It gets the matrix shard file pattern
+ * @return a constant reference to the matrix shard file pattern string, empty for a single file
+ */
+const std::string& Dictionary::getMatrixShards() const
+{
+    return matrix_shards;
+}
+
+/*!
+ * It sets the matrix shard file pattern
+ * \param[in] matrixShards matrix shard file name, '*' standing for the shard number
+ */
+void Dictionary::setMatrixShards(const std::string& matrixShards)
+{
+    matrix_shards = matrixShards;
+}
+
+/*!
+ * It gets the sequence manifest path
+ * @return a constant reference to the sequence manifest path string, empty if the sequence mode is off
+ */
+const std::string& Dictionary::getSequenceManifest() const
+{
+    return sequence_manifest;
+}
+
+/*!
+ * It sets the sequence manifest path
+ * \param[in] sequenceManifest path of the sequence manifest, empty to turn the sequence mode off
+ */
+void Dictionary::setSequenceManifest(const std::string& sequenceManifest)
+{
+    sequence_manifest = sequenceManifest;
+}
+
+/*!
+ * It gets the number of sequence steps between two preconditioner rebuilds
+ * @return the number of steps, 0 for no periodic rebuild
+ */
+int Dictionary::getSequenceRebuild() const
+{
+    return sequence_rebuild;
+}
+
+/*!
+ * It sets the number of sequence steps between two preconditioner rebuilds
+ * \param[in] sequenceRebuild number of steps, 0 for no periodic rebuild
+ */
+void Dictionary::setSequenceRebuild(int sequenceRebuild)
+{
+    sequence_rebuild = sequenceRebuild;
+}
+
+/*!
+ * It gets the iteration growth ratio triggering a preconditioner rebuild in sequence mode
+ * @return the ratio, 0 if disabled
+ */
+double Dictionary::getSequenceGrowth() const
+{
+    return sequence_growth;
+}
+
+/*!
+ * It sets the iteration growth ratio triggering a preconditioner rebuild in sequence mode
+ * \param[in] sequenceGrowth ratio between the iterations of a step and those of the last rebuild, 0 to disable
+ */
+void Dictionary::setSequenceGrowth(double sequenceGrowth)
+{
+    sequence_growth = sequenceGrowth;
+}
+
+/*!
+ * It gets the solver tuning switch
+ * @return true if the solver trials are run
+ */
+bool Dictionary::isTuningOn() const
+{
+    return tuning_on;
+}
+
+/*!
+ * It sets the solver tuning switch
+ * \param[in] tuningOn true to run the solver trials when no decision is cached for the matrix
+ */
+void Dictionary::setTuningOn(bool tuningOn)
+{
+    tuning_on = tuningOn;
+}
+
+/*!
+ * It gets the candidate solvers of the tuning
+ * @return a constant reference to the blank separated ksp/pc[/subpc] candidates string
+ */
+const std::string& Dictionary::getTuningCandidates() const
+{
+    return tuning_candidates;
+}
+
+/*!
+ * It sets the candidate solvers of the tuning
+ * \param[in] tuningCandidates blank separated ksp/pc[/subpc] candidates, with PETSc type names
+ */
+void Dictionary::setTuningCandidates(const std::string& tuningCandidates)
+{
+    tuning_candidates = tuningCandidates;
+}
+
+/*!
+ * It gets the iteration cap of every tuning trial
+ * @return a copy of the iteration cap of every tuning trial
+ */
+int Dictionary::getTuningMaxIterations() const
+{
+    return tuning_maxit;
+}
+
+/*!
+ * It sets the iteration cap of every tuning trial
+ * \param[in] tuningMaxIterations the number of iterations a candidate has to converge within
+ */
+void Dictionary::setTuningMaxIterations(int tuningMaxIterations)
+{
+    tuning_maxit = tuningMaxIterations;
+}
+
+/*!
+ * It gets the tuning decisions file path
+ * @return a constant reference to the tuning decisions file path string
+ */
+const std::string& Dictionary::getTuningCache() const
+{
+    return tuning_cache;
+}
+
+/*!
+ * It sets the tuning decisions file path
+ * \param[in] tuningCache the path of the file, empty for no cache
+ */
+void Dictionary::setTuningCache(const std::string& tuningCache)
+{
+    tuning_cache = tuningCache;
+}
+
+/*!
+ * It gets the input files access mode
+ * @return a constant reference to the input mode string
+ */
+const std::string& Dictionary::getInputMode() const
+{
+    return input_mode;
+}
+
+/*!
+ * It sets the input files access mode
+ * \param[in] inputMode input mode (stream, mpiio, scatter or nodescatter)
+ */
+void Dictionary::setInputMode(const std::string& inputMode)
+{
+    input_mode = inputMode;
+}
+
+/*!
+ * It gets the number of parsing threads per process
+ * @return the number of threads (0 for all the available cores)
+ */
+int Dictionary::getInputThreads() const
+{
+    return input_threads;
+}
+
+/*!
+ * It sets the number of parsing threads per process
+ * \param[in] inputThreads number of threads (0 for all the available cores)
+ */
+void Dictionary::setInputThreads(int inputThreads)
+{
+    input_threads = inputThreads;
+}
+
+/*!
+ * It gets the row partition among processes
+ * @return a constant reference to the row partition string
+ */
+const std::string& Dictionary::getInputPartition() const
+{
+    return input_partition;
+}
+
+/*!
+ * It sets the row partition among processes
+ * \param[in] inputPartition row partition (rows, nonzeros or weighted)
+ */
+void Dictionary::setInputPartition(const std::string& inputPartition)
+{
+    input_partition = inputPartition;
+}
+
+/*!
+ * It gets the non-zeros weight of the weighted row partition
+ * @return the weight, between 0 (as rows) and 1 (as nonzeros)
+ */
+double Dictionary::getInputPartitionWeight() const
+{
+    return input_partition_weight;
+}
+
+/*!
+ * It sets the non-zeros weight of the weighted row partition
+ * \param[in] inputPartitionWeight the weight, between 0 (as rows) and 1 (as nonzeros)
+ */
+void Dictionary::setInputPartitionWeight(double inputPartitionWeight)
+{
+    input_partition_weight = inputPartitionWeight;
+}
+
+/*!
+ * It gets the size of the chunks scattered by the reading processes
+ * @return the chunk size in MB
+ */
+int Dictionary::getInputChunkSize() const
+{
+    return input_chunk_size;
+}
+
+/*!
+ * It sets the size of the chunks scattered by the reading processes
+ * \param[in] inputChunkSize the chunk size in MB
+ */
+void Dictionary::setInputChunkSize(int inputChunkSize)
+{
+    input_chunk_size = inputChunkSize;
+}
+
+/*!
+ * It gets the name of the shared-memory input segment
+ * @return a constant reference to the segment name, empty if the inputs are read from files only
+ */
+const std::string& Dictionary::getInputShared() const
+{
+    return input_shared;
+}
+
+/*!
+ * It sets the name of the shared-memory input segment
+ * \param[in] inputShared the segment name, empty to read the inputs from files only
+ */
+void Dictionary::setInputShared(const std::string& inputShared)
+{
+    input_shared = inputShared;
+}
+
+/*!
+ * It gets how long the shared-memory input segment is waited for
+ * @return the timeout in seconds
+ */
+double Dictionary::getInputSharedTimeout() const
+{
+    return input_shared_timeout;
+}
+
+/*!
+ * It sets how long the shared-memory input segment is waited for
+ * \param[in] inputSharedTimeout the timeout in seconds
+ */
+void Dictionary::setInputSharedTimeout(double inputSharedTimeout)
+{
+    input_shared_timeout = inputSharedTimeout;
+}
+
+/*!
+ * It gets the directory of the matrix cache
+ * @return a constant reference to the cache directory, empty if the cache is disabled
+ */
+const std::string& Dictionary::getInputCache() const
+{
+    return input_cache;
+}
+
+/*!
+ * It sets the directory of the matrix cache
+ * \param[in] inputCache the cache directory, empty to disable the cache
+ */
+void Dictionary::setInputCache(const std::string& inputCache)
+{
+    input_cache = inputCache;
+}
+
 /*!
  * It gets the right-hand side extension
  * @return a constant reference to the right-hand side extension string
@@ -482,6 +1248,21 @@ const std::string& Dictionary::getRhsName() const
     return rhs_name;
 }
 
+/*!
+ * It gets the right-hand side file names, one per blank separated token of the name option
+ * @return the right-hand side file names, in the order they are solved
+ */
+std::vector<std::string> Dictionary::getRhsNames() const
+{
+    std::vector<std::string> names;
+    std::stringstream ss(rhs_name);
+    std::string name;
+    while(ss >> name) {
+        names.push_back(name);
+    }
+    return names;
+}
+
 /*!
  * It sets the right-hand side file name
  * \param[in] rhsName right-hand side file name
@@ -490,3 +1271,93 @@ void Dictionary::setRhsName(const std::string& rhsName)
 {
     rhs_name = rhsName;
 }
+
+/*!
+ * It gets the right-hand side shard file pattern
+ * @return a constant reference to the right-hand side shard file pattern string, empty for a single file
+ */
+const std::string& Dictionary::getRhsShards() const
+{
+    return rhs_shards;
+}
+
+/*!
+ * It sets the right-hand side shard file pattern
+ * \param[in] rhsShards right-hand side shard file name, '*' standing for the shard number
+ */
+void Dictionary::setRhsShards(const std::string& rhsShards)
+{
+    rhs_shards = rhsShards;
+}
+
+/*!
+ * It gets the solution output flag
+ * \return a copy of the boolean flag
+ */
+bool Dictionary::isSolutionOn() const
+{
+    return solutionOn;
+}
+
+/*!
+ * It sets the solution output flag
+ * \param[in] solutionOn boolean to activate the solution output of every right-hand side
+ */
+void Dictionary::setSolutionOn(bool solutionOn)
+{
+    this->solutionOn = solutionOn;
+}
+
+/*!
+ * It gets the solution file extension
+ * @return a constant reference to the solution file extension string
+ */
+const std::string& Dictionary::getSolutionApp() const
+{
+    return solution_app;
+}
+
+/*!
+ * It sets the solution file extension
+ * \param[in] solutionApp extension of the solution file
+ */
+void Dictionary::setSolutionApp(const std::string& solutionApp)
+{
+    solution_app = solutionApp;
+}
+
+/*!
+ * It gets the solution folder path
+ * @return a constant reference to the solution folder path string
+ */
+const std::string& Dictionary::getSolutionDir() const
+{
+    return solution_dir;
+}
+
+/*!
+ * It sets the solution folder path
+ * \param[in] solutionDir path of solution output folder
+ */
+void Dictionary::setSolutionDir(const std::string& solutionDir)
+{
+    solution_dir = solutionDir;
+}
+
+/*!
+ * It gets the solution file name
+ * @return a constant reference to the solution file name string
+ */
+const std::string& Dictionary::getSolutionName() const
+{
+    return solution_name;
+}
+
+/*!
+ * It sets the solution file name
+ * \param[in] solutionName solution file name
+ */
+void Dictionary::setSolutionName(const std::string& solutionName)
+{
+    solution_name = solutionName;
+}
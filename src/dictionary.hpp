@@ -24,6 +24,7 @@
 #define __MADLINSOLV_DICTIONARY_HPP__
 
 #include <string>
+#include <vector>
 #include <libxml/parser.h>
 #include <libxml/tree.h>
 
@@ -41,23 +42,65 @@
  *  <MadLinSolv website="">
  *    <Solver>
  *      <debug>...true/false...</debug>                             --> it controls the PETSc log_summary options and the PETSc true residuals print
+ *      <backend>...petsc/native...</backend>                       --> it selects PETSc or the native OpenMP Krylov engine for single-process runs (see NativeKrylovSolver class)
+ *      <ksp>...PETSc KSP type (fgmres/gmres/cg/bcgs/...)...</ksp>  --> it selects the Krylov method (bitpit default FGMRES)
+ *      <pc>...PETSc PC type (asm/bjacobi/gamg/ilu/...)...</pc>     --> it selects the preconditioner (bitpit default ASM)
+ *      <subpc>...PETSc PC type (ilu/icc/lu/...)...</subpc>         --> it selects the sub-domain preconditioner of ASM and block Jacobi (default ILU)
+ *      <levels>...number of levels...</levels>                     --> it controls the fill levels of the ILU/ICC factorization, of the sub-domains with ASM and block Jacobi
+ *      <overlap>...number of layers...</overlap>                   --> it controls the overlap of the ASM sub-domains
+ *      <restart>...number of iterations...</restart>               --> it controls the restart length of the GMRES methods
+ *      <rtol>...relative tolerance...</rtol>                       --> it controls the relative decrease of the residual norm at convergence
+ *      <atol>...absolute tolerance...</atol>                       --> it controls the absolute residual norm at convergence
+ *      <maxit>...number of iterations...</maxit>                   --> it controls the maximum number of iterations
+ *      <options>...PETSc command line options...</options>         --> free-form PETSc options (e.g. -ksp_monitor), applied last so that they override the settings above
  *    </Solver>
  *    <Matrix>
  *      <directory>...matrix folder...</directory>                  --> it controls the input folder for matrix file
  *      <name>...matrix file name...</name>                         --> it controls matrix file name
  *      <appendix>...matrix extension...</appendix>                 --> it controls matrix extension
+ *      <format>...auto/csr/binary/mtx/values...</format>           --> it controls matrix file format (auto detects it from file signature, values files need the pattern of a previous sequence step)
+ *      <shards>...shard file pattern...</shards>                   --> it controls the sharded layout ('*' replaced by the shard number), name and appendix are then ignored
  *    </Matrix>
  *    <RHS>
  *      <directory>...right-hand side folder...</directory>         --> it controls the input folder for right-hand side file
- *      <name>...right-hand side file name...</name>                --> it controls right-hand side file name
+ *      <name>...right-hand side file names...</name>               --> it controls right-hand side file name (several blank separated names for several right-hand sides)
  *      <appendix>...right-hand side extension</appendix>           --> it controls right-hand side extension
+ *      <shards>...shard file pattern...</shards>                   --> it controls the sharded layout ('*' replaced by the shard number), name and appendix are then ignored
  *    </RHS>
  *    <InitialSolution>
  *      <haveIt>...true/false...</haveIt>                           --> it controls if the user wants to provide an initial guess for the solution
  *      <directory>...initial solution guess folder...</directory>  --> it controls the input folder for initial solution guess file
  *      <name>...initial solution guess name...</name>              --> it controls the initial solution guess file name
  *      <appendix>...initial solution guess extension...</appendix> --> it controls the initial solution guess extension
+ *      <shards>...shard file pattern...</shards>                   --> it controls the sharded layout ('*' replaced by the shard number), name and appendix are then ignored
  *    </InitialSolution>
+ *    <Solution>
+ *      <on>...true/false...</on>                                   --> it controls if the user wants to write the solution of every right-hand side
+ *      <directory>...solution folder...</directory>                --> it controls the output folder for solution files
+ *      <name>...solution name...</name>                            --> it controls the solution file name (outputs are [name]_[right-hand side number].[appendix] with several right-hand sides)
+ *      <appendix>...solution extension...</appendix>               --> it controls the solution extension
+ *    </Solution>
+ *    <Sequence>
+ *      <manifest>...sequence manifest file...</manifest>          --> it activates the sequence mode, solving the (matrix, right-hand side) pairs of the manifest (see SequenceManifest class), Matrix and RHS files are then ignored
+ *      <rebuild>...number of steps...</rebuild>                    --> it controls how often the preconditioner is rebuilt in sequence mode (1 at every step, 0 only when iterations degrade)
+ *      <growth>...iteration ratio...</growth>                      --> it rebuilds the preconditioner after a step whose iterations exceed this ratio times those of the last rebuild (0 to disable)
+ *    </Sequence>
+ *    <Tuning>
+ *      <on>...true/false...</on>                                   --> it runs short trials of the candidate solvers on the first right-hand side and keeps the fastest (see SolverTuner class)
+ *      <candidates>...ksp/pc[/subpc] list...</candidates>          --> it controls the blank separated candidates (default cg/jacobi gmres/ilu bcgs/bjacobi gmres/gamg)
+ *      <maxit>...number of iterations...</maxit>                   --> it controls the iteration cap of every trial
+ *      <cache>...decision file...</cache>                          --> it keeps the decisions keyed by the matrix fingerprint there, so that a matrix seen before skips the trials
+ *    </Tuning>
+ *    <Input>
+ *      <mode>...stream/mpiio/scatter/nodescatter...</mode>         --> it controls how processes read input files (independent streams, collective MPI-IO, one reader or one reader per node scattering the matrix)
+ *      <threads>...number of threads...</threads>                  --> it controls how many threads each process uses to parse the ASCII matrix (0 for all the cores)
+ *      <partition>...rows/nonzeros/weighted...</partition>         --> it controls how rows are distributed (equal rows, equal non-zeros or a mix of the two)
+ *      <weight>...between 0 and 1...</weight>                      --> it controls the non-zeros weight of the weighted partition (0 as rows, 1 as nonzeros)
+ *      <chunk>...size in MB...</chunk>                             --> it controls the size of the chunks sent by each reader in the scatter modes
+ *      <shared>...shared-memory segment name...</shared>           --> it reads the inputs the segment holds from a co-located producer instead of files (see SharedSegment class)
+ *      <timeout>...seconds...</timeout>                            --> it controls how long the shared-memory segment is waited for
+ *      <cache>...directory...</cache>                              --> it keeps the local rows of each process there and reloads them when the same ASCII CSR matrix is read again (see MatrixCache class)
+ *    </Input>
  *    <Dump>
  *      <on>...true/false...</on>                                   --> it controls if the user wants to print matrix, right-hand side and solution file
  *      <directory>...dump folder...</directory>                    --> it controls the output folder for matrix, right-hand side and solution file
@@ -65,6 +108,7 @@
  *    </Dump>
  *  </MadLinSolv>
  *  \endverbatim
+ *  Right-hand side files with several columns provide one right-hand side per column (see VectorReader class for details).
  */
 class Dictionary {
 
@@ -75,6 +119,28 @@ public:
 
     bool isDebug() const;
     void setDebug(bool debug);
+    const std::string& getSolverBackend() const;
+    void setSolverBackend(const std::string& solverBackend);
+    const std::string& getSolverKsp() const;
+    void setSolverKsp(const std::string& solverKsp);
+    const std::string& getSolverPc() const;
+    void setSolverPc(const std::string& solverPc);
+    const std::string& getSolverSubPc() const;
+    void setSolverSubPc(const std::string& solverSubPc);
+    int getSolverLevels() const;
+    void setSolverLevels(int solverLevels);
+    int getSolverOverlap() const;
+    void setSolverOverlap(int solverOverlap);
+    int getSolverRestart() const;
+    void setSolverRestart(int solverRestart);
+    double getSolverRtol() const;
+    void setSolverRtol(double solverRtol);
+    double getSolverAtol() const;
+    void setSolverAtol(double solverAtol);
+    int getSolverMaxIterations() const;
+    void setSolverMaxIterations(int solverMaxIterations);
+    const std::string& getSolverOptions() const;
+    void setSolverOptions(const std::string& solverOptions);
     const std::string& getDumpDir() const;
     void setDumpDir(const std::string& dumpDir);
     const std::string& getDumpName() const;
@@ -89,31 +155,112 @@ public:
     void setInitialSolutionDir(const std::string& initialSolutionDir);
     const std::string& getInitialSolutionName() const;
     void setInitialSolutionName(const std::string& initialSolutionName);
+    const std::string& getInitialSolutionShards() const;
+    void setInitialSolutionShards(const std::string& initialSolutionShards);
     const std::string& getMatrixApp() const;
     void setMatrixApp(const std::string& matrixApp);
     const std::string& getMatrixDir() const;
     void setMatrixDir(const std::string& matrixDir);
     const std::string& getMatrixName() const;
     void setMatrixName(const std::string& matrixName);
+    const std::string& getMatrixFormat() const;
+    void setMatrixFormat(const std::string& matrixFormat);
+    const std::string& getMatrixShards() const;
+    void setMatrixShards(const std::string& matrixShards);
+    const std::string& getSequenceManifest() const;
+    void setSequenceManifest(const std::string& sequenceManifest);
+    int getSequenceRebuild() const;
+    void setSequenceRebuild(int sequenceRebuild);
+    double getSequenceGrowth() const;
+    void setSequenceGrowth(double sequenceGrowth);
+    bool isTuningOn() const;
+    void setTuningOn(bool tuningOn);
+    const std::string& getTuningCandidates() const;
+    void setTuningCandidates(const std::string& tuningCandidates);
+    int getTuningMaxIterations() const;
+    void setTuningMaxIterations(int tuningMaxIterations);
+    const std::string& getTuningCache() const;
+    void setTuningCache(const std::string& tuningCache);
+    const std::string& getInputMode() const;
+    void setInputMode(const std::string& inputMode);
+    int getInputThreads() const;
+    void setInputThreads(int inputThreads);
+    const std::string& getInputPartition() const;
+    void setInputPartition(const std::string& inputPartition);
+    double getInputPartitionWeight() const;
+    void setInputPartitionWeight(double inputPartitionWeight);
+    int getInputChunkSize() const;
+    void setInputChunkSize(int inputChunkSize);
+    const std::string& getInputShared() const;
+    void setInputShared(const std::string& inputShared);
+    double getInputSharedTimeout() const;
+    void setInputSharedTimeout(double inputSharedTimeout);
+    const std::string& getInputCache() const;
+    void setInputCache(const std::string& inputCache);
     const std::string& getRhsApp() const;
     void setRhsApp(const std::string& rhsApp);
     const std::string& getRhsDir() const;
     void setRhsDir(const std::string& rhsDir);
     const std::string& getRhsName() const;
+    std::vector<std::string> getRhsNames() const;
     void setRhsName(const std::string& rhsName);
+    const std::string& getRhsShards() const;
+    void setRhsShards(const std::string& rhsShards);
+    bool isSolutionOn() const;
+    void setSolutionOn(bool solutionOn);
+    const std::string& getSolutionApp() const;
+    void setSolutionApp(const std::string& solutionApp);
+    const std::string& getSolutionDir() const;
+    void setSolutionDir(const std::string& solutionDir);
+    const std::string& getSolutionName() const;
+    void setSolutionName(const std::string& solutionName);
 
 private:
     bool debug;                             /**<boolean for controlling PETSc log and residuals print*/
+    std::string solver_backend = "petsc";   /**<solver backend, petsc or native*/
+    std::string solver_ksp;                 /**<Krylov method, empty for the bitpit default (FGMRES)*/
+    std::string solver_pc;                  /**<preconditioner, empty for the bitpit default (ASM)*/
+    std::string solver_subpc;               /**<sub-domain preconditioner of ASM and block Jacobi, empty for ILU*/
+    int solver_levels = -1;                 /**<fill levels of the incomplete factorization, negative for the default*/
+    int solver_overlap = -1;                /**<overlap of the ASM sub-domains, negative for the default*/
+    int solver_restart = -1;                /**<restart length of the GMRES methods, non-positive for the default*/
+    double solver_rtol = -1.;               /**<relative tolerance, non-positive for the default*/
+    double solver_atol = -1.;               /**<absolute tolerance, non-positive for the default*/
+    int solver_maxit = -1;                  /**<maximum number of iterations, non-positive for the default*/
+    std::string solver_options;             /**<free-form PETSc options, applied after the other settings*/
     std::string matrix_dir;                 /**<matrix folder*/
     std::string matrix_name;                /**<matrix name*/
     std::string matrix_app;                 /**<matrix extension*/
+    std::string matrix_format = "auto";     /**<matrix file format*/
+    std::string matrix_shards;              /**<matrix shard file pattern, empty for a single file*/
     std::string rhs_dir;                    /**<right-hand side folder*/
-    std::string rhs_name;                   /**<right-hand side name*/
+    std::string rhs_name;                   /**<right-hand side names, blank separated*/
     std::string rhs_app;                    /**<right-hand side extension*/
+    std::string rhs_shards;                 /**<right-hand side shard file pattern, empty for a single file*/
     bool haveInitialSolution;               /**<boolean for activating initial solution guess reading*/
     std::string initialSolution_dir;        /**<initial solution folder*/
     std::string initialSolution_name;       /**<initial solution name*/
     std::string initialSolution_app;        /**<initial solution extension*/
+    std::string initialSolution_shards;     /**<initial solution shard file pattern, empty for a single file*/
+    bool solutionOn = false;                /**<boolean for activating solution outputs*/
+    std::string solution_dir = ".";         /**<solution output folder*/
+    std::string solution_name = "solution"; /**<solution output file name*/
+    std::string solution_app = "dat";       /**<solution output extension*/
+    std::string sequence_manifest;          /**<sequence manifest path, empty if the sequence mode is off*/
+    int sequence_rebuild = 0;               /**<steps between two preconditioner rebuilds, 0 for no periodic rebuild*/
+    double sequence_growth = 2.0;           /**<iteration growth ratio triggering a preconditioner rebuild, 0 to disable*/
+    bool tuning_on = false;                 /**<boolean for running the solver trials*/
+    std::string tuning_candidates = "cg/jacobi gmres/ilu bcgs/bjacobi gmres/gamg"; /**<blank separated ksp/pc[/subpc] candidates*/
+    int tuning_maxit = 200;                 /**<iteration cap of every trial*/
+    std::string tuning_cache = "madlinsolv.tuning"; /**<file of the decisions keyed by matrix fingerprint, empty for no cache*/
+    std::string input_mode = "stream";      /**<input files access mode*/
+    int input_threads = 1;                  /**<number of parsing threads per process*/
+    std::string input_partition = "rows";   /**<row partition among processes*/
+    double input_partition_weight = 0.5;    /**<non-zeros weight of the weighted row partition*/
+    int input_chunk_size = 16;              /**<size of the scattered chunks [MB]*/
+    std::string input_shared;               /**<shared-memory input segment name, empty to read files only*/
+    double input_shared_timeout = 60.;      /**<time the shared-memory segment is waited for [s]*/
+    std::string input_cache;                /**<matrix cache directory, empty to disable the cache*/
     bool dumpOn;                            /**<boolean for activating system components outputs*/
     std::string dump_dir;                   /**<dump output folder*/
     std::string dump_name;                  /**<dump output file name prefix*/
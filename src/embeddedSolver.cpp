@@ -0,0 +1,244 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#if ENABLE_MPI==1
+#    include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+
+#include <bitpit_IO.hpp>
+
+#include "embeddedSolver.hpp"
+#include "localCSR.hpp"
+#include "sequenceSystemSolver.hpp"
+
+using namespace bitpit;
+
+/*!
+ * Constructor. It declares the system solver; MPI must have been initialized by the caller.
+ * \param[in] nProcessors the number of MPI ranks
+ * \param[in] rank        the MPI rank of the process owing the object
+ * \param[in] debug       true to enable the PETSc debug of the system solver
+ */
+EmbeddedSolver::EmbeddedSolver(int nProcessors, int rank, bool debug)
+    : m_nProcessors(nProcessors), m_rank(rank), m_solver(nProcessors, rank),
+      m_isAssembled(false), m_nLocalRows(0), m_nGlobalRows(0), m_rowStart(0), m_nLocalNz(0), m_iterations(0), m_residual(0.)
+{
+    m_solver.getSystem() = std::unique_ptr<SystemSolver>(new SequenceSystemSolver(debug));
+}
+
+/*!
+ * It assembles the system matrix from the CSR arrays of the caller. This method is collective.
+ * A process may own no rows, as long as another one owns some: it passes zero rows and rowPtr[0] only,
+ * column indices and values may then be null.
+ * \param[in] nLocalRows number of rows (and columns) of the process, the rows of the processes follow the rank order
+ * \param[in] rowPtr offset of each row in colIdx and values, nLocalRows + 1 elements (the first one is not required to be zero)
+ * \param[in] colIdx global column indices of the rows, possibly null if the process has no non-zeros
+ * \param[in] values values of the rows, possibly null if the process has no non-zeros
+ * \return true if the matrix has been assembled on all the processes
+ */
+bool EmbeddedSolver::assemble(long nLocalRows, const long * rowPtr, const long * colIdx, const double * values)
+{
+    if(!agree(!isAssembled())) {
+        log::cout() << "Matrix already assembled, its values can only be updated" << std::endl;
+        return false;
+    }
+
+    m_nLocalRows = std::max(nLocalRows, 0L);
+    m_nGlobalRows = m_nLocalRows;
+    m_rowStart = 0;
+#if ENABLE_MPI == 1
+    MPI_Allreduce(&m_nLocalRows, &m_nGlobalRows, 1, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Exscan(&m_nLocalRows, &m_rowStart, 1, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+    if(m_rank == 0) {
+        m_rowStart = 0;
+    }
+#endif
+    bool isValid = nLocalRows >= 0 && m_nGlobalRows > 0 && checkArguments(nLocalRows, rowPtr, colIdx, values);
+    if(!agree(isValid)) {
+        log::cout() << "Invalid CSR arrays, the matrix is not assembled" << std::endl;
+        m_nLocalRows = 0;
+        return false;
+    }
+    m_nLocalNz = rowPtr[m_nLocalRows] - rowPtr[0];
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    LocalCSR::commit(m_nLocalRows, rowPtr, colIdx, values, m_rowStart, m_nLocalNz, m_solver.getMatrix());
+    m_solver.getSystem()->assembly(*(m_solver.getMatrix()));
+    m_solver.releaseMatrix();
+    m_isAssembled = true;
+    log::cout() << "System assembly time = "
+            << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s" << std::endl;
+
+    return true;
+}
+
+/*!
+ * It updates the values of the assembled matrix, whose pattern must be the one given to assemble.
+ * This method is collective.
+ * \param[in] rowPtr offset of each row in colIdx and values, as given to assemble
+ * \param[in] colIdx global column indices of the rows, as given to assemble
+ * \param[in] values new values of the rows
+ * \return true if the matrix has been updated on all the processes
+ */
+bool EmbeddedSolver::update(const long * rowPtr, const long * colIdx, const double * values)
+{
+    bool isValid = isAssembled() && checkArguments(m_nLocalRows, rowPtr, colIdx, values)
+            && rowPtr[m_nLocalRows] - rowPtr[0] == m_nLocalNz;
+    if(!agree(isValid)) {
+        log::cout() << "Matrix not assembled or CSR arrays not matching its pattern, the matrix is not updated" << std::endl;
+        return false;
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    LocalCSR::commit(m_nLocalRows, rowPtr, colIdx, values, m_rowStart, m_nLocalNz, m_solver.getMatrix());
+    m_solver.getSystem()->update(*(m_solver.getMatrix()));
+    m_solver.releaseMatrix();
+    log::cout() << "Matrix values update time = "
+            << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s" << std::endl;
+
+    return true;
+}
+
+/*!
+ * It solves the system. This method is collective.
+ * \param[in] rhs local elements of the right-hand side, possibly null on processes without rows
+ * \param[in,out] solution local elements of the initial guess, overwritten by the solution, possibly null on processes without rows
+ * \return true if the system has been solved on all the processes
+ */
+bool EmbeddedSolver::solve(const double * rhs, double * solution)
+{
+    if(!agree(isAssembled() && ((rhs && solution) || m_nLocalRows == 0))) {
+        log::cout() << "Matrix not assembled or vectors missing, the system is not solved" << std::endl;
+        return false;
+    }
+
+    std::unique_ptr<SystemSolver> & system = m_solver.getSystem();
+    double *values = system->getRHSRawPtr();
+    std::copy(rhs, rhs + m_nLocalRows, values);
+    system->restoreRHSRawPtr(values);
+
+    values = system->getSolutionRawPtr();
+    std::copy(solution, solution + m_nLocalRows, values);
+    system->restoreSolutionRawPtr(values);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    system->solve();
+    m_iterations = system->getKSPStatus().its;
+    m_residual = static_cast<SequenceSystemSolver &>(*system).getResidualNorm();
+    log::cout() << "Solve time = " << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()
+            << " s, iterations = " << getIterations() << ", residual = " << getResidual() << std::endl;
+
+    const double *result = system->getSolutionRawReadPtr();
+    std::copy(result, result + m_nLocalRows, solution);
+    system->restoreSolutionRawReadPtr(result);
+
+    return true;
+}
+
+/*!
+ * \return true if the matrix has been assembled
+ */
+bool EmbeddedSolver::isAssembled() const
+{
+    return m_isAssembled;
+}
+
+/*!
+ * \return the number of rows of the process
+ */
+long EmbeddedSolver::getRowCount() const
+{
+    return m_nLocalRows;
+}
+
+/*!
+ * \return the global number of rows
+ */
+long EmbeddedSolver::getRowGlobalCount() const
+{
+    return m_nGlobalRows;
+}
+
+/*!
+ * \return the iterations of the last solve
+ */
+long EmbeddedSolver::getIterations() const
+{
+    return m_iterations;
+}
+
+/*!
+ * \return the residual norm of the last solve, as computed by the Krylov method
+ */
+double EmbeddedSolver::getResidual() const
+{
+    return m_residual;
+}
+
+/*!
+ * It checks the local CSR arrays: the row pointer must be non-decreasing and the column indices within the global columns.
+ * Column indices and values are needed only if the process has non-zeros.
+ * \param[in] nLocalRows number of rows of the process
+ * \param[in] rowPtr offset of each row in colIdx and values
+ * \param[in] colIdx global column indices of the rows
+ * \param[in] values values of the rows
+ * \return true if the arrays are valid
+ */
+bool EmbeddedSolver::checkArguments(long nLocalRows, const long * rowPtr, const long * colIdx, const double * values)
+{
+    if(!rowPtr || rowPtr[0] < 0) {
+        return false;
+    }
+    for(long row = 0; row < nLocalRows; ++row) {
+        if(rowPtr[row + 1] < rowPtr[row]) {
+            return false;
+        }
+    }
+    if(rowPtr[nLocalRows] > rowPtr[0] && (!colIdx || !values)) {
+        return false;
+    }
+    for(long k = rowPtr[0]; k < rowPtr[nLocalRows]; ++k) {
+        if(colIdx[k] < 0 || colIdx[k] >= m_nGlobalRows) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*!
+ * It agrees on a condition among all the processes. This method is collective.
+ * \param[in] isValid the condition on the process
+ * \return true if the condition holds on all the processes
+ */
+bool EmbeddedSolver::agree(bool isValid)
+{
+    int isValidEverywhere = isValid ? 1 : 0;
+#if ENABLE_MPI == 1
+    MPI_Allreduce(MPI_IN_PLACE, &isValidEverywhere, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+#endif
+
+    return isValidEverywhere == 1;
+}
@@ -0,0 +1,83 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_EMBEDDEDSOLVER_HPP__
+#define __MADLINSOLV_EMBEDDEDSOLVER_HPP__
+
+#include "solver.hpp"
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The embedded solver class
+ *
+ *  This class is intended to
+ *  solve, inside the process of a caller application, a linear system whose matrix and vectors are owned by the caller,
+ *  with no file in between (it is exposed to C through the madlinsolv.h API).
+ *  Each process passes its own contiguous block of rows, in rank order, as CSR arrays (row pointer, global column indices
+ *  and values); the block of a process may be empty. The arrays are handed to the bitpit SparseMatrix as they are, with its storage reserved for the exact
+ *  non-zeros (see LocalCSR::commit), then the PETSc matrix is assembled and the SparseMatrix released: PETSc keeps
+ *  the only copy of the matrix, the caller arrays are only read and may be released after the call.
+ *  New values with the same pattern are copied into the assembled PETSc matrix, whose preconditioner is rebuilt by the
+ *  next solve. The right-hand side and the initial guess are copied into the PETSc vectors and the solution is copied
+ *  back into the caller array in place of the initial guess.
+ *  Invalid arguments on any process are detected collectively, so that all the processes fail together.
+ */
+class EmbeddedSolver {
+
+public:
+
+    EmbeddedSolver(int nProcessors, int rank, bool debug);
+
+    EmbeddedSolver(EmbeddedSolver const&) = delete;
+    EmbeddedSolver & operator=(EmbeddedSolver const&) = delete;
+
+    bool assemble(long nLocalRows, const long * rowPtr, const long * colIdx, const double * values);
+    bool update(const long * rowPtr, const long * colIdx, const double * values);
+    bool solve(const double * rhs, double * solution);
+
+    bool isAssembled() const;
+    long getRowCount() const;
+    long getRowGlobalCount() const;
+    long getIterations() const;
+    double getResidual() const;
+
+private:
+
+    bool checkArguments(long nLocalRows, const long * rowPtr, const long * colIdx, const double * values);
+    bool agree(bool isValid);
+
+    int m_nProcessors;                                  /**<number of MPI processes*/
+    int m_rank;                                         /**<MPI rank of the process*/
+    Solver m_solver;                                    /**<solver holding the SparseMatrix and the system*/
+
+    bool m_isAssembled;                                 /**<true once the matrix has been assembled*/
+    long m_nLocalRows;                                  /**<number of rows of the process*/
+    long m_nGlobalRows;                                 /**<global number of rows*/
+    long m_rowStart;                                    /**<first global row of the process*/
+    long m_nLocalNz;                                    /**<number of non-zeros of the process*/
+    long m_iterations;                                  /**<Krylov iterations of the last solve*/
+    double m_residual;                                  /**<final residual norm of the last solve*/
+
+};
+
+#endif
@@ -0,0 +1,341 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cstring>
+
+#include "gzipStreamBuffer.hpp"
+
+namespace {
+
+//Size of the compressed and decompressed blocks
+const std::size_t BLOCK_SIZE = 256 << 10;
+
+//Window of the gzip format, as expected by inflateInit2
+const int GZIP_WINDOW_BITS = 16 + MAX_WBITS;
+
+}
+
+const int GzipStreamBuffer::MEMBER_OFFSET_BITS = 24;
+const uint64_t GzipStreamBuffer::MAX_MEMBER_SIZE = uint64_t(1) << GzipStreamBuffer::MEMBER_OFFSET_BITS;
+
+/*!
+ * Default constructor
+ * No file is open until open is called.
+ */
+GzipStreamBuffer::GzipStreamBuffer() :
+        m_file(nullptr), m_zStream(), m_isInflateInitialized(false), m_input(BLOCK_SIZE), m_output(BLOCK_SIZE),
+        m_inputOffset(0), m_memberOffset(0), m_outputOffset(0), m_isMemberEnded(false), m_isCorrupted(false)
+{
+    setg(nullptr, nullptr, nullptr);
+}
+
+/*!
+ * Destructor
+ * It closes the file.
+ */
+GzipStreamBuffer::~GzipStreamBuffer()
+{
+    close();
+}
+
+/*!
+ * It opens a gzip file and places the read position at its beginning
+ * \param[in] path path of the file
+ * \return true if the file has been opened
+ */
+bool GzipStreamBuffer::open(const std::string & path)
+{
+    close();
+
+    m_file = std::fopen(path.c_str(), "rb");
+    if(m_file == nullptr) {
+        return false;
+    }
+
+    std::memset(&m_zStream, 0, sizeof(m_zStream));
+    if(inflateInit2(&m_zStream, GZIP_WINDOW_BITS) != Z_OK) {
+        close();
+        return false;
+    }
+    m_isInflateInitialized = true;
+    m_isCorrupted = false;
+
+    return restartMember(0);
+}
+
+/*!
+ * It checks if the file is open
+ * \return true if the file is open
+ */
+bool GzipStreamBuffer::isOpen() const
+{
+    return m_file != nullptr;
+}
+
+/*!
+ * It checks if the decompression stopped on invalid compressed data or on a member truncated by the end of the file,
+ * instead of at the end of the last member
+ * \return true if the file is corrupted or truncated
+ */
+bool GzipStreamBuffer::isCorrupted() const
+{
+    return m_isCorrupted;
+}
+
+/*!
+ * It closes the file and releases the inflate state
+ */
+void GzipStreamBuffer::close()
+{
+    if(m_isInflateInitialized) {
+        inflateEnd(&m_zStream);
+        m_isInflateInitialized = false;
+    }
+    if(m_file != nullptr) {
+        std::fclose(m_file);
+        m_file = nullptr;
+    }
+    setg(nullptr, nullptr, nullptr);
+}
+
+/*!
+ * It gives the unread decompressed bytes of the get area, refilling it if empty, and consumes them.
+ * All the bytes belong to the same member, so the virtual offset of the k-th byte is virtualOffset + k
+ * as long as it stays below MAX_MEMBER_SIZE in the member.
+ * \param[out] begin first byte of the block
+ * \param[out] end byte after the last one of the block
+ * \param[out] virtualOffset virtual offset of the first byte of the block
+ * \return false at the end of the file or on corrupted data (see isCorrupted)
+ */
+bool GzipStreamBuffer::nextBlock(const char ** begin, const char ** end, uint64_t * virtualOffset)
+{
+    if(gptr() == egptr() && traits_type::eq_int_type(underflow(), traits_type::eof())) {
+        return false;
+    }
+
+    *begin = gptr();
+    *end = egptr();
+    *virtualOffset = makeVirtualOffset(m_memberOffset, getInMemberOffset());
+    setg(eback(), egptr(), egptr());
+
+    return true;
+}
+
+/*!
+ * It checks if a file starts with the gzip magic bytes
+ * \param[in] path path of the file
+ * \return true if the file is gzip compressed
+ */
+bool GzipStreamBuffer::hasMagic(const std::string & path)
+{
+    std::FILE *file = std::fopen(path.c_str(), "rb");
+    if(file == nullptr) {
+        return false;
+    }
+
+    unsigned char magic[2] = {0, 0};
+    std::size_t nRead = std::fread(magic, 1, 2, file);
+    std::fclose(file);
+
+    return nRead == 2 && magic[0] == 0x1f && magic[1] == 0x8b;
+}
+
+/*!
+ * It builds a virtual offset
+ * \param[in] memberOffset compressed offset of the member
+ * \param[in] inMemberOffset uncompressed offset in the member, lower than MAX_MEMBER_SIZE
+ * \return the virtual offset
+ */
+uint64_t GzipStreamBuffer::makeVirtualOffset(uint64_t memberOffset, uint64_t inMemberOffset)
+{
+    return (memberOffset << MEMBER_OFFSET_BITS) | inMemberOffset;
+}
+
+/*!
+ * It decompresses the next block of the current member, moving to the next member when the current one ends
+ * \return the first byte of the new get area, or EOF at the end of the file or on corrupted data (see isCorrupted)
+ */
+GzipStreamBuffer::int_type GzipStreamBuffer::underflow()
+{
+    if(gptr() < egptr()) {
+        return traits_type::to_int_type(*gptr());
+    }
+    if(m_file == nullptr) {
+        return traits_type::eof();
+    }
+
+    m_outputOffset += static_cast<uint64_t>(egptr() - eback());
+    setg(m_output.data(), m_output.data(), m_output.data());
+
+    while(true) {
+        if(m_isMemberEnded && !startNextMember()) {
+            return traits_type::eof();
+        }
+        if(m_zStream.avail_in == 0 && !refillInput()) {
+            //The file ended inside a member
+            m_isCorrupted = true;
+            return traits_type::eof();
+        }
+
+        m_zStream.next_out = reinterpret_cast<Bytef *>(m_output.data());
+        m_zStream.avail_out = static_cast<uInt>(m_output.size());
+        int status = inflate(&m_zStream, Z_NO_FLUSH);
+        if(status == Z_STREAM_END) {
+            m_isMemberEnded = true;
+        } else if(status != Z_OK && status != Z_BUF_ERROR) {
+            m_isCorrupted = true;
+            return traits_type::eof();
+        }
+
+        std::size_t nProduced = m_output.size() - m_zStream.avail_out;
+        if(nProduced > 0) {
+            setg(m_output.data(), m_output.data(), m_output.data() + nProduced);
+            return traits_type::to_int_type(*gptr());
+        }
+    }
+}
+
+/*!
+ * It supports only the query of the current position, as done by tellg
+ * \param[in] off relative offset, it must be zero
+ * \param[in] dir reference position, it must be the current one
+ * \param[in] which only input sequences are supported
+ * \return the virtual offset of the read position, or -1 if it cannot be represented
+ */
+GzipStreamBuffer::pos_type GzipStreamBuffer::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+    if(!(which & std::ios_base::in) || dir != std::ios_base::cur || off != 0 || m_file == nullptr) {
+        return pos_type(off_type(-1));
+    }
+
+    uint64_t inMemberOffset = getInMemberOffset();
+    if(inMemberOffset >= MAX_MEMBER_SIZE) {
+        return pos_type(off_type(-1));
+    }
+
+    return pos_type(static_cast<off_type>(makeVirtualOffset(m_memberOffset, inMemberOffset)));
+}
+
+/*!
+ * It moves the read position at the given virtual offset.
+ * Inside the current member the decompression goes on forward, otherwise it restarts at the beginning of the member.
+ * \param[in] pos virtual offset
+ * \param[in] which only input sequences are supported
+ * \return the virtual offset, or -1 if it is beyond the end of the member
+ */
+GzipStreamBuffer::pos_type GzipStreamBuffer::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+    if(!(which & std::ios_base::in) || m_file == nullptr || off_type(pos) < 0) {
+        return pos_type(off_type(-1));
+    }
+
+    uint64_t virtualOffset = static_cast<uint64_t>(off_type(pos));
+    uint64_t memberOffset = virtualOffset >> MEMBER_OFFSET_BITS;
+    uint64_t inMemberOffset = virtualOffset & (MAX_MEMBER_SIZE - 1);
+    if(memberOffset != m_memberOffset || inMemberOffset < getInMemberOffset()) {
+        if(!restartMember(memberOffset)) {
+            return pos_type(off_type(-1));
+        }
+    }
+
+    //Skip the decompressed bytes up to the position, without leaving the member
+    while(getInMemberOffset() < inMemberOffset) {
+        if(gptr() == egptr()) {
+            if(m_isMemberEnded || traits_type::eq_int_type(underflow(), traits_type::eof())) {
+                return pos_type(off_type(-1));
+            }
+            continue;
+        }
+        std::size_t nSkipped = static_cast<std::size_t>(std::min<uint64_t>(egptr() - gptr(), inMemberOffset - getInMemberOffset()));
+        setg(eback(), gptr() + nSkipped, egptr());
+    }
+
+    return pos;
+}
+
+/*!
+ * It restarts the decompression at the beginning of a member
+ * \param[in] memberOffset compressed offset of the member
+ * \return true if the file could be positioned at the member
+ */
+bool GzipStreamBuffer::restartMember(uint64_t memberOffset)
+{
+    if(std::fseek(m_file, static_cast<long>(memberOffset), SEEK_SET) != 0) {
+        return false;
+    }
+
+    inflateReset(&m_zStream);
+    m_zStream.next_in = m_input.data();
+    m_zStream.avail_in = 0;
+    m_inputOffset = memberOffset;
+    m_memberOffset = memberOffset;
+    m_outputOffset = 0;
+    m_isMemberEnded = false;
+    setg(m_output.data(), m_output.data(), m_output.data());
+
+    return true;
+}
+
+/*!
+ * It starts the member following the one just ended, whose compressed bytes may already be in the input buffer
+ * \return false if the file has no more members
+ */
+bool GzipStreamBuffer::startNextMember()
+{
+    if(m_zStream.avail_in == 0 && !refillInput()) {
+        return false;
+    }
+
+    inflateReset(&m_zStream);
+    m_memberOffset = m_inputOffset + static_cast<uint64_t>(m_zStream.next_in - m_input.data());
+    m_outputOffset = 0;
+    m_isMemberEnded = false;
+
+    return true;
+}
+
+/*!
+ * It reads the next compressed block, flagging the file as corrupted on read errors
+ * \return false at the end of the file or on read errors
+ */
+bool GzipStreamBuffer::refillInput()
+{
+    m_inputOffset += static_cast<uint64_t>(m_zStream.next_in - m_input.data());
+    std::size_t nRead = std::fread(m_input.data(), 1, m_input.size(), m_file);
+    m_zStream.next_in = m_input.data();
+    m_zStream.avail_in = static_cast<uInt>(nRead);
+    if(std::ferror(m_file)) {
+        m_isCorrupted = true;
+    }
+
+    return nRead > 0;
+}
+
+/*!
+ * It gets the uncompressed offset in the current member of the read position
+ * \return the offset in the member
+ */
+uint64_t GzipStreamBuffer::getInMemberOffset() const
+{
+    return m_outputOffset + static_cast<uint64_t>(gptr() - eback());
+}
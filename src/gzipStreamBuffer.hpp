@@ -0,0 +1,101 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_GZIPSTREAMBUFFER_HPP__
+#define __MADLINSOLV_GZIPSTREAMBUFFER_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include <zlib.h>
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The gzip stream buffer class
+ *
+ *  This class is intended to
+ *  decompress a gzip file on the fly, so that the ASCII parsers read it as a plain stream
+ *  without any temporary file. Files made of several gzip members are read as their concatenation.
+ *  Positions are virtual offsets, as in block gzip (BGZF): the compressed offset of the member
+ *  shifted by MEMBER_OFFSET_BITS, plus the uncompressed offset inside the member.
+ *  Seeking restarts the decompression at the member, so it is cheap when the file is compressed
+ *  in small independent members (e.g. with bgzip); positions beyond MAX_MEMBER_SIZE bytes
+ *  of a member cannot be represented and such files can only be read sequentially.
+ *  Invalid compressed data and members truncated by the end of the file end the stream as the end of the file does,
+ *  readers tell them apart by isCorrupted.
+ */
+class GzipStreamBuffer : public std::streambuf {
+
+public:
+
+    static const int MEMBER_OFFSET_BITS;
+    static const uint64_t MAX_MEMBER_SIZE;
+
+    GzipStreamBuffer();
+    ~GzipStreamBuffer();
+
+    GzipStreamBuffer(const GzipStreamBuffer &) = delete;
+    GzipStreamBuffer & operator=(const GzipStreamBuffer &) = delete;
+
+    bool open(const std::string & path);
+    bool isOpen() const;
+    bool isCorrupted() const;
+    void close();
+
+    bool nextBlock(const char ** begin, const char ** end, uint64_t * virtualOffset);
+
+    static bool hasMagic(const std::string & path);
+    static uint64_t makeVirtualOffset(uint64_t memberOffset, uint64_t inMemberOffset);
+
+protected:
+
+    int_type underflow() override;
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+private:
+
+    bool restartMember(uint64_t memberOffset);
+    bool startNextMember();
+    bool refillInput();
+    uint64_t getInMemberOffset() const;
+
+    std::FILE *m_file;                                  /**<compressed file*/
+    z_stream m_zStream;                                 /**<zlib inflate state*/
+    bool m_isInflateInitialized;                        /**<true if m_zStream has been initialized*/
+
+    std::vector<unsigned char> m_input;                 /**<compressed bytes*/
+    std::vector<char> m_output;                         /**<decompressed bytes, the get area*/
+    uint64_t m_inputOffset;                             /**<compressed offset of the first byte of m_input*/
+    uint64_t m_memberOffset;                            /**<compressed offset of the current member*/
+    uint64_t m_outputOffset;                            /**<uncompressed offset in the member of the first byte of the get area*/
+    bool m_isMemberEnded;                               /**<true if the current member has been decompressed completely*/
+    bool m_isCorrupted;                                 /**<true if invalid compressed data or a member truncated by the end of the file have been found*/
+
+};
+
+#endif
@@ -0,0 +1,95 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#include "inputFileStream.hpp"
+
+/*!
+ * Constructor
+ * It opens the file for reading, with on the fly decompression if it starts with the gzip magic bytes.
+ * If the file cannot be opened, the failbit is set and isOpen returns false.
+ * \param[in] path path of the file
+ */
+InputFileStream::InputFileStream(const std::string & path) :
+        std::istream(nullptr), m_fileBuffer(), m_gzipBuffer(), m_isCompressed(GzipStreamBuffer::hasMagic(path))
+{
+    bool isOpened;
+    if(m_isCompressed) {
+        isOpened = m_gzipBuffer.open(path);
+        rdbuf(&m_gzipBuffer);
+    } else {
+        isOpened = (m_fileBuffer.open(path.c_str(), std::ios_base::in | std::ios_base::binary) != nullptr);
+        rdbuf(&m_fileBuffer);
+    }
+
+    if(!isOpened) {
+        setstate(std::ios_base::failbit);
+    }
+}
+
+/*!
+ * It checks if the file is open
+ * \return true if the file is open
+ */
+bool InputFileStream::isOpen() const
+{
+    return m_isCompressed ? m_gzipBuffer.isOpen() : m_fileBuffer.is_open();
+}
+
+/*!
+ * It checks if the file is gzip compressed
+ * \return true if the file is decompressed on the fly
+ */
+bool InputFileStream::isCompressed() const
+{
+    return m_isCompressed;
+}
+
+/*!
+ * It checks if the decompression of a gzip compressed file stopped on corrupted or truncated data
+ * \return true if the file is compressed and corrupted, false for plain files
+ */
+bool InputFileStream::isCorrupted() const
+{
+    return m_isCompressed && m_gzipBuffer.isCorrupted();
+}
+
+/*!
+ * It closes the file
+ */
+void InputFileStream::close()
+{
+    if(m_isCompressed) {
+        m_gzipBuffer.close();
+    } else {
+        m_fileBuffer.close();
+    }
+}
+
+/*!
+ * It checks if a file is gzip compressed, looking at its magic bytes
+ * \param[in] path path of the file
+ * \return true if the file is gzip compressed
+ */
+bool InputFileStream::isCompressed(const std::string & path)
+{
+    return GzipStreamBuffer::hasMagic(path);
+}
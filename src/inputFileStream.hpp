@@ -0,0 +1,65 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_INPUTFILESTREAM_HPP__
+#define __MADLINSOLV_INPUTFILESTREAM_HPP__
+
+#include <fstream>
+#include <istream>
+#include <string>
+
+#include "gzipStreamBuffer.hpp"
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The input file stream class
+ *
+ *  This class is intended to
+ *  open the ASCII input files (matrix, right-hand side, initial solution and their shards) either plain
+ *  or gzip compressed, recognized by their magic bytes, behind the same std::istream.
+ *  Compressed files are decompressed on the fly (see GzipStreamBuffer class); their positions are
+ *  virtual offsets, so tellg and seekg (and the line index built on them) work as for plain files,
+ *  but positions of compressed files cannot be used as byte ranges (e.g. by MPI-IO).
+ */
+class InputFileStream : public std::istream {
+
+public:
+
+    explicit InputFileStream(const std::string & path);
+
+    bool isOpen() const;
+    bool isCompressed() const;
+    bool isCorrupted() const;
+    void close();
+
+    static bool isCompressed(const std::string & path);
+
+private:
+
+    std::filebuf m_fileBuffer;                          /**<buffer of plain files*/
+    GzipStreamBuffer m_gzipBuffer;                      /**<buffer of compressed files*/
+    bool m_isCompressed;                                /**<true if the file is gzip compressed*/
+
+};
+
+#endif
@@ -0,0 +1,104 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <thread>
+
+#include <bitpit_IO.hpp>
+
+#include "inputOptions.hpp"
+
+using namespace bitpit;
+
+/*!
+ * It converts the dictionary value of the input mode into the corresponding read mode.
+ * Unknown values fall back to independent streams.
+ * \param[in] mode the dictionary value ("stream", "mpiio", "scatter" or "nodescatter")
+ * \return the read mode
+ */
+ReadMode InputOptions::parseReadMode(const std::string & mode)
+{
+    if(mode == "mpiio") {
+        return ReadMode::MPIIO;
+    } else if(mode == "scatter") {
+        return ReadMode::SCATTER;
+    } else if(mode == "nodescatter") {
+        return ReadMode::NODE_SCATTER;
+    } else if(!mode.empty() && mode != "stream") {
+        log::cout() << "Unknown input mode " << mode << ", independent streams will be used" << std::endl;
+    }
+
+    return ReadMode::STREAM;
+}
+
+/*!
+ * It converts the dictionary value of the parsing threads into the number of threads to be used.
+ * Zero or negative values select all the cores reported by the system.
+ * \param[in] requested the dictionary value
+ * \return the number of threads, at least one
+ */
+int InputOptions::resolveThreadCount(int requested)
+{
+    if(requested > 0) {
+        return requested;
+    }
+
+    int nCores = static_cast<int>(std::thread::hardware_concurrency());
+
+    return std::max(nCores, 1);
+}
+
+/*!
+ * It converts the dictionary values of the row partition into the weight of the non-zeros in the row cost.
+ * Unknown values fall back to equal rows.
+ * \param[in] partition the dictionary partition ("rows", "nonzeros" or "weighted")
+ * \param[in] weight the dictionary weight, used by the weighted partition and clipped to [0,1]
+ * \return the weight of the non-zeros, 0 for equal rows and 1 for equal non-zeros
+ */
+double InputOptions::parsePartitionWeight(const std::string & partition, double weight)
+{
+    if(partition == "nonzeros") {
+        return 1.;
+    } else if(partition == "weighted") {
+        return std::min(std::max(weight, 0.), 1.);
+    } else if(!partition.empty() && partition != "rows") {
+        log::cout() << "Unknown row partition " << partition << ", rows will be equally distributed" << std::endl;
+    }
+
+    return 0.;
+}
+
+/*!
+ * It converts the dictionary value of the scatter chunk size into bytes.
+ * Zero or negative values select the default size of 16 MB, sizes are limited to 1 GB (MPI counts are int).
+ * \param[in] megaBytes the dictionary value [MB]
+ * \return the chunk size [bytes]
+ */
+std::size_t InputOptions::resolveChunkSize(int megaBytes)
+{
+    if(megaBytes <= 0) {
+        megaBytes = 16;
+    }
+    megaBytes = std::min(megaBytes, 1024);
+
+    return static_cast<std::size_t>(megaBytes) << 20;
+}
@@ -0,0 +1,62 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_INPUTOPTIONS_HPP__
+#define __MADLINSOLV_INPUTOPTIONS_HPP__
+
+#include <cstddef>
+#include <string>
+
+/*!
+ * Ways the processes access the input files
+ */
+enum class ReadMode {
+    STREAM,                                             /**<each process opens the file with an independent stream*/
+    MPIIO,                                              /**<processes read their slices with collective MPI-IO calls*/
+    SCATTER,                                            /**<one process reads the matrix and scatters its rows, see ScatterReader*/
+    NODE_SCATTER                                        /**<one process per node reads the matrix and scatters its rows, see ScatterReader*/
+};
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The input options structure
+ *
+ *  This structure collects the settings of the <Input> dictionary section,
+ *  shared by the matrix, right-hand side and initial solution readers.
+ */
+struct InputOptions {
+
+    ReadMode mode = ReadMode::STREAM;                   /**<file access mode*/
+    int nThreads = 1;                                   /**<number of parsing threads per process*/
+    double partitionWeight = 0.;                        /**<weight of the non-zeros in the row partition, see RowPartition*/
+    std::size_t chunkSize = 16 << 20;                   /**<size of the chunks sent by the reading processes in the scatter modes [bytes]*/
+    std::string cacheDirectory;                         /**<directory of the matrix cache, empty to disable it, see MatrixCache*/
+
+    static ReadMode parseReadMode(const std::string & mode);
+    static int resolveThreadCount(int requested);
+    static double parsePartitionWeight(const std::string & partition, double weight);
+    static std::size_t resolveChunkSize(int megaBytes);
+
+};
+
+#endif
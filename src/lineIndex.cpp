@@ -0,0 +1,424 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#if ENABLE_MPI==1
+#    include <mpi.h>
+#endif
+
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#include <bitpit_IO.hpp>
+
+#include "gzipStreamBuffer.hpp"
+#include "lineIndex.hpp"
+
+using namespace bitpit;
+
+namespace {
+
+/*!
+ * Header of the sidecar index file
+ */
+struct LineIndexHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t fileSize;
+    int64_t  fileTime;
+    uint64_t bodyOffset;
+    uint64_t stride;
+    uint64_t nLines;
+    uint64_t nEntries;
+};
+
+const char INDEX_MAGIC[8] = {'M', 'L', 'S', 'I', 'D', 'X', '\0', '\1'};
+const uint32_t INDEX_VERSION = 1;
+const std::size_t SCAN_BLOCK_SIZE = 1 << 20;
+
+}
+
+const uint64_t LineIndex::DEFAULT_STRIDE = 1024;
+
+/*!
+ * Constructor
+ * No index is loaded or built until initialize is called.
+ * \param[in] path path of the file to be indexed
+ * \param[in] stride number of body lines between two consecutive index entries
+ */
+LineIndex::LineIndex(const std::string & path, uint64_t stride) :
+        m_path(path), m_stride(stride > 0 ? stride : DEFAULT_STRIDE),
+        m_fileSize(0), m_fileTime(0), m_bodyOffset(0), m_nLines(0)
+{
+
+}
+
+/*!
+ * It makes the index available on all the processes.
+ * The process of rank 0 loads the sidecar index if it is still valid for the indexed file,
+ * otherwise it builds the index by scanning the file and saves it for later runs.
+ * In parallel runs the index is then broadcast to all the other processes, which never touch the sidecar file.
+ * \param[in] bodyOffset byte offset of the first body line, i.e. the first line after the header
+ * \param[in] rank MPI rank of the process
+ */
+void LineIndex::initialize(uint64_t bodyOffset, int rank)
+{
+    if(rank == 0) {
+        initializeLocal(bodyOffset, true);
+    }
+
+#if ENABLE_MPI==1
+    uint64_t info[3] = {m_bodyOffset, m_nLines, static_cast<uint64_t>(m_offsets.size())};
+    MPI_Bcast(info, 3, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+    m_bodyOffset = info[0];
+    m_nLines = info[1];
+    m_offsets.resize(info[2]);
+    MPI_Bcast(m_offsets.data(), static_cast<int>(m_offsets.size()), MPI_UINT64_T, 0, MPI_COMM_WORLD);
+#endif
+}
+
+/*!
+ * It makes the index available on the calling process only, without any communication.
+ * It is meant for files read by a subset of the processes, e.g. shards: the sidecar index is loaded
+ * if it is still valid, otherwise the index is built and, if requested, saved for later runs.
+ * Only one of the processes sharing a file should save its index.
+ * \param[in] bodyOffset byte offset of the first body line, i.e. the first line after the header
+ * \param[in] saveIndex true if a built index has to be saved in the sidecar file
+ */
+void LineIndex::initializeLocal(uint64_t bodyOffset, bool saveIndex)
+{
+    if(load(bodyOffset)) {
+        log::cout() << "Line index loaded from " << getIndexPath() << std::endl;
+    } else if(build(bodyOffset)) {
+        log::cout() << "Line index built for " << m_path << " (" << m_nLines << " lines, "
+                << m_offsets.size() << " entries)" << std::endl;
+        if(saveIndex && !save()) {
+            log::cout() << "Line index could not be saved to " << getIndexPath() << std::endl;
+        }
+    } else {
+        log::cout() << "Line index could not be built for " << m_path << std::endl;
+        m_bodyOffset = bodyOffset;
+        m_nLines = 0;
+        m_offsets.assign(1, bodyOffset);
+    }
+}
+
+/*!
+ * It moves the stream at the beginning of the given body line.
+ * The stream is positioned at the closest index entry and only the remaining lines
+ * (less than the stride) are skipped.
+ * \param[in] fileStream the stream from the indexed file
+ * \param[in] line zero-based body line number
+ */
+void LineIndex::seek(std::istream & fileStream, uint64_t line) const
+{
+    uint64_t entryLine;
+    uint64_t offset = getFloorOffset(line, &entryLine);
+
+    fileStream.clear();
+    fileStream.seekg(static_cast<std::streamoff>(offset));
+    for(uint64_t l = entryLine; l < line; ++l) {
+        fileStream.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+}
+
+/*!
+ * It gets the byte offset of the closest index entry at or before the given body line
+ * \param[in] line zero-based body line number
+ * \param[out] entryLine if not null, it is set to the body line number of the entry
+ * \return the byte offset of the entry
+ */
+uint64_t LineIndex::getFloorOffset(uint64_t line, uint64_t * entryLine) const
+{
+    uint64_t entry = 0;
+    if(!m_offsets.empty()) {
+        entry = std::min<uint64_t>(line / m_stride, m_offsets.size() - 1);
+    }
+
+    if(entryLine != nullptr) {
+        *entryLine = entry * m_stride;
+    }
+
+    return m_offsets.empty() ? m_bodyOffset : m_offsets[entry];
+}
+
+/*!
+ * It gets the byte offset of the closest index entry at or after the given body line.
+ * If there is no such entry, the end of the file is returned.
+ * \param[in] line zero-based body line number
+ * \param[out] entryLine if not null, it is set to the body line number of the entry (number of lines at end of file)
+ * \return the byte offset of the entry
+ */
+uint64_t LineIndex::getCeilOffset(uint64_t line, uint64_t * entryLine) const
+{
+    uint64_t entry = (line + m_stride - 1) / m_stride;
+    if(entry >= m_offsets.size()) {
+        if(entryLine != nullptr) {
+            *entryLine = m_nLines;
+        }
+        return std::numeric_limits<uint64_t>::max();
+    }
+
+    if(entryLine != nullptr) {
+        *entryLine = entry * m_stride;
+    }
+
+    return m_offsets[entry];
+}
+
+/*!
+ * It gets the number of body lines of the indexed file
+ * \return the number of body lines
+ */
+uint64_t LineIndex::getLineCount() const
+{
+    return m_nLines;
+}
+
+/*!
+ * It gets the number of body lines between two consecutive entries
+ * \return the index stride
+ */
+uint64_t LineIndex::getStride() const
+{
+    return m_stride;
+}
+
+/*!
+ * It gets the path of the sidecar index file
+ * \return the indexed file path followed by ".idx"
+ */
+std::string LineIndex::getIndexPath() const
+{
+    return m_path + ".idx";
+}
+
+/*!
+ * It loads the sidecar index file, if it matches the indexed file and the requested layout
+ * \param[in] bodyOffset byte offset of the first body line
+ * \return true if a valid index has been loaded
+ */
+bool LineIndex::load(uint64_t bodyOffset)
+{
+    uint64_t fileSize;
+    int64_t fileTime;
+    if(!getFileStatus(fileSize, fileTime)) {
+        return false;
+    }
+
+    std::ifstream in(getIndexPath().c_str(), std::ifstream::in | std::ifstream::binary);
+    if(!in.is_open()) {
+        return false;
+    }
+
+    LineIndexHeader header;
+    if(!in.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+        return false;
+    }
+    if(std::memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0 || header.version != INDEX_VERSION
+            || header.fileSize != fileSize || header.fileTime != fileTime
+            || header.bodyOffset != bodyOffset || header.stride != m_stride) {
+        return false;
+    }
+
+    std::vector<uint64_t> offsets(header.nEntries);
+    if(!in.read(reinterpret_cast<char *>(offsets.data()), header.nEntries * sizeof(uint64_t))) {
+        return false;
+    }
+
+    m_fileSize = fileSize;
+    m_fileTime = fileTime;
+    m_bodyOffset = bodyOffset;
+    m_nLines = header.nLines;
+    m_offsets.swap(offsets);
+
+    return true;
+}
+
+/*!
+ * It builds the index by scanning the indexed file in large blocks, looking only for line ends
+ * \param[in] bodyOffset byte offset of the first body line
+ * \return true if the index has been built
+ */
+bool LineIndex::build(uint64_t bodyOffset)
+{
+    if(!getFileStatus(m_fileSize, m_fileTime)) {
+        return false;
+    }
+    if(GzipStreamBuffer::hasMagic(m_path)) {
+        return buildCompressed(bodyOffset);
+    }
+
+    std::FILE *in = std::fopen(m_path.c_str(), "rb");
+    if(in == nullptr) {
+        return false;
+    }
+    if(std::fseek(in, static_cast<long>(bodyOffset), SEEK_SET) != 0) {
+        std::fclose(in);
+        return false;
+    }
+
+    m_bodyOffset = bodyOffset;
+    m_offsets.clear();
+    m_offsets.push_back(bodyOffset);
+
+    //Body line 0 starts at bodyOffset, every line end starts a new line
+    uint64_t nLineEnds = 0;
+    uint64_t blockOffset = bodyOffset;
+    bool pendingLine = false;
+    std::vector<char> block(SCAN_BLOCK_SIZE);
+    std::size_t nRead;
+    while((nRead = std::fread(block.data(), 1, block.size(), in)) > 0) {
+        const char *begin = block.data();
+        const char *end = begin + nRead;
+        const char *cursor = begin;
+        while((cursor = static_cast<const char *>(std::memchr(cursor, '\n', end - cursor))) != nullptr) {
+            ++nLineEnds;
+            ++cursor;
+            uint64_t lineOffset = blockOffset + (cursor - begin);
+            if(nLineEnds % m_stride == 0 && lineOffset < m_fileSize) {
+                m_offsets.push_back(lineOffset);
+            }
+        }
+        pendingLine = (block[nRead - 1] != '\n');
+        blockOffset += nRead;
+    }
+    std::fclose(in);
+
+    //The last line may not be terminated by a line end
+    m_nLines = nLineEnds + (pendingLine ? 1 : 0);
+
+    return true;
+}
+
+/*!
+ * It builds the index of a gzip compressed file by decompressing it once, the offsets being the virtual offsets
+ * of the line starts (see GzipStreamBuffer class). It fails if a line starts beyond the largest offset
+ * representable in a member, i.e. if the file has not been compressed in small independent blocks,
+ * or if the file is corrupted or truncated.
+ * \param[in] bodyOffset virtual offset of the first body line
+ * \return true if the index has been built
+ */
+bool LineIndex::buildCompressed(uint64_t bodyOffset)
+{
+    GzipStreamBuffer in;
+    if(!in.open(m_path) || in.pubseekpos(static_cast<std::streamoff>(bodyOffset), std::ios_base::in) == std::streampos(std::streamoff(-1))) {
+        return false;
+    }
+
+    m_bodyOffset = bodyOffset;
+    m_offsets.clear();
+    m_offsets.push_back(bodyOffset);
+
+    //The entry of a line starting at the end of a block is the beginning of the next block
+    uint64_t nLineEnds = 0;
+    bool pendingLine = false;
+    bool pendingEntry = false;
+    const char *begin, *end;
+    uint64_t blockOffset;
+    while(in.nextBlock(&begin, &end, &blockOffset)) {
+        if((blockOffset & (GzipStreamBuffer::MAX_MEMBER_SIZE - 1)) + (end - begin) > GzipStreamBuffer::MAX_MEMBER_SIZE) {
+            log::cout() << "File " << m_path << " has gzip members larger than " << (GzipStreamBuffer::MAX_MEMBER_SIZE >> 20)
+                    << " MB, compress it in blocks (e.g. with bgzip) to let processes start partway" << std::endl;
+            return false;
+        }
+        if(pendingEntry) {
+            m_offsets.push_back(blockOffset);
+            pendingEntry = false;
+        }
+
+        const char *cursor = begin;
+        while((cursor = static_cast<const char *>(std::memchr(cursor, '\n', end - cursor))) != nullptr) {
+            ++nLineEnds;
+            ++cursor;
+            if(nLineEnds % m_stride == 0) {
+                if(cursor < end) {
+                    m_offsets.push_back(blockOffset + (cursor - begin));
+                } else {
+                    pendingEntry = true;
+                }
+            }
+        }
+        pendingLine = (*(end - 1) != '\n');
+    }
+    if(in.isCorrupted()) {
+        log::cout() << "File " << m_path << " is a corrupted or truncated gzip file" << std::endl;
+        return false;
+    }
+
+    //The last line may not be terminated by a line end
+    m_nLines = nLineEnds + (pendingLine ? 1 : 0);
+
+    return true;
+}
+
+/*!
+ * It saves the index into the sidecar file
+ * \return true if the sidecar file has been written
+ */
+bool LineIndex::save() const
+{
+    std::ofstream out(getIndexPath().c_str(), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+    if(!out.is_open()) {
+        return false;
+    }
+
+    LineIndexHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    header.version = INDEX_VERSION;
+    header.fileSize = m_fileSize;
+    header.fileTime = m_fileTime;
+    header.bodyOffset = m_bodyOffset;
+    header.stride = m_stride;
+    header.nLines = m_nLines;
+    header.nEntries = m_offsets.size();
+
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(m_offsets.data()), m_offsets.size() * sizeof(uint64_t));
+
+    return out.good();
+}
+
+/*!
+ * It gets size and modification time of the indexed file
+ * \param[out] size size in bytes of the indexed file
+ * \param[out] mtime modification time of the indexed file
+ * \return true if the file status is available
+ */
+bool LineIndex::getFileStatus(uint64_t & size, int64_t & mtime) const
+{
+    struct stat info;
+    if(stat(m_path.c_str(), &info) != 0) {
+        return false;
+    }
+
+    size = static_cast<uint64_t>(info.st_size);
+    mtime = static_cast<int64_t>(info.st_mtime);
+
+    return true;
+}
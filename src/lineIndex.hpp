@@ -0,0 +1,91 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_LINEINDEX_HPP__
+#define __MADLINSOLV_LINEINDEX_HPP__
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The line byte-offset index class
+ *
+ *  This class is intended to
+ *  let each process jump directly to the first line of its own slice of an ASCII input file
+ *  (matrix, right-hand side or initial solution), instead of reading and discarding all the previous lines.
+ *  It stores the byte offset of every stride-th line of the file body (the lines following the header).
+ *  The index is built once by a fast block scan of the file and saved in a sidecar file
+ *  (the input path followed by ".idx"), which is reused by later runs as long as the size and
+ *  the modification time of the input file do not change.
+ *  For gzip compressed files the offsets are virtual offsets (see GzipStreamBuffer class).
+ *  \verbatim
+ *                              sidecar index file format (binary)
+ *           -------------------------------------------------------------------
+ *  header   | signature, version, input size and modification time,           |
+ *           | body offset, stride, number of body lines, number of entries    |
+ *  entries  | uint64[number of entries], byte offset of body line k*stride    |
+ *           -------------------------------------------------------------------
+ *  \endverbatim
+ */
+class LineIndex {
+
+public:
+
+    static const uint64_t DEFAULT_STRIDE;
+
+    LineIndex(const std::string & path, uint64_t stride = DEFAULT_STRIDE);
+
+    void initialize(uint64_t bodyOffset, int rank);
+    void initializeLocal(uint64_t bodyOffset, bool saveIndex);
+    void seek(std::istream & fileStream, uint64_t line) const;
+
+    uint64_t getFloorOffset(uint64_t line, uint64_t * entryLine = nullptr) const;
+    uint64_t getCeilOffset(uint64_t line, uint64_t * entryLine = nullptr) const;
+    uint64_t getLineCount() const;
+    uint64_t getStride() const;
+
+    std::string getIndexPath() const;
+
+private:
+
+    bool load(uint64_t bodyOffset);
+    bool build(uint64_t bodyOffset);
+    bool buildCompressed(uint64_t bodyOffset);
+    bool save() const;
+    bool getFileStatus(uint64_t & size, int64_t & mtime) const;
+
+    std::string m_path;                                 /**<path of the indexed file*/
+    uint64_t m_stride;                                  /**<number of body lines between two consecutive entries*/
+
+    uint64_t m_fileSize;                                /**<size of the indexed file when the index was built*/
+    int64_t m_fileTime;                                 /**<modification time of the indexed file when the index was built*/
+    uint64_t m_bodyOffset;                              /**<byte offset of the first body line*/
+    uint64_t m_nLines;                                  /**<number of body lines*/
+    std::vector<uint64_t> m_offsets;                    /**<byte offset of every stride-th body line*/
+
+};
+
+#endif
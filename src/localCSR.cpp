@@ -0,0 +1,260 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#if ENABLE_MPI==1
+#    include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+#include <bitpit_IO.hpp>
+
+#include "localCSR.hpp"
+#include "nonZeroProfile.hpp"
+
+using namespace bitpit;
+
+/*!
+ * Default constructor
+ * It builds an empty buffer.
+ */
+LocalCSR::LocalCSR() :
+        m_rowPtr(1, 0), m_colIdx(), m_values(), m_nMismatchedRows(0)
+{
+
+}
+
+/*!
+ * It reserves the storage of the buffer
+ * \param[in] nRows expected number of rows
+ * \param[in] nNz expected number of non-zeros
+ */
+void LocalCSR::reserve(long nRows, long nNz)
+{
+    m_rowPtr.reserve(nRows + 1);
+    m_colIdx.reserve(nNz);
+    m_values.reserve(nNz);
+}
+
+/*!
+ * It removes all the rows, keeping the storage
+ */
+void LocalCSR::clear()
+{
+    m_rowPtr.assign(1, 0);
+    m_colIdx.clear();
+    m_values.clear();
+    m_nMismatchedRows = 0;
+}
+
+/*!
+ * It parses the next row pair of an ASCII CSR body, pattern line and values line, at the end of the buffer
+ * \param[in] tokenizer the tokenizer positioned at the pattern line of the row
+ */
+void LocalCSR::appendRow(Tokenizer & tokenizer)
+{
+    tokenizer.readLine(m_colIdx);
+    tokenizer.readLine(m_values);
+    closeRow();
+}
+
+/*!
+ * It parses a row pair of an ASCII CSR body at the end of the buffer
+ * \param[in] patternBegin first character of the pattern line
+ * \param[in] patternEnd character after the last one of the pattern line
+ * \param[in] valuesBegin first character of the values line
+ * \param[in] valuesEnd character after the last one of the values line
+ */
+void LocalCSR::appendRow(const char * patternBegin, const char * patternEnd, const char * valuesBegin, const char * valuesEnd)
+{
+    Tokenizer::parseLine(patternBegin, patternEnd, m_colIdx);
+    Tokenizer::parseLine(valuesBegin, valuesEnd, m_values);
+    closeRow();
+}
+
+/*!
+ * It copies a row at the end of the buffer
+ * \param[in] nRowNz number of non-zeros of the row
+ * \param[in] pattern global column indices of the row
+ * \param[in] values values of the row
+ */
+void LocalCSR::appendRow(long nRowNz, const long * pattern, const double * values)
+{
+    m_colIdx.insert(m_colIdx.end(), pattern, pattern + nRowNz);
+    m_values.insert(m_values.end(), values, values + nRowNz);
+    m_rowPtr.push_back(static_cast<long>(m_colIdx.size()));
+}
+
+/*!
+ * It copies all the rows of another buffer at the end of this one
+ * \param[in] other the buffer whose rows are copied
+ */
+void LocalCSR::append(const LocalCSR & other)
+{
+    long offset = getNonZeroCount();
+    for(std::size_t r = 1; r < other.m_rowPtr.size(); ++r) {
+        m_rowPtr.push_back(offset + other.m_rowPtr[r]);
+    }
+    m_colIdx.insert(m_colIdx.end(), other.m_colIdx.begin(), other.m_colIdx.end());
+    m_values.insert(m_values.end(), other.m_values.begin(), other.m_values.end());
+    m_nMismatchedRows += other.m_nMismatchedRows;
+}
+
+/*!
+ * It gets the number of rows in the buffer
+ * \return the number of rows
+ */
+long LocalCSR::getRowCount() const
+{
+    return static_cast<long>(m_rowPtr.size()) - 1;
+}
+
+/*!
+ * It gets the number of non-zeros in the buffer
+ * \return the number of non-zeros
+ */
+long LocalCSR::getNonZeroCount() const
+{
+    return m_rowPtr.back();
+}
+
+/*!
+ * It gets the row pointer array
+ * \return a pointer to getRowCount() + 1 offsets
+ */
+const long * LocalCSR::getRowPtr() const
+{
+    return m_rowPtr.data();
+}
+
+/*!
+ * It gets the column indices array
+ * \return a pointer to getNonZeroCount() global column indices
+ */
+const long * LocalCSR::getColIdx() const
+{
+    return m_colIdx.data();
+}
+
+/*!
+ * It gets the values array
+ * \return a pointer to getNonZeroCount() values
+ */
+const double * LocalCSR::getValues() const
+{
+    return m_values.data();
+}
+
+/*!
+ * It creates, fills and assemblies the bitpit SparseMatrix with the rows of the buffer, then it releases the buffer storage.
+ * If any process parsed a row whose pattern and values lines have different lengths, the matrix file is invalid
+ * and the execution is stopped on all the processes. This method is collective.
+ * \param[in] diagonalBegin first global column of the diagonal block, i.e. the first global row of the process
+ * \param[in] estimatedNnz number of local non-zeros the matrix would be initialized with without the buffer, for the report
+ * \param[in] matrix a reference to the unique pointer to the bitpit SparseMatrix to be created
+ * \param[in] consumer if set, it receives the rows in place of the SparseMatrix, which is not created
+ */
+void LocalCSR::commit(long diagonalBegin, long estimatedNnz, std::unique_ptr<SparseMatrix> & matrix,
+        const Consumer & consumer)
+{
+    long nMismatchedRows = m_nMismatchedRows;
+#if ENABLE_MPI == 1
+    MPI_Allreduce(MPI_IN_PLACE, &nMismatchedRows, 1, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+#endif
+    if(nMismatchedRows > 0) {
+        log::cout() << nMismatchedRows << " matrix rows with different numbers of column indices and values. Please, check the matrix file" << std::endl;
+#if ENABLE_MPI == 1
+        MPI_Finalize();
+#endif
+        exit(1);
+    }
+
+    commit(getRowCount(), m_rowPtr.data(), m_colIdx.data(), m_values.data(), diagonalBegin, estimatedNnz, matrix, consumer);
+
+    std::vector<long>(1, 0).swap(m_rowPtr);
+    std::vector<long>().swap(m_colIdx);
+    std::vector<double>().swap(m_values);
+}
+
+/*!
+ * It creates, fills and assemblies the bitpit SparseMatrix with rows stored in CSR arrays owned by the caller.
+ * The exact non-zeros of the rows, split between diagonal and off-diagonal blocks, are counted first,
+ * so that the matrix storage is reserved once with the right size; then they are reported against
+ * the estimate the matrix would be initialized with otherwise. This method is collective.
+ * \param[in] nRows number of rows (and columns) owned by the process
+ * \param[in] rowPtr offset of each row in colIdx and values, nRows + 1 elements (the first one is not required to be zero)
+ * \param[in] colIdx global column indices of the rows
+ * \param[in] values values of the rows
+ * \param[in] diagonalBegin first global column of the diagonal block, i.e. the first global row of the process
+ * \param[in] estimatedNnz number of local non-zeros the matrix would be initialized with otherwise, for the report
+ * \param[in] matrix a reference to the unique pointer to the bitpit SparseMatrix to be created
+ * \param[in] consumer if set, it receives the rows in place of the SparseMatrix, which is not created
+ */
+void LocalCSR::commit(long nRows, const long * rowPtr, const long * colIdx, const double * values,
+        long diagonalBegin, long estimatedNnz, std::unique_ptr<SparseMatrix> & matrix,
+        const Consumer & consumer)
+{
+    if(consumer) {
+        consumer(nRows, rowPtr, colIdx, values, diagonalBegin);
+        return;
+    }
+
+    NonZeroProfile profile;
+    profile.compute(nRows, rowPtr, colIdx, diagonalBegin, diagonalBegin + nRows);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+#if ENABLE_MPI == 1
+    matrix = std::unique_ptr<SparseMatrix>(new SparseMatrix(MPI_COMM_WORLD,true,nRows,nRows,profile.getNonZeroCount()));
+#else
+    matrix = std::unique_ptr<SparseMatrix>(new SparseMatrix(nRows,nRows,profile.getNonZeroCount()));
+#endif
+    for(long row = 0; row < nRows; ++row) {
+        matrix->addRow(rowPtr[row + 1] - rowPtr[row], colIdx + rowPtr[row], values + rowPtr[row]);
+    }
+    matrix->assembly();
+    double fillTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    profile.report(estimatedNnz, fillTime);
+}
+
+/*!
+ * It closes the row whose pattern and values have just been parsed.
+ * A row whose pattern and values lines have different lengths is cut to the shorter one and counted,
+ * the commit stops the execution on all the processes.
+ */
+void LocalCSR::closeRow()
+{
+    long rowBegin = m_rowPtr.back();
+    if(m_colIdx.size() != m_values.size()) {
+        if(m_nMismatchedRows == 0) {
+            log::cout() << "Matrix row with " << static_cast<long>(m_colIdx.size()) - rowBegin << " column indices and "
+                    << static_cast<long>(m_values.size()) - rowBegin << " values. Please, check the matrix file" << std::endl;
+        }
+        ++m_nMismatchedRows;
+        std::size_t nRowEnd = std::min(m_colIdx.size(), m_values.size());
+        m_colIdx.resize(nRowEnd);
+        m_values.resize(nRowEnd);
+    }
+    m_rowPtr.push_back(static_cast<long>(m_colIdx.size()));
+}
@@ -0,0 +1,94 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_LOCALCSR_HPP__
+#define __MADLINSOLV_LOCALCSR_HPP__
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <bitpit_LA.hpp>
+
+#include "tokenizer.hpp"
+
+using namespace bitpit;
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The local CSR buffer class
+ *
+ *  This class is intended to
+ *  accumulate the rows owned by a process in three contiguous arrays (row pointer, column indices and values)
+ *  and to hand them to the bitpit SparseMatrix with a single commit call.
+ *  Rows are parsed or copied straight into the arrays, which are reserved once from the expected size:
+ *  no temporary row vectors are created and, as long as the estimate holds, nothing is allocated per row.
+ *  A cleared buffer keeps its storage, so the buffers of the worker threads are reused batch after batch.
+ *  The commit creates the SparseMatrix with the exact number of non-zeros (see NonZeroProfile class),
+ *  fills and assemblies it, then releases the arrays.
+ *  A consumer can be given to the commit in place of the SparseMatrix, so that the rows are handed over
+ *  as they are (e.g. to the offline converter) without creating the matrix.
+ */
+class LocalCSR {
+
+public:
+
+    /*!
+     * Callable receiving the local rows in CSR arrays: number of rows, row pointer, column indices, values and first global row
+     */
+    typedef std::function<void(long nRows, const long * rowPtr, const long * colIdx, const double * values, long rowStart)> Consumer;
+
+    LocalCSR();
+
+    void reserve(long nRows, long nNz);
+    void clear();
+
+    void appendRow(Tokenizer & tokenizer);
+    void appendRow(const char * patternBegin, const char * patternEnd, const char * valuesBegin, const char * valuesEnd);
+    void appendRow(long nRowNz, const long * pattern, const double * values);
+    void append(const LocalCSR & other);
+
+    long getRowCount() const;
+    long getNonZeroCount() const;
+    const long * getRowPtr() const;
+    const long * getColIdx() const;
+    const double * getValues() const;
+
+    void commit(long diagonalBegin, long estimatedNnz, std::unique_ptr<SparseMatrix> & matrix,
+            const Consumer & consumer = Consumer());
+    static void commit(long nRows, const long * rowPtr, const long * colIdx, const double * values,
+            long diagonalBegin, long estimatedNnz, std::unique_ptr<SparseMatrix> & matrix,
+            const Consumer & consumer = Consumer());
+
+private:
+
+    void closeRow();
+
+    std::vector<long> m_rowPtr;                         /**<offset of each row in column indices and values, followed by the number of non-zeros*/
+    std::vector<long> m_colIdx;                         /**<global column indices of the rows*/
+    std::vector<double> m_values;                       /**<values of the rows*/
+    long m_nMismatchedRows;                             /**<number of rows whose pattern and values lines have different lengths*/
+
+};
+
+#endif
@@ -0,0 +1,66 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_H__
+#define __MADLINSOLV_H__
+
+/*
+ * C API of the MadLinSolv library.
+ *
+ * It solves, inside the caller process, a linear system whose CSR matrix and vectors are owned by the caller
+ * (see EmbeddedSolver class for details). MPI must be initialized by the caller before creating a solver and all
+ * the functions taking a solver are collective on MPI_COMM_WORLD. Each process passes its own contiguous block of
+ * rows, the blocks following the rank order; column indices are global. A process may own no rows, as long as
+ * another one owns some: it passes nLocalRows = 0 and a row pointer holding rowPtr[0] only, while its column indices,
+ * values, right-hand side and solution may be NULL. The caller arrays are only read, except the solution, and may be
+ * released after each call.
+ *
+ *     madlinsolv_solver *solver = madlinsolv_create(0);
+ *     madlinsolv_assemble(solver, nLocalRows, rowPtr, colIdx, values);
+ *     madlinsolv_solve(solver, rhs, solution);
+ *     madlinsolv_destroy(solver);
+ */
+
+#define MADLINSOLV_SUCCESS 0
+#define MADLINSOLV_FAILURE 1
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct madlinsolv_solver madlinsolv_solver;
+
+madlinsolv_solver * madlinsolv_create(int debug);
+void madlinsolv_destroy(madlinsolv_solver *solver);
+
+int madlinsolv_assemble(madlinsolv_solver *solver, long nLocalRows, const long *rowPtr, const long *colIdx, const double *values);
+int madlinsolv_update(madlinsolv_solver *solver, const long *rowPtr, const long *colIdx, const double *values);
+int madlinsolv_solve(madlinsolv_solver *solver, const double *rhs, double *solution);
+
+long madlinsolv_get_iterations(const madlinsolv_solver *solver);
+double madlinsolv_get_residual(const madlinsolv_solver *solver);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,138 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#if ENABLE_MPI==1
+#    include <mpi.h>
+#endif
+
+#include <new>
+
+#include "embeddedSolver.hpp"
+#include "madlinsolv.h"
+
+/*!
+ * Opaque handle of the C API, wrapping an EmbeddedSolver
+ */
+struct madlinsolv_solver {
+    EmbeddedSolver solver;                              /**<the wrapped solver*/
+
+    madlinsolv_solver(int nProcessors, int rank, bool debug) : solver(nProcessors, rank, debug) {}
+};
+
+/*!
+ * It creates a solver. MPI must have been initialized. This function is collective.
+ * \param[in] debug non-zero to enable the PETSc debug
+ * \return the solver, NULL on failure
+ */
+madlinsolv_solver * madlinsolv_create(int debug)
+{
+    int nProcessors;
+    int rank;
+#if ENABLE_MPI==1
+    MPI_Comm_size(MPI_COMM_WORLD, &nProcessors);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#else
+    nProcessors = 1;
+    rank = 0;
+#endif
+
+    return new (std::nothrow) madlinsolv_solver(nProcessors, rank, debug != 0);
+}
+
+/*!
+ * It destroys a solver. This function is collective.
+ * \param[in] solver the solver, possibly NULL
+ */
+void madlinsolv_destroy(madlinsolv_solver *solver)
+{
+    delete solver;
+}
+
+/*!
+ * It assembles the system matrix from the local CSR arrays (see EmbeddedSolver::assemble). This function is collective.
+ * \param[in] solver the solver
+ * \param[in] nLocalRows number of rows (and columns) of the process, possibly zero
+ * \param[in] rowPtr offset of each row in colIdx and values, nLocalRows + 1 elements
+ * \param[in] colIdx global column indices of the rows, possibly NULL if the process has no non-zeros
+ * \param[in] values values of the rows, possibly NULL if the process has no non-zeros
+ * \return MADLINSOLV_SUCCESS or MADLINSOLV_FAILURE
+ */
+int madlinsolv_assemble(madlinsolv_solver *solver, long nLocalRows, const long *rowPtr, const long *colIdx, const double *values)
+{
+    if(!solver) {
+        return MADLINSOLV_FAILURE;
+    }
+
+    return solver->solver.assemble(nLocalRows, rowPtr, colIdx, values) ? MADLINSOLV_SUCCESS : MADLINSOLV_FAILURE;
+}
+
+/*!
+ * It updates the values of the assembled matrix, keeping its pattern (see EmbeddedSolver::update).
+ * This function is collective.
+ * \param[in] solver the solver
+ * \param[in] rowPtr offset of each row in colIdx and values, as given to madlinsolv_assemble
+ * \param[in] colIdx global column indices of the rows, as given to madlinsolv_assemble
+ * \param[in] values new values of the rows
+ * \return MADLINSOLV_SUCCESS or MADLINSOLV_FAILURE
+ */
+int madlinsolv_update(madlinsolv_solver *solver, const long *rowPtr, const long *colIdx, const double *values)
+{
+    if(!solver) {
+        return MADLINSOLV_FAILURE;
+    }
+
+    return solver->solver.update(rowPtr, colIdx, values) ? MADLINSOLV_SUCCESS : MADLINSOLV_FAILURE;
+}
+
+/*!
+ * It solves the system (see EmbeddedSolver::solve). This function is collective.
+ * \param[in] solver the solver
+ * \param[in] rhs local elements of the right-hand side
+ * \param[in,out] solution local elements of the initial guess, overwritten by the solution
+ * \return MADLINSOLV_SUCCESS or MADLINSOLV_FAILURE
+ */
+int madlinsolv_solve(madlinsolv_solver *solver, const double *rhs, double *solution)
+{
+    if(!solver) {
+        return MADLINSOLV_FAILURE;
+    }
+
+    return solver->solver.solve(rhs, solution) ? MADLINSOLV_SUCCESS : MADLINSOLV_FAILURE;
+}
+
+/*!
+ * \param[in] solver the solver
+ * \return the iterations of the last solve, -1 without solver
+ */
+long madlinsolv_get_iterations(const madlinsolv_solver *solver)
+{
+    return solver ? solver->solver.getIterations() : -1;
+}
+
+/*!
+ * \param[in] solver the solver
+ * \return the residual norm of the last solve, -1 without solver
+ */
+double madlinsolv_get_residual(const madlinsolv_solver *solver)
+{
+    return solver ? solver->solver.getResidual() : -1.;
+}
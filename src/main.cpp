@@ -25,6 +25,8 @@
 #    include <mpi.h>
 #endif
 
+#include <string>
+
 #include <bitpit_IO.hpp>
 
 #include "run_manager.hpp"
@@ -69,7 +71,19 @@ int main(int argc, char *argv[])
     //
     // Execution
     //
-    RunManager::execute(nProcessors,rank);
+    // With "--server <socket path>" the system is kept resident and served through a UNIX-domain socket
+    std::string socketPath;
+    for(int i = 1; i < argc; ++i) {
+        if(std::string(argv[i]) == "--server" && i + 1 < argc) {
+            socketPath = argv[++i];
+        }
+    }
+    if(socketPath.empty()) {
+        RunManager::execute(nProcessors,rank);
+    }
+    else {
+        RunManager::serve(nProcessors,rank,socketPath);
+    }
 
 
     //
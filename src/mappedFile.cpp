@@ -0,0 +1,168 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+
+#include "mappedFile.hpp"
+
+/*!
+ * Default constructor
+ * No file is mapped.
+ */
+MappedFile::MappedFile() :
+        m_data(nullptr), m_size(0)
+{
+
+}
+
+/*!
+ * Constructor
+ * It maps the file at the given path. Use isOpen to check the result.
+ * \param[in] path path of the file to be mapped
+ */
+MappedFile::MappedFile(const std::string & path) :
+        m_data(nullptr), m_size(0)
+{
+    open(path);
+}
+
+/*!
+ * Destructor
+ * It releases the mapping, if any.
+ */
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+/*!
+ * It maps read-only the whole file at the given path, releasing any previous mapping.
+ * \param[in] path path of the file to be mapped
+ * \return true if the file has been mapped, false otherwise
+ */
+bool MappedFile::open(const std::string & path)
+{
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if(fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void *address = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    //The mapping keeps its own reference to the file
+    ::close(fd);
+    if(address == MAP_FAILED) {
+        return false;
+    }
+
+    m_data = static_cast<const char *>(address);
+    m_size = static_cast<std::size_t>(info.st_size);
+
+    return true;
+}
+
+/*!
+ * It releases the mapping, if any.
+ */
+void MappedFile::close()
+{
+    if(m_data != nullptr) {
+        munmap(const_cast<char *>(m_data), m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+}
+
+/*!
+ * It checks if a file is currently mapped
+ * \return true if a file is mapped
+ */
+bool MappedFile::isOpen() const
+{
+    return (m_data != nullptr);
+}
+
+/*!
+ * It gets the size of the mapped file
+ * \return the size in bytes of the mapped file
+ */
+std::size_t MappedFile::getSize() const
+{
+    return m_size;
+}
+
+/*!
+ * It gets the mapped bytes
+ * \return a pointer to the first mapped byte
+ */
+const char * MappedFile::getData() const
+{
+    return m_data;
+}
+
+/*!
+ * It hints the kernel that the given byte range will be read sequentially,
+ * so that read-ahead is applied to it. It is only an advice: errors are ignored.
+ * \param[in] offset first byte of the range
+ * \param[in] length number of bytes of the range
+ */
+void MappedFile::adviseSequential(std::size_t offset, std::size_t length) const
+{
+    adviseSequential(m_data, m_size, offset, length);
+}
+
+/*!
+ * It hints the kernel that the given byte range of a memory mapped region will be read sequentially,
+ * so that read-ahead is applied to it. It is only an advice: errors are ignored.
+ * \param[in] data first byte of the region, within a mapping starting at a page boundary
+ * \param[in] size size in bytes of the region
+ * \param[in] offset first byte of the range, from the beginning of the region
+ * \param[in] length number of bytes of the range
+ */
+void MappedFile::adviseSequential(const char * data, std::size_t size, std::size_t offset, std::size_t length)
+{
+    if(data == nullptr || length == 0 || offset >= size) {
+        return;
+    }
+
+    //madvise needs a page aligned address
+    std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    uintptr_t begin = reinterpret_cast<uintptr_t>(data + offset);
+    begin -= begin % pageSize;
+    uintptr_t end = reinterpret_cast<uintptr_t>(data + std::min(offset + length, size));
+
+    madvise(reinterpret_cast<void *>(begin), end - begin, MADV_SEQUENTIAL);
+    madvise(reinterpret_cast<void *>(begin), end - begin, MADV_WILLNEED);
+}
@@ -0,0 +1,68 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_MAPPEDFILE_HPP__
+#define __MADLINSOLV_MAPPEDFILE_HPP__
+
+#include <cstddef>
+#include <string>
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The read-only memory mapped file class
+ *
+ *  This class is intended to
+ *  map a whole file read-only in the process address space.
+ *  Pages are loaded by the operating system only when they are touched, so
+ *  each process pays only for the byte ranges it actually accesses.
+ *  The mapping is released when the object is destroyed.
+ */
+class MappedFile {
+
+public:
+
+    MappedFile();
+    explicit MappedFile(const std::string & path);
+    ~MappedFile();
+
+    MappedFile(MappedFile const&) = delete;
+    MappedFile & operator=(MappedFile const&) = delete;
+
+    bool open(const std::string & path);
+    void close();
+
+    bool isOpen() const;
+    std::size_t getSize() const;
+    const char * getData() const;
+
+    void adviseSequential(std::size_t offset, std::size_t length) const;
+    static void adviseSequential(const char * data, std::size_t size, std::size_t offset, std::size_t length);
+
+private:
+
+    const char *m_data;                                 /**<pointer to the first mapped byte*/
+    std::size_t m_size;                                 /**<size in bytes of the mapped file*/
+
+};
+
+#endif
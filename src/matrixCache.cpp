@@ -0,0 +1,445 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#if ENABLE_MPI==1
+#    include <mpi.h>
+#endif
+
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <bitpit_IO.hpp>
+
+#include "matrixCache.hpp"
+
+using namespace bitpit;
+
+namespace {
+
+/*!
+ * Header of a cache entry file
+ */
+struct MatrixCacheHeader {
+    char     magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t key;
+    int32_t  nProcessors;
+    int32_t  rank;
+    int64_t  nRows;
+    int64_t  nCols;
+    int64_t  nNz;
+    int64_t  nLocalRows;
+    int64_t  nLocalNz;
+};
+
+const char CACHE_MAGIC[8] = {'M', 'L', 'S', 'C', 'A', 'C', '\0', '\1'};
+const uint32_t CACHE_VERSION = 1;
+const std::size_t HEADER_WORDS = sizeof(MatrixCacheHeader) / sizeof(int64_t);
+
+//Blocks of the matrix file hashed into the key, evenly spread from the first to the last byte
+const int KEY_SAMPLES = 16;
+const std::size_t KEY_SAMPLE_SIZE = 4096;
+
+static_assert(sizeof(MatrixCacheHeader) % sizeof(int64_t) == 0, "Cache entry arrays must be 8-byte aligned");
+static_assert(sizeof(long) == sizeof(int64_t), "Cached row pointer and column indices are passed as long without copy");
+
+/*!
+ * It mixes bytes into a 64-bit FNV-1a hash
+ * \param[in] data the bytes
+ * \param[in] size the number of bytes
+ * \param[in,out] hash the hash
+ */
+void mixHash(const void * data, std::size_t size, uint64_t & hash)
+{
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for(std::size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+}
+
+/*!
+ * It gets the header of a loaded entry
+ * \param[in] entry the entry words
+ * \return a copy of the header
+ */
+MatrixCacheHeader readHeader(const std::vector<int64_t> & entry)
+{
+    MatrixCacheHeader header;
+    std::memcpy(&header, entry.data(), sizeof(header));
+
+    return header;
+}
+
+}
+
+/*!
+ * Constructor
+ * No key is computed and no entry is loaded until load is called.
+ * \param[in] nProcessors number of MPI processes
+ * \param[in] rank MPI rank of the process
+ * \param[in] directory directory of the cache entries
+ * \param[in] path path of the matrix file
+ * \param[in] partitionWeight non-zeros weight of the row partition (see RowPartition class)
+ */
+MatrixCache::MatrixCache(int nProcessors, int rank, const std::string & directory, const std::string & path, double partitionWeight) :
+        m_nProcessors(nProcessors), m_rank(rank), m_directory(directory), m_path(path), m_partitionWeight(partitionWeight),
+        m_key(0), m_entry()
+{
+
+}
+
+/*!
+ * It computes the key of the matrix file and loads the entry of the process, if every process finds its own.
+ * Hit or miss is reported in the log. This method is collective.
+ * \return true if the entries have been loaded on all the processes
+ */
+bool MatrixCache::load()
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    m_key = 0;
+    if(m_rank == 0) {
+        m_key = computeKey();
+    }
+#if ENABLE_MPI==1
+    MPI_Bcast(&m_key, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+#endif
+    if(m_key == 0) {
+        log::cout() << "Matrix cache not available, file " << m_path << " cannot be hashed" << std::endl;
+        return false;
+    }
+
+    if(!agree(loadEntry())) {
+        clear();
+        log::cout() << "Matrix cache miss for " << m_path << " (" << getEntryPath() << ")" << std::endl;
+        return false;
+    }
+
+    double megaBytes = static_cast<double>(m_entry.size() * sizeof(int64_t));
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+#if ENABLE_MPI==1
+    MPI_Allreduce(MPI_IN_PLACE, &megaBytes, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+#endif
+    megaBytes /= 1024. * 1024.;
+    log::cout() << "Matrix cache hit for " << m_path << " (" << getEntryPath() << "): "
+            << megaBytes << " MB loaded in " << elapsed << " s" << std::endl;
+
+    return true;
+}
+
+/*!
+ * It stores the local rows of the process into its entry, creating the cache directory if needed.
+ * The key must have been computed by a previous load. This method is collective.
+ * \param[in] nRows global number of rows
+ * \param[in] nCols global number of columns
+ * \param[in] nNz global number of non-zeros
+ * \param[in] partition the row partition of the matrix
+ * \param[in] nLocalRows number of local rows
+ * \param[in] rowPtr offset of each row in colIdx and values, nLocalRows + 1 elements (the first one is not required to be zero)
+ * \param[in] colIdx global column indices of the rows
+ * \param[in] values values of the rows
+ * \return true if the entries have been stored on all the processes
+ */
+bool MatrixCache::store(long nRows, long nCols, long nNz, const RowPartition & partition,
+        long nLocalRows, const long * rowPtr, const long * colIdx, const double * values)
+{
+    if(m_key == 0) {
+        return false;
+    }
+
+    long nzBegin = rowPtr[0];
+    long nLocalNz = rowPtr[nLocalRows] - nzBegin;
+    std::vector<long> nnzStarts(m_nProcessors + 1, 0);
+#if ENABLE_MPI==1
+    MPI_Allgather(&nLocalNz, 1, MPI_LONG, nnzStarts.data() + 1, 1, MPI_LONG, MPI_COMM_WORLD);
+#else
+    nnzStarts[1] = nLocalNz;
+#endif
+    for(int p = 0; p < m_nProcessors; ++p) {
+        nnzStarts[p + 1] += nnzStarts[p];
+    }
+
+    int isCreated = 1;
+    if(m_rank == 0) {
+        isCreated = (mkdir(m_directory.c_str(), 0755) == 0 || errno == EEXIST) ? 1 : 0;
+    }
+#if ENABLE_MPI==1
+    MPI_Bcast(&isCreated, 1, MPI_INT, 0, MPI_COMM_WORLD);
+#endif
+
+    //The entry is written aside and renamed, so that an interrupted run never leaves a truncated entry
+    bool isStored = false;
+    if(isCreated == 1) {
+        MatrixCacheHeader header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+        header.version = CACHE_VERSION;
+        header.key = m_key;
+        header.nProcessors = m_nProcessors;
+        header.rank = m_rank;
+        header.nRows = nRows;
+        header.nCols = nCols;
+        header.nNz = nNz;
+        header.nLocalRows = nLocalRows;
+        header.nLocalNz = nLocalNz;
+
+        std::vector<long> rowStarts = partition.getRowStarts();
+        std::vector<long> localRowPtr(rowPtr, rowPtr + nLocalRows + 1);
+        for(long & offset : localRowPtr) {
+            offset -= nzBegin;
+        }
+
+        std::string tmpPath = getEntryPath() + ".tmp";
+        std::ofstream out(tmpPath.c_str(), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+        if(out.is_open()) {
+            out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char *>(rowStarts.data()), rowStarts.size() * sizeof(long));
+            out.write(reinterpret_cast<const char *>(nnzStarts.data()), nnzStarts.size() * sizeof(long));
+            out.write(reinterpret_cast<const char *>(localRowPtr.data()), localRowPtr.size() * sizeof(long));
+            out.write(reinterpret_cast<const char *>(colIdx + nzBegin), nLocalNz * sizeof(long));
+            out.write(reinterpret_cast<const char *>(values + nzBegin), nLocalNz * sizeof(double));
+            out.close();
+            isStored = out.good() && std::rename(tmpPath.c_str(), getEntryPath().c_str()) == 0;
+        }
+        if(!isStored) {
+            std::remove(tmpPath.c_str());
+        }
+    }
+
+    isStored = agree(isStored);
+    if(isStored) {
+        log::cout() << "Matrix cached in " << getEntryPath() << std::endl;
+    } else {
+        log::cout() << "Matrix could not be cached in " << m_directory << std::endl;
+    }
+
+    return isStored;
+}
+
+/*!
+ * It releases the loaded entry
+ */
+void MatrixCache::clear()
+{
+    std::vector<int64_t>().swap(m_entry);
+}
+
+/*!
+ * \return true if the entry of the process has been loaded
+ */
+bool MatrixCache::isLoaded() const
+{
+    return !m_entry.empty();
+}
+
+/*!
+ * \return the key of the entries, 0 if not computed or if the matrix file is not available
+ */
+uint64_t MatrixCache::getKey() const
+{
+    return m_key;
+}
+
+/*!
+ * It gets the path of the entry of the process, i.e. the key in hexadecimal digits followed by the rank
+ * \return the entry path
+ */
+std::string MatrixCache::getEntryPath() const
+{
+    std::ostringstream path;
+    path << m_directory << "/" << std::hex << std::setw(16) << std::setfill('0') << m_key << std::dec << "." << m_rank << ".mlc";
+
+    return path.str();
+}
+
+/*!
+ * \return the global number of rows of the loaded matrix
+ */
+long MatrixCache::getNRows() const
+{
+    return readHeader(m_entry).nRows;
+}
+
+/*!
+ * \return the global number of columns of the loaded matrix
+ */
+long MatrixCache::getNCols() const
+{
+    return readHeader(m_entry).nCols;
+}
+
+/*!
+ * \return the global number of non-zeros of the loaded matrix
+ */
+long MatrixCache::getNNz() const
+{
+    return readHeader(m_entry).nNz;
+}
+
+/*!
+ * \return the row partition the loaded matrix was cached with, including the non-zeros of each process
+ */
+RowPartition MatrixCache::getPartition() const
+{
+    const int64_t *rowStarts = m_entry.data() + HEADER_WORDS;
+    const int64_t *nnzStarts = rowStarts + m_nProcessors + 1;
+
+    return RowPartition::fromRowStarts(std::vector<long>(rowStarts, rowStarts + m_nProcessors + 1),
+            std::vector<long>(nnzStarts, nnzStarts + m_nProcessors + 1));
+}
+
+/*!
+ * \return the number of local rows of the loaded matrix
+ */
+long MatrixCache::getRowCount() const
+{
+    return readHeader(m_entry).nLocalRows;
+}
+
+/*!
+ * \return the row pointer of the local rows, starting from zero
+ */
+const long * MatrixCache::getRowPtr() const
+{
+    return reinterpret_cast<const long *>(m_entry.data() + HEADER_WORDS + 2 * (m_nProcessors + 1));
+}
+
+/*!
+ * \return the global column indices of the local rows
+ */
+const long * MatrixCache::getColIdx() const
+{
+    return getRowPtr() + getRowCount() + 1;
+}
+
+/*!
+ * \return the values of the local rows
+ */
+const double * MatrixCache::getValues() const
+{
+    return reinterpret_cast<const double *>(getColIdx() + readHeader(m_entry).nLocalNz);
+}
+
+/*!
+ * It computes the key of the matrix file from its size, its modification time and KEY_SAMPLES blocks of its content,
+ * together with the number of processes and the row partition weight
+ * \return the key, 0 if the matrix file is not available
+ */
+uint64_t MatrixCache::computeKey() const
+{
+    struct stat info;
+    if(stat(m_path.c_str(), &info) != 0) {
+        return 0;
+    }
+    uint64_t size = static_cast<uint64_t>(info.st_size);
+    int64_t mtime = static_cast<int64_t>(info.st_mtime);
+
+    uint64_t hash = 14695981039346656037ULL;
+    mixHash(&CACHE_VERSION, sizeof(CACHE_VERSION), hash);
+    mixHash(&size, sizeof(size), hash);
+    mixHash(&mtime, sizeof(mtime), hash);
+    mixHash(&m_nProcessors, sizeof(m_nProcessors), hash);
+    mixHash(&m_partitionWeight, sizeof(m_partitionWeight), hash);
+
+    std::FILE *in = std::fopen(m_path.c_str(), "rb");
+    if(in == nullptr) {
+        return 0;
+    }
+    std::vector<char> block(KEY_SAMPLE_SIZE);
+    uint64_t span = (size > KEY_SAMPLE_SIZE) ? size - KEY_SAMPLE_SIZE : 0;
+    for(int k = 0; k < KEY_SAMPLES; ++k) {
+        uint64_t offset = span * k / (KEY_SAMPLES - 1);
+        if(std::fseek(in, static_cast<long>(offset), SEEK_SET) != 0) {
+            break;
+        }
+        std::size_t nRead = std::fread(block.data(), 1, block.size(), in);
+        mixHash(block.data(), nRead, hash);
+        if(span == 0) {
+            break;
+        }
+    }
+    std::fclose(in);
+
+    return (hash != 0) ? hash : 1;
+}
+
+/*!
+ * It loads the entry of the process with one sequential read and checks it against the key
+ * \return true if a valid entry has been loaded
+ */
+bool MatrixCache::loadEntry()
+{
+    std::string path = getEntryPath();
+    struct stat info;
+    if(stat(path.c_str(), &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(MatrixCacheHeader)
+            || info.st_size % sizeof(int64_t) != 0) {
+        return false;
+    }
+    std::size_t size = static_cast<std::size_t>(info.st_size);
+
+    std::FILE *in = std::fopen(path.c_str(), "rb");
+    if(in == nullptr) {
+        return false;
+    }
+    m_entry.resize(size / sizeof(int64_t));
+    bool isRead = (std::fread(m_entry.data(), 1, size, in) == size);
+    std::fclose(in);
+
+    bool isValid = false;
+    if(isRead) {
+        MatrixCacheHeader header = readHeader(m_entry);
+        isValid = std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0 && header.version == CACHE_VERSION
+                && header.key == m_key && header.nProcessors == m_nProcessors && header.rank == m_rank
+                && header.nLocalRows >= 0 && header.nLocalNz >= 0
+                && m_entry.size() == HEADER_WORDS + 2 * (m_nProcessors + 1) + (header.nLocalRows + 1) + 2 * header.nLocalNz;
+    }
+    if(!isValid) {
+        clear();
+    }
+
+    return isValid;
+}
+
+/*!
+ * It checks that a step succeeded on all the processes. This method is collective.
+ * \param[in] isDone true if the step succeeded on the process
+ * \return true if the step succeeded on all the processes
+ */
+bool MatrixCache::agree(bool isDone) const
+{
+    int isDoneEverywhere = isDone ? 1 : 0;
+#if ENABLE_MPI==1
+    MPI_Allreduce(MPI_IN_PLACE, &isDoneEverywhere, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+#endif
+
+    return isDoneEverywhere == 1;
+}
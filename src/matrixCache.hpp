@@ -0,0 +1,98 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_MATRIXCACHE_HPP__
+#define __MADLINSOLV_MATRIXCACHE_HPP__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "rowPartition.hpp"
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The matrix cache class
+ *
+ *  This class is intended to
+ *  skip parsing and partitioning when the same ASCII CSR matrix is read again by a later run, e.g. with another
+ *  right-hand side or other solver settings. Each process keeps its local rows in a binary entry of the cache directory,
+ *  which the next run loads with a single sequential read and commits to the SparseMatrix as they are.
+ *  Entries are content addressed: their key is a fast hash of the size, the modification time and sampled blocks
+ *  of the matrix file, together with the number of processes and the row partition weight, so that a changed matrix
+ *  or a different layout simply misses. Only the first process touches the matrix file to compute the key.
+ *  A run hits only if every process loads its entry, otherwise the matrix is read from the file and cached again.
+ *  Stale entries are never removed: the directory can be cleared at any time.
+ *  \verbatim
+ *                              cache entry file format (binary, one per process)
+ *           -------------------------------------------------------------------------
+ *  header   | signature, version, key, number of processes, rank,                    |
+ *           | global rows, columns and non-zeros, local rows and non-zeros           |
+ *  layout   | int64[nProcessors + 1] first row, int64[nProcessors + 1] first non-zero |
+ *  rows     | int64[local rows + 1] row pointer, int64[local non-zeros] columns,      |
+ *           | double[local non-zeros] values                                          |
+ *           -------------------------------------------------------------------------
+ *  \endverbatim
+ */
+class MatrixCache {
+
+public:
+
+    MatrixCache(int nProcessors, int rank, const std::string & directory, const std::string & path, double partitionWeight);
+
+    bool load();
+    bool store(long nRows, long nCols, long nNz, const RowPartition & partition,
+            long nLocalRows, const long * rowPtr, const long * colIdx, const double * values);
+    void clear();
+
+    bool isLoaded() const;
+    uint64_t getKey() const;
+    std::string getEntryPath() const;
+
+    long getNRows() const;
+    long getNCols() const;
+    long getNNz() const;
+    RowPartition getPartition() const;
+    long getRowCount() const;
+    const long * getRowPtr() const;
+    const long * getColIdx() const;
+    const double * getValues() const;
+
+private:
+
+    uint64_t computeKey() const;
+    bool loadEntry();
+    bool agree(bool isDone) const;
+
+    int m_nProcessors;                                  /**<number of MPI processes*/
+    int m_rank;                                         /**<MPI rank of the process*/
+    std::string m_directory;                            /**<directory of the cache entries*/
+    std::string m_path;                                 /**<path of the cached matrix file*/
+    double m_partitionWeight;                           /**<non-zeros weight of the row partition, part of the key*/
+
+    uint64_t m_key;                                     /**<key of the entries, 0 if the matrix file is not available*/
+    std::vector<int64_t> m_entry;                       /**<loaded entry of the process, empty if not loaded*/
+
+};
+
+#endif
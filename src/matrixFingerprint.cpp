@@ -0,0 +1,195 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#if ENABLE_MPI==1
+#    include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "matrixFingerprint.hpp"
+
+/*!
+ * Default constructor
+ */
+MatrixFingerprint::MatrixFingerprint() :
+        m_isComputed(false), m_nRows(0), m_nNz(0), m_symmetry(0.), m_diagonalDominance(0.),
+        m_minDiagonalRatio(0.), m_positiveDiagonal(0.)
+{
+
+}
+
+/*!
+ * It computes the fingerprint from the local rows of the process. This method is collective.
+ * The transposed entry of a non-zero is looked for only if its column belongs to the local rows,
+ * in a copy of the rows sorted by column.
+ * \param[in] nRows number of local rows
+ * \param[in] rowPtr offset of each row in colIdx, nRows + 1 elements (the first one is not required to be zero)
+ * \param[in] colIdx global column indices of the rows
+ * \param[in] values values of the non-zeros
+ * \param[in] rowStart first global row of the process
+ */
+void MatrixFingerprint::compute(long nRows, const long * rowPtr, const long * colIdx, const double * values, long rowStart)
+{
+    long nzBegin = rowPtr[0];
+    std::vector<std::pair<long, double>> sorted(rowPtr[nRows] - nzBegin);
+    for(long nz = nzBegin; nz < rowPtr[nRows]; ++nz) {
+        sorted[nz - nzBegin] = std::make_pair(colIdx[nz], values[nz]);
+    }
+    for(long row = 0; row < nRows; ++row) {
+        std::sort(sorted.begin() + (rowPtr[row] - nzBegin), sorted.begin() + (rowPtr[row + 1] - nzBegin));
+    }
+
+    //Counts are rows, non-zeros, local off-diagonal non-zeros, matched ones, dominant rows and positive diagonals
+    long counts[6] = {nRows, rowPtr[nRows] - nzBegin, 0, 0, 0, 0};
+    double minRatio = std::numeric_limits<double>::max();
+    for(long row = 0; row < nRows; ++row) {
+        long globalRow = rowStart + row;
+        double diagonal = 0.;
+        double offDiagonalSum = 0.;
+        for(long nz = rowPtr[row]; nz < rowPtr[row + 1]; ++nz) {
+            long col = colIdx[nz];
+            if(col == globalRow) {
+                diagonal += values[nz];
+                continue;
+            }
+            offDiagonalSum += std::abs(values[nz]);
+            if(col < rowStart || col >= rowStart + nRows) {
+                continue;
+            }
+
+            ++counts[2];
+            std::vector<std::pair<long, double>>::const_iterator begin = sorted.begin() + (rowPtr[col - rowStart] - nzBegin);
+            std::vector<std::pair<long, double>>::const_iterator end = sorted.begin() + (rowPtr[col - rowStart + 1] - nzBegin);
+            std::vector<std::pair<long, double>>::const_iterator transposed = std::lower_bound(begin, end,
+                    std::make_pair(globalRow, -std::numeric_limits<double>::max()));
+            if(transposed != end && transposed->first == globalRow
+                    && std::abs(transposed->second - values[nz]) <= 1.e-12 * std::max(std::abs(transposed->second), std::abs(values[nz]))) {
+                ++counts[3];
+            }
+        }
+        if(std::abs(diagonal) >= offDiagonalSum) {
+            ++counts[4];
+        }
+        if(diagonal > 0.) {
+            ++counts[5];
+        }
+        if(offDiagonalSum > 0.) {
+            minRatio = std::min(minRatio, std::abs(diagonal) / offDiagonalSum);
+        }
+    }
+
+#if ENABLE_MPI==1
+    MPI_Allreduce(MPI_IN_PLACE, counts, 6, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &minRatio, 1, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+#endif
+
+    m_nRows = counts[0];
+    m_nNz = counts[1];
+    m_symmetry = (counts[2] > 0) ? static_cast<double>(counts[3]) / counts[2] : 1.;
+    m_diagonalDominance = (counts[0] > 0) ? static_cast<double>(counts[4]) / counts[0] : 0.;
+    m_minDiagonalRatio = minRatio;
+    m_positiveDiagonal = (counts[0] > 0) ? static_cast<double>(counts[5]) / counts[0] : 0.;
+    m_isComputed = true;
+}
+
+/*!
+ * It gets if the fingerprint has been computed
+ * \return true if compute has been called
+ */
+bool MatrixFingerprint::isComputed() const
+{
+    return m_isComputed;
+}
+
+/*!
+ * It gets the global number of rows
+ * \return the number of rows
+ */
+long MatrixFingerprint::getRowGlobalCount() const
+{
+    return m_nRows;
+}
+
+/*!
+ * It gets the global number of non-zeros
+ * \return the number of non-zeros
+ */
+long MatrixFingerprint::getNonZeroGlobalCount() const
+{
+    return m_nNz;
+}
+
+/*!
+ * It gets the estimated symmetry
+ * \return the fraction of off-diagonal non-zeros matched by their transposed entry, 1 for a symmetric matrix
+ */
+double MatrixFingerprint::getSymmetry() const
+{
+    return m_symmetry;
+}
+
+/*!
+ * It gets the diagonal dominance
+ * \return the fraction of diagonally dominant rows
+ */
+double MatrixFingerprint::getDiagonalDominance() const
+{
+    return m_diagonalDominance;
+}
+
+/*!
+ * It gets the smallest ratio between the diagonal magnitude and the off-diagonal magnitudes sum of a row
+ * \return the ratio, the largest double if no row has off-diagonal non-zeros
+ */
+double MatrixFingerprint::getMinDiagonalRatio() const
+{
+    return m_minDiagonalRatio;
+}
+
+/*!
+ * It gets the fraction of rows with a positive diagonal
+ * \return the fraction, 1 if all the diagonal elements are positive
+ */
+double MatrixFingerprint::getPositiveDiagonal() const
+{
+    return m_positiveDiagonal;
+}
+
+/*!
+ * It gets the key of the fingerprint, made of the sizes and of the fractions rounded to two digits
+ * \return the key, without blanks
+ */
+std::string MatrixFingerprint::getKey() const
+{
+    std::ostringstream key;
+    key << m_nRows << "x" << m_nNz << std::fixed << std::setprecision(2) << "-s" << m_symmetry << "-d" << m_diagonalDominance
+            << "-p" << m_positiveDiagonal;
+
+    return key.str();
+}
@@ -0,0 +1,75 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_MATRIXFINGERPRINT_HPP__
+#define __MADLINSOLV_MATRIXFINGERPRINT_HPP__
+
+#include <string>
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The matrix fingerprint class
+ *
+ *  This class is intended to
+ *  summarize the properties of a matrix that drive the choice of the Krylov method and of the preconditioner,
+ *  so that solvers tuned on a matrix can be reused for matrices alike (see SolverTuner class).
+ *  The fingerprint is computed from the local rows of every process while they are read (see MatrixReader::setRowsInspector)
+ *  and it holds:
+ *   - the global numbers of rows and non-zeros
+ *   - the symmetry, i.e. the fraction of off-diagonal non-zeros whose transposed entry has the same value;
+ *     since no rows are exchanged, it is estimated on the diagonal block of every process
+ *   - the diagonal dominance, i.e. the fraction of rows whose diagonal magnitude is not smaller than the sum
+ *     of the off-diagonal ones, and the smallest ratio between the two
+ *   - the fraction of rows with a positive diagonal
+ *  Its key rounds the fractions to two digits, so that small changes of the values do not change it.
+ */
+class MatrixFingerprint {
+
+public:
+
+    MatrixFingerprint();
+
+    void compute(long nRows, const long * rowPtr, const long * colIdx, const double * values, long rowStart);
+
+    bool isComputed() const;
+    long getRowGlobalCount() const;
+    long getNonZeroGlobalCount() const;
+    double getSymmetry() const;
+    double getDiagonalDominance() const;
+    double getMinDiagonalRatio() const;
+    double getPositiveDiagonal() const;
+    std::string getKey() const;
+
+private:
+
+    bool m_isComputed;                                  /**<true once the fingerprint has been computed*/
+    long m_nRows;                                       /**<global number of rows*/
+    long m_nNz;                                         /**<global number of non-zeros*/
+    double m_symmetry;                                  /**<fraction of off-diagonal non-zeros matched by their transposed entry*/
+    double m_diagonalDominance;                         /**<fraction of diagonally dominant rows*/
+    double m_minDiagonalRatio;                          /**<smallest ratio between the diagonal and the off-diagonal sum of a row*/
+    double m_positiveDiagonal;                          /**<fraction of rows with a positive diagonal*/
+
+};
+
+#endif
@@ -0,0 +1,466 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#if ENABLE_MPI==1
+#    include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include <bitpit_IO.hpp>
+#include <bitpit_LA.hpp>
+
+#include "matrixMarketReader.hpp"
+#include "localCSR.hpp"
+#include "tokenizer.hpp"
+
+using namespace bitpit;
+
+const char MatrixMarketReader::BANNER[] = "%%MatrixMarket";
+
+/*!
+ * It checks if the file at the given path starts with the Matrix Market banner
+ * \param[in] path path of the file to be checked
+ * \return true if the file is a Matrix Market file
+ */
+bool MatrixMarketReader::hasBanner(const std::string & path)
+{
+    char buffer[sizeof(BANNER) - 1];
+    std::ifstream file(path.c_str(), std::ifstream::in | std::ifstream::binary);
+    if(!file.read(buffer, sizeof(buffer))) {
+        return false;
+    }
+
+    return (std::memcmp(buffer, BANNER, sizeof(buffer)) == 0);
+}
+
+/*!
+ * Constructor
+ * It sets m_nProcessors and m_rank to values passed from the caller
+ * File_Handler is constructed with folder, file name and extension from the caller.
+ * Sizes are set to zero.
+ * \param[in] nProcessors number of MPI processes
+ * \param[in] rank process MPI rank
+ * \param[in] dir_ matrix folder name
+ * \param[in] name_ matrix file name
+ * \param[in] app_ matrix file extension
+ */
+MatrixMarketReader::MatrixMarketReader(int nProcessors, int rank, const std::string & dir_, const std::string & name_, const std::string & app_) :
+        m_nProcessors(nProcessors), m_rank(rank), m_fileHandler(dir_,name_,app_),
+        m_inputOptions(), m_partition(), m_nRows(0), m_nCols(0), m_nNz(0), m_nEntries(0), m_symmetric(false)
+{
+
+}
+
+/*!
+ * It reads the matrix from disk, populates and assemblies bitpit SparseMatrix objects.
+ * The first process reads banner and size line, then each process parses the entries of its own byte range
+ * and the entries are routed to the processes owning their rows.
+ * \param[in] matrix a reference to the unique pointer to the bitpit SparseMatrix to be filled
+ */
+void MatrixMarketReader::read(std::unique_ptr<SparseMatrix> & matrix)
+{
+    log::cout() << "Matrix path: " << m_fileHandler.getPath() << std::endl;
+
+    //Only the first process reads the header
+    int isValid = 0;
+    uint64_t offsets[2] = {0, 0};
+    if(m_rank == 0) {
+        std::ifstream inMatrix(m_fileHandler.getPath().c_str(), std::ifstream::in | std::ifstream::binary);
+        if(inMatrix.is_open()) {
+            isValid = readInfo(inMatrix) ? 1 : 0;
+            offsets[0] = static_cast<uint64_t>(inMatrix.tellg());
+            inMatrix.seekg(0, std::ifstream::end);
+            offsets[1] = static_cast<uint64_t>(inMatrix.tellg());
+        } else {
+            log::cout() << "File " << m_fileHandler.getPath() << " not open!" << std::endl;
+        }
+    }
+#if ENABLE_MPI==1
+    long info[5] = {isValid, m_nRows, m_nCols, m_nEntries, m_symmetric ? 1 : 0};
+    MPI_Bcast(info, 5, MPI_LONG, 0, MPI_COMM_WORLD);
+    isValid = static_cast<int>(info[0]);
+    m_nRows = static_cast<int>(info[1]);
+    m_nCols = static_cast<int>(info[2]);
+    m_nEntries = info[3];
+    m_symmetric = (info[4] == 1);
+    MPI_Bcast(offsets, 2, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+#endif
+    if(!isValid) {
+#if ENABLE_MPI == 1
+        MPI_Finalize();
+#endif
+        exit(1);
+    }
+
+    //Parse the entries whose line starts in the process byte range
+    uint64_t bodySize = offsets[1] - offsets[0];
+    uint64_t begin = offsets[0] + bodySize * m_rank / m_nProcessors;
+    uint64_t end = offsets[0] + bodySize * (m_rank + 1) / m_nProcessors;
+
+    std::vector<Entry> entries;
+    std::ifstream inMatrix(m_fileHandler.getPath().c_str(), std::ifstream::in | std::ifstream::binary);
+    long nParsed = readEntries(inMatrix, begin, end, entries);
+    inMatrix.close();
+
+    //A truncated file, or lines which are not entries, would silently give a different matrix
+#if ENABLE_MPI==1
+    MPI_Allreduce(MPI_IN_PLACE, &nParsed, 1, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+#endif
+    if(nParsed != m_nEntries) {
+        log::cout() << "Parsed " << nParsed << " entries, the size line declares " << m_nEntries
+                << ". Please, check file " << m_fileHandler.getPath() << std::endl;
+#if ENABLE_MPI == 1
+        MPI_Finalize();
+#endif
+        exit(1);
+    }
+
+    //Route the entries to the processes owning their rows
+    RowPartition initial = RowPartition::uniform(m_nRows, m_nProcessors);
+#if ENABLE_MPI==1
+    exchangeEntries(entries, initial.getRowStarts());
+#endif
+
+    //With balanced non-zeros, the row lengths are known once the entries are merged, then they are routed again
+    if(m_inputOptions.partitionWeight > 0.) {
+        sortEntries(entries);
+        long startRow = initial.getRowStart(m_rank);
+        std::vector<long> rowNnz(initial.getRowCount(m_rank), 0);
+        for(const Entry & entry : entries) {
+            ++rowNnz[entry.row - startRow];
+        }
+        m_partition = RowPartition::balance(initial, m_rank, rowNnz, m_inputOptions.partitionWeight);
+#if ENABLE_MPI==1
+        exchangeEntries(entries, m_partition.getRowStarts());
+#endif
+    } else {
+        m_partition = initial;
+    }
+    log::cout() << "rows per proc = " << m_partition.getRowCounts() << std::endl;
+
+    fillMatrix(entries, m_partition.getRowStart(m_rank), m_partition.getRowCount(m_rank), matrix);
+}
+
+/*!
+ * It reads banner and size line from file, checking that the matrix type is supported
+ * \param fileStream the stream from the matrix file
+ * \return true if the matrix is a supported coordinate matrix
+ */
+bool MatrixMarketReader::readInfo(std::istream & fileStream)
+{
+    std::string line;
+    std::getline(fileStream,line);
+    std::transform(line.begin(), line.end(), line.begin(), [](unsigned char c) { return std::tolower(c); });
+
+    std::stringstream banner(line);
+    std::string tag, object, format, field, symmetry;
+    banner >> tag >> object >> format >> field >> symmetry;
+    if(tag != "%%matrixmarket" || object != "matrix" || format != "coordinate") {
+        log::cout() << "Only Matrix Market coordinate matrices are supported. Please, check file " << m_fileHandler.getPath() << std::endl;
+        return false;
+    }
+    if(field != "real" && field != "integer" && field != "double") {
+        log::cout() << "Matrix Market field " << field << " is not supported. Please, check file " << m_fileHandler.getPath() << std::endl;
+        return false;
+    }
+    if(symmetry != "general" && symmetry != "symmetric") {
+        log::cout() << "Matrix Market symmetry " << symmetry << " is not supported. Please, check file " << m_fileHandler.getPath() << std::endl;
+        return false;
+    }
+    m_symmetric = (symmetry == "symmetric");
+
+    while(std::getline(fileStream,line)) {
+        line = utils::string::trim(line);
+        if(!line.empty() && line.substr(0,1) != "%") {
+            std::stringstream ss(line);
+            ss >> m_nRows;
+            ss >> m_nCols;
+            ss >> m_nEntries;
+            break;
+        }
+    }
+    log::cout() << "nRows = " << m_nRows << std::endl;
+    log::cout() << "nCols = " << m_nCols << std::endl;
+    log::cout() << "nEntries = " << m_nEntries << (m_symmetric ? " (symmetric)" : " (general)") << std::endl;
+
+    return true;
+}
+
+/*!
+ * It parses the entries whose line starts in the given byte range.
+ * A line crossing the end of the range belongs to this process, a line crossing its beginning to the previous one.
+ * \param[in] fileStream the stream from the matrix file
+ * \param[in] begin first byte of the range
+ * \param[in] end byte after the last one of the range
+ * \param[out] entries the parsed entries, with zero-based indices and mirrored entries for symmetric matrices
+ * \return the number of parsed entry lines, including those out of matrix bounds
+ */
+long MatrixMarketReader::readEntries(std::istream & fileStream, uint64_t begin, uint64_t end, std::vector<Entry> & entries)
+{
+    //Move to the first line starting in the range
+    uint64_t position = begin;
+    if(m_rank > 0) {
+        fileStream.seekg(static_cast<std::streamoff>(begin - 1));
+        if(fileStream.get() != '\n') {
+            fileStream.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        }
+        position = static_cast<uint64_t>(fileStream.tellg());
+    } else {
+        fileStream.seekg(static_cast<std::streamoff>(begin));
+    }
+
+    long nParsed = 0;
+    long nUnparsed = 0;
+    long nInvalid = 0;
+    Tokenizer tokenizer(fileStream);
+    const char *line, *lineEnd;
+    while(position + tokenizer.getConsumedBytes() < end && tokenizer.nextLine(&line, &lineEnd)) {
+        long row, col;
+        double value;
+        const char *cursor = Tokenizer::skipBlanks(line, lineEnd);
+        if(cursor == lineEnd || *cursor == '%') {
+            continue;
+        }
+        if((cursor = Tokenizer::parseLong(cursor, lineEnd, &row)) == nullptr
+                || (cursor = Tokenizer::parseLong(Tokenizer::skipBlanks(cursor, lineEnd), lineEnd, &col)) == nullptr
+                || Tokenizer::parseDouble(Tokenizer::skipBlanks(cursor, lineEnd), lineEnd, &value) == nullptr) {
+            ++nUnparsed;
+            continue;
+        }
+
+        ++nParsed;
+        if(row < 1 || row > m_nRows || col < 1 || col > m_nCols) {
+            ++nInvalid;
+            continue;
+        }
+
+        entries.push_back(Entry{row - 1, col - 1, value});
+        if(m_symmetric && row != col) {
+            entries.push_back(Entry{col - 1, row - 1, value});
+        }
+    }
+
+    if(nUnparsed > 0) {
+        log::cout() << "Skipped " << nUnparsed << " lines which are not entries. Please, check file " << m_fileHandler.getPath() << std::endl;
+    }
+    if(nInvalid > 0) {
+        log::cout() << "Skipped " << nInvalid << " entries out of matrix bounds. Please, check file " << m_fileHandler.getPath() << std::endl;
+    }
+
+    return nParsed;
+}
+
+#if ENABLE_MPI==1
+/*!
+ * It sends each entry to the process owning its row
+ * \param[in,out] entries on input the parsed entries, on output the entries of the process rows
+ * \param[in] rowStarts a vector of m_nProcessors+1 elements containing the first row of each process
+ */
+void MatrixMarketReader::exchangeEntries(std::vector<Entry> & entries, const std::vector<long> & rowStarts)
+{
+    //Sort the entries by owner, counting them in Entry units
+    std::vector<int> owners(entries.size());
+    std::vector<long> sendCounts(m_nProcessors, 0);
+    for(std::size_t e = 0; e < entries.size(); ++e) {
+        owners[e] = static_cast<int>(std::upper_bound(rowStarts.begin(), rowStarts.end(), entries[e].row) - rowStarts.begin()) - 1;
+        ++sendCounts[owners[e]];
+    }
+
+    std::vector<long> sendDispls(m_nProcessors, 0);
+    for(int p = 1; p < m_nProcessors; ++p) {
+        sendDispls[p] = sendDispls[p - 1] + sendCounts[p - 1];
+    }
+
+    std::vector<Entry> sendBuffer(entries.size());
+    std::vector<long> cursor(sendDispls);
+    for(std::size_t e = 0; e < entries.size(); ++e) {
+        sendBuffer[cursor[owners[e]]++] = entries[e];
+    }
+    std::vector<Entry>().swap(entries);
+    std::vector<int>().swap(owners);
+
+    //Exchange
+    std::vector<long> recvCounts(m_nProcessors, 0);
+    MPI_Alltoall(sendCounts.data(), 1, MPI_LONG, recvCounts.data(), 1, MPI_LONG, MPI_COMM_WORLD);
+
+    std::vector<long> recvDispls(m_nProcessors, 0);
+    for(int p = 1; p < m_nProcessors; ++p) {
+        recvDispls[p] = recvDispls[p - 1] + recvCounts[p - 1];
+    }
+    long nReceived = recvDispls[m_nProcessors - 1] + recvCounts[m_nProcessors - 1];
+
+    //Counts and displacements of MPI_Alltoallv are int, so that each process can send and receive at most INT_MAX entries
+    const long maxEntries = std::numeric_limits<int>::max();
+    int isValid = (static_cast<long>(sendBuffer.size()) <= maxEntries && nReceived <= maxEntries) ? 1 : 0;
+    MPI_Allreduce(MPI_IN_PLACE, &isValid, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    if(!isValid) {
+        log::cout() << "More than " << maxEntries << " entries to be exchanged by a process. Please, run file "
+                << m_fileHandler.getPath() << " with more processes" << std::endl;
+        MPI_Finalize();
+        exit(1);
+    }
+
+    std::vector<int> sendEntries(sendCounts.begin(), sendCounts.end());
+    std::vector<int> sendOffsets(sendDispls.begin(), sendDispls.end());
+    std::vector<int> recvEntries(recvCounts.begin(), recvCounts.end());
+    std::vector<int> recvOffsets(recvDispls.begin(), recvDispls.end());
+
+    MPI_Datatype entryType;
+    MPI_Type_contiguous(sizeof(Entry), MPI_BYTE, &entryType);
+    MPI_Type_commit(&entryType);
+    entries.resize(nReceived);
+    MPI_Alltoallv(sendBuffer.data(), sendEntries.data(), sendOffsets.data(), entryType,
+            entries.data(), recvEntries.data(), recvOffsets.data(), entryType, MPI_COMM_WORLD);
+    MPI_Type_free(&entryType);
+}
+#endif
+
+/*!
+ * It sorts the entries by row and column, summing duplicated entries
+ * \param[in,out] entries the entries to be sorted and merged
+ */
+void MatrixMarketReader::sortEntries(std::vector<Entry> & entries)
+{
+    std::sort(entries.begin(), entries.end(), [](const Entry & a, const Entry & b) {
+        return (a.row < b.row) || (a.row == b.row && a.col < b.col);
+    });
+
+    std::size_t nMerged = 0;
+    for(std::size_t e = 0; e < entries.size(); ++e) {
+        if(nMerged > 0 && entries[e].row == entries[nMerged - 1].row && entries[e].col == entries[nMerged - 1].col) {
+            entries[nMerged - 1].value += entries[e].value;
+        } else {
+            entries[nMerged++] = entries[e];
+        }
+    }
+    entries.resize(nMerged);
+}
+
+/*!
+ * It fills and assemblies the bitpit SparseMatrix with the entries of the process rows.
+ * Entries are sorted by row and column; duplicated entries are summed.
+ * The matrix is created with the exact number of local non-zeros and filled with a single commit
+ * (see LocalCSR class for details). This method is collective.
+ * \param[in] entries the entries of the process rows, they are sorted in place
+ * \param[in] startRow first global row of the process
+ * \param[in] nLocalRows number of rows of the process
+ * \param[in] matrix a reference to the unique pointer to the bitpit SparseMatrix to be filled
+ */
+void MatrixMarketReader::fillMatrix(std::vector<Entry> & entries, long startRow, long nLocalRows, std::unique_ptr<SparseMatrix> & matrix)
+{
+    sortEntries(entries);
+
+    //Convert to contiguous CSR arrays
+    std::vector<long> rowPtr(nLocalRows + 1, 0);
+    std::vector<long> colIdx(entries.size());
+    std::vector<double> values(entries.size());
+    for(std::size_t e = 0; e < entries.size(); ++e) {
+        colIdx[e] = entries[e].col;
+        values[e] = entries[e].value;
+        ++rowPtr[entries[e].row - startRow + 1];
+    }
+    std::vector<Entry>().swap(entries);
+
+    for(long row = 0; row < nLocalRows; ++row) {
+        rowPtr[row + 1] += rowPtr[row];
+    }
+
+    m_nNz = static_cast<int>(colIdx.size());
+#if ENABLE_MPI==1
+    MPI_Allreduce(MPI_IN_PLACE, &m_nNz, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+#endif
+    log::cout() << "nNz = " << m_nNz << std::endl;
+
+    LocalCSR::commit(nLocalRows, rowPtr.data(), colIdx.data(), values.data(), startRow, m_nNz / m_nProcessors, matrix,
+            m_rowsConsumer);
+}
+
+/*!
+ * It sets the input settings
+ * \param[in] options input settings from the dictionary
+ */
+void MatrixMarketReader::setInputOptions(const InputOptions & options)
+{
+    m_inputOptions = options;
+}
+
+/*!
+ * It sets the consumer of the local rows: if set, the read method hands the rows to it
+ * in place of creating the SparseMatrix, which is left untouched
+ * \param[in] consumer the consumer of the local rows, an empty one restores the SparseMatrix creation
+ */
+void MatrixMarketReader::setRowsConsumer(const LocalCSR::Consumer & consumer)
+{
+    m_rowsConsumer = consumer;
+}
+
+/*!
+ * It gets the row partition among processes, computed while reading the matrix
+ * @return a constant reference to the row partition
+ */
+const RowPartition & MatrixMarketReader::getPartition() const
+{
+    return m_partition;
+}
+
+/*!
+ * It gets the matrix file path from the file handler
+ * @return a string containing the file path
+ */
+std::string MatrixMarketReader::getPath()
+{
+    return m_fileHandler.getPath();
+}
+
+/*!
+ * It gets the global number of matrix rows as read in the size line
+ * @return the global number of matrix rows
+ */
+int MatrixMarketReader::getNRows()
+{
+    return m_nRows;
+}
+
+/*!
+ * It gets the global number of matrix columns as read in the size line
+ * @return the global number of matrix columns
+ */
+int MatrixMarketReader::getNCols()
+{
+    return m_nCols;
+}
+
+/*!
+ * It gets the global number of non-zeros, mirrored entries of symmetric matrices included
+ * @return the global number of non-zeros
+ */
+int MatrixMarketReader::getNNz()
+{
+    return m_nNz;
+}
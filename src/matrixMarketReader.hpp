@@ -0,0 +1,124 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_MATRIXMARKETREADER_HPP__
+#define __MADLINSOLV_MATRIXMARKETREADER_HPP__
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <bitpit_IO.hpp>
+#include <bitpit_LA.hpp>
+
+#include "inputOptions.hpp"
+#include "localCSR.hpp"
+#include "rowPartition.hpp"
+
+using namespace bitpit;
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The Matrix Market matrix reader class
+ *
+ *  This class is intended to
+ *  read from the disk a matrix in Matrix Market coordinate format, real (or integer) general or symmetric,
+ *  feeding the bitpit SparseMatrix directly without any serial conversion:
+ *
+ *  \verbatim
+ *                                  Matrix Market file format
+ *            -----------------------------------------------------------------------------
+ *  line 1    | %%MatrixMarket matrix coordinate real general/symmetric                   | ---> banner
+ *  ...       | % comments                                                                |
+ *  line k    | global_number_of_rows global_number_of_columns number_of_entries          | ---> size
+ *  line k+1  | row_1 column_1 value_1                                                    | ---
+ *  ...       | ...                                                                       |   | ---> body (1-based indices,
+ *  line k+L  | row_L column_L value_L                                                    | ---       any order)
+ *            -----------------------------------------------------------------------------
+ *  \endverbatim
+ *
+ *  The body is split in equal byte ranges among the processes; each process parses the entries whose line starts
+ *  in its own range and sends them to the process owning their row. Symmetric matrices store only one triangle:
+ *  the mirrored entries are generated while parsing.
+ *  Rows are distributed among the processes by a RowPartition, shared with the right-hand side and solution readers.
+ *  With balanced non-zeros, entries are first routed to an equal rows partition, where the row lengths are counted,
+ *  and then to the balanced one.
+ */
+class MatrixMarketReader {
+
+public:
+
+    static const char BANNER[];
+
+    static bool hasBanner(const std::string & path);
+
+    MatrixMarketReader(int nProcessors, int rank, const std::string & dir_, const std::string & name_, const std::string & app_);
+
+    void read(std::unique_ptr<SparseMatrix> & matrix);
+
+    void setInputOptions(const InputOptions & options);
+    void setRowsConsumer(const LocalCSR::Consumer & consumer);
+
+    std::string getPath();
+    int getNRows();
+    int getNCols();
+    int getNNz();
+    const RowPartition & getPartition() const;
+
+private:
+
+    /*!
+     * Matrix entry with global zero-based indices
+     */
+    struct Entry {
+        long row;                                       /**<global row index*/
+        long col;                                       /**<global column index*/
+        double value;                                   /**<entry value*/
+    };
+
+    bool readInfo(std::istream & fileStream);
+    long readEntries(std::istream & fileStream, uint64_t begin, uint64_t end, std::vector<Entry> & entries);
+#if ENABLE_MPI==1
+    void exchangeEntries(std::vector<Entry> & entries, const std::vector<long> & rowStarts);
+#endif
+    void sortEntries(std::vector<Entry> & entries);
+    void fillMatrix(std::vector<Entry> & entries, long startRow, long nLocalRows, std::unique_ptr<SparseMatrix> & matrix);
+
+    int m_nProcessors;                                  /**<number of MPI processes*/
+    int m_rank;                                         /**<MPI rank of the process*/
+
+    FileHandler m_fileHandler;                          /**<bitpit file handler*/
+    InputOptions m_inputOptions;                        /**<input settings shared by all the readers*/
+    RowPartition m_partition;                           /**<row partition among processes*/
+    LocalCSR::Consumer m_rowsConsumer;                  /**<consumer of the local rows, if set no SparseMatrix is created*/
+
+    int m_nRows;                                        /**<number of rows as read in size line*/
+    int m_nCols;                                        /**<number of columns as read in size line*/
+    int m_nNz;                                          /**<number of non-zeros, mirrored entries included*/
+    long m_nEntries;                                    /**<number of entries as read in size line*/
+    bool m_symmetric;                                   /**<true if only one triangle is stored*/
+
+};
+
+#endif
@@ -20,13 +20,65 @@
  *
  \*---------------------------------------------------------------------------*/
 
+#include <cstring>
+#include <functional>
+#include <thread>
+
 #include <bitpit_IO.hpp>
 
 #include "matrixReader.hpp"
+#include "matrixMarketReader.hpp"
+#include "collectiveReader.hpp"
+#include "inputFileStream.hpp"
+#include "mappedFile.hpp"
+#include "scatterReader.hpp"
+#include "shardSet.hpp"
 
 
 using namespace bitpit;
 
+namespace {
+
+//Amount of text collected before the worker threads parse it
+const std::size_t THREADED_BATCH_SIZE = 64 << 20;
+
+/*!
+ * It parses a range of row pairs collected in a batch
+ * \param[in] text the batch text
+ * \param[in] lineStarts offset in text of each batch line, followed by the text size
+ * \param[in] firstRow first batch row to be parsed
+ * \param[in] lastRow batch row after the last one to be parsed
+ * \param[out] rows the parsed rows
+ */
+void parseRows(const std::vector<char> & text, const std::vector<std::size_t> & lineStarts, int firstRow, int lastRow, LocalCSR & rows)
+{
+    rows.clear();
+    const char *data = text.data();
+    for(int row = firstRow; row < lastRow; ++row) {
+        rows.appendRow(data + lineStarts[2 * row], data + lineStarts[2 * row + 1],
+                data + lineStarts[2 * row + 1], data + lineStarts[2 * row + 2]);
+    }
+}
+
+/*!
+ * It splits a scattered chunk in row pairs, every line of the chunk being ended by a newline
+ * \param[in] begin beginning of the chunk
+ * \param[in] end end of the chunk
+ * \param[in] visitor function receiving the pattern and the values lines of each row
+ */
+void forEachRow(const char * begin, const char * end,
+        const std::function<void(const char *, const char *, const char *, const char *)> & visitor)
+{
+    while(begin < end) {
+        const char *patternEnd = Tokenizer::findNewline(begin, end);
+        const char *valuesEnd = Tokenizer::findNewline(patternEnd + 1, end);
+        visitor(begin, patternEnd, patternEnd + 1, valuesEnd);
+        begin = valuesEnd + 1;
+    }
+}
+
+}
+
 
 /*!
  * Constructor
@@ -36,7 +88,8 @@ using namespace bitpit;
  * \param[in] rank process MPI rank
  */
 MatrixReader::MatrixReader(int nProcessors, int rank) :
-        m_nProcessors(nProcessors), m_rank(rank),m_fileHandler(),m_nRows(0),m_nCols(0),m_nNz(0)
+        m_nProcessors(nProcessors), m_rank(rank),m_fileHandler(),m_inputOptions(),m_partition(),m_shardPattern(),m_rowsConsumer(),m_rowsInspector(),
+        m_cachePattern(false),m_patternRowPtr(),m_patternColIdx(),m_patternRowStart(0),m_patternNnzStart(0),m_sharedData(nullptr),m_sharedSize(0),m_cache(),m_nRows(0),m_nCols(0),m_nNz(0)
 {
 
 }
@@ -53,53 +106,643 @@ MatrixReader::MatrixReader(int nProcessors, int rank) :
  * \param[in] app_ matrix file extension
  */
 MatrixReader::MatrixReader(int nProcessors, int rank,const std::string & dir_, const std::string & name_, const std::string & app_) :
-        m_nProcessors(nProcessors), m_rank(rank), m_fileHandler(dir_,name_,app_),m_nRows(0),m_nCols(0),m_nNz(0)
+        m_nProcessors(nProcessors), m_rank(rank), m_fileHandler(dir_,name_,app_),m_inputOptions(),m_partition(),m_shardPattern(),m_rowsConsumer(),m_rowsInspector(),
+        m_cachePattern(false),m_patternRowPtr(),m_patternColIdx(),m_patternRowStart(0),m_patternNnzStart(0),m_sharedData(nullptr),m_sharedSize(0),m_cache(),m_nRows(0),m_nCols(0),m_nNz(0)
 {
 
 }
 
+/*!
+ * It selects the format of the matrix file.
+ * If the user requested a format explicitly ("csr", "binary", "mtx" or "values"), it is used.
+ * Otherwise ("auto" or empty), the format is recognized from the first bytes of the file:
+ * a binary vector container holds the values of a cached pattern.
+ * \param[in] requested format requested by the user in the dictionary
+ * \param[in] path path of the matrix file
+ * \return the format to be used for reading the matrix
+ */
+MatrixReader::Format MatrixReader::selectFormat(const std::string & requested, const std::string & path)
+{
+    if(requested == "binary") {
+        return Format::BINARY_CSR;
+    } else if(requested == "csr") {
+        return Format::ASCII_CSR;
+    } else if(requested == "mtx") {
+        return Format::MATRIX_MARKET;
+    } else if(requested == "values") {
+        return Format::BINARY_VALUES;
+    } else if(!requested.empty() && requested != "auto") {
+        log::cout() << "Unknown matrix format " << requested << ", it will be detected from file" << std::endl;
+    }
+
+    if(CSRBinaryFormat::hasMagic(path)) {
+        return Format::BINARY_CSR;
+    }
+    if(VectorBinaryFormat::hasMagic(path)) {
+        return Format::BINARY_VALUES;
+    }
+    if(MatrixMarketReader::hasBanner(path)) {
+        return Format::MATRIX_MARKET;
+    }
+
+    return Format::ASCII_CSR;
+}
+
 /*!
  * It reads the matrix from disk, populates and assemblies bitpit SparseMatrix objects.
+ * With a cache directory set in the input options, the local rows are loaded from the cache if it holds them
+ * for this matrix file and number of processes; otherwise they are read from the file and cached for later runs.
  * \param[in] system a reference to the unique pointer to the bitpit SparseMatrix to be filled
  */
 void MatrixReader::readMatrixCSRFormat(std::unique_ptr<SparseMatrix> & matrix)
 {
+    if(!m_inputOptions.cacheDirectory.empty()) {
+        m_cache = std::unique_ptr<MatrixCache>(new MatrixCache(m_nProcessors, m_rank, m_inputOptions.cacheDirectory,
+                m_fileHandler.getPath(), m_inputOptions.partitionWeight));
+    }
+
+    if(m_cache && m_cache->load()) {
+        readMatrixCSRFormatCached(matrix);
+    } else {
+        readMatrixCSRFormatFile(matrix);
+    }
+    m_cache.reset();
+}
+
+/*!
+ * It reads the local rows loaded from the matrix cache, populates and assemblies bitpit SparseMatrix objects.
+ * Sizes and row partition are those the matrix was cached with.
+ * \param[in] matrix a reference to the unique pointer to the bitpit SparseMatrix to be filled
+ */
+void MatrixReader::readMatrixCSRFormatCached(std::unique_ptr<SparseMatrix> & matrix)
+{
+    m_nRows = static_cast<int>(m_cache->getNRows());
+    m_nCols = static_cast<int>(m_cache->getNCols());
+    m_nNz = static_cast<int>(m_cache->getNNz());
+    log::cout() << "nRows = " << m_nRows << std::endl;
+    log::cout() << "nCols = " << m_nCols << std::endl;
+    log::cout() << "nNz = " << m_nNz << std::endl;
+
+    m_partition = m_cache->getPartition();
+    log::cout() << "rows per proc = " << m_partition.getRowCounts() << std::endl;
+
+    LocalCSR::commit(m_cache->getRowCount(), m_cache->getRowPtr(), m_cache->getColIdx(), m_cache->getValues(),
+            m_partition.getRowStart(m_rank), m_nNz / m_nProcessors, matrix, getCommitConsumer(matrix));
+    m_cache->clear();
+}
+
+/*!
+ * It reads the matrix from the ASCII CSR file with the input mode of the options,
+ * populates and assemblies bitpit SparseMatrix objects.
+ * \param[in] matrix a reference to the unique pointer to the bitpit SparseMatrix to be filled
+ */
+void MatrixReader::readMatrixCSRFormatFile(std::unique_ptr<SparseMatrix> & matrix)
+{
+    if(m_inputOptions.mode == ReadMode::MPIIO) {
+        if(!InputFileStream::isCompressed(m_fileHandler.getPath())) {
+            readMatrixCSRFormatCollective(matrix);
+            return;
+        }
+        log::cout() << "Compressed file, independent streams will be used instead of MPI-IO" << std::endl;
+    }
+    if(m_inputOptions.mode == ReadMode::SCATTER || m_inputOptions.mode == ReadMode::NODE_SCATTER) {
+        readMatrixCSRFormatScattered(matrix);
+        return;
+    }
+
     log::cout() << "Matrix path: " << m_fileHandler.getPath() << std::endl;
-    std::fstream inMatrix(m_fileHandler.getPath().c_str(), std::ifstream::in);
-    if(inMatrix.is_open()) {
+    InputFileStream inMatrix(m_fileHandler.getPath());
+    if(inMatrix.isOpen()) {
         readMatrixCSRFormatInfo(inMatrix);
 
-        std::vector<int> procRows = computeLinesPerProc();
+        //Index every k-th row pair of the body
+        LineIndex index(m_fileHandler.getPath(), 2 * LineIndex::DEFAULT_STRIDE);
+        index.initialize(static_cast<uint64_t>(inMatrix.tellg()), m_rank);
+
+        //Partition rows, scanning the row lengths only if non-zeros have to be balanced
+        RowPartition initial = RowPartition::uniform(m_nRows, m_nProcessors);
+        if(m_inputOptions.partitionWeight > 0.) {
+            std::vector<long> rowNnz = scanRowLengths(inMatrix, index, initial);
+            m_partition = RowPartition::balance(initial, m_rank, rowNnz, m_inputOptions.partitionWeight);
+        } else {
+            m_partition = initial;
+        }
+
+        std::vector<int> procRows = m_partition.getRowCounts();
         log::cout() << "lines per proc = " << procRows << std::endl;
         std::vector<int> startRows = computeStartLinePerProc(procRows);
         log::cout() << "start per proc = " << startRows << std::endl;
 
-        //Initialize matrix
+        LocalCSR rows;
+        readMatrixCSRFormatMatrix(inMatrix, index, procRows, startRows, rows);
+
+        //A corrupted compressed file ends early, it has to be told apart before the rows are committed
+        int isCorrupted = inMatrix.isCorrupted() ? 1 : 0;
+        inMatrix.close();
 #if ENABLE_MPI == 1
-        matrix = std::unique_ptr<SparseMatrix>(new SparseMatrix(MPI_COMM_WORLD,true,procRows[m_rank],procRows[m_rank],m_nNz/m_nProcessors));
-#else
-        matrix = std::unique_ptr<SparseMatrix>(new SparseMatrix(procRows[m_rank],procRows[m_rank],m_nNz/m_nProcessors));
+        MPI_Allreduce(MPI_IN_PLACE, &isCorrupted, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
 #endif
+        if(isCorrupted) {
+            log::cout() << "File " << m_fileHandler.getPath() << " is a corrupted or truncated gzip file!" << std::endl;
+#if ENABLE_MPI == 1
+            MPI_Finalize();
+#endif
+            exit(1);
+        }
 
-        readMatrixCSRFormatMatrix(inMatrix, procRows,startRows,matrix);
-
-        inMatrix.close();
+        rows.commit(m_partition.getRowStart(m_rank), m_nNz / m_nProcessors, matrix, getCommitConsumer(matrix));
     } else {
         log::cout() << "File " << m_fileHandler.getPath() << " not open!" << std::endl;
+#if ENABLE_MPI == 1
+        MPI_Finalize();
+#endif
+        exit(1);
     }
+
+}
+
+/*!
+ * It reads the ASCII CSR matrix with collective MPI-IO calls, populates and assemblies bitpit SparseMatrix objects.
+ * Only the first process opens the file to read the header and to provide the line index,
+ * then each process loads the byte range of its own rows with a single collective read and parses it from memory.
+ * \param[in] matrix a reference to the unique pointer to the bitpit SparseMatrix to be filled
+ */
+void MatrixReader::readMatrixCSRFormatCollective(std::unique_ptr<SparseMatrix> & matrix)
+{
+    log::cout() << "Matrix path: " << m_fileHandler.getPath() << " (collective MPI-IO)" << std::endl;
+
+    uint64_t bodyOffset = readMatrixCSRFormatInfoOnFirst();
+
+    //Index every k-th row pair of the body
+    LineIndex index(m_fileHandler.getPath(), 2 * LineIndex::DEFAULT_STRIDE);
+    index.initialize(bodyOffset, m_rank);
+
+    //Partition rows, scanning the row lengths of an equal rows split only if non-zeros have to be balanced
+    RowPartition initial = RowPartition::uniform(m_nRows, m_nProcessors);
+    if(m_inputOptions.partitionWeight > 0.) {
+        CollectiveReader scanReader(m_fileHandler.getPath());
+        if(!scanReader.readLines(index, 2 * initial.getRowStart(m_rank), 2 * initial.getRowCount(m_rank))) {
+            log::cout() << "File " << m_fileHandler.getPath() << " could not be read!" << std::endl;
+#if ENABLE_MPI == 1
+            MPI_Finalize();
+#endif
+            exit(1);
+        }
+        std::istream scanStream(&scanReader.getStreamBuffer());
+        std::vector<long> rowNnz = scanRowLengths(scanStream, index, initial);
+        m_partition = RowPartition::balance(initial, m_rank, rowNnz, m_inputOptions.partitionWeight);
+    } else {
+        m_partition = initial;
+    }
+
+    std::vector<int> procRows = m_partition.getRowCounts();
+    log::cout() << "lines per proc = " << procRows << std::endl;
+    std::vector<int> startRows = computeStartLinePerProc(procRows);
+    log::cout() << "start per proc = " << startRows << std::endl;
+
+    //Load the rank lines with a collective read and parse them from memory
+    CollectiveReader reader(m_fileHandler.getPath());
+    if(!reader.readLines(index, startRows[m_rank], 2 * procRows[m_rank])) {
+        log::cout() << "File " << m_fileHandler.getPath() << " could not be read!" << std::endl;
+#if ENABLE_MPI == 1
+        MPI_Finalize();
+#endif
+        exit(1);
+    }
+    std::istream inMatrix(&reader.getStreamBuffer());
+    LocalCSR rows;
+    readMatrixCSRFormatMatrix(inMatrix, index, procRows, startRows, rows);
+    reader.logBandwidth("Matrix");
+
+    rows.commit(m_partition.getRowStart(m_rank), m_nNz / m_nProcessors, matrix, getCommitConsumer(matrix));
+
+}
+
+/*!
+ * It reads the ASCII CSR matrix through one reader, or one reader per node, which scatters the rows to their owners
+ * in chunks of bounded size (see ScatterReader class for details), populates and assemblies bitpit SparseMatrix objects.
+ * Each process parses its chunks into the local CSR buffer while the reader sends the next ones,
+ * so only the readers open the file. A single reader streams the whole body in order without any line index,
+ * one reader per node jumps to the rows of its node through the line index.
+ * If non-zeros have to be balanced, the rows of an equal rows split are scattered once more to scan their lengths.
+ * \param[in] matrix a reference to the unique pointer to the bitpit SparseMatrix to be filled
+ */
+void MatrixReader::readMatrixCSRFormatScattered(std::unique_ptr<SparseMatrix> & matrix)
+{
+    bool perNode = (m_inputOptions.mode == ReadMode::NODE_SCATTER);
+    log::cout() << "Matrix path: " << m_fileHandler.getPath()
+            << (perNode ? " (scattered by one reader per node)" : " (scattered by one reader)") << std::endl;
+
+    uint64_t bodyOffset = readMatrixCSRFormatInfoOnFirst();
+
+    std::unique_ptr<LineIndex> index;
+    if(perNode) {
+        index.reset(new LineIndex(m_fileHandler.getPath(), 2 * LineIndex::DEFAULT_STRIDE));
+        index->initialize(bodyOffset, m_rank);
+    }
+    ScatterReader reader(m_fileHandler.getPath(), perNode, m_inputOptions.chunkSize);
+
+    //Partition rows, scanning the row lengths of an equal rows split only if non-zeros have to be balanced
+    bool isRead = true;
+    RowPartition initial = RowPartition::uniform(m_nRows, m_nProcessors);
+    if(m_inputOptions.partitionWeight > 0.) {
+        std::vector<long> rowNnz(initial.getRowCount(m_rank), 0);
+        long row = 0;
+        isRead = reader.readLines(bodyOffset, index.get(), 2 * initial.getRowStart(m_rank), 2 * initial.getRowCount(m_rank), 2,
+                [&rowNnz, &row](const char *begin, const char *end) {
+            forEachRow(begin, end, [&rowNnz, &row](const char *patternBegin, const char *patternEnd, const char *, const char *) {
+                rowNnz[row++] = Tokenizer::countTokens(patternBegin, patternEnd);
+            });
+        });
+        if(isRead) {
+            m_partition = RowPartition::balance(initial, m_rank, rowNnz, m_inputOptions.partitionWeight);
+        }
+    } else {
+        m_partition = initial;
+    }
+
+    //Parse the scattered rows into the local CSR buffer
+    LocalCSR rows;
+    if(isRead) {
+        log::cout() << "rows per proc = " << m_partition.getRowCounts() << std::endl;
+        rows.reserve(m_partition.getRowCount(m_rank), computeLocalNnzEstimate());
+        isRead = reader.readLines(bodyOffset, index.get(), 2 * m_partition.getRowStart(m_rank), 2 * m_partition.getRowCount(m_rank), 2,
+                [&rows](const char *begin, const char *end) {
+            forEachRow(begin, end, [&rows](const char *patternBegin, const char *patternEnd, const char *valuesBegin, const char *valuesEnd) {
+                rows.appendRow(patternBegin, patternEnd, valuesBegin, valuesEnd);
+            });
+        });
+    }
+    if(!isRead) {
+        log::cout() << "File " << m_fileHandler.getPath() << " could not be read!" << std::endl;
+#if ENABLE_MPI == 1
+        MPI_Finalize();
+#endif
+        exit(1);
+    }
+    reader.logBandwidth("Matrix");
+
+    rows.commit(m_partition.getRowStart(m_rank), m_nNz / m_nProcessors, matrix, getCommitConsumer(matrix));
+}
+
+/*!
+ * It reads the ASCII CSR matrix from shards (see ShardSet class for details), populates and assemblies bitpit SparseMatrix objects.
+ * With one shard per process, the shard row ranges are the partition and each process opens only its own shard.
+ * Otherwise rows are partitioned as for a single file, scanning the row lengths through the shards if non-zeros
+ * have to be balanced, and each process opens only the shards overlapping its rows.
+ * \param[in] matrix a reference to the unique pointer to the bitpit SparseMatrix to be filled
+ */
+void MatrixReader::readMatrixShards(std::unique_ptr<SparseMatrix> & matrix)
+{
+    ShardSet shards(m_fileHandler.getDirectory(), m_shardPattern);
+    if(!shards.readManifest(m_rank)) {
+#if ENABLE_MPI == 1
+        MPI_Finalize();
+#endif
+        exit(1);
+    }
+    m_nRows = static_cast<int>(shards.getRowGlobalCount());
+    m_nCols = shards.getColGlobalCount() > 0 ? static_cast<int>(shards.getColGlobalCount()) : m_nRows;
+    m_nNz = static_cast<int>(shards.getNonZeroGlobalCount());
+
+    bool isRead = true;
+    if(shards.getShardCount() == m_nProcessors) {
+        m_partition = shards.getPartition();
+    } else {
+        log::cout() << "Shards are merged or split among " << m_nProcessors << " processes" << std::endl;
+        RowPartition initial = RowPartition::uniform(m_nRows, m_nProcessors);
+        if(m_inputOptions.partitionWeight > 0.) {
+            std::vector<long> rowNnz(initial.getRowCount(m_rank), 0);
+            isRead = shards.readRows(initial, m_rank, 2, [&rowNnz](Tokenizer & tokenizer, long localRow, long nRows) {
+                const char *begin, *end;
+                for(long r = localRow; r < localRow + nRows && tokenizer.nextLine(&begin, &end); ++r) {
+                    rowNnz[r] = Tokenizer::countTokens(begin, end);
+                    tokenizer.nextLine(&begin, &end);
+                }
+            });
+            m_partition = RowPartition::balance(initial, m_rank, rowNnz, m_inputOptions.partitionWeight);
+        } else {
+            m_partition = initial;
+        }
+    }
+    log::cout() << "rows per proc = " << m_partition.getRowCounts() << std::endl;
+
+    //Read the rank rows from its shards into the local CSR buffer
+    LocalCSR rows;
+    int nThreads = m_inputOptions.nThreads;
+    if(isRead) {
+        rows.reserve(m_partition.getRowCount(m_rank), computeLocalNnzEstimate());
+        isRead = shards.readRows(m_partition, m_rank, 2, [this, &rows, nThreads](Tokenizer & tokenizer, long, long nRows) {
+            if(nThreads > 1) {
+                readMatrixCSRFormatRowsThreaded(tokenizer, static_cast<int>(nRows), nThreads, rows);
+            } else {
+                for(long r = 0; r < nRows; ++r) {
+                    rows.appendRow(tokenizer);
+                }
+            }
+        });
+    }
+    if(!isRead) {
+#if ENABLE_MPI == 1
+        MPI_Finalize();
+#endif
+        exit(1);
+    }
+
+    //The manifest may not give the number of non-zeros
+    if(m_nNz == 0) {
+        long nNz = rows.getNonZeroCount();
 #if ENABLE_MPI==1
-    MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Allreduce(MPI_IN_PLACE, &nNz, 1, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
 #endif
+        m_nNz = static_cast<int>(nNz);
+    }
+    log::cout() << "nCols = " << m_nCols << std::endl;
+    log::cout() << "nNz = " << m_nNz << std::endl;
 
-    matrix->assembly();
+    rows.commit(m_partition.getRowStart(m_rank), m_nNz / m_nProcessors, matrix, getCommitConsumer(matrix));
+}
 
+/*!
+ * It gives the number of non-zeros expected in the process rows:
+ * the exact one if the partition knows it, the average one otherwise
+ * \return the number of non-zeros expected in the process rows
+ */
+long MatrixReader::computeLocalNnzEstimate()
+{
+    if(m_partition.hasNonZeroCounts()) {
+        return m_partition.getNonZeroCount(m_rank);
+    }
+
+    return m_nNz / m_nProcessors;
+}
+
+/*!
+ * It reads the matrix from a binary CSR container, populates and assemblies bitpit SparseMatrix objects.
+ * The file is memory mapped: each process touches only the header, its own slice of the row pointer array
+ * and its own slices of column indices and values, which are passed to the SparseMatrix without any copy or parsing.
+ * If shared data are set (see setSharedData), the container is read in place from them instead of the file.
+ * \param[in] matrix a reference to the unique pointer to the bitpit SparseMatrix to be filled
+ */
+void MatrixReader::readMatrixBinaryFormat(std::unique_ptr<SparseMatrix> & matrix)
+{
+    static_assert(sizeof(long) == sizeof(int64_t), "Binary CSR column indices are passed as long without copy");
+
+    MappedFile inMatrix;
+    const char *data = m_sharedData;
+    std::size_t size = m_sharedSize;
+    std::string source = "Shared-memory matrix";
+    if(data == nullptr) {
+        log::cout() << "Matrix path: " << m_fileHandler.getPath() << std::endl;
+        if(!inMatrix.open(m_fileHandler.getPath())) {
+            log::cout() << "File " << m_fileHandler.getPath() << " not open!" << std::endl;
+#if ENABLE_MPI == 1
+            MPI_Finalize();
+#endif
+            exit(1);
+        }
+        data = inMatrix.getData();
+        size = inMatrix.getSize();
+        source = "File " + m_fileHandler.getPath();
+    } else {
+        log::cout() << "Matrix source: shared memory" << std::endl;
+    }
+
+    CSRBinaryHeader header;
+    std::string error;
+    if(size < sizeof(CSRBinaryHeader)) {
+        error = "truncated header";
+    } else {
+        std::memcpy(&header, data, sizeof(CSRBinaryHeader));
+        CSRBinaryFormat::checkHeader(header, size, &error);
+    }
+    if(!error.empty()) {
+        log::cout() << source << " is not a valid binary CSR matrix: " << error << std::endl;
+#if ENABLE_MPI == 1
+        MPI_Finalize();
+#endif
+        exit(1);
+    }
+
+    m_nRows = header.nRows;
+    m_nCols = header.nCols;
+    m_nNz = header.nNz;
+    log::cout() << "nRows = " << m_nRows << std::endl;
+    log::cout() << "nCols = " << m_nCols << std::endl;
+    log::cout() << "nNz = " << m_nNz << std::endl;
+
+    const int64_t *rowPtr = reinterpret_cast<const int64_t *>(data + header.rowPtrOffset);
+
+    //Partition rows, the row pointer gives the row lengths for free
+    m_partition = RowPartition::fromRowOffsets(m_nRows, m_nProcessors, rowPtr, m_inputOptions.partitionWeight);
+    std::vector<int> procRows = m_partition.getRowCounts();
+    log::cout() << "rows per proc = " << procRows << std::endl;
+    long startRow = m_partition.getRowStart(m_rank);
+    const long *colIdx = reinterpret_cast<const long *>(data + header.colIdxOffset);
+    const double *values = reinterpret_cast<const double *>(data + header.valuesOffset);
+
+    //Each process checks the row pointers of its own rows only, before addressing the arrays with them
+    int isValid = CSRBinaryFormat::checkRows(header, data, startRow, procRows[m_rank], &error) ? 1 : 0;
+    if(!isValid) {
+        log::cout() << source << " is not a valid binary CSR matrix: " << error << std::endl;
+    }
+#if ENABLE_MPI == 1
+    MPI_Allreduce(MPI_IN_PLACE, &isValid, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+#endif
+    if(!isValid) {
+#if ENABLE_MPI == 1
+        MPI_Finalize();
+#endif
+        exit(1);
+    }
+
+    long nzBegin = rowPtr[startRow];
+    long nzEnd = rowPtr[startRow + procRows[m_rank]];
+    log::cout() << "local non-zeros = " << (nzEnd - nzBegin) << std::endl;
+
+    MappedFile::adviseSequential(data, size, header.rowPtrOffset + startRow * sizeof(int64_t), (procRows[m_rank] + 1) * sizeof(int64_t));
+    MappedFile::adviseSequential(data, size, header.valuesOffset + nzBegin * sizeof(double), (nzEnd - nzBegin) * sizeof(double));
+
+    if(header.flags == 0) {
+        MappedFile::adviseSequential(data, size, header.colIdxOffset + nzBegin * sizeof(int64_t), (nzEnd - nzBegin) * sizeof(int64_t));
+        LocalCSR::commit(procRows[m_rank], reinterpret_cast<const long *>(rowPtr + startRow), colIdx, values,
+                startRow, m_nNz / m_nProcessors, matrix, getCommitConsumer(matrix));
+    } else {
+        //Compact column indices are widened into a local array, row pointer and values are still used in place
+        log::cout() << "Column indices layout: " << ((header.flags & CSRBinaryFormat::FLAG_VARINT) ? "varint" : "int32") << std::endl;
+        std::vector<long> localColIdx;
+        isValid = CSRBinaryFormat::decodeColumns(header, data, startRow, procRows[m_rank], localColIdx) ? 1 : 0;
+        if(!isValid) {
+            log::cout() << source << " is not a valid binary CSR matrix: corrupted column indices from row " << startRow << std::endl;
+        }
+#if ENABLE_MPI == 1
+        MPI_Allreduce(MPI_IN_PLACE, &isValid, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+#endif
+        if(!isValid) {
+#if ENABLE_MPI == 1
+            MPI_Finalize();
+#endif
+            exit(1);
+        }
+        std::vector<long> localRowPtr(rowPtr + startRow, rowPtr + startRow + procRows[m_rank] + 1);
+        for(long & offset : localRowPtr) {
+            offset -= nzBegin;
+        }
+        LocalCSR::commit(procRows[m_rank], localRowPtr.data(), localColIdx.data(), values + nzBegin,
+                startRow, m_nNz / m_nProcessors, matrix, getCommitConsumer(matrix));
+    }
+
+}
+
+/*!
+ * It reads the values of a matrix sharing the pattern cached by the last matrix read with pattern caching enabled,
+ * populates and assemblies bitpit SparseMatrix objects.
+ * The values file is a binary vector container (see VectorBinaryFormat class for details) holding one value per non-zero,
+ * in the order of the non-zeros of the pattern, i.e. the values array of the CSR matrix; it is written by the
+ * madlinsolv-convert tool with the --values option.
+ * The file is memory mapped and each process reads only the contiguous range of its own non-zeros,
+ * which is passed to the SparseMatrix together with the cached pattern, with no parsing and no copy.
+ * The row partition and the sizes are those of the pattern.
+ * \param[in] matrix a reference to the unique pointer to the bitpit SparseMatrix to be filled
+ */
+void MatrixReader::readMatrixValues(std::unique_ptr<SparseMatrix> & matrix)
+{
+    log::cout() << "Matrix values path: " << m_fileHandler.getPath() << std::endl;
+    if(m_patternRowPtr.empty()) {
+        log::cout() << "No cached pattern, a matrix must be read with pattern caching enabled before its values!" << std::endl;
+#if ENABLE_MPI == 1
+        MPI_Finalize();
+#endif
+        exit(1);
+    }
+
+    MappedFile inValues(m_fileHandler.getPath());
+    if(!inValues.isOpen()) {
+        log::cout() << "File " << m_fileHandler.getPath() << " not open!" << std::endl;
+#if ENABLE_MPI == 1
+        MPI_Finalize();
+#endif
+        exit(1);
+    }
+
+    VectorBinaryHeader header;
+    std::string error;
+    if(inValues.getSize() < sizeof(VectorBinaryHeader)) {
+        error = "truncated header";
+    } else {
+        std::memcpy(&header, inValues.getData(), sizeof(VectorBinaryHeader));
+        if(VectorBinaryFormat::checkHeader(header, inValues.getSize(), &error) && header.nRows != m_nNz) {
+            error = "it holds " + std::to_string(header.nRows) + " values, the cached pattern has " + std::to_string(m_nNz) + " non-zeros";
+        }
+    }
+    if(!error.empty()) {
+        log::cout() << "File " << m_fileHandler.getPath() << " is not a valid matrix values file: " << error << std::endl;
+#if ENABLE_MPI == 1
+        MPI_Finalize();
+#endif
+        exit(1);
+    }
+
+    long localNnz = getCachedNonZeroCount();
+    log::cout() << "local non-zeros = " << localNnz << std::endl;
+    std::size_t valuesBegin = header.valuesOffset + m_patternNnzStart * sizeof(double);
+    inValues.adviseSequential(valuesBegin, localNnz * sizeof(double));
+    const double *values = reinterpret_cast<const double *>(inValues.getData() + valuesBegin);
+
+    commitValues(values, matrix);
+}
+
+/*!
+ * It commits new values of the local non-zeros with the cached pattern to the matrix.
+ * The pattern must have been cached by a previous read (see setPatternCaching).
+ * \param[in] values the local non-zero values, in the order of the cached pattern
+ * \param[in] matrix a reference to the unique pointer to the bitpit SparseMatrix to be filled
+ */
+void MatrixReader::commitValues(const double * values, std::unique_ptr<SparseMatrix> & matrix)
+{
+    long nLocalRows = static_cast<long>(m_patternRowPtr.size()) - 1;
+    LocalCSR::commit(nLocalRows, m_patternRowPtr.data(), m_patternColIdx.data(), values,
+            m_patternRowStart, m_nNz / m_nProcessors, matrix, m_rowsConsumer);
+}
+
+/*!
+ * It gets the number of non-zeros of the cached local pattern.
+ * \return the number of local non-zeros, 0 if no pattern is cached
+ */
+long MatrixReader::getCachedNonZeroCount() const
+{
+    return m_patternRowPtr.empty() ? 0 : m_patternRowPtr.back();
+}
+
+/*!
+ * It gets the consumer the local rows are committed to. It is the rows consumer, if set.
+ * Otherwise, with pattern caching enabled, it is a consumer copying the pattern of the rows into the cache
+ * before creating the SparseMatrix; if neither is set, it is empty and the SparseMatrix is created as usual.
+ * While a matrix missed by the matrix cache is read, the rows are stored into the matrix cache first.
+ * With a rows inspector set, the rows are handed to it before anything else.
+ * \param[in] matrix a reference to the unique pointer to the bitpit SparseMatrix to be filled
+ * \return the consumer to be passed to the commit
+ */
+LocalCSR::Consumer MatrixReader::getCommitConsumer(std::unique_ptr<SparseMatrix> & matrix)
+{
+    LocalCSR::Consumer consumer = m_rowsConsumer;
+    if(!m_rowsConsumer && m_cachePattern) {
+        consumer = [this, &matrix](long nRows, const long * rowPtr, const long * colIdx, const double * values, long rowStart) {
+            cachePattern(nRows, rowPtr, colIdx, rowStart);
+            LocalCSR::commit(nRows, rowPtr, colIdx, values, rowStart, m_nNz / m_nProcessors, matrix);
+        };
+    }
+    if(m_cache && !m_cache->isLoaded()) {
+        consumer = [this, consumer, &matrix](long nRows, const long * rowPtr, const long * colIdx, const double * values, long rowStart) {
+            m_cache->store(m_nRows, m_nCols, m_nNz, m_partition, nRows, rowPtr, colIdx, values);
+            LocalCSR::commit(nRows, rowPtr, colIdx, values, rowStart, m_nNz / m_nProcessors, matrix, consumer);
+        };
+    }
+    if(m_rowsInspector) {
+        consumer = [this, consumer, &matrix](long nRows, const long * rowPtr, const long * colIdx, const double * values, long rowStart) {
+            m_rowsInspector(nRows, rowPtr, colIdx, values, rowStart);
+            LocalCSR::commit(nRows, rowPtr, colIdx, values, rowStart, m_nNz / m_nProcessors, matrix, consumer);
+        };
+    }
+
+    return consumer;
+}
+
+/*!
+ * It copies the pattern of the local rows into the cache, together with the first global non-zero of the process.
+ * This method is collective.
+ * \param[in] nRows number of local rows
+ * \param[in] rowPtr offset of each row in colIdx, nRows + 1 elements (the first one is not required to be zero)
+ * \param[in] colIdx global column indices of the rows
+ * \param[in] rowStart first global row of the process
+ */
+void MatrixReader::cachePattern(long nRows, const long * rowPtr, const long * colIdx, long rowStart)
+{
+    long nzBegin = rowPtr[0];
+    m_patternRowPtr.assign(rowPtr, rowPtr + nRows + 1);
+    for(long & offset : m_patternRowPtr) {
+        offset -= nzBegin;
+    }
+    m_patternColIdx.assign(colIdx + nzBegin, colIdx + rowPtr[nRows]);
+    m_patternRowStart = rowStart;
+
+    m_patternNnzStart = 0;
+#if ENABLE_MPI == 1
+    long localNnz = m_patternRowPtr.back();
+    MPI_Exscan(&localNnz, &m_patternNnzStart, 1, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+    if(m_rank == 0) {
+        m_patternNnzStart = 0;
+    }
+#endif
+    log::cout() << "Local matrix pattern cached: " << (m_patternRowPtr.size() + m_patternColIdx.size()) * sizeof(long) / (1024. * 1024.)
+            << " MB" << std::endl;
 }
 
 /*!
  * It reads the matrix header from file,
  * \param fileStream the stream from the matrix file
  */
-void MatrixReader::readMatrixCSRFormatInfo(std::fstream & fileStream)
+void MatrixReader::readMatrixCSRFormatInfo(std::istream & fileStream)
 {
 
     std::string line;
@@ -107,10 +750,13 @@ void MatrixReader::readMatrixCSRFormatInfo(std::fstream & fileStream)
     while(std::getline(fileStream,line)) {
         line = utils::string::trim(line);
         if(line.substr(0,1) != "#") {
-            std::stringstream ss(line);
-            ss >> m_nRows;
-            ss >> m_nCols;
-            ss >> m_nNz;
+            std::vector<long> sizes;
+            sizes.reserve(3);
+            Tokenizer::parseLine(line.data(), line.data() + line.size(), sizes);
+            sizes.resize(3, 0);
+            m_nRows = static_cast<int>(sizes[0]);
+            m_nCols = static_cast<int>(sizes[1]);
+            m_nNz = static_cast<int>(sizes[2]);
             break;
         }
     }
@@ -120,57 +766,152 @@ void MatrixReader::readMatrixCSRFormatInfo(std::fstream & fileStream)
 }
 
 /*!
- * It reads the body of the matrix file populating the bitpit SparseMatrix object.
+ * It reads the matrix header on the first process only and broadcasts the sizes to all the processes.
+ * If the file cannot be opened, the run is stopped. This method is collective.
+ * \return the byte offset of the first body line
+ */
+uint64_t MatrixReader::readMatrixCSRFormatInfoOnFirst()
+{
+    int isOpen = 0;
+    uint64_t bodyOffset = 0;
+    if(m_rank == 0) {
+        InputFileStream inMatrix(m_fileHandler.getPath());
+        if(inMatrix.isOpen()) {
+            isOpen = 1;
+            readMatrixCSRFormatInfo(inMatrix);
+            bodyOffset = static_cast<uint64_t>(inMatrix.tellg());
+        }
+    }
+#if ENABLE_MPI==1
+    int info[4] = {isOpen, m_nRows, m_nCols, m_nNz};
+    MPI_Bcast(info, 4, MPI_INT, 0, MPI_COMM_WORLD);
+    isOpen = info[0];
+    m_nRows = info[1];
+    m_nCols = info[2];
+    m_nNz = info[3];
+    MPI_Bcast(&bodyOffset, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+#endif
+    if(!isOpen) {
+        log::cout() << "File " << m_fileHandler.getPath() << " not open!" << std::endl;
+#if ENABLE_MPI == 1
+        MPI_Finalize();
+#endif
+        exit(1);
+    }
+
+    return bodyOffset;
+}
+
+/*!
+ * It reads the rows of the process from the body of the matrix file into local CSR arrays,
+ * the matrix is then created with their exact number of non-zeros and filled with a single commit (see LocalCSR class).
  * \param[in] fileStream the stream from the input initial solution file
+ * \param[in] index the line index of the matrix file body
  * \param[in] procLines a vector of m_nProcessors elements containing the number of file lines for each process
  * \param[in] startLines a vector of m_nProcessors elements containing the line number which each process starts reading at
- * \param[in] system a reference to the unique pointer to the system which the user wants to fill the solution in
+ * \param[out] rows the local CSR buffer the process rows are appended to
  */
-void MatrixReader::readMatrixCSRFormatMatrix(std::fstream & fileStream, const std::vector<int> & procLines,
-        const std::vector<int> & startLines, std::unique_ptr<SparseMatrix> & matrix)
+void MatrixReader::readMatrixCSRFormatMatrix(std::istream & fileStream, const LineIndex & index, const std::vector<int> & procLines,
+        const std::vector<int> & startLines, LocalCSR & rows)
 {
-    std::string line;
-    //jump lines before rank lines
-    for(int l = 0; l < startLines[m_rank]; ++l) {
-        std::getline(fileStream,line);
+    //jump to rank lines
+    index.seek(fileStream, startLines[m_rank]);
+    //read rank lines into local CSR arrays
+    Tokenizer tokenizer(fileStream);
+    rows.reserve(procLines[m_rank], computeLocalNnzEstimate());
+    if(m_inputOptions.nThreads > 1) {
+        readMatrixCSRFormatRowsThreaded(tokenizer, procLines[m_rank], m_inputOptions.nThreads, rows);
+    } else {
+        for(int l = 0; l < procLines[m_rank]; ++l) {
+            rows.appendRow(tokenizer);
+#if ENABLE_DEBUG==1
+            const long *rowPtr = rows.getRowPtr();
+            log::cout() << "pattern " << std::vector<long>(rows.getColIdx() + rowPtr[l], rows.getColIdx() + rowPtr[l + 1]) << std::endl;
+            log::cout() << "values " << std::vector<double>(rows.getValues() + rowPtr[l], rows.getValues() + rowPtr[l + 1]) << std::endl;
+#endif
+        }
     }
-    //read rank lines
-    std::vector<long> rowPattern;
-    std::vector<double> rowValues;
-    rowPattern.reserve(100);
-    rowValues.reserve(100);
-    for(int l = 0; l < procLines[m_rank]; ++l) {
-        genericIO::lineStream(fileStream, rowPattern);
-        genericIO::lineStream(fileStream, rowValues);
-        log::cout() << "pattern " << rowPattern << std::endl;
-        log::cout() << "values " << rowValues << std::endl;
-        matrix->addRow(rowPattern,rowValues);
-        rowPattern.clear();
-        rowValues.clear();
+}
+
+/*!
+ * It reads the rows of the process with worker threads.
+ * Row pairs are collected in batches of about THREADED_BATCH_SIZE bytes; each batch is split in one contiguous
+ * block of rows per thread, the blocks are parsed concurrently and then appended to the local CSR arrays in row order.
+ * \param[in] tokenizer the tokenizer positioned at the first row of the process
+ * \param[in] nLocalRows number of rows of the process
+ * \param[in] nThreads number of worker threads
+ * \param[out] rows the local CSR buffer the process rows are appended to
+ */
+void MatrixReader::readMatrixCSRFormatRowsThreaded(Tokenizer & tokenizer, int nLocalRows, int nThreads, LocalCSR & rows)
+{
+    std::vector<char> text;
+    std::vector<std::size_t> lineStarts;
+    std::vector<LocalCSR> blocks(nThreads);
+    std::vector<std::thread> workers;
+    workers.reserve(nThreads);
+
+    int row = 0;
+    while(row < nLocalRows) {
+        //Collect the batch, the tokenizer block is reused by the next lines
+        text.clear();
+        lineStarts.clear();
+        int nBatchRows = 0;
+        while(row + nBatchRows < nLocalRows && text.size() < THREADED_BATCH_SIZE) {
+            for(int l = 0; l < 2; ++l) {
+                const char *begin = nullptr, *end = nullptr;
+                tokenizer.nextLine(&begin, &end);
+                lineStarts.push_back(text.size());
+                text.insert(text.end(), begin, end);
+            }
+            ++nBatchRows;
+        }
+        lineStarts.push_back(text.size());
+
+        //Parse it
+        for(int t = 0; t < nThreads; ++t) {
+            int firstRow = static_cast<int>(static_cast<long>(nBatchRows) * t / nThreads);
+            int lastRow = static_cast<int>(static_cast<long>(nBatchRows) * (t + 1) / nThreads);
+            workers.emplace_back(parseRows, std::cref(text), std::cref(lineStarts), firstRow, lastRow, std::ref(blocks[t]));
+        }
+        for(std::thread & worker : workers) {
+            worker.join();
+        }
+        workers.clear();
+
+        //Append the blocks in row order
+        for(const LocalCSR & block : blocks) {
+            rows.append(block);
+        }
+
+        row += nBatchRows;
     }
 }
 
 /*!
- * It computes the line number which each process has to start reading at into the matrix file
- * \param[in] procRows a vector of m_nProcessors elements containing the number of file lines for each process
- * \return a vector of m_nProcessors elements containing the line number which each process starts reading at
+ * It scans the lengths of the rows of the process in the given partition, counting the tokens of the pattern lines
+ * without converting them. The stream is left in a clean state, ready to be seeked again.
+ * \param[in] fileStream the stream from the matrix file
+ * \param[in] index the line index of the matrix file body
+ * \param[in] partition the partition whose rows are scanned
+ * \return the number of non-zeros of each row of the process
  */
-std::vector<int> MatrixReader::computeLinesPerProc()
+std::vector<long> MatrixReader::scanRowLengths(std::istream & fileStream, const LineIndex & index, const RowPartition & partition)
 {
-    std::vector<int> rows(m_nProcessors,0);
+    std::vector<long> rowNnz(partition.getRowCount(m_rank), 0);
 
-    int division = m_nRows / m_nProcessors;
-    int reminder = m_nRows % m_nProcessors;
-    log::cout() << "division " << division << std::endl;
-    log::cout() << "reminder " << reminder << std::endl;
-    for(int & stride : rows) {
-        stride = division;
-        if(reminder > 0){
-            stride += 1;
-            --reminder;
+    index.seek(fileStream, 2 * partition.getRowStart(m_rank));
+    Tokenizer tokenizer(fileStream);
+    const char *begin, *end;
+    for(long & nnz : rowNnz) {
+        if(!tokenizer.nextLine(&begin, &end)) {
+            break;
         }
+        nnz = Tokenizer::countTokens(begin, end);
+        tokenizer.nextLine(&begin, &end);
     }
-    return rows;
+    fileStream.clear();
+
+    return rowNnz;
 }
 
 /*!
@@ -182,6 +923,24 @@ int MatrixReader::getNRows()
     return m_nRows;
 }
 
+/*!
+ * It gets the global number of matrix columns as read in the matrix file header
+ * @return the global number of matrix columns as read in the matrix file header
+ */
+int MatrixReader::getNCols()
+{
+    return m_nCols;
+}
+
+/*!
+ * It gets the global number of matrix non-zeros as read in the matrix file header
+ * @return the global number of matrix non-zeros as read in the matrix file header
+ */
+int MatrixReader::getNNz()
+{
+    return m_nNz;
+}
+
 /*!
  * It computes the line number which each process has to start reading at into the matrix file
  * \param[in] procRows a vector of m_nProcessors elements containing the number of file lines for each process
@@ -200,6 +959,42 @@ std::vector<int> MatrixReader::computeStartLinePerProc(const std::vector<int> &
     return startLines;
 }
 
+/*!
+ * It gets the row partition among processes, computed while reading the matrix
+ * @return a constant reference to the row partition
+ */
+const RowPartition & MatrixReader::getPartition() const
+{
+    return m_partition;
+}
+
+/*!
+ * It sets the shard file name pattern, readMatrixShards method reads the matrix from such shards
+ * \param[in] pattern shard file name pattern, empty for a single file
+ */
+void MatrixReader::setShardPattern(const std::string & pattern)
+{
+    m_shardPattern = pattern;
+}
+
+/*!
+ * It sets the row partition among processes, when the matrix has been read by another reader
+ * \param[in] partition the row partition
+ */
+void MatrixReader::setPartition(const RowPartition & partition)
+{
+    m_partition = partition;
+}
+
+/*!
+ * It sets the input settings
+ * \param[in] options input settings from the dictionary
+ */
+void MatrixReader::setInputOptions(const InputOptions & options)
+{
+    m_inputOptions = options;
+}
+
 /*!
  * It sets the global number of rows
  * \param[in] nRows the global number of rows
@@ -227,6 +1022,49 @@ void MatrixReader::setNNz(int nNz)
     m_nNz = nNz;
 }
 
+/*!
+ * It sets the consumer of the local rows: if set, the read methods hand the rows to it
+ * in place of creating the SparseMatrix, which is left untouched
+ * \param[in] consumer the consumer of the local rows, an empty one restores the SparseMatrix creation
+ */
+void MatrixReader::setRowsConsumer(const LocalCSR::Consumer & consumer)
+{
+    m_rowsConsumer = consumer;
+}
+
+/*!
+ * It sets the inspector of the local rows: unlike the consumer, it is called on the rows before they are committed
+ * as usual, e.g. to compute their statistics (see MatrixFingerprint class). Values files are not inspected.
+ * The inspector is called by every process.
+ * \param[in] inspector the inspector of the local rows, an empty one removes it
+ */
+void MatrixReader::setRowsInspector(const LocalCSR::Consumer & inspector)
+{
+    m_rowsInspector = inspector;
+}
+
+/*!
+ * It sets if the pattern of the next matrix read is cached, so that matrices sharing it are then read
+ * from their values only (see readMatrixValues)
+ * \param[in] cache true to cache the pattern
+ */
+void MatrixReader::setPatternCaching(bool cache)
+{
+    m_cachePattern = cache;
+}
+
+/*!
+ * It sets a binary CSR container held in memory, e.g. in a shared-memory segment (see SharedSegment class),
+ * to be read in place of the matrix file by readMatrixBinaryFormat. The data must outlive the read.
+ * \param[in] data first byte of the container, null to read the file again
+ * \param[in] size size in bytes of the container
+ */
+void MatrixReader::setSharedData(const char * data, std::size_t size)
+{
+    m_sharedData = data;
+    m_sharedSize = size;
+}
+
 /*!
  * It sets the matrix folder name into the file handler
  * @param dir matrix folder name
@@ -23,13 +23,23 @@
 #ifndef __MADLINSOLV_MATRIXREADER_HPP__
 #define __MADLINSOLV_MATRIXREADER_HPP__
 
+#include <cstdint>
 #include <memory>
 #include <fstream>
 #include <string>
+#include <vector>
 
 #include <bitpit_IO.hpp>
 #include <bitpit_LA.hpp>
 
+#include "binaryFormat.hpp"
+#include "inputOptions.hpp"
+#include "lineIndex.hpp"
+#include "localCSR.hpp"
+#include "matrixCache.hpp"
+#include "rowPartition.hpp"
+#include "tokenizer.hpp"
+
 using namespace bitpit;
 
 /*!
@@ -52,22 +62,73 @@ using namespace bitpit;
  *  line 2N+1 | element_N_nonzeros_values                                                 | ---
  *            -----------------------------------------------------------------------------
  *  \endverbatim
+ *
+ *  Each process jumps to its first row through a sidecar line index (see LineIndex class for details),
+ *  which stores the byte offset of every k-th row pair and is built once and reused by later runs.
+ *  With the MPI-IO input mode, only the first process reads the header and all the processes
+ *  load their own rows with a single collective read (see CollectiveReader class for details).
+ *  With the scatter input modes, only one process, or one process per node, opens the file and
+ *  sends the rows to their owners in chunks of bounded size (see ScatterReader class for details).
+ *
+ *  Rows are distributed among the processes by a RowPartition, with equal rows, equal non-zeros or a mix of the two;
+ *  the right-hand side and initial solution readers share the same partition.
+ *  With more than one input thread, each process parses its rows in batches split among worker threads,
+ *  then it appends them to the local CSR buffer in row order.
+ *  The rows are always parsed into a LocalCSR buffer and committed to the SparseMatrix with a single call,
+ *  so that its storage is reserved with the exact number of local non-zeros (see NonZeroProfile class for details).
+ *
+ *  The matrix can also be provided as binary CSR container (see CSRBinaryFormat class for details).
+ *  Such a file is memory mapped and each process reads only its own rows and the matching non-zeros;
+ *  it is written by the madlinsolv-convert tool, possibly with compact column indices.
+ *  The same container can be read in place from a shared-memory segment written by a co-located producer
+ *  (see SharedSegment class for details).
+ *  Matrices in Matrix Market coordinate format are read by MatrixMarketReader class.
+ *  When a sequence of matrices shares the same pattern, the pattern (row pointer and column indices) of the first one
+ *  can be cached in memory, then each following matrix is read from a values file only: a binary vector container
+ *  with the values array of the matrix, of which each process reads the contiguous range of its non-zeros.
+ *  The ASCII CSR matrix can also be split in shards, each process opening only its own ones (see ShardSet class for details).
+ *  ASCII CSR files and shards may be gzip compressed; they are decompressed on the fly (see InputFileStream class for details).
+ *  With a cache directory set, the local rows of a single ASCII CSR file are cached after the first read and later runs
+ *  load them back without parsing nor partitioning (see MatrixCache class for details).
  */
 class MatrixReader {
 
 public:
 
+    /*!
+     * Matrix file formats
+     */
+    enum class Format {
+        ASCII_CSR,                                      /**<ASCII CSR format, two lines per row*/
+        BINARY_CSR,                                     /**<binary CSR container, see CSRBinaryFormat*/
+        MATRIX_MARKET,                                  /**<Matrix Market coordinate format, see MatrixMarketReader*/
+        BINARY_VALUES                                   /**<binary values of a cached pattern, see readMatrixValues*/
+    };
+
+    static Format selectFormat(const std::string & requested, const std::string & path);
+
     MatrixReader(int nProcessors, int rank);
     MatrixReader(int nProcessors, int rank, const std::string & dir_, const std::string & name_, const std::string & app_);
 
     void readMatrixCSRFormat(std::unique_ptr<SparseMatrix> & matrix);
-    void readMatrixCSRFormatInfo(std::fstream & fileStream);
-    void readMatrixCSRFormatMatrix(std::fstream & fileStream, const std::vector<int> & procLines,
-            const std::vector<int> & startLines, std::unique_ptr<SparseMatrix> & matrix);
-
+    void readMatrixCSRFormatInfo(std::istream & fileStream);
+    void readMatrixCSRFormatMatrix(std::istream & fileStream, const LineIndex & index, const std::vector<int> & procLines,
+            const std::vector<int> & startLines, LocalCSR & rows);
+    void readMatrixBinaryFormat(std::unique_ptr<SparseMatrix> & matrix);
+    void readMatrixShards(std::unique_ptr<SparseMatrix> & matrix);
+    void readMatrixValues(std::unique_ptr<SparseMatrix> & matrix);
+    void commitValues(const double * values, std::unique_ptr<SparseMatrix> & matrix);
+
+    void setInputOptions(const InputOptions & options);
+    void setPartition(const RowPartition & partition);
+    void setShardPattern(const std::string & pattern);
     void setNRows(int nRows);
     void setNCols(int nCols);
     void setNNz(int nNz);
+    void setRowsConsumer(const LocalCSR::Consumer & consumer);
+    void setRowsInspector(const LocalCSR::Consumer & inspector);
+    void setPatternCaching(bool cache);
+    void setSharedData(const char * data, std::size_t size);
     void setDirectory(const std::string & dir);
     void setName(const std::string & name);
     void setAppendix(const std::string & app);
@@ -78,16 +139,45 @@ public:
     std::string getAppendix();
 
     int getNRows();
+    int getNCols();
+    int getNNz();
+    const RowPartition & getPartition() const;
+    long getCachedNonZeroCount() const;
+
+    LocalCSR::Consumer getCommitConsumer(std::unique_ptr<SparseMatrix> & matrix);
 
 private:
 
-    std::vector<int> computeLinesPerProc();
+    void readMatrixCSRFormatFile(std::unique_ptr<SparseMatrix> & matrix);
+    void readMatrixCSRFormatCached(std::unique_ptr<SparseMatrix> & matrix);
+    void readMatrixCSRFormatCollective(std::unique_ptr<SparseMatrix> & matrix);
+    void readMatrixCSRFormatScattered(std::unique_ptr<SparseMatrix> & matrix);
+    uint64_t readMatrixCSRFormatInfoOnFirst();
+    void readMatrixCSRFormatRowsThreaded(Tokenizer & tokenizer, int nLocalRows, int nThreads, LocalCSR & rows);
+
+    void cachePattern(long nRows, const long * rowPtr, const long * colIdx, long rowStart);
+
+    std::vector<long> scanRowLengths(std::istream & fileStream, const LineIndex & index, const RowPartition & partition);
+    long computeLocalNnzEstimate();
     std::vector<int> computeStartLinePerProc(const std::vector<int> & procRows);
 
     int m_nProcessors;                                  /**<number of MPI processes*/
     int m_rank;                                         /**<MPI rank of the process*/
 
     FileHandler m_fileHandler;                          /**<bitpit file handler*/
+    InputOptions m_inputOptions;                        /**<input settings shared by all the readers*/
+    RowPartition m_partition;                           /**<row partition among processes*/
+    std::string m_shardPattern;                         /**<shard file name pattern, empty for a single file*/
+    LocalCSR::Consumer m_rowsConsumer;                  /**<consumer of the local rows, if set no SparseMatrix is created*/
+    LocalCSR::Consumer m_rowsInspector;                 /**<inspector of the local rows, called before they are committed*/
+    bool m_cachePattern;                                /**<true if the pattern of the next matrix read is cached*/
+    std::vector<long> m_patternRowPtr;                  /**<cached offset of each local row in the cached column indices, followed by the local non-zeros*/
+    std::vector<long> m_patternColIdx;                  /**<cached global column indices of the local rows*/
+    long m_patternRowStart;                             /**<first global row of the cached local rows*/
+    long m_patternNnzStart;                             /**<first global non-zero of the cached local rows*/
+    const char *m_sharedData;                           /**<binary CSR container read in place of the file, null if none*/
+    std::size_t m_sharedSize;                           /**<size in bytes of the shared binary CSR container*/
+    std::unique_ptr<MatrixCache> m_cache;               /**<cache of the ASCII CSR matrix being read, null if disabled*/
 
     int m_nRows;                                        /**<number of rows as read in header file*/
     int m_nCols;                                        /**<number of columns as read in header file*/
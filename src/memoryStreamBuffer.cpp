@@ -0,0 +1,128 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#include "memoryStreamBuffer.hpp"
+
+/*!
+ * Default constructor
+ * The buffer is empty.
+ */
+MemoryStreamBuffer::MemoryStreamBuffer() :
+        m_baseOffset(0)
+{
+    reset(nullptr, 0, 0);
+}
+
+/*!
+ * Constructor
+ * \param[in] data pointer to the first byte of the chunk
+ * \param[in] size number of bytes of the chunk
+ * \param[in] baseOffset file offset of the first byte of the chunk
+ */
+MemoryStreamBuffer::MemoryStreamBuffer(const char *data, std::size_t size, uint64_t baseOffset) :
+        m_baseOffset(baseOffset)
+{
+    reset(data, size, baseOffset);
+}
+
+/*!
+ * It makes the buffer point to a new chunk, moving the read position at its beginning
+ * \param[in] data pointer to the first byte of the chunk
+ * \param[in] size number of bytes of the chunk
+ * \param[in] baseOffset file offset of the first byte of the chunk
+ */
+void MemoryStreamBuffer::reset(const char *data, std::size_t size, uint64_t baseOffset)
+{
+    //The get area is never written, std::streambuf just wants non-const pointers
+    char *begin = const_cast<char *>(data);
+    setg(begin, begin, begin + size);
+    m_baseOffset = baseOffset;
+}
+
+/*!
+ * It gets the first byte of the chunk
+ * \return a pointer to the first byte of the chunk
+ */
+const char * MemoryStreamBuffer::getData() const
+{
+    return eback();
+}
+
+/*!
+ * It gets the size of the chunk
+ * \return the number of bytes of the chunk
+ */
+std::size_t MemoryStreamBuffer::getSize() const
+{
+    return static_cast<std::size_t>(egptr() - eback());
+}
+
+/*!
+ * It gets the file offset of the first byte of the chunk
+ * \return the file offset of the first byte of the chunk
+ */
+uint64_t MemoryStreamBuffer::getBaseOffset() const
+{
+    return m_baseOffset;
+}
+
+/*!
+ * It moves the read position relatively to the beginning, the current position or the end of the chunk
+ * \param[in] off relative offset
+ * \param[in] dir reference position
+ * \param[in] which only input sequences are supported
+ * \return the new file position, or -1 if it falls outside the chunk
+ */
+MemoryStreamBuffer::pos_type MemoryStreamBuffer::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+    if(!(which & std::ios_base::in)) {
+        return pos_type(off_type(-1));
+    }
+
+    off_type position;
+    if(dir == std::ios_base::beg) {
+        position = off - static_cast<off_type>(m_baseOffset);
+    } else if(dir == std::ios_base::cur) {
+        position = (gptr() - eback()) + off;
+    } else {
+        position = (egptr() - eback()) + off;
+    }
+
+    if(position < 0 || position > (egptr() - eback())) {
+        return pos_type(off_type(-1));
+    }
+
+    setg(eback(), eback() + position, egptr());
+
+    return pos_type(position + static_cast<off_type>(m_baseOffset));
+}
+
+/*!
+ * It moves the read position at the given file offset
+ * \param[in] pos file offset
+ * \param[in] which only input sequences are supported
+ * \return the new file position, or -1 if it falls outside the chunk
+ */
+MemoryStreamBuffer::pos_type MemoryStreamBuffer::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+}
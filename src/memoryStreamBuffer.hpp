@@ -0,0 +1,64 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_MEMORYSTREAMBUFFER_HPP__
+#define __MADLINSOLV_MEMORYSTREAMBUFFER_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <streambuf>
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The read-only memory stream buffer class
+ *
+ *  This class is intended to
+ *  expose a chunk of a file, already loaded in memory, as a std::istream source without copying it.
+ *  Stream positions are file offsets: the first byte of the chunk is at position baseOffset,
+ *  so the same seek logic (e.g. LineIndex::seek) works both on files and on loaded chunks.
+ */
+class MemoryStreamBuffer : public std::streambuf {
+
+public:
+
+    MemoryStreamBuffer();
+    MemoryStreamBuffer(const char *data, std::size_t size, uint64_t baseOffset = 0);
+
+    void reset(const char *data, std::size_t size, uint64_t baseOffset = 0);
+
+    const char * getData() const;
+    std::size_t getSize() const;
+    uint64_t getBaseOffset() const;
+
+protected:
+
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+
+private:
+
+    uint64_t m_baseOffset;                              /**<file offset of the first byte of the chunk*/
+
+};
+
+#endif
@@ -0,0 +1,138 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#if ENABLE_MPI==1
+#    include <mpi.h>
+#endif
+
+#include <cstdlib>
+#include <fstream>
+#include <vector>
+
+#include <bitpit_IO.hpp>
+
+#include "memoryUsage.hpp"
+
+using namespace bitpit;
+
+namespace {
+
+/*!
+ * It gathers a pair of values of every process
+ * \param[in] first first value of the process
+ * \param[in] second second value of the process
+ * \return the values of all the processes, interleaved
+ */
+std::vector<long> gatherPairs(long first, long second)
+{
+    long local[2] = {first, second};
+    int nProcessors = 1;
+#if ENABLE_MPI==1
+    MPI_Comm_size(MPI_COMM_WORLD, &nProcessors);
+#endif
+    std::vector<long> values(2 * nProcessors);
+#if ENABLE_MPI==1
+    MPI_Allgather(local, 2, MPI_LONG, values.data(), 2, MPI_LONG, MPI_COMM_WORLD);
+#else
+    values.assign(local, local + 2);
+#endif
+
+    return values;
+}
+
+/*!
+ * It converts bytes to megabytes
+ * \param[in] bytes number of bytes
+ * \return the number of megabytes
+ */
+double toMegaBytes(long bytes)
+{
+    return static_cast<double>(bytes) / (1024. * 1024.);
+}
+
+}
+
+/*!
+ * It gets the current resident memory of the process
+ * \return the resident memory in bytes, zero if it is not available
+ */
+long MemoryUsage::getResidentSize()
+{
+    return readStatusField("VmRSS:");
+}
+
+/*!
+ * It gets the peak resident memory of the process since its start
+ * \return the peak resident memory in bytes, zero if it is not available
+ */
+long MemoryUsage::getPeakResidentSize()
+{
+    return readStatusField("VmHWM:");
+}
+
+/*!
+ * It logs, for every process, the resident memory before and after an operation. This method is collective.
+ * \param[in] label description of the operation
+ * \param[in] before resident memory of the process before the operation, in bytes
+ * \param[in] after resident memory of the process after the operation, in bytes
+ */
+void MemoryUsage::logChange(const std::string & label, long before, long after)
+{
+    std::vector<long> values = gatherPairs(before, after);
+    log::cout() << label << ", resident memory per rank:" << std::endl;
+    for(std::size_t p = 0; 2 * p < values.size(); ++p) {
+        log::cout() << "    rank " << p << ": " << toMegaBytes(values[2 * p]) << " MB -> " << toMegaBytes(values[2 * p + 1])
+                << " MB (" << toMegaBytes(values[2 * p + 1] - values[2 * p]) << " MB)" << std::endl;
+    }
+}
+
+/*!
+ * It logs, for every process, the current and the peak resident memory. This method is collective.
+ * \param[in] label description of the point of the run
+ */
+void MemoryUsage::logPeak(const std::string & label)
+{
+    std::vector<long> values = gatherPairs(getResidentSize(), getPeakResidentSize());
+    log::cout() << label << ", resident memory per rank (current/peak):" << std::endl;
+    for(std::size_t p = 0; 2 * p < values.size(); ++p) {
+        log::cout() << "    rank " << p << ": " << toMegaBytes(values[2 * p]) << " MB / " << toMegaBytes(values[2 * p + 1])
+                << " MB" << std::endl;
+    }
+}
+
+/*!
+ * It reads a memory field of /proc/self/status, expressed in kB
+ * \param[in] field name of the field, colon included
+ * \return the field value in bytes, zero if it is not available
+ */
+long MemoryUsage::readStatusField(const std::string & field)
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while(std::getline(status, line)) {
+        if(line.compare(0, field.size(), field) == 0) {
+            return 1024 * std::atol(line.c_str() + field.size());
+        }
+    }
+
+    return 0;
+}
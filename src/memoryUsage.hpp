@@ -0,0 +1,53 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_MEMORYUSAGE_HPP__
+#define __MADLINSOLV_MEMORYUSAGE_HPP__
+
+#include <string>
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The memory usage class
+ *
+ *  This class is intended to
+ *  read the resident memory of the process, current and peak, from /proc/self/status (VmRSS and VmHWM fields)
+ *  and to log it for every process. Where /proc is not available, sizes are reported as zero.
+ */
+class MemoryUsage {
+
+public:
+
+    static long getResidentSize();
+    static long getPeakResidentSize();
+
+    static void logChange(const std::string & label, long before, long after);
+    static void logPeak(const std::string & label);
+
+private:
+
+    static long readStatusField(const std::string & field);
+
+};
+
+#endif
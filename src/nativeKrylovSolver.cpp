@@ -0,0 +1,603 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifdef _OPENMP
+#    include <omp.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+
+#include <bitpit_IO.hpp>
+
+#include "nativeKrylovSolver.hpp"
+
+using namespace bitpit;
+
+namespace {
+
+/*!
+ * It allocates a vector without initializing it, so that its pages are first touched by the threads using them
+ * \param[in] n number of elements
+ * \return the vector
+ */
+std::unique_ptr<double[]> allocate(long n)
+{
+    return std::unique_ptr<double[]>(new double[std::max(n, 1L)]);
+}
+
+/*!
+ * It sets all the elements of a vector to a value
+ */
+void fill(long n, double value, double * x)
+{
+#pragma omp parallel for schedule(static)
+    for(long i = 0; i < n; ++i) {
+        x[i] = value;
+    }
+}
+
+/*!
+ * It copies a vector into another one
+ */
+void copy(long n, const double * x, double * y)
+{
+#pragma omp parallel for schedule(static)
+    for(long i = 0; i < n; ++i) {
+        y[i] = x[i];
+    }
+}
+
+/*!
+ * It computes the dot product of two vectors
+ */
+double dot(long n, const double * x, const double * y)
+{
+    double sum = 0.;
+#pragma omp parallel for schedule(static) reduction(+:sum)
+    for(long i = 0; i < n; ++i) {
+        sum += x[i] * y[i];
+    }
+
+    return sum;
+}
+
+/*!
+ * It computes the Euclidean norm of a vector
+ */
+double norm(long n, const double * x)
+{
+    return std::sqrt(dot(n, x, x));
+}
+
+/*!
+ * It computes y = y + a x
+ */
+void axpy(long n, double a, const double * x, double * y)
+{
+#pragma omp parallel for schedule(static)
+    for(long i = 0; i < n; ++i) {
+        y[i] += a * x[i];
+    }
+}
+
+/*!
+ * It computes y = x + a y
+ */
+void xpay(long n, const double * x, double a, double * y)
+{
+#pragma omp parallel for schedule(static)
+    for(long i = 0; i < n; ++i) {
+        y[i] = x[i] + a * y[i];
+    }
+}
+
+/*!
+ * It computes x = a x
+ */
+void scale(long n, double a, double * x)
+{
+#pragma omp parallel for schedule(static)
+    for(long i = 0; i < n; ++i) {
+        x[i] *= a;
+    }
+}
+
+}
+
+/*!
+ * Default constructor
+ * The method is GMRES with the Jacobi preconditioner and the PETSc default tolerances, until setOptions is called.
+ */
+NativeKrylovSolver::NativeKrylovSolver() :
+        m_method(Method::GMRES), m_isJacobi(true), m_restart(30), m_rtol(1.e-5), m_atol(1.e-50), m_maxIterations(10000),
+        m_nRows(0), m_rowPtr(1, 0), m_colIdx(), m_values(), m_inverseDiagonal(), m_solution(),
+        m_iterations(0), m_residual(0.), m_isConverged(false)
+{
+
+}
+
+/*!
+ * It gets the number of threads of the kernels
+ * \return the number of OpenMP threads, 1 without OpenMP
+ */
+int NativeKrylovSolver::getThreadCount()
+{
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+/*!
+ * It sets the Krylov method, the preconditioner, the restart length and the tolerances.
+ * KSP types other than cg, bcgs and gmres (fgmres being taken as gmres) fall back to GMRES,
+ * PC types other than jacobi and none fall back to Jacobi; the other settings are ignored.
+ * \param[in] options the settings, with PETSc names
+ */
+void NativeKrylovSolver::setOptions(const SolverOptions & options)
+{
+    m_method = Method::GMRES;
+    if(options.kspType == "cg") {
+        m_method = Method::CG;
+    } else if(options.kspType == "bcgs" || options.kspType == "bicgstab") {
+        m_method = Method::BICGSTAB;
+    } else if(!options.kspType.empty() && options.kspType != "gmres" && options.kspType != "fgmres") {
+        log::cout() << "KSP type " << options.kspType << " not available in the native Krylov engine, GMRES is used" << std::endl;
+    }
+
+    m_isJacobi = (options.pcType != "none");
+    if(!options.pcType.empty() && options.pcType != "jacobi" && options.pcType != "none") {
+        log::cout() << "PC type " << options.pcType << " not available in the native Krylov engine, Jacobi is used" << std::endl;
+    }
+    if(!options.petscOptions.empty()) {
+        log::cout() << "Free-form PETSc options are ignored by the native Krylov engine" << std::endl;
+    }
+
+    m_restart = (options.restart > 0) ? options.restart : 30;
+    m_rtol = (options.rtol > 0.) ? options.rtol : 1.e-5;
+    m_atol = (options.atol > 0.) ? options.atol : 1.e-50;
+    m_maxIterations = (options.maxIterations > 0) ? options.maxIterations : 10000;
+
+    const char *methodName = (m_method == Method::CG) ? "CG" : ((m_method == Method::BICGSTAB) ? "BiCGStab" : "GMRES");
+    log::cout() << "Native Krylov engine: " << methodName << (m_isJacobi ? " with Jacobi" : " without preconditioner")
+            << ", restart = " << m_restart << ", rtol = " << m_rtol << ", atol = " << m_atol
+            << ", maximum iterations = " << m_maxIterations << ", threads = " << getThreadCount() << std::endl;
+}
+
+/*!
+ * It copies the matrix, held by a single process, and it computes the Jacobi preconditioner.
+ * The solution is reset to zero.
+ * \param[in] nRows number of rows
+ * \param[in] rowPtr offset of each row in colIdx, nRows + 1 elements (the first one is not required to be zero)
+ * \param[in] colIdx column indices of the rows
+ * \param[in] values values of the rows
+ */
+void NativeKrylovSolver::setMatrix(long nRows, const long * rowPtr, const long * colIdx, const double * values)
+{
+    m_nRows = nRows;
+    long nzBegin = rowPtr[0];
+    m_rowPtr.assign(rowPtr, rowPtr + nRows + 1);
+    for(long & offset : m_rowPtr) {
+        offset -= nzBegin;
+    }
+
+    //Rows are copied by the threads multiplying them, with the same static schedule
+    long nNz = m_rowPtr.back();
+    m_colIdx = std::unique_ptr<long[]>(new long[std::max(nNz, 1L)]);
+    m_values = allocate(nNz);
+    m_inverseDiagonal = allocate(nRows);
+    m_solution = allocate(nRows);
+#pragma omp parallel for schedule(static)
+    for(long row = 0; row < nRows; ++row) {
+        double diagonal = 0.;
+        for(long nz = m_rowPtr[row]; nz < m_rowPtr[row + 1]; ++nz) {
+            m_colIdx[nz] = colIdx[nz + nzBegin];
+            m_values[nz] = values[nz + nzBegin];
+            if(m_colIdx[nz] == row) {
+                diagonal += m_values[nz];
+            }
+        }
+        m_inverseDiagonal[row] = (diagonal != 0.) ? 1. / diagonal : 1.;
+        m_solution[row] = 0.;
+    }
+
+    log::cout() << "Native matrix: " << nRows << " rows, " << nNz << " non-zeros, "
+            << static_cast<double>(nNz * (sizeof(long) + sizeof(double)) + (nRows + 1) * sizeof(long)) / (1024. * 1024.) << " MB" << std::endl;
+}
+
+/*!
+ * It solves the system with the right-hand side, starting from the current solution.
+ * \param[in] rhs the right-hand side
+ * \return true if the tolerance has been reached
+ */
+bool NativeKrylovSolver::solve(const double * rhs)
+{
+    m_iterations = 0;
+    m_isConverged = false;
+
+    double rhsNorm = norm(m_nRows, rhs);
+    if(rhsNorm == 0.) {
+        fill(m_nRows, 0., m_solution.get());
+        m_residual = 0.;
+        m_isConverged = true;
+        return true;
+    }
+
+    double target = std::max(m_rtol * rhsNorm, m_atol);
+    switch(m_method) {
+    case Method::CG:
+        solveCG(rhs, target);
+        break;
+    case Method::BICGSTAB:
+        solveBiCGStab(rhs, target);
+        break;
+    case Method::GMRES:
+        solveGMRES(rhs, target);
+        break;
+    }
+
+    return m_isConverged;
+}
+
+/*!
+ * It gets the number of rows
+ * \return the number of rows
+ */
+long NativeKrylovSolver::getRowCount() const
+{
+    return m_nRows;
+}
+
+/*!
+ * It gets the number of non-zeros
+ * \return the number of non-zeros
+ */
+long NativeKrylovSolver::getNonZeroCount() const
+{
+    return m_rowPtr.back();
+}
+
+/*!
+ * It gets the solution, i.e. the initial guess of the next solve
+ * \return a pointer to the first element of the solution
+ */
+double * NativeKrylovSolver::getSolution()
+{
+    return m_solution.get();
+}
+
+/*!
+ * It gets the solution, i.e. the initial guess of the next solve
+ * \return a constant pointer to the first element of the solution
+ */
+const double * NativeKrylovSolver::getSolution() const
+{
+    return m_solution.get();
+}
+
+/*!
+ * It gets the iterations of the last solve
+ * \return the number of iterations
+ */
+long NativeKrylovSolver::getIterations() const
+{
+    return m_iterations;
+}
+
+/*!
+ * It gets the residual norm at the end of the last solve
+ * \return the norm of the residual
+ */
+double NativeKrylovSolver::getResidual() const
+{
+    return m_residual;
+}
+
+/*!
+ * It gets if the last solve reached the tolerance
+ * \return true if the tolerance has been reached
+ */
+bool NativeKrylovSolver::isConverged() const
+{
+    return m_isConverged;
+}
+
+/*!
+ * It computes the product of the matrix by a vector, one block of rows per thread
+ * \param[in] x the vector
+ * \param[out] y the product
+ */
+void NativeKrylovSolver::multiply(const double * x, double * y) const
+{
+#pragma omp parallel for schedule(static)
+    for(long row = 0; row < m_nRows; ++row) {
+        double sum = 0.;
+        for(long nz = m_rowPtr[row]; nz < m_rowPtr[row + 1]; ++nz) {
+            sum += m_values[nz] * x[m_colIdx[nz]];
+        }
+        y[row] = sum;
+    }
+}
+
+/*!
+ * It applies the preconditioner to a vector
+ * \param[in] x the vector
+ * \param[out] y the preconditioned vector
+ */
+void NativeKrylovSolver::precondition(const double * x, double * y) const
+{
+    if(!m_isJacobi) {
+        copy(m_nRows, x, y);
+        return;
+    }
+
+#pragma omp parallel for schedule(static)
+    for(long i = 0; i < m_nRows; ++i) {
+        y[i] = m_inverseDiagonal[i] * x[i];
+    }
+}
+
+/*!
+ * It computes the residual of a solution
+ * \param[in] rhs the right-hand side
+ * \param[in] x the solution
+ * \param[out] residual the residual, b - Ax
+ * \return the norm of the residual
+ */
+double NativeKrylovSolver::computeResidual(const double * rhs, const double * x, double * residual) const
+{
+    multiply(x, residual);
+    xpay(m_nRows, rhs, -1., residual);
+
+    return norm(m_nRows, residual);
+}
+
+/*!
+ * It solves the system with the preconditioned conjugate gradient method.
+ * When the recursively updated residual reaches the tolerance, the true residual is checked and, if it does not,
+ * the method is restarted from it. It stops if the matrix turns out not to be positive definite.
+ * \param[in] rhs the right-hand side
+ * \param[in] target the residual norm to be reached
+ */
+void NativeKrylovSolver::solveCG(const double * rhs, double target)
+{
+    long n = m_nRows;
+    double *x = m_solution.get();
+    std::unique_ptr<double[]> r = allocate(n);
+    std::unique_ptr<double[]> z = allocate(n);
+    std::unique_ptr<double[]> p = allocate(n);
+    std::unique_ptr<double[]> q = allocate(n);
+
+    while(true) {
+        m_residual = computeResidual(rhs, x, r.get());
+        if(m_residual <= target) {
+            m_isConverged = true;
+            return;
+        }
+        if(m_iterations >= m_maxIterations) {
+            return;
+        }
+        precondition(r.get(), z.get());
+        copy(n, z.get(), p.get());
+        double rz = dot(n, r.get(), z.get());
+
+        while(m_iterations < m_maxIterations) {
+            multiply(p.get(), q.get());
+            double pq = dot(n, p.get(), q.get());
+            if(pq <= 0.) {
+                log::cout() << "CG breakdown, the matrix is not positive definite" << std::endl;
+                m_residual = computeResidual(rhs, x, r.get());
+                return;
+            }
+            double alpha = rz / pq;
+            axpy(n, alpha, p.get(), x);
+            axpy(n, -alpha, q.get(), r.get());
+            ++m_iterations;
+            if(norm(n, r.get()) <= target) {
+                break;
+            }
+
+            precondition(r.get(), z.get());
+            double rzNew = dot(n, r.get(), z.get());
+            xpay(n, z.get(), rzNew / rz, p.get());
+            rz = rzNew;
+        }
+    }
+}
+
+/*!
+ * It solves the system with the right preconditioned BiCGStab method.
+ * When the recursively updated residual reaches the tolerance, the true residual is checked and, if it does not,
+ * the method is restarted from it.
+ * \param[in] rhs the right-hand side
+ * \param[in] target the residual norm to be reached
+ */
+void NativeKrylovSolver::solveBiCGStab(const double * rhs, double target)
+{
+    long n = m_nRows;
+    double *x = m_solution.get();
+    std::unique_ptr<double[]> r = allocate(n);
+    std::unique_ptr<double[]> rHat = allocate(n);
+    std::unique_ptr<double[]> p = allocate(n);
+    std::unique_ptr<double[]> v = allocate(n);
+    std::unique_ptr<double[]> pHat = allocate(n);
+    std::unique_ptr<double[]> sHat = allocate(n);
+    std::unique_ptr<double[]> t = allocate(n);
+
+    while(true) {
+        m_residual = computeResidual(rhs, x, r.get());
+        if(m_residual <= target) {
+            m_isConverged = true;
+            return;
+        }
+        if(m_iterations >= m_maxIterations) {
+            return;
+        }
+        copy(n, r.get(), rHat.get());
+        fill(n, 0., p.get());
+        fill(n, 0., v.get());
+
+        double rho = 1.;
+        double alpha = 1.;
+        double omega = 1.;
+        while(m_iterations < m_maxIterations) {
+            double rhoNew = dot(n, rHat.get(), r.get());
+            if(rhoNew == 0.) {
+                log::cout() << "BiCGStab breakdown" << std::endl;
+                m_residual = computeResidual(rhs, x, r.get());
+                return;
+            }
+            double beta = (rhoNew / rho) * (alpha / omega);
+#pragma omp parallel for schedule(static)
+            for(long i = 0; i < n; ++i) {
+                p[i] = r[i] + beta * (p[i] - omega * v[i]);
+            }
+            precondition(p.get(), pHat.get());
+            multiply(pHat.get(), v.get());
+            double rHatV = dot(n, rHat.get(), v.get());
+            if(rHatV == 0.) {
+                log::cout() << "BiCGStab breakdown" << std::endl;
+                m_residual = computeResidual(rhs, x, r.get());
+                return;
+            }
+            alpha = rhoNew / rHatV;
+
+            //The residual holds s = r - alpha v until the end of the iteration
+            axpy(n, -alpha, v.get(), r.get());
+            ++m_iterations;
+            if(norm(n, r.get()) <= target) {
+                axpy(n, alpha, pHat.get(), x);
+                break;
+            }
+
+            precondition(r.get(), sHat.get());
+            multiply(sHat.get(), t.get());
+            double tt = dot(n, t.get(), t.get());
+            omega = (tt > 0.) ? dot(n, t.get(), r.get()) / tt : 0.;
+#pragma omp parallel for schedule(static)
+            for(long i = 0; i < n; ++i) {
+                x[i] += alpha * pHat[i] + omega * sHat[i];
+                r[i] -= omega * t[i];
+            }
+            rho = rhoNew;
+            if(norm(n, r.get()) <= target) {
+                break;
+            }
+            if(omega == 0.) {
+                log::cout() << "BiCGStab breakdown" << std::endl;
+                m_residual = computeResidual(rhs, x, r.get());
+                return;
+            }
+        }
+    }
+}
+
+/*!
+ * It solves the system with the right preconditioned GMRES method, restarted every restart iterations.
+ * The Krylov basis is orthogonalized with the modified Gram-Schmidt method and the least squares problem is
+ * solved with Givens rotations. Every restart starts from the true residual, so that convergence is never
+ * claimed on the estimate of the rotations only.
+ * \param[in] rhs the right-hand side
+ * \param[in] target the residual norm to be reached
+ */
+void NativeKrylovSolver::solveGMRES(const double * rhs, double target)
+{
+    long n = m_nRows;
+    int m = m_restart;
+    double *x = m_solution.get();
+    std::vector<std::unique_ptr<double[]>> basis(m + 1);
+    for(std::unique_ptr<double[]> & vector : basis) {
+        vector = allocate(n);
+    }
+    std::unique_ptr<double[]> w = allocate(n);
+    std::vector<double> hessenberg((m + 1) * m, 0.);
+    std::vector<double> cosines(m, 0.);
+    std::vector<double> sines(m, 0.);
+    std::vector<double> g(m + 1, 0.);
+    std::vector<double> y(m, 0.);
+
+    while(true) {
+        m_residual = computeResidual(rhs, x, basis[0].get());
+        if(m_residual <= target) {
+            m_isConverged = true;
+            return;
+        }
+        if(m_iterations >= m_maxIterations) {
+            return;
+        }
+        scale(n, 1. / m_residual, basis[0].get());
+        std::fill(g.begin(), g.end(), 0.);
+        g[0] = m_residual;
+
+        int k = 0;
+        while(k < m && m_iterations < m_maxIterations) {
+            precondition(basis[k].get(), w.get());
+            multiply(w.get(), basis[k + 1].get());
+            for(int i = 0; i <= k; ++i) {
+                double h = dot(n, basis[k + 1].get(), basis[i].get());
+                hessenberg[i * m + k] = h;
+                axpy(n, -h, basis[i].get(), basis[k + 1].get());
+            }
+            double h = norm(n, basis[k + 1].get());
+            if(h > 0.) {
+                scale(n, 1. / h, basis[k + 1].get());
+            }
+
+            for(int i = 0; i < k; ++i) {
+                double upper = hessenberg[i * m + k];
+                double lower = hessenberg[(i + 1) * m + k];
+                hessenberg[i * m + k] = cosines[i] * upper + sines[i] * lower;
+                hessenberg[(i + 1) * m + k] = -sines[i] * upper + cosines[i] * lower;
+            }
+            double diagonal = hessenberg[k * m + k];
+            double radius = std::sqrt(diagonal * diagonal + h * h);
+            cosines[k] = (radius > 0.) ? diagonal / radius : 1.;
+            sines[k] = (radius > 0.) ? h / radius : 0.;
+            hessenberg[k * m + k] = radius;
+            g[k + 1] = -sines[k] * g[k];
+            g[k] = cosines[k] * g[k];
+
+            ++k;
+            ++m_iterations;
+            if(std::abs(g[k]) <= target || h == 0.) {
+                break;
+            }
+        }
+
+        //The update is the preconditioned combination of the basis solving the least squares problem
+        for(int i = k - 1; i >= 0; --i) {
+            y[i] = g[i];
+            for(int j = i + 1; j < k; ++j) {
+                y[i] -= hessenberg[i * m + j] * y[j];
+            }
+            y[i] = (hessenberg[i * m + i] != 0.) ? y[i] / hessenberg[i * m + i] : 0.;
+        }
+        fill(n, 0., w.get());
+        for(int i = 0; i < k; ++i) {
+            axpy(n, y[i], basis[i].get(), w.get());
+        }
+        precondition(w.get(), basis[0].get());
+        axpy(n, 1., basis[0].get(), x);
+    }
+}
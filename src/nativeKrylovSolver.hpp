@@ -0,0 +1,110 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_NATIVEKRYLOVSOLVER_HPP__
+#define __MADLINSOLV_NATIVEKRYLOVSOLVER_HPP__
+
+#include <memory>
+#include <vector>
+
+#include "solverOptions.hpp"
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The native Krylov solver class
+ *
+ *  This class is intended to
+ *  solve a linear system held by a single process without bitpit and PETSc, on all the cores of a node:
+ *  the matrix is kept in CSR arrays and the Krylov methods are built on OpenMP parallel kernels
+ *  (sparse matrix-vector product, dot products and vector updates). Without OpenMP, the kernels run serially.
+ *  The methods are CG, BiCGStab and restarted GMRES, with the Jacobi preconditioner or none;
+ *  they are chosen with the PETSc names of SolverOptions (cg, bcgs, gmres), together with the restart length
+ *  and the tolerances, whose defaults are those of PETSc.
+ *  Preconditioning is applied on the right for BiCGStab and GMRES, so that all the methods check convergence on
+ *  the norm of the true residual: ||b - Ax|| <= max(rtol ||b||, atol).
+ *  The matrix arrays are copied by the threads that later work on them, so that on NUMA nodes every thread
+ *  finds its rows in its own memory.
+ *  Like SystemSolver, the solution vector holds the initial guess before a solve and the solution after it.
+ */
+class NativeKrylovSolver {
+
+public:
+
+    /*!
+     * Krylov methods
+     */
+    enum class Method {
+        CG,                                             /**<conjugate gradient, for symmetric positive definite matrices*/
+        BICGSTAB,                                       /**<stabilized bi-conjugate gradient*/
+        GMRES                                           /**<restarted generalized minimal residual*/
+    };
+
+    NativeKrylovSolver();
+
+    static int getThreadCount();
+
+    void setOptions(const SolverOptions & options);
+    void setMatrix(long nRows, const long * rowPtr, const long * colIdx, const double * values);
+
+    bool solve(const double * rhs);
+
+    long getRowCount() const;
+    long getNonZeroCount() const;
+    double * getSolution();
+    const double * getSolution() const;
+    long getIterations() const;
+    double getResidual() const;
+    bool isConverged() const;
+
+    void multiply(const double * x, double * y) const;
+
+private:
+
+    void precondition(const double * x, double * y) const;
+    double computeResidual(const double * rhs, const double * x, double * residual) const;
+
+    void solveCG(const double * rhs, double target);
+    void solveBiCGStab(const double * rhs, double target);
+    void solveGMRES(const double * rhs, double target);
+
+    Method m_method;                                    /**<Krylov method*/
+    bool m_isJacobi;                                    /**<true if the Jacobi preconditioner is applied*/
+    int m_restart;                                      /**<restart length of GMRES*/
+    double m_rtol;                                      /**<relative tolerance*/
+    double m_atol;                                      /**<absolute tolerance*/
+    long m_maxIterations;                               /**<maximum number of iterations*/
+
+    long m_nRows;                                       /**<number of rows*/
+    std::vector<long> m_rowPtr;                         /**<offset of each row in the column indices, followed by the non-zeros*/
+    std::unique_ptr<long[]> m_colIdx;                   /**<column indices of the non-zeros*/
+    std::unique_ptr<double[]> m_values;                 /**<values of the non-zeros*/
+    std::unique_ptr<double[]> m_inverseDiagonal;        /**<inverse of the diagonal, 1 where it is zero*/
+    std::unique_ptr<double[]> m_solution;               /**<initial guess before a solve, solution after it*/
+
+    long m_iterations;                                  /**<iterations of the last solve*/
+    double m_residual;                                  /**<residual norm at the end of the last solve*/
+    bool m_isConverged;                                 /**<true if the last solve reached the tolerance*/
+
+};
+
+#endif
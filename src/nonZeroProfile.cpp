@@ -0,0 +1,115 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#if ENABLE_MPI==1
+#    include <mpi.h>
+#endif
+
+#include <bitpit_IO.hpp>
+
+#include "nonZeroProfile.hpp"
+
+using namespace bitpit;
+
+/*!
+ * Default constructor
+ * It builds an empty profile.
+ */
+NonZeroProfile::NonZeroProfile() :
+        m_nDiagonalNz(0), m_nOffDiagonalNz(0)
+{
+
+}
+
+/*!
+ * It counts the non-zeros of the local rows in the diagonal and off-diagonal blocks
+ * \param[in] nLocalRows number of rows owned by the process
+ * \param[in] rowPtr offset of each local row in colIdx, nLocalRows + 1 elements (the first one is not required to be zero)
+ * \param[in] colIdx global column indices of the local rows
+ * \param[in] diagonalBegin first global column of the diagonal block
+ * \param[in] diagonalEnd global column after the last one of the diagonal block
+ */
+void NonZeroProfile::compute(long nLocalRows, const long * rowPtr, const long * colIdx, long diagonalBegin, long diagonalEnd)
+{
+    m_nDiagonalNz = 0;
+    for(long k = rowPtr[0]; k < rowPtr[nLocalRows]; ++k) {
+        if(colIdx[k] >= diagonalBegin && colIdx[k] < diagonalEnd) {
+            ++m_nDiagonalNz;
+        }
+    }
+    m_nOffDiagonalNz = (rowPtr[nLocalRows] - rowPtr[0]) - m_nDiagonalNz;
+}
+
+/*!
+ * It gets the number of local non-zeros
+ * \return the number of non-zeros of the local rows
+ */
+long NonZeroProfile::getNonZeroCount() const
+{
+    return m_nDiagonalNz + m_nOffDiagonalNz;
+}
+
+/*!
+ * It gets the number of local non-zeros in the diagonal block
+ * \return the number of non-zeros of the local rows in the diagonal block
+ */
+long NonZeroProfile::getDiagonalNonZeroCount() const
+{
+    return m_nDiagonalNz;
+}
+
+/*!
+ * It gets the number of local non-zeros in the off-diagonal block
+ * \return the number of non-zeros of the local rows in the off-diagonal block
+ */
+long NonZeroProfile::getOffDiagonalNonZeroCount() const
+{
+    return m_nOffDiagonalNz;
+}
+
+/*!
+ * It prints the global diagonal and off-diagonal non-zeros, the memory the exact preallocation saved
+ * with respect to the estimate (unused storage on the processes with fewer non-zeros, storage growth
+ * on the ones with more) and the time spent building the SparseMatrix. This method is collective.
+ * Each non-zero takes a column index and a value in the SparseMatrix storage.
+ * \param[in] estimatedNnz number of local non-zeros the SparseMatrix would have been initialized with
+ * \param[in] fillTime seconds spent by the process creating the SparseMatrix, adding its rows and assembling it
+ */
+void NonZeroProfile::report(long estimatedNnz, double fillTime) const
+{
+    const double bytesPerNz = static_cast<double>(sizeof(long) + sizeof(double));
+    long difference = estimatedNnz - getNonZeroCount();
+    double sums[4] = {static_cast<double>(m_nDiagonalNz), static_cast<double>(m_nOffDiagonalNz),
+            difference > 0 ? bytesPerNz * difference : 0., difference < 0 ? -bytesPerNz * difference : 0.};
+    double maxFillTime = fillTime;
+#if ENABLE_MPI==1
+    MPI_Allreduce(MPI_IN_PLACE, sums, 4, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &maxFillTime, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+#endif
+
+    const double megaBytes = 1024. * 1024.;
+    log::cout() << "Non-zeros in diagonal blocks = " << static_cast<long>(sums[0])
+            << ", in off-diagonal blocks = " << static_cast<long>(sums[1]) << std::endl;
+    log::cout() << "Exact preallocation saved " << sums[2] / megaBytes << " MB of unused storage and "
+            << sums[3] / megaBytes << " MB of storage growth" << std::endl;
+    log::cout() << "SparseMatrix creation, row insertion and assembly time = " << maxFillTime << " s" << std::endl;
+}
@@ -0,0 +1,60 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_NONZEROPROFILE_HPP__
+#define __MADLINSOLV_NONZEROPROFILE_HPP__
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The non-zero profile class
+ *
+ *  This class is intended to
+ *  count the exact number of non-zeros of the rows owned by the process, split between the diagonal block
+ *  (columns owned by the process itself) and the off-diagonal block (columns owned by the other processes).
+ *  Readers compute it from the local CSR arrays before creating the SparseMatrix, so that its storage
+ *  is reserved exactly instead of from the average number of non-zeros per process; the PETSc matrix
+ *  is then preallocated by SystemSolver::assembly from the pattern of the SparseMatrix.
+ *  The report method prints the memory saved with respect to the average estimate.
+ */
+class NonZeroProfile {
+
+public:
+
+    NonZeroProfile();
+
+    void compute(long nLocalRows, const long * rowPtr, const long * colIdx, long diagonalBegin, long diagonalEnd);
+
+    long getNonZeroCount() const;
+    long getDiagonalNonZeroCount() const;
+    long getOffDiagonalNonZeroCount() const;
+
+    void report(long estimatedNnz, double fillTime) const;
+
+private:
+
+    long m_nDiagonalNz;                                 /**<number of local non-zeros in the diagonal block*/
+    long m_nOffDiagonalNz;                              /**<number of local non-zeros in the off-diagonal block*/
+
+};
+
+#endif
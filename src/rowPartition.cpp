@@ -0,0 +1,314 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#if ENABLE_MPI==1
+#    include <mpi.h>
+#endif
+
+#include <algorithm>
+
+#include "rowPartition.hpp"
+
+namespace {
+
+/*!
+ * It computes the cost of the rows preceding the given one
+ * \param[in] row global row index
+ * \param[in] nnzPrefix number of non-zeros preceding the row
+ * \param[in] meanNnz average number of non-zeros per row
+ * \param[in] weight weight of the non-zeros in the row cost
+ * \return the cumulative cost, always evaluated the same way so that all the processes agree on it
+ */
+inline double computeCost(long row, long nnzPrefix, double meanNnz, double weight)
+{
+    return weight * static_cast<double>(nnzPrefix) + (1. - weight) * meanNnz * static_cast<double>(row);
+}
+
+}
+
+/*!
+ * Default constructor
+ * It builds an empty partition.
+ */
+RowPartition::RowPartition() :
+        m_rowStarts(), m_nnzStarts()
+{
+
+}
+
+/*!
+ * It builds the partition giving the same number of rows to every process, the remainder going to the first ones
+ * \param[in] nRows global number of rows
+ * \param[in] nProcessors number of MPI processes
+ * \return the partition
+ */
+RowPartition RowPartition::uniform(long nRows, int nProcessors)
+{
+    RowPartition partition;
+    partition.m_rowStarts.assign(nProcessors + 1, 0);
+
+    long division = nRows / nProcessors;
+    long reminder = nRows % nProcessors;
+    for(int p = 0; p < nProcessors; ++p) {
+        partition.m_rowStarts[p + 1] = partition.m_rowStarts[p] + division + (p < reminder ? 1 : 0);
+    }
+
+    return partition;
+}
+
+/*!
+ * It builds the partition from the global row pointer of a CSR matrix. No communication is needed.
+ * \param[in] nRows global number of rows
+ * \param[in] nProcessors number of MPI processes
+ * \param[in] rowOffsets global row pointer, nRows + 1 elements
+ * \param[in] weight weight of the non-zeros in the row cost, between 0 (equal rows) and 1 (equal non-zeros)
+ * \return the partition, with the number of non-zeros of each process
+ */
+RowPartition RowPartition::fromRowOffsets(long nRows, int nProcessors, const int64_t * rowOffsets, double weight)
+{
+    long nNz = rowOffsets[nRows];
+
+    RowPartition partition;
+    if(weight <= 0. || nNz == 0) {
+        partition = uniform(nRows, nProcessors);
+    } else {
+        weight = std::min(weight, 1.);
+        double meanNnz = static_cast<double>(nNz) / static_cast<double>(nRows);
+        double totalCost = static_cast<double>(nNz);
+
+        partition.m_rowStarts.assign(nProcessors + 1, 0);
+        partition.m_rowStarts[nProcessors] = nRows;
+        for(int p = 1; p < nProcessors; ++p) {
+            double target = totalCost * p / nProcessors;
+
+            //Smallest row whose preceding cost reaches the target, then the closest of it and the previous one
+            long low = partition.m_rowStarts[p - 1];
+            long high = nRows;
+            while(low < high) {
+                long middle = low + (high - low) / 2;
+                if(computeCost(middle, rowOffsets[middle], meanNnz, weight) < target) {
+                    low = middle + 1;
+                } else {
+                    high = middle;
+                }
+            }
+            if(low > partition.m_rowStarts[p - 1]
+                    && target - computeCost(low - 1, rowOffsets[low - 1], meanNnz, weight) < computeCost(low, rowOffsets[low], meanNnz, weight) - target) {
+                --low;
+            }
+            partition.m_rowStarts[p] = low;
+        }
+    }
+
+    partition.m_nnzStarts.resize(nProcessors + 1);
+    for(int p = 0; p <= nProcessors; ++p) {
+        partition.m_nnzStarts[p] = rowOffsets[partition.m_rowStarts[p]];
+    }
+
+    return partition;
+}
+
+/*!
+ * It builds the partition from the lengths of the rows, distributed among the processes according to an initial partition.
+ * The processes compute the prefix of their non-zeros with a scan, then each one locates the partition boundaries
+ * falling in its own rows: the full row lengths are never gathered. This method is collective.
+ * \param[in] initial the partition the row lengths are distributed with
+ * \param[in] rank process MPI rank
+ * \param[in] localRowNnz number of non-zeros of each row of the process in the initial partition
+ * \param[in] weight weight of the non-zeros in the row cost, between 0 (equal rows) and 1 (equal non-zeros)
+ * \return the partition, with the number of non-zeros of each process
+ */
+RowPartition RowPartition::balance(const RowPartition & initial, int rank, const std::vector<long> & localRowNnz, double weight)
+{
+    int nProcessors = initial.getProcessorCount();
+    long nRows = initial.getRowGlobalCount();
+
+    long localNnz = 0;
+    for(long nnz : localRowNnz) {
+        localNnz += nnz;
+    }
+    long nnzBefore = 0;
+    long nNz = localNnz;
+#if ENABLE_MPI==1
+    MPI_Exscan(&localNnz, &nnzBefore, 1, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+    if(rank == 0) {
+        nnzBefore = 0;
+    }
+    MPI_Allreduce(&localNnz, &nNz, 1, MPI_LONG, MPI_SUM, MPI_COMM_WORLD);
+#endif
+
+    RowPartition partition;
+    if(weight <= 0. || nNz == 0) {
+        //Keep the initial rows, only the non-zeros of each process are needed
+        partition.m_rowStarts = initial.m_rowStarts;
+        partition.m_nnzStarts.assign(nProcessors + 1, 0);
+        partition.m_nnzStarts[rank] = nnzBefore;
+#if ENABLE_MPI==1
+        MPI_Allgather(&nnzBefore, 1, MPI_LONG, partition.m_nnzStarts.data(), 1, MPI_LONG, MPI_COMM_WORLD);
+#endif
+        partition.m_nnzStarts[nProcessors] = nNz;
+        return partition;
+    }
+
+    weight = std::min(weight, 1.);
+    double meanNnz = static_cast<double>(nNz) / static_cast<double>(nRows);
+    double totalCost = static_cast<double>(nNz);
+
+    //Locate the boundaries whose target cost falls in the process rows
+    std::vector<long> bounds(2 * (nProcessors + 1), 0);
+    long row = initial.getRowStart(rank);
+    long nnzPrefix = nnzBefore;
+    double cost = computeCost(row, nnzPrefix, meanNnz, weight);
+    int p = 1;
+    while(p < nProcessors && totalCost * p / nProcessors <= cost) {
+        ++p;
+    }
+    for(long nnz : localRowNnz) {
+        double nextCost = computeCost(row + 1, nnzPrefix + nnz, meanNnz, weight);
+        while(p < nProcessors && totalCost * p / nProcessors <= nextCost) {
+            double target = totalCost * p / nProcessors;
+            bool before = (target - cost < nextCost - target);
+            bounds[p] = before ? row : row + 1;
+            bounds[nProcessors + 1 + p] = before ? nnzPrefix : nnzPrefix + nnz;
+            ++p;
+        }
+        cost = nextCost;
+        nnzPrefix += nnz;
+        ++row;
+    }
+#if ENABLE_MPI==1
+    MPI_Allreduce(MPI_IN_PLACE, bounds.data(), static_cast<int>(bounds.size()), MPI_LONG, MPI_MAX, MPI_COMM_WORLD);
+#endif
+
+    partition.m_rowStarts.assign(bounds.begin(), bounds.begin() + nProcessors + 1);
+    partition.m_nnzStarts.assign(bounds.begin() + nProcessors + 1, bounds.end());
+    partition.m_rowStarts[nProcessors] = nRows;
+    partition.m_nnzStarts[nProcessors] = nNz;
+
+    return partition;
+}
+
+/*!
+ * It builds the partition from explicit row ranges
+ * \param[in] rowStarts first row of each process, followed by the global number of rows
+ * \param[in] nnzStarts first non-zero of each process, followed by the global number of non-zeros, empty if unknown
+ * \return the partition
+ */
+RowPartition RowPartition::fromRowStarts(const std::vector<long> & rowStarts, const std::vector<long> & nnzStarts)
+{
+    RowPartition partition;
+    partition.m_rowStarts = rowStarts;
+    if(nnzStarts.size() == rowStarts.size()) {
+        partition.m_nnzStarts = nnzStarts;
+    }
+
+    return partition;
+}
+
+/*!
+ * It checks if the partition has been built
+ * \return true if the partition is empty
+ */
+bool RowPartition::isEmpty() const
+{
+    return m_rowStarts.empty();
+}
+
+/*!
+ * It gets the number of processes of the partition
+ * \return the number of processes
+ */
+int RowPartition::getProcessorCount() const
+{
+    return m_rowStarts.empty() ? 0 : static_cast<int>(m_rowStarts.size()) - 1;
+}
+
+/*!
+ * It gets the global number of rows
+ * \return the global number of rows
+ */
+long RowPartition::getRowGlobalCount() const
+{
+    return m_rowStarts.empty() ? 0 : m_rowStarts.back();
+}
+
+/*!
+ * It gets the first global row of a process
+ * \param[in] rank process MPI rank
+ * \return the first global row of the process
+ */
+long RowPartition::getRowStart(int rank) const
+{
+    return m_rowStarts[rank];
+}
+
+/*!
+ * It gets the number of rows of a process
+ * \param[in] rank process MPI rank
+ * \return the number of rows of the process
+ */
+long RowPartition::getRowCount(int rank) const
+{
+    return m_rowStarts[rank + 1] - m_rowStarts[rank];
+}
+
+/*!
+ * It gets the number of rows of every process
+ * \return a vector containing the number of rows of each process
+ */
+std::vector<int> RowPartition::getRowCounts() const
+{
+    std::vector<int> counts(getProcessorCount());
+    for(std::size_t p = 0; p < counts.size(); ++p) {
+        counts[p] = static_cast<int>(m_rowStarts[p + 1] - m_rowStarts[p]);
+    }
+
+    return counts;
+}
+
+/*!
+ * It gets the first global row of every process, followed by the global number of rows
+ * \return a vector of number of processes + 1 elements
+ */
+std::vector<long> RowPartition::getRowStarts() const
+{
+    return m_rowStarts;
+}
+
+/*!
+ * It checks if the number of non-zeros of each process is known
+ * \return true if the non-zeros are known
+ */
+bool RowPartition::hasNonZeroCounts() const
+{
+    return !m_nnzStarts.empty();
+}
+
+/*!
+ * It gets the number of non-zeros of a process. Valid only if hasNonZeroCounts is true.
+ * \param[in] rank process MPI rank
+ * \return the number of non-zeros of the process
+ */
+long RowPartition::getNonZeroCount(int rank) const
+{
+    return m_nnzStarts[rank + 1] - m_nnzStarts[rank];
+}
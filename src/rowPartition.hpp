@@ -0,0 +1,76 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_ROWPARTITION_HPP__
+#define __MADLINSOLV_ROWPARTITION_HPP__
+
+#include <cstdint>
+#include <vector>
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The row partition class
+ *
+ *  This class is intended to
+ *  store which contiguous range of global rows each process owns. The same object is shared by the matrix,
+ *  right-hand side and initial solution readers, so the three layouts always match.
+ *  Partitions are computed balancing the cost of the rows:
+ *  \verbatim
+ *      cost(row) = weight * nonzeros(row) + (1 - weight) * average_nonzeros_per_row
+ *  \endverbatim
+ *  A weight of 0 gives the same number of rows to every process (the remainder going to the first ones),
+ *  a weight of 1 the same number of non-zeros, intermediate values a mix of the two.
+ *  The row lengths are known either through the row pointer of a binary CSR matrix, or through a prefix scan
+ *  of the row lengths distributed among the processes (see balance method).
+ *  A partition can also be given explicitly, e.g. by the row ranges of a sharded input (see ShardSet class).
+ */
+class RowPartition {
+
+public:
+
+    RowPartition();
+
+    static RowPartition uniform(long nRows, int nProcessors);
+    static RowPartition fromRowOffsets(long nRows, int nProcessors, const int64_t * rowOffsets, double weight);
+    static RowPartition balance(const RowPartition & initial, int rank, const std::vector<long> & localRowNnz, double weight);
+    static RowPartition fromRowStarts(const std::vector<long> & rowStarts, const std::vector<long> & nnzStarts);
+
+    bool isEmpty() const;
+    int getProcessorCount() const;
+    long getRowGlobalCount() const;
+    long getRowStart(int rank) const;
+    long getRowCount(int rank) const;
+    std::vector<int> getRowCounts() const;
+    std::vector<long> getRowStarts() const;
+
+    bool hasNonZeroCounts() const;
+    long getNonZeroCount(int rank) const;
+
+private:
+
+    std::vector<long> m_rowStarts;                      /**<first row of each process, followed by the number of rows*/
+    std::vector<long> m_nnzStarts;                      /**<first non-zero of each process, followed by the number of non-zeros (empty if unknown)*/
+
+};
+
+#endif
@@ -20,9 +20,18 @@
  *
  \*---------------------------------------------------------------------------*/
 
+#include <algorithm>
+#include <chrono>
+#include <string>
+
 #include <bitpit_IO.hpp>
 
 #include "run_manager.hpp"
+#include "matrixMarketReader.hpp"
+#include "configuredSystemSolver.hpp"
+#include "sequenceSystemSolver.hpp"
+#include "solverServer.hpp"
+#include "memoryUsage.hpp"
 
 using namespace bitpit;
 
@@ -47,6 +56,35 @@ void RunManager::execute(int nProcessors, int rank)
 
 }
 
+/*!
+ *  This static method executes the application work flow in server mode.
+ *  The system is set up by preprocess as usual, with the matrix pattern cached so that its values can be updated;
+ *  then it is kept resident and served through a local UNIX-domain socket until a client requests the shutdown
+ *  (see SolverServer class for details). No right-hand side file is read, they are sent by the clients.
+ *  Finally, postprocess is called on the last served system.
+ *
+ *  \param[in] nProcessors the number of MPI ranks
+ *  \param[in] rank        the MPI rank of the process owing the object
+ *  \param[in] socketPath  path of the UNIX-domain socket the server listens on
+*/
+void RunManager::serve(int nProcessors, int rank, const std::string & socketPath)
+{
+    RunManager m_manager(nProcessors,rank);
+    m_manager.m_isServer = true;
+
+    m_manager.preprocess();
+
+    log::cout() << "" << std::endl;
+    log::cout() << "|=====================================================|" << std::endl;
+    log::cout() << "| SERVE                                               |" << std::endl;
+    log::cout() << "|=====================================================|" << std::endl;
+    SolverServer server(nProcessors, rank, *(m_manager.m_solver), socketPath);
+    server.run();
+
+    m_manager.postprocess();
+
+}
+
 /*!
  *  Constructor
  *  It sets m_nProcessors and m_rank to values passed from the caller
@@ -54,7 +92,7 @@ void RunManager::execute(int nProcessors, int rank)
  *  It constructs a default dictionary
 */
 RunManager::RunManager(int nProcessors, int rank)
-    : m_nProcessors(nProcessors), m_rank(rank), m_dictionary(), m_solver(nullptr)
+    : m_nProcessors(nProcessors), m_rank(rank), m_dictionary(), m_inputOptions(), m_manifest(nullptr), m_sharedSegment(nullptr), m_tuner(nullptr), m_setupTime(0.), m_isServer(false), m_solver(nullptr)
 {
     //Declare solver
     m_solver = std::unique_ptr<Solver>(new Solver(m_nProcessors,m_rank));
@@ -65,13 +103,27 @@ RunManager::RunManager(int nProcessors, int rank)
  *  Preprocessing method.
  *  Briefly, it prepares the solver (basically the SystemSolver object) for the solving call by:
  *   - reading the XML user dictionary
- *   - initializing the system solver
- *   - reading (in parallel) the matrix (in CSR format, see MatrixReader class for details) from disk
- *   - reading (in parallel) the right-hand side from disk (see RhsReader class for details)
- *   - possibly, reading (in parallel) the initial solution guess from disk (see InitialSolutionReader class for details)
+ *   - possibly, reading the sequence manifest (see SequenceManifest class for details)
+ *   - possibly, attaching the shared-memory input segment of a co-located producer (see SharedSegment class for details),
+ *     whose parts replace the matching files
+ *   - initializing the system solver with the Krylov method and preconditioner of the dictionary (see ConfiguredSystemSolver class)
+ *     or, with the tuning on, with those chosen by a previous run for a matrix with the same fingerprint (see SolverTuner class);
+ *     with the native backend, in a single process out of sequence and server modes, the built-in OpenMP Krylov engine
+ *     is initialized instead (see NativeKrylovSolver class)
+ *   - reading (in parallel) the matrix (in ASCII or binary CSR format, see MatrixReader class for details) from disk,
+ *     in sequence mode the one of the first step
+ *   - assembling the PETSc matrix and releasing the bitpit SparseMatrix, so that only one copy of the matrix is kept;
+ *     the native engine copies the rows straight from the reader instead
+ *   - declaring the right-hand side reader, the right-hand sides are read by compute
+ *   - possibly, reading (in parallel) the initial solution guess from disk (see VectorReader class for details)
+ *   - possibly, declaring the solution writer
+ *  In server mode, the matrix pattern is cached for the values updates requested by the clients.
+ *  Its wall time is the setup time shared by all the right-hand sides.
 */
 void RunManager::preprocess()
 {
+    std::chrono::steady_clock::time_point setupStart = std::chrono::steady_clock::now();
+
     log::cout() << "" << std::endl;
     log::cout() << "|=====================================================|" << std::endl;
     log::cout() << "| PREPROCESS                                          |" << std::endl;
@@ -83,10 +135,94 @@ void RunManager::preprocess()
     //m_dictionary.readXML("../../data/dictionary.xml");
     m_dictionary.readXMLbitpit("./dictionary.xml");
 
+    m_inputOptions.mode = InputOptions::parseReadMode(m_dictionary.getInputMode());
+    m_inputOptions.nThreads = InputOptions::resolveThreadCount(m_dictionary.getInputThreads());
+    log::cout() << "Input threads per process: " << m_inputOptions.nThreads << std::endl;
+    m_inputOptions.partitionWeight = InputOptions::parsePartitionWeight(m_dictionary.getInputPartition(),
+            m_dictionary.getInputPartitionWeight());
+    log::cout() << "Row partition non-zeros weight: " << m_inputOptions.partitionWeight << std::endl;
+    m_inputOptions.chunkSize = InputOptions::resolveChunkSize(m_dictionary.getInputChunkSize());
+    m_inputOptions.cacheDirectory = m_dictionary.getInputCache();
+    if(!m_inputOptions.cacheDirectory.empty()) {
+        log::cout() << "Matrix cache directory: " << m_inputOptions.cacheDirectory << std::endl;
+    }
+#if ENABLE_MPI == 0
+    if(m_inputOptions.mode == ReadMode::MPIIO) {
+        log::cout() << "MPI-IO input mode requested in a serial build, plain reads will be used" << std::endl;
+    }
+#endif
+
+    //Sequence mode takes the files of the first step from the manifest
+    if(!m_dictionary.getSequenceManifest().empty()) {
+        log::cout() << "" << std::endl;
+        log::cout() << "    Reading sequence manifest..." << std::endl;
+        log::cout() << "    ---------------------------" << std::endl;
+        m_manifest = std::unique_ptr<SequenceManifest>(new SequenceManifest(m_dictionary.getSequenceManifest()));
+        if(!m_manifest->readManifest(m_rank)) {
+#if ENABLE_MPI == 1
+            MPI_Finalize();
+            exit(1);
+#else
+            exit(1);
+#endif
+        }
+    }
+
+    //Shared-memory inputs replace the files, the segment is released once its parts have been read
+    if(!m_dictionary.getInputShared().empty()) {
+        if(m_manifest) {
+            log::cout() << "Shared-memory input is not available in sequence mode, the manifest files will be read" << std::endl;
+        }
+        else {
+            log::cout() << "" << std::endl;
+            log::cout() << "    Attaching shared-memory input..." << std::endl;
+            log::cout() << "    -------------------------------" << std::endl;
+            m_sharedSegment = std::unique_ptr<SharedSegment>(new SharedSegment(m_nProcessors,m_rank,m_dictionary.getInputShared()));
+            if(!m_sharedSegment->attach(m_dictionary.getInputSharedTimeout())) {
+#if ENABLE_MPI == 1
+                MPI_Finalize();
+                exit(1);
+#else
+                exit(1);
+#endif
+            }
+        }
+    }
+
     log::cout() << "" << std::endl;
     log::cout() << "    Initializing Solver..." << std::endl;
     log::cout() << "    ----------------------" << std::endl;
-    m_solver->getSystem() = std::unique_ptr<SystemSolver>(new SystemSolver(m_dictionary.isDebug()));
+    SolverOptions solverOptions;
+    solverOptions.kspType = m_dictionary.getSolverKsp();
+    solverOptions.pcType = m_dictionary.getSolverPc();
+    solverOptions.subPCType = m_dictionary.getSolverSubPc();
+    solverOptions.levels = m_dictionary.getSolverLevels();
+    solverOptions.overlap = m_dictionary.getSolverOverlap();
+    solverOptions.restart = m_dictionary.getSolverRestart();
+    solverOptions.rtol = m_dictionary.getSolverRtol();
+    solverOptions.atol = m_dictionary.getSolverAtol();
+    solverOptions.maxIterations = m_dictionary.getSolverMaxIterations();
+    solverOptions.petscOptions = m_dictionary.getSolverOptions();
+    //The native engine holds the whole system in a single process
+    bool isNative = (m_dictionary.getSolverBackend() == "native");
+    if(isNative && (m_nProcessors > 1 || m_manifest || m_isServer)) {
+        log::cout() << "Native Krylov engine available for single-process runs, out of sequence and server modes; PETSc is used" << std::endl;
+        isNative = false;
+    }
+    if(isNative) {
+        m_solver->getNativeSolver() = std::unique_ptr<NativeKrylovSolver>(new NativeKrylovSolver());
+        m_solver->getNativeSolver()->setOptions(solverOptions);
+    }
+    else {
+        //The server updates the matrix values between solves, as the sequence mode does
+        if(m_manifest || m_isServer) {
+            m_solver->getSystem() = std::unique_ptr<SystemSolver>(new SequenceSystemSolver(m_dictionary.isDebug()));
+        }
+        else {
+            m_solver->getSystem() = std::unique_ptr<SystemSolver>(new ConfiguredSystemSolver(m_dictionary.isDebug()));
+        }
+        static_cast<ConfiguredSystemSolver &>(*(m_solver->getSystem())).setOptions(solverOptions);
+    }
 
 
     log::cout() << "" << std::endl;
@@ -95,8 +231,37 @@ void RunManager::preprocess()
     //Declare matrix reader
     m_solver->getMatrixReader() = std::unique_ptr<MatrixReader>(new MatrixReader(m_nProcessors,m_rank,
             m_dictionary.getMatrixDir(),m_dictionary.getMatrixName(),m_dictionary.getMatrixApp()));
-    //Read matrix
-    m_solver->getMatrixReader()->readMatrixCSRFormat( m_solver->getMatrix() );
+    m_solver->getMatrixReader()->setInputOptions(m_inputOptions);
+    if(m_manifest) {
+        //Later steps may ship only the values of the first matrix pattern
+        m_solver->getMatrixReader()->setPatternCaching(true);
+        setMatrixPath(m_manifest->getStep(0).matrixPath);
+    }
+    else {
+        m_solver->getMatrixReader()->setShardPattern(m_dictionary.getMatrixShards());
+        m_solver->getMatrixReader()->setPatternCaching(m_isServer);
+    }
+    if(m_sharedSegment && m_sharedSegment->hasPart(SharedSegment::Part::MATRIX)) {
+        m_solver->getMatrixReader()->setSharedData(m_sharedSegment->getData(SharedSegment::Part::MATRIX),
+                m_sharedSegment->getSize(SharedSegment::Part::MATRIX));
+    }
+    //The native engine copies the rows in place of the SparseMatrix
+    if(isNative) {
+        m_solver->getMatrixReader()->setRowsConsumer([this](long nRows, const long * rowPtr, const long * colIdx, const double * values, long) {
+            m_solver->getNativeSolver()->setMatrix(nRows, rowPtr, colIdx, values);
+        });
+    }
+    //The tuning fingerprint is computed from the local rows while they are read
+    if(m_dictionary.isTuningOn() && isNative) {
+        log::cout() << "Solver trials available with the PETSc backend only, the configured native solver is used" << std::endl;
+    }
+    else if(m_dictionary.isTuningOn()) {
+        m_tuner = std::unique_ptr<SolverTuner>(new SolverTuner(m_nProcessors,m_rank,m_dictionary.getTuningCache()));
+        m_solver->getMatrixReader()->setRowsInspector([this](long nRows, const long * rowPtr, const long * colIdx, const double * values, long rowStart) {
+            m_tuner->getFingerprint().compute(nRows, rowPtr, colIdx, values, rowStart);
+        });
+    }
+    readMatrix();
 
     //Initialiaze linear system
     if(m_nProcessors > m_solver->getMatrixReader()->getNRows()) {
@@ -109,42 +274,211 @@ void RunManager::preprocess()
 #endif
 
     }
-    else {
+    else if(!isNative) {
         log::cout() << "" << std::endl;
         log::cout() << "    Initializing solver..." << std::endl;
         log::cout() << "    ----------------------" << std::endl;
+        //PETSc matrix is preallocated from the pattern of the SparseMatrix, exact since it is created by the readers
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
         m_solver->getSystem()->assembly(*(m_solver->getMatrix()));
+        log::cout() << "System assembly time = "
+                << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() << " s" << std::endl;
+
+        //PETSc holds its own copy of the matrix, the one filled by the readers is not needed anymore
+        long residentBefore = MemoryUsage::getResidentSize();
+        m_solver->releaseMatrix();
+        MemoryUsage::logChange("SparseMatrix released", residentBefore, MemoryUsage::getResidentSize());
     }
 
-    //Declare RHS reader
-    log::cout() << "" << std::endl;
-    log::cout() << "    Reading RHS..." << std::endl;
-    log::cout() << "    ----------------------" << std::endl;
-    m_solver->getRhsReader() = std::unique_ptr<RhsReader>(new RhsReader(m_nProcessors,m_rank,
+    //A cached decision is applied at once, otherwise the trials are run on the first right-hand side by compute
+    if(m_tuner) {
+        log::cout() << "" << std::endl;
+        log::cout() << "    Tuning solver..." << std::endl;
+        log::cout() << "    ----------------------" << std::endl;
+        m_solver->getMatrixReader()->setRowsInspector(LocalCSR::Consumer());
+        const MatrixFingerprint & fingerprint = m_tuner->getFingerprint();
+        ConfiguredSystemSolver & system = static_cast<ConfiguredSystemSolver &>(*(m_solver->getSystem()));
+        std::string candidate;
+        if(!fingerprint.isComputed()) {
+            log::cout() << "Matrix fingerprint not available, the configured solver is used" << std::endl;
+            m_tuner.reset();
+        }
+        else {
+            log::cout() << "Matrix fingerprint: symmetry = " << fingerprint.getSymmetry() << ", diagonal dominance = "
+                    << fingerprint.getDiagonalDominance() << " (min ratio " << fingerprint.getMinDiagonalRatio()
+                    << "), positive diagonal = " << fingerprint.getPositiveDiagonal() << std::endl;
+            if(m_tuner->lookup(candidate)) {
+                system.setOptions(m_tuner->getCandidateOptions(candidate, system.getOptions()));
+                m_tuner.reset();
+            }
+            else if(m_manifest || m_isServer) {
+                log::cout() << "Solver trials run on the right-hand sides of the compute step only, the configured solver is used" << std::endl;
+                m_tuner.reset();
+            }
+        }
+    }
+
+    //Declare RHS reader, the files are read one at a time by compute
+    m_solver->getRhsReader() = std::unique_ptr<VectorReader>(new VectorReader(m_nProcessors,m_rank,VectorReader::Target::RHS,
             m_dictionary.getRhsDir(),m_dictionary.getRhsName(),m_dictionary.getRhsApp()));
-    //Read RHS
-    m_solver->getRhsReader()->read(m_solver->getSystem(),m_solver->getMatrixReader()->getNRows());
+    m_solver->getRhsReader()->setInputOptions(m_inputOptions);
+    m_solver->getRhsReader()->setPartition(m_solver->getMatrixReader()->getPartition());
+    if(!m_manifest) {
+        m_solver->getRhsReader()->setShardPattern(m_dictionary.getRhsShards());
+    }
+    if(m_sharedSegment && m_sharedSegment->hasPart(SharedSegment::Part::RHS)) {
+        m_solver->getRhsReader()->setSharedData(m_sharedSegment->getData(SharedSegment::Part::RHS),
+                m_sharedSegment->getSize(SharedSegment::Part::RHS));
+    }
 
-    //Read initial solution
-    if(m_dictionary.isHaveInitialSolution()) {
+    //Read initial solution, always provided by a shared-memory segment holding it
+    bool isSharedSolution = m_sharedSegment && m_sharedSegment->hasPart(SharedSegment::Part::SOLUTION);
+    if(m_dictionary.isHaveInitialSolution() || isSharedSolution) {
         log::cout() << "" << std::endl;
         log::cout() << "    Reading Initial Solution..." << std::endl;
         log::cout() << "    ----------------------" << std::endl;
         //Declare Initial Solution reader
-        m_solver->getInitialSolutionReader() = std::unique_ptr<InitialSolutionReader>(new InitialSolutionReader(m_nProcessors,m_rank,
+        m_solver->getInitialSolutionReader() = std::unique_ptr<VectorReader>(new VectorReader(m_nProcessors,m_rank,VectorReader::Target::SOLUTION,
                 m_dictionary.getInitialSolutionDir(),m_dictionary.getInitialSolutionName(),m_dictionary.getInitialSolutionApp()));
+        m_solver->getInitialSolutionReader()->setInputOptions(m_inputOptions);
+        m_solver->getInitialSolutionReader()->setPartition(m_solver->getMatrixReader()->getPartition());
+        m_solver->getInitialSolutionReader()->setShardPattern(m_dictionary.getInitialSolutionShards());
+        if(isSharedSolution) {
+            m_solver->getInitialSolutionReader()->setSharedData(m_sharedSegment->getData(SharedSegment::Part::SOLUTION),
+                    m_sharedSegment->getSize(SharedSegment::Part::SOLUTION));
+        }
         //Read Initial Solution
-        m_solver->getInitialSolutionReader()->read(m_solver->getSystem(),m_solver->getMatrixReader()->getNRows());
+        if(isNative) {
+            std::vector<std::vector<double>> columns;
+            m_solver->getInitialSolutionReader()->readColumns(m_solver->getMatrixReader()->getNRows(), columns);
+            std::copy(columns.front().begin(), columns.front().end(), m_solver->getNativeSolver()->getSolution());
+        }
+        else {
+            m_solver->getInitialSolutionReader()->read(m_solver->getSystem(),m_solver->getMatrixReader()->getNRows());
+        }
     }
     else {
         log::cout() << "No initial solution will be set. PETSc solution default initialization is used" << std::endl;
     }
 
+    //Without right-hand sides to be read by compute, the shared-memory segment is not needed anymore
+    if(m_sharedSegment && (m_isServer || !m_sharedSegment->hasPart(SharedSegment::Part::RHS))) {
+        releaseSharedSegment();
+    }
+
+    //Declare solution writer
+    if(m_dictionary.isSolutionOn()) {
+        m_solver->getSolutionWriter() = std::unique_ptr<VectorWriter>(new VectorWriter(m_nProcessors,m_rank,
+                m_dictionary.getSolutionDir(),m_dictionary.getSolutionName(),m_dictionary.getSolutionApp()));
+    }
+
+    m_setupTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - setupStart).count();
+    log::cout() << "" << std::endl;
+    log::cout() << "Setup time = " << m_setupTime << " s" << std::endl;
+
+}
+
+/*!
+ *  It reads the matrix with the file set in the matrix reader, choosing the reader from the shard pattern,
+ *  the dictionary format or the file signature, into the SparseMatrix of the solver.
+ *  A values file is read with the pattern cached by the matrix reader (see MatrixReader::readMatrixValues).
+*/
+void RunManager::readMatrix()
+{
+    std::unique_ptr<MatrixReader> & matrixReader = m_solver->getMatrixReader();
+    if(m_sharedSegment && m_sharedSegment->hasPart(SharedSegment::Part::MATRIX)) {
+        log::cout() << "Matrix format: binary CSR in shared memory" << std::endl;
+        matrixReader->readMatrixBinaryFormat( m_solver->getMatrix() );
+        return;
+    }
+
+    MatrixReader::Format matrixFormat = MatrixReader::selectFormat(m_dictionary.getMatrixFormat(), matrixReader->getPath());
+    if(!m_manifest && !m_dictionary.getMatrixShards().empty()) {
+        log::cout() << "Matrix format: sharded ASCII CSR" << std::endl;
+        matrixReader->readMatrixShards( m_solver->getMatrix() );
+    }
+    else if(matrixFormat == MatrixReader::Format::BINARY_CSR) {
+        log::cout() << "Matrix format: binary CSR" << std::endl;
+        matrixReader->readMatrixBinaryFormat( m_solver->getMatrix() );
+    }
+    else if(matrixFormat == MatrixReader::Format::BINARY_VALUES) {
+        log::cout() << "Matrix format: binary values of the cached pattern" << std::endl;
+        matrixReader->readMatrixValues( m_solver->getMatrix() );
+    }
+    else if(matrixFormat == MatrixReader::Format::MATRIX_MARKET) {
+        log::cout() << "Matrix format: Matrix Market" << std::endl;
+        MatrixMarketReader marketReader(m_nProcessors,m_rank,
+                matrixReader->getDirectory(),matrixReader->getName(),matrixReader->getAppendix());
+        marketReader.setInputOptions(m_inputOptions);
+        marketReader.setRowsConsumer(matrixReader->getCommitConsumer( m_solver->getMatrix() ));
+        marketReader.read( m_solver->getMatrix() );
+        matrixReader->setPartition(marketReader.getPartition());
+        matrixReader->setNRows(marketReader.getNRows());
+        matrixReader->setNCols(marketReader.getNCols());
+        matrixReader->setNNz(marketReader.getNNz());
+    }
+    else {
+        log::cout() << "Matrix format: ASCII CSR" << std::endl;
+        matrixReader->readMatrixCSRFormat( m_solver->getMatrix() );
+    }
+}
+
+/*!
+ *  It marks the shared-memory input segment consumed, so that the producer may publish the next inputs,
+ *  and detaches the readers from it. Its parts must have been read.
+*/
+void RunManager::releaseSharedSegment()
+{
+    m_solver->getMatrixReader()->setSharedData(nullptr, 0);
+    if(m_solver->getRhsReader()) {
+        m_solver->getRhsReader()->setSharedData(nullptr, 0);
+    }
+    if(m_solver->getInitialSolutionReader()) {
+        m_solver->getInitialSolutionReader()->setSharedData(nullptr, 0);
+    }
+    m_sharedSegment->release();
+    m_sharedSegment.reset();
+}
+
+/*!
+ *  It sets the file of the matrix reader from a path of the sequence manifest
+ *  \param[in] path path of the matrix file
+*/
+void RunManager::setMatrixPath(const std::string & path)
+{
+    std::string dir, name, app;
+    SequenceManifest::splitPath(path, dir, name, app);
+    m_solver->getMatrixReader()->setDirectory(dir);
+    m_solver->getMatrixReader()->setName(name);
+    m_solver->getMatrixReader()->setAppendix(app);
+}
+
+/*!
+ *  It sets the file of the right-hand side reader from a path of the sequence manifest
+ *  \param[in] path path of the right-hand side file
+*/
+void RunManager::setRhsPath(const std::string & path)
+{
+    std::string dir, name, app;
+    SequenceManifest::splitPath(path, dir, name, app);
+    m_solver->getRhsReader()->setDirectory(dir);
+    m_solver->getRhsReader()->setName(name);
+    m_solver->getRhsReader()->setAppendix(app);
 }
 
 /*!
  *  Computing method.
- *  Basically it calls the solve method of the SystemSolver class on m_system member of the m_solver member of this class
+ *  It solves the system once per right-hand side, reusing the assembled matrix and its preconditioner,
+ *  which PETSc sets up during the first solve only, since the matrix does not change.
+ *  The right-hand sides are the columns of the files listed by the RHS name option of the dictionary,
+ *  in the order they are listed; every file is read in a single pass (see VectorReader class for details).
+ *  With a shared-memory input holding them, they are the columns of its right-hand sides part instead.
+ *  Each solve starts from the same initial guess, i.e. the initial solution read by preprocess or the PETSc default one.
+ *  If user set by dictionary the solution output in mode "on", the solution of every right-hand side is written
+ *  (see VectorWriter class for details), numbered when there are several right-hand sides.
+ *  With solver trials pending, they are run on the first right-hand side before it is solved (see tuneSolver).
+ *  Finally, the setup time amortised over the solves is logged.
+ *  In sequence mode, the steps of the manifest are solved instead (see computeSequence).
 */
 void RunManager::compute()
 {
@@ -153,18 +487,263 @@ void RunManager::compute()
     log::cout() << "| COMPUTE                                             |" << std::endl;
     log::cout() << "|=====================================================|" << std::endl;
 
+    if(m_manifest) {
+        computeSequence();
+        return;
+    }
+
+    //Shards are selected by their pattern, the names are then ignored
+    std::vector<std::string> rhsNames = m_dictionary.getRhsNames();
+    if(rhsNames.empty() || !m_dictionary.getRhsShards().empty() || m_sharedSegment) {
+        rhsNames.assign(1, m_dictionary.getRhsName());
+    }
+
+    //Every solve restarts from the initial guess set by preprocess
+    std::unique_ptr<NativeKrylovSolver> & nativeSolver = m_solver->getNativeSolver();
+    long nLocalRows;
+    const double *solution;
+    std::vector<double> initialGuess;
+    if(nativeSolver) {
+        nLocalRows = nativeSolver->getRowCount();
+        initialGuess.assign(nativeSolver->getSolution(), nativeSolver->getSolution() + nLocalRows);
+    }
+    else {
+        nLocalRows = m_solver->getSystem()->getRowCount();
+        solution = m_solver->getSystem()->getSolutionRawReadPtr();
+        initialGuess.assign(solution, solution + nLocalRows);
+        m_solver->getSystem()->restoreSolutionRawReadPtr(solution);
+    }
+
+    int nSolves = 0;
+    double firstSolveTime = 0.;
+    double laterSolvesTime = 0.;
+    std::vector<std::vector<double>> columns;
+    for(std::size_t file = 0; file < rhsNames.size(); ++file) {
+        log::cout() << "" << std::endl;
+        log::cout() << "    Reading RHS..." << std::endl;
+        log::cout() << "    ----------------------" << std::endl;
+        m_solver->getRhsReader()->setName(rhsNames[file]);
+        m_solver->getRhsReader()->readColumns(m_solver->getMatrixReader()->getNRows(), columns);
+        if(m_sharedSegment) {
+            releaseSharedSegment();
+        }
+        bool isNumbered = (rhsNames.size() > 1 || columns.size() > 1);
+
+        for(std::size_t column = 0; column < columns.size(); ++column) {
+            log::cout() << "" << std::endl;
+            log::cout() << "    Solving Linear System..." << std::endl;
+            log::cout() << "    ----------------------" << std::endl;
+            if(isNumbered) {
+                log::cout() << "Right-hand side " << nSolves << ": column " << column << " of " << m_solver->getRhsReader()->getPath() << std::endl;
+            }
+            if(m_tuner) {
+                tuneSolver(columns[column], initialGuess);
+            }
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            solveColumn(columns[column], initialGuess);
+            double solveTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            long iterations = nativeSolver ? nativeSolver->getIterations() : m_solver->getSystem()->getKSPStatus().its;
+            double residual = nativeSolver ? nativeSolver->getResidual()
+                    : static_cast<ConfiguredSystemSolver &>(*(m_solver->getSystem())).getResidualNorm();
+            log::cout() << "Solve time = " << solveTime << " s, iterations = " << iterations << ", residual = " << residual << std::endl;
+            if(nSolves == 0) {
+                firstSolveTime = solveTime;
+            } else {
+                laterSolvesTime += solveTime;
+            }
+
+            if(m_solver->getSolutionWriter()) {
+                std::string name = m_dictionary.getSolutionName();
+                if(isNumbered) {
+                    name += "_" + std::to_string(nSolves);
+                }
+                m_solver->getSolutionWriter()->setName(name);
+                log::cout() << "Writing solution to " << m_solver->getSolutionWriter()->getPath() << std::endl;
+                solution = nativeSolver ? nativeSolver->getSolution() : m_solver->getSystem()->getSolutionRawReadPtr();
+                m_solver->getSolutionWriter()->write(solution, nLocalRows, m_solver->getMatrixReader()->getNRows(),
+                        "Solution of right-hand side " + std::to_string(nSolves));
+                if(!nativeSolver) {
+                    m_solver->getSystem()->restoreSolutionRawReadPtr(solution);
+                }
+            }
+
+            ++nSolves;
+        }
+    }
+
+    //The first solve also sets the preconditioner up, the later ones reuse it
     log::cout() << "" << std::endl;
-    log::cout() << "    Solving Linear System..." << std::endl;
-    log::cout() << "    ----------------------" << std::endl;
+    log::cout() << "Number of right-hand sides solved = " << nSolves << std::endl;
+    double sharedTime = m_setupTime;
+    if(nSolves > 1) {
+        double preconditionerTime = std::max(0., firstSolveTime - laterSolvesTime / (nSolves - 1));
+        log::cout() << "Preconditioner setup time (first solve minus mean of the later ones) = " << preconditionerTime << " s" << std::endl;
+        sharedTime += preconditionerTime;
+    }
+    if(nSolves > 0) {
+        log::cout() << "Setup time amortised per solve = " << sharedTime / nSolves << " s" << std::endl;
+    }
+
+}
+
+/*!
+ *  Sequence computing method.
+ *  It solves the (matrix, right-hand side) pairs of the sequence manifest in order. The matrix of the first step
+ *  has been assembled by preprocess; from the second step on, the step matrix is read and only the values of the
+ *  assembled PETSc matrix are updated (see SystemSolver::update), with no preallocation nor pattern rebuild,
+ *  so all the matrices must share the same pattern and, hence, the same row partition.
+ *  Since the pattern of the first matrix is cached, the later steps may provide just a values file.
+ *  The preconditioner is rebuilt at the first step, every "rebuild" steps of the dictionary, and at the step following
+ *  a solve whose iterations exceed "growth" times those of the last rebuild; otherwise the current one is reused
+ *  (see SequenceSystemSolver class for details).
+ *  The right-hand side is the first column of the step file. Each step starts from the solution of the previous one,
+ *  the first from the initial guess set by preprocess.
+ *  If user set by dictionary the solution output in mode "on", the solution of every step is written.
+*/
+void RunManager::computeSequence()
+{
+    SequenceSystemSolver & system = static_cast<SequenceSystemSolver &>(*(m_solver->getSystem()));
+    std::unique_ptr<MatrixReader> & matrixReader = m_solver->getMatrixReader();
+
+    long nRows = matrixReader->getNRows();
+    long nNz = matrixReader->getNNz();
+    std::vector<long> rowStarts = matrixReader->getPartition().getRowStarts();
+
+    int rebuildEvery = std::max(m_dictionary.getSequenceRebuild(), 0);
+    double growth = m_dictionary.getSequenceGrowth();
+    log::cout() << "Preconditioner rebuild every " << rebuildEvery << " steps (0 for never), iteration growth ratio " << growth
+            << " (0 for disabled)" << std::endl;
+
+    std::size_t lastRebuild = 0;
+    long rebuildIterations = 0;
+    bool isDegraded = false;
+    int nRebuilds = 0;
+    double updateTime = 0.;
+    double solveTime = 0.;
+    for(std::size_t step = 0; step < m_manifest->getStepCount(); ++step) {
+        log::cout() << "" << std::endl;
+        log::cout() << "    Step " << step << "..." << std::endl;
+        log::cout() << "    ----------------------" << std::endl;
+
+        //Only the values change: read the step matrix and copy them into the assembled PETSc matrix
+        if(step > 0) {
+            setMatrixPath(m_manifest->getStep(step).matrixPath);
+            readMatrix();
+            if(matrixReader->getNRows() != nRows || matrixReader->getNNz() != nNz
+                    || matrixReader->getPartition().getRowStarts() != rowStarts) {
+                log::cout() << "Matrix " << matrixReader->getPath() << " does not share the pattern of the first step!" << std::endl;
+#if ENABLE_MPI == 1
+                MPI_Finalize();
+                exit(1);
+#else
+                exit(1);
+#endif
+            }
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            system.update(*(m_solver->getMatrix()));
+            double stepUpdateTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            log::cout() << "Matrix values update time = " << stepUpdateTime << " s" << std::endl;
+            updateTime += stepUpdateTime;
+            m_solver->releaseMatrix();
+        }
+
+        bool isRebuilt = (step == 0) || isDegraded || (rebuildEvery > 0 && step - lastRebuild >= static_cast<std::size_t>(rebuildEvery));
+        system.setReusePreconditioner(!isRebuilt);
+        log::cout() << "Preconditioner " << (isRebuilt ? "rebuilt" : "reused") << std::endl;
+
+        setRhsPath(m_manifest->getStep(step).rhsPath);
+        m_solver->getRhsReader()->read(m_solver->getSystem(), nRows);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        system.solve();
+        double stepSolveTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        solveTime += stepSolveTime;
+        long iterations = system.getKSPStatus().its;
+        log::cout() << "Solve time = " << stepSolveTime << " s, iterations = " << iterations
+                << ", residual = " << system.getResidualNorm() << std::endl;
+
+        if(isRebuilt) {
+            lastRebuild = step;
+            rebuildIterations = std::max(iterations, 1L);
+            ++nRebuilds;
+        }
+        isDegraded = (growth > 0. && iterations > growth * rebuildIterations);
+        if(isDegraded) {
+            log::cout() << "Iterations grew beyond " << growth << " times those of the last rebuild, the preconditioner will be rebuilt" << std::endl;
+        }
+
+        if(m_solver->getSolutionWriter()) {
+            m_solver->getSolutionWriter()->setName(m_dictionary.getSolutionName() + "_" + std::to_string(step));
+            log::cout() << "Writing solution to " << m_solver->getSolutionWriter()->getPath() << std::endl;
+            const double *solution = system.getSolutionRawReadPtr();
+            m_solver->getSolutionWriter()->write(solution, system.getRowCount(), nRows, "Solution of step " + std::to_string(step));
+            system.restoreSolutionRawReadPtr(solution);
+        }
+    }
+
+    log::cout() << "" << std::endl;
+    log::cout() << "Number of steps solved = " << m_manifest->getStepCount() << ", preconditioner rebuilds = " << nRebuilds << std::endl;
+    log::cout() << "Total matrix values update time = " << updateTime << " s, total solve time = " << solveTime << " s" << std::endl;
+
+}
+
+/*!
+ *  It copies a right-hand side and the initial guess into the system vectors and solves the system,
+ *  with the native engine if it is set.
+ *  \param[in] rhs          local elements of the right-hand side
+ *  \param[in] initialGuess local elements of the initial guess of the solution
+*/
+void RunManager::solveColumn(const std::vector<double> & rhs, const std::vector<double> & initialGuess)
+{
+    if(m_solver->getNativeSolver()) {
+        std::copy(initialGuess.begin(), initialGuess.end(), m_solver->getNativeSolver()->getSolution());
+        m_solver->getNativeSolver()->solve(rhs.data());
+        return;
+    }
+
+    double *values = m_solver->getSystem()->getRHSRawPtr();
+    std::copy(rhs.begin(), rhs.end(), values);
+    m_solver->getSystem()->restoreRHSRawPtr(values);
+
+    values = m_solver->getSystem()->getSolutionRawPtr();
+    std::copy(initialGuess.begin(), initialGuess.end(), values);
+    m_solver->getSystem()->restoreSolutionRawPtr(values);
+
     m_solver->getSystem()->solve();
+}
 
+/*!
+ *  It runs the solver trials of the dictionary candidates on a right-hand side and keeps the fastest candidate
+ *  for the solves to come, caching the decision for later runs (see SolverTuner class).
+ *  The trials time is added to the setup time shared by all the right-hand sides.
+ *  \param[in] rhs          local elements of the right-hand side
+ *  \param[in] initialGuess local elements of the initial guess of the solution
+*/
+void RunManager::tuneSolver(const std::vector<double> & rhs, const std::vector<double> & initialGuess)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<std::string> candidates = SolverTuner::parseCandidates(m_dictionary.getTuningCandidates());
+    log::cout() << "Solver trials: " << candidates.size() << " candidates, at most " << m_dictionary.getTuningMaxIterations()
+            << " iterations each" << std::endl;
+    std::string winner = m_tuner->tune(static_cast<ConfiguredSystemSolver &>(*(m_solver->getSystem())), candidates,
+            m_dictionary.getTuningMaxIterations(), [&]() { solveColumn(rhs, initialGuess); });
+    if(!winner.empty()) {
+        m_tuner->store(winner);
+    }
+    m_tuner.reset();
+
+    double tuningTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    log::cout() << "Solver trials time = " << tuningTime << " s" << std::endl;
+    m_setupTime += tuningTime;
 }
 
 /*!
  *  Postprocessing method.
  *  If user set by dictionary the system dump in mode "on",
- *  this method calls for SystemSolver PETSc based dump and matrix, right-hand side and solution are dumped in ASCII files.
+ *  this method calls for SystemSolver PETSc based dump and matrix, right-hand side and solution are dumped in ASCII files
+ *  (with several right-hand sides, the last one and its solution); the dump is not available with the native engine.
  *  Otherwise, nothing happens, but log message printing
+ *  Finally, the current and peak resident memory of every process are logged.
 */
 void RunManager::postprocess()
 {
@@ -177,9 +756,17 @@ void RunManager::postprocess()
         log::cout() << "" << std::endl;
         log::cout() << "    Dumping Linear System..." << std::endl;
         log::cout() << "    ------------------------" << std::endl;
-        m_solver->getSystem()->dump(m_dictionary.getDumpDir(),m_dictionary.getDumpName());
+        if(m_solver->getNativeSolver()) {
+            log::cout() << "Linear system dump available with the PETSc backend only" << std::endl;
+        }
+        else {
+            m_solver->getSystem()->dump(m_dictionary.getDumpDir(),m_dictionary.getDumpName());
+        }
     }
 
+    log::cout() << "" << std::endl;
+    MemoryUsage::logPeak("End of run");
+
 
 
 }
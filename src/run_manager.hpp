@@ -24,9 +24,15 @@
 #define __MADLINSOLV_RUN_MANAGER_HPP__
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "solver.hpp"
 #include "dictionary.hpp"
+#include "inputOptions.hpp"
+#include "sequenceManifest.hpp"
+#include "sharedSegment.hpp"
+#include "solverTuner.hpp"
 
 /*!
  *  \authors        Marco Cisternino
@@ -39,16 +45,28 @@
  *   - preprocess
  *   - compute
  *   - postprocess
+ *  The compute step solves one system per right-hand side or, in sequence mode, one system per step of a manifest.
+ *  Through its static method serve, the compute step is replaced by a server keeping the system resident
+ *  (see SolverServer class for details).
+ *  With the tuning on, the solver is chosen by trials on the first right-hand side, unless a previous run
+ *  already chose it for a matrix alike (see SolverTuner class for details).
  */
 
 class RunManager {
 
 public:
     static void execute(int nProcessors, int rank); //TODO pass argc argv from main to Solver and SystemSolver
+    static void serve(int nProcessors, int rank, const std::string & socketPath);
 private:
     int m_nProcessors;                                  /**<number of MPI processes*/
     int m_rank;                                         /**<MPI rank of the process*/
     Dictionary m_dictionary;                            /**<XML user interface object*/
+    InputOptions m_inputOptions;                        /**<input settings shared by all the readers*/
+    std::unique_ptr<SequenceManifest> m_manifest;       /**<unique pointer to SequenceManifest, null if the sequence mode is off*/
+    std::unique_ptr<SharedSegment> m_sharedSegment;     /**<unique pointer to SharedSegment, null if no shared-memory input is attached*/
+    std::unique_ptr<SolverTuner> m_tuner;               /**<unique pointer to SolverTuner, null if no solver trials are pending*/
+    double m_setupTime;                                 /**<wall time spent in preprocess [s], shared by all the right-hand sides*/
+    bool m_isServer;                                    /**<true if the system is served through a socket instead of computed*/
 
     std::unique_ptr<Solver> m_solver;                   /**<unique pointer to Solver. It manages bitpit system solvers and disk file readers*/
 
@@ -60,6 +78,14 @@ private:
     void compute();
     void postprocess();
 
+    void computeSequence();
+    void readMatrix();
+    void releaseSharedSegment();
+    void setMatrixPath(const std::string & path);
+    void setRhsPath(const std::string & path);
+    void solveColumn(const std::vector<double> & rhs, const std::vector<double> & initialGuess);
+    void tuneSolver(const std::vector<double> & rhs, const std::vector<double> & initialGuess);
+
 };
 
 
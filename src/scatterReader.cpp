@@ -0,0 +1,386 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#if ENABLE_MPI==1
+#    include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include <bitpit_IO.hpp>
+
+#include "inputFileStream.hpp"
+#include "scatterReader.hpp"
+#include "tokenizer.hpp"
+
+using namespace bitpit;
+
+namespace {
+
+/*!
+ * Lines of the file owned by the members of a group, read in member order by the group reader
+ */
+class LineSource {
+
+public:
+
+    /*!
+     * Constructor
+     * It opens the file and orders the members by their first line.
+     * \param[in] path path of the file
+     * \param[in] bodyOffset byte offset of the first body line
+     * \param[in] index the line index of the file body, null if lines are reached by skipping
+     * \param[in] linesPerRecord number of lines of a record, never split between two chunks
+     * \param[in] ranges first line and number of lines of each member
+     */
+    LineSource(const std::string & path, uint64_t bodyOffset, const LineIndex * index, int linesPerRecord,
+            const std::vector<uint64_t> & ranges) :
+            m_stream(path), m_bodyOffset(bodyOffset), m_index(index),
+            m_linesPerRecord(linesPerRecord), m_ranges(ranges), m_order(), m_cursor(0), m_remaining(0),
+            m_isPositioned(false), m_tokenizer(), m_line(0), m_isFailed(false)
+    {
+        int nMembers = static_cast<int>(m_ranges.size() / 2);
+        for(int member = 0; member < nMembers; ++member) {
+            if(m_ranges[2 * member + 1] > 0) {
+                m_order.push_back(member);
+            }
+        }
+        std::stable_sort(m_order.begin(), m_order.end(), [this](int a, int b) {
+            return m_ranges[2 * a] < m_ranges[2 * b];
+        });
+    }
+
+    /*!
+     * It checks if the file is open
+     * \return true if the file is open
+     */
+    bool isOpen() const
+    {
+        return m_stream.isOpen();
+    }
+
+    /*!
+     * It checks if the decompression of a gzip compressed file stopped on corrupted or truncated data
+     * \return true if the file is corrupted
+     */
+    bool isCorrupted() const
+    {
+        return m_stream.isCorrupted();
+    }
+
+    /*!
+     * It checks if the file ended before all the requested lines were read
+     * \return true if some lines are missing
+     */
+    bool isFailed() const
+    {
+        return m_isFailed;
+    }
+
+    /*!
+     * It fills the next chunk with whole records, until it reaches the chunk size or all the lines have been read
+     * \param[in] chunkSize the chunk size [bytes]
+     * \param[out] buffer the chunk text
+     * \param[out] counts the number of chunk bytes of each member, -1 for everyone when all the lines have been read
+     * \param[out] displs the offset in the chunk of the bytes of each member
+     */
+    void fill(std::size_t chunkSize, std::vector<char> & buffer, std::vector<int> & counts, std::vector<int> & displs)
+    {
+        int nMembers = static_cast<int>(m_ranges.size() / 2);
+        buffer.clear();
+        counts.assign(nMembers, 0);
+        displs.assign(nMembers, 0);
+
+        while(m_cursor < m_order.size() && buffer.size() < chunkSize) {
+            int member = m_order[m_cursor];
+            if(!m_isPositioned) {
+                seek(m_ranges[2 * member]);
+                m_remaining = m_ranges[2 * member + 1];
+                m_isPositioned = true;
+                displs[member] = static_cast<int>(buffer.size());
+            }
+
+            std::size_t recordBegin = buffer.size();
+            for(int l = 0; l < m_linesPerRecord && m_remaining > 0; ++l) {
+                if(!appendLine(buffer)) {
+                    m_isFailed = true;
+                    m_remaining = 0;
+                    break;
+                }
+                --m_remaining;
+            }
+            counts[member] += static_cast<int>(buffer.size() - recordBegin);
+
+            if(m_remaining == 0) {
+                ++m_cursor;
+                m_isPositioned = false;
+            }
+        }
+
+        if(buffer.empty()) {
+            counts.assign(nMembers, -1);
+        }
+    }
+
+private:
+
+    /*!
+     * It moves to the given body line, through the index if available, by skipping lines otherwise.
+     * Consecutive ranges are read without any seek.
+     * \param[in] line zero-based body line number
+     */
+    void seek(uint64_t line)
+    {
+        if(m_tokenizer && line == m_line) {
+            return;
+        }
+
+        if(m_index) {
+            m_index->seek(m_stream, line);
+            m_line = line;
+            m_tokenizer.reset(new Tokenizer(m_stream));
+            return;
+        }
+
+        if(!m_tokenizer || line < m_line) {
+            m_stream.clear();
+            m_stream.seekg(static_cast<std::streamoff>(m_bodyOffset));
+            m_line = 0;
+            m_tokenizer.reset(new Tokenizer(m_stream));
+        }
+        const char *begin, *end;
+        while(m_line < line && m_tokenizer->nextLine(&begin, &end)) {
+            ++m_line;
+        }
+    }
+
+    /*!
+     * It appends the next line to the chunk, ended by a newline
+     * \param[in,out] buffer the chunk text
+     * \return false if the file has no more lines
+     */
+    bool appendLine(std::vector<char> & buffer)
+    {
+        const char *begin, *end;
+        if(!m_tokenizer->nextLine(&begin, &end)) {
+            return false;
+        }
+        buffer.insert(buffer.end(), begin, end);
+        buffer.push_back('\n');
+        ++m_line;
+
+        return true;
+    }
+
+    InputFileStream m_stream;                           /**<stream from the file, possibly compressed*/
+    uint64_t m_bodyOffset;                              /**<byte offset of the first body line*/
+    const LineIndex *m_index;                           /**<line index of the file body, null if not available*/
+    int m_linesPerRecord;                               /**<number of lines of a record*/
+    std::vector<uint64_t> m_ranges;                     /**<first line and number of lines of each member*/
+    std::vector<int> m_order;                           /**<members with lines, by first line*/
+    std::size_t m_cursor;                               /**<position in m_order of the member being read*/
+    uint64_t m_remaining;                               /**<lines still to be read for the member being read*/
+    bool m_isPositioned;                                /**<true if the stream is at the lines of the member being read*/
+    std::unique_ptr<Tokenizer> m_tokenizer;             /**<tokenizer on the stream, reset after each seek*/
+    uint64_t m_line;                                    /**<body line the tokenizer returns next*/
+    bool m_isFailed;                                    /**<true if the file ended before the requested lines*/
+
+};
+
+}
+
+/*!
+ * Constructor
+ * Nothing is read until readLines is called.
+ * \param[in] path path of the file
+ * \param[in] perNode true for one reader per node, false for a single reader
+ * \param[in] chunkSize size of the chunks sent by the readers [bytes]; a chunk always holds at least one record
+ */
+ScatterReader::ScatterReader(const std::string & path, bool perNode, std::size_t chunkSize) :
+        m_path(path), m_perNode(perNode), m_chunkSize(chunkSize), m_isReader(false), m_bytes(0), m_nChunks(0), m_peakBuffer(0), m_elapsed(0.)
+{
+
+}
+
+/*!
+ * It reads the given body lines of the process through the reader of its group, passing them to the parser
+ * one chunk at a time. Lines are streamed from the file in member order; without a line index the reader
+ * reaches the lines by skipping, so the index is needed only when the members of a group do not own
+ * consecutive lines (e.g. several readers).
+ * This method is collective.
+ * \param[in] bodyOffset byte offset of the first body line, i.e. the first line after the header
+ * \param[in] index the line index of the file body, null if it is not available
+ * \param[in] firstLine zero-based number of the first body line of the process
+ * \param[in] nLines number of body lines of the process, a multiple of linesPerRecord
+ * \param[in] linesPerRecord number of lines of a record, never split between two chunks
+ * \param[in] parser the function parsing the chunks of the process
+ * \return true if the file has been opened and all the lines have been read, on all the processes
+ */
+bool ScatterReader::readLines(uint64_t bodyOffset, const LineIndex * index, uint64_t firstLine, uint64_t nLines,
+        int linesPerRecord, const ChunkParser & parser)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    m_bytes = 0;
+    m_nChunks = 0;
+    m_peakBuffer = 0;
+
+    //Group the processes and collect the lines of the members on the reader
+    int groupRank = 0;
+    uint64_t range[2] = {firstLine, nLines};
+#if ENABLE_MPI==1
+    MPI_Comm group;
+    if(m_perNode) {
+        MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &group);
+    } else {
+        MPI_Comm_dup(MPI_COMM_WORLD, &group);
+    }
+    int groupSize;
+    MPI_Comm_rank(group, &groupRank);
+    MPI_Comm_size(group, &groupSize);
+    std::vector<uint64_t> ranges(groupRank == 0 ? 2 * groupSize : 0);
+    MPI_Gather(range, 2, MPI_UINT64_T, ranges.data(), 2, MPI_UINT64_T, 0, group);
+#else
+    std::vector<uint64_t> ranges(range, range + 2);
+#endif
+
+    std::unique_ptr<LineSource> source;
+    int isOpen = 1;
+    m_isReader = (groupRank == 0);
+    if(m_isReader) {
+        source.reset(new LineSource(m_path, bodyOffset, index, linesPerRecord, ranges));
+        isOpen = source->isOpen() ? 1 : 0;
+    }
+#if ENABLE_MPI==1
+    MPI_Bcast(&isOpen, 1, MPI_INT, 0, group);
+#endif
+
+    std::vector<char> sendBuffers[2];
+    std::vector<int> counts[2];
+    std::vector<int> displs[2];
+    if(isOpen) {
+#if ENABLE_MPI==1
+        //Chunk k is scattered while chunk k-1 is parsed and chunk k+1 is read
+        std::vector<char> recvBuffers[2];
+        MPI_Request request = MPI_REQUEST_NULL;
+        int pending = -1;
+        for(int round = 0; ; ++round) {
+            int slot = round % 2;
+            if(groupRank == 0) {
+                source->fill(m_chunkSize, sendBuffers[slot], counts[slot], displs[slot]);
+                m_bytes += sendBuffers[slot].size();
+                m_peakBuffer = std::max(m_peakBuffer, sendBuffers[slot].size());
+            }
+
+            int count;
+            MPI_Scatter(counts[slot].data(), 1, MPI_INT, &count, 1, MPI_INT, 0, group);
+            if(count < 0) {
+                break;
+            }
+            ++m_nChunks;
+
+            recvBuffers[slot].resize(count);
+            MPI_Request next;
+            MPI_Iscatterv(sendBuffers[slot].data(), counts[slot].data(), displs[slot].data(), MPI_CHAR,
+                    recvBuffers[slot].data(), count, MPI_CHAR, 0, group, &next);
+            if(pending >= 0) {
+                MPI_Wait(&request, MPI_STATUS_IGNORE);
+                parser(recvBuffers[pending].data(), recvBuffers[pending].data() + recvBuffers[pending].size());
+            }
+            request = next;
+            pending = slot;
+        }
+        if(pending >= 0) {
+            MPI_Wait(&request, MPI_STATUS_IGNORE);
+            parser(recvBuffers[pending].data(), recvBuffers[pending].data() + recvBuffers[pending].size());
+        }
+#else
+        while(true) {
+            source->fill(m_chunkSize, sendBuffers[0], counts[0], displs[0]);
+            if(counts[0][0] < 0) {
+                break;
+            }
+            ++m_nChunks;
+            m_bytes += sendBuffers[0].size();
+            m_peakBuffer = std::max(m_peakBuffer, sendBuffers[0].size());
+            parser(sendBuffers[0].data(), sendBuffers[0].data() + sendBuffers[0].size());
+        }
+#endif
+    }
+
+    int success = isOpen;
+    if(source && source->isCorrupted()) {
+        log::cout() << "File " << m_path << " is a corrupted or truncated gzip file" << std::endl;
+        success = 0;
+    } else if(source && source->isFailed()) {
+        log::cout() << "File " << m_path << " ended before all the requested lines were read" << std::endl;
+        success = 0;
+    }
+#if ENABLE_MPI==1
+    MPI_Comm_free(&group);
+    MPI_Allreduce(MPI_IN_PLACE, &success, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+#endif
+    m_elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    return success == 1;
+}
+
+/*!
+ * It checks if there is one reader per node
+ * \return true for one reader per node, false for a single reader
+ */
+bool ScatterReader::isPerNode() const
+{
+    return m_perNode;
+}
+
+/*!
+ * It logs the number of readers, the bytes they sent with the bandwidth of the slowest process
+ * and the largest chunk, which bounds the memory of the readers.
+ * This method is collective.
+ * \param[in] label name of the file content to be printed in the log
+ */
+void ScatterReader::logBandwidth(const std::string & label) const
+{
+    double bytes = static_cast<double>(m_bytes);
+    double elapsed = m_elapsed;
+    int nReaders = m_isReader ? 1 : 0;
+    uint64_t peakBuffer = m_peakBuffer;
+    uint64_t nChunks = m_nChunks;
+#if ENABLE_MPI==1
+    MPI_Allreduce(MPI_IN_PLACE, &bytes, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &nReaders, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &peakBuffer, 1, MPI_UINT64_T, MPI_MAX, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &nChunks, 1, MPI_UINT64_T, MPI_MAX, MPI_COMM_WORLD);
+#endif
+
+    double megaBytes = bytes / (1024. * 1024.);
+    log::cout() << label << " scattered: " << megaBytes << " MB by " << nReaders << " reader(s) in "
+            << nChunks << " chunk(s) and " << elapsed << " s";
+    if(elapsed > 0.) {
+        log::cout() << " (" << megaBytes / elapsed << " MB/s)";
+    }
+    log::cout() << ", largest chunk " << static_cast<double>(peakBuffer) / (1024. * 1024.) << " MB" << std::endl;
+}
@@ -0,0 +1,82 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_SCATTERREADER_HPP__
+#define __MADLINSOLV_SCATTERREADER_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "lineIndex.hpp"
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The scattering file reader class
+ *
+ *  This class is intended to
+ *  read an ASCII file with a few processes only, for filesystems (e.g. NFS) where many processes
+ *  opening the same file are much slower than a single reader.
+ *  The processes are grouped, either all together or by node (MPI_COMM_TYPE_SHARED), and only the first
+ *  process of each group opens the file. It streams the lines owned by the group members in chunks of bounded
+ *  size, always ending at a record boundary, and sends each member its part with MPI_Iscatterv.
+ *  Two chunks are in flight: while a member parses chunk k, the reader is already reading chunk k+1,
+ *  so the memory of the reader is bounded by four chunks whatever the file size.
+ *  In serial runs the chunks are read and parsed in turn.
+ *  All the methods but the getters are collective: every process must call them, even with no lines.
+ */
+class ScatterReader {
+
+public:
+
+    /*!
+     * Function parsing a chunk: it receives the text of whole records of the process, in file order,
+     * each line ended by a newline
+     */
+    typedef std::function<void(const char * begin, const char * end)> ChunkParser;
+
+    ScatterReader(const std::string & path, bool perNode, std::size_t chunkSize);
+
+    bool readLines(uint64_t bodyOffset, const LineIndex * index, uint64_t firstLine, uint64_t nLines,
+            int linesPerRecord, const ChunkParser & parser);
+
+    bool isPerNode() const;
+
+    void logBandwidth(const std::string & label) const;
+
+private:
+
+    std::string m_path;                                 /**<path of the file*/
+    bool m_perNode;                                     /**<true for one reader per node, false for a single reader*/
+    std::size_t m_chunkSize;                            /**<size of the chunks sent by the readers [bytes]*/
+
+    bool m_isReader;                                    /**<true if the process was a reader in the last read*/
+    uint64_t m_bytes;                                   /**<bytes sent by the process in the last read, zero if it is not a reader*/
+    uint64_t m_nChunks;                                 /**<chunks sent by the process in the last read*/
+    std::size_t m_peakBuffer;                           /**<largest chunk sent by the process in the last read [bytes]*/
+    double m_elapsed;                                   /**<time spent in the last read [s]*/
+
+};
+
+#endif
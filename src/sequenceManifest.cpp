@@ -0,0 +1,172 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#if ENABLE_MPI==1
+#    include <mpi.h>
+#endif
+
+#include <fstream>
+#include <sstream>
+
+#include <bitpit_IO.hpp>
+
+#include "sequenceManifest.hpp"
+
+using namespace bitpit;
+
+/*!
+ * It splits a file path into the folder, name and extension used by bitpit FileHandler
+ * (e.g. data/matrix.0.dat gives data, matrix.0 and dat)
+ * \param[in] path path of the file
+ * \param[out] dir folder of the file, "." if the path has none
+ * \param[out] name file name without extension
+ * \param[out] app file extension, empty if the name has none
+ */
+void SequenceManifest::splitPath(const std::string & path, std::string & dir, std::string & name, std::string & app)
+{
+    std::size_t slash = path.find_last_of('/');
+    dir = (slash == std::string::npos) ? "." : path.substr(0, slash);
+    std::string fileName = (slash == std::string::npos) ? path : path.substr(slash + 1);
+    std::size_t dot = fileName.find_last_of('.');
+    name = (dot == std::string::npos) ? fileName : fileName.substr(0, dot);
+    app = (dot == std::string::npos) ? "" : fileName.substr(dot + 1);
+}
+
+/*!
+ * Constructor
+ * No manifest is read until readManifest is called.
+ * \param[in] path path of the manifest
+ */
+SequenceManifest::SequenceManifest(const std::string & path) :
+        m_path(path), m_steps()
+{
+
+}
+
+/*!
+ * It reads the manifest on the first process and broadcasts it. This method is collective.
+ * \param[in] rank MPI rank of the process
+ * \return true if the manifest has been read and it has at least one step
+ */
+bool SequenceManifest::readManifest(int rank)
+{
+    int isValid = 0;
+    if(rank == 0) {
+        log::cout() << "Sequence manifest path: " << m_path << std::endl;
+        std::ifstream manifest(m_path.c_str());
+        if(manifest.is_open()) {
+            isValid = parseManifest(manifest) ? 1 : 0;
+        }
+    }
+
+#if ENABLE_MPI==1
+    //Steps travel as a single string, one path per line
+    std::string packed;
+    if(rank == 0) {
+        for(const Step & step : m_steps) {
+            packed += step.matrixPath + "\n" + step.rhsPath + "\n";
+        }
+    }
+    long info[2] = {isValid, static_cast<long>(packed.size())};
+    MPI_Bcast(info, 2, MPI_LONG, 0, MPI_COMM_WORLD);
+    isValid = static_cast<int>(info[0]);
+    packed.resize(info[1]);
+    MPI_Bcast(&packed[0], static_cast<int>(packed.size()), MPI_CHAR, 0, MPI_COMM_WORLD);
+    if(rank != 0) {
+        std::istringstream ss(packed);
+        Step step;
+        while(std::getline(ss, step.matrixPath) && std::getline(ss, step.rhsPath)) {
+            m_steps.push_back(step);
+        }
+    }
+#endif
+    if(!isValid) {
+        log::cout() << "Sequence manifest " << m_path << " not open or not valid!" << std::endl;
+        return false;
+    }
+
+    log::cout() << "Sequence steps = " << getStepCount() << std::endl;
+
+    return true;
+}
+
+/*!
+ * It parses the manifest lines after the title, skipping comments and blank lines
+ * \param[in] manifest the manifest stream
+ * \return true if every step line has two paths and there is at least one step
+ */
+bool SequenceManifest::parseManifest(std::istream & manifest)
+{
+    std::string line;
+    std::getline(manifest, line);
+    while(std::getline(manifest, line)) {
+        line = utils::string::trim(line);
+        if(line.empty() || line.substr(0,1) == "#") {
+            continue;
+        }
+        std::istringstream ss(line);
+        Step step;
+        std::string extra;
+        if(!(ss >> step.matrixPath >> step.rhsPath) || (ss >> extra)) {
+            log::cout() << "Sequence manifest line \"" << line << "\" is not a matrix and right-hand side pair!" << std::endl;
+            return false;
+        }
+        step.matrixPath = resolvePath(step.matrixPath);
+        step.rhsPath = resolvePath(step.rhsPath);
+        m_steps.push_back(step);
+    }
+
+    return !m_steps.empty();
+}
+
+/*!
+ * It makes a path of the manifest relative to the folder of the manifest, absolute paths are kept
+ * \param[in] path path as written in the manifest
+ * \return the path to be opened
+ */
+std::string SequenceManifest::resolvePath(const std::string & path) const
+{
+    std::size_t slash = m_path.find_last_of('/');
+    if(path.substr(0,1) == "/" || slash == std::string::npos) {
+        return path;
+    }
+    return m_path.substr(0, slash + 1) + path;
+}
+
+/*!
+ * It gets the number of steps of the sequence
+ * \return the number of steps
+ */
+std::size_t SequenceManifest::getStepCount() const
+{
+    return m_steps.size();
+}
+
+/*!
+ * It gets the files of a step
+ * \param[in] step zero-based number of the step
+ * \return a constant reference to the files of the step
+ */
+const SequenceManifest::Step & SequenceManifest::getStep(std::size_t step) const
+{
+    return m_steps[step];
+}
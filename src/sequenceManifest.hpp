@@ -0,0 +1,82 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_SEQUENCEMANIFEST_HPP__
+#define __MADLINSOLV_SEQUENCEMANIFEST_HPP__
+
+#include <istream>
+#include <string>
+#include <vector>
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The sequence manifest class
+ *
+ *  This class is intended to
+ *  read the list of linear systems solved in sequence mode, one (matrix, right-hand side) pair per step:
+ *  \verbatim
+ *                                  manifest file format
+ *             ------------------------------------------------------------------------
+ *  line 1     | title                                                                | ---> skipped
+ *  line 2     | step_0_matrix_file step_0_right-hand_side_file                       | ---
+ *  ...        | ...                                                                  |   | ---> steps
+ *  line S+1   | step_S-1_matrix_file step_S-1_right-hand_side_file                   | ---
+ *             ------------------------------------------------------------------------
+ *  \endverbatim
+ *  Lines starting with '#' are comments. Relative paths are relative to the folder of the manifest,
+ *  and file names must have an extension (see bitpit FileHandler class).
+ *  All the matrices must share the sparsity pattern of the first one.
+ *  Only the first process reads the manifest, then it is broadcast.
+ */
+class SequenceManifest {
+
+public:
+
+    /*!
+     * Files of a step of the sequence
+     */
+    struct Step {
+        std::string matrixPath;                         /**<path of the matrix file*/
+        std::string rhsPath;                            /**<path of the right-hand side file*/
+    };
+
+    static void splitPath(const std::string & path, std::string & dir, std::string & name, std::string & app);
+
+    explicit SequenceManifest(const std::string & path);
+
+    bool readManifest(int rank);
+
+    std::size_t getStepCount() const;
+    const Step & getStep(std::size_t step) const;
+
+private:
+
+    bool parseManifest(std::istream & manifest);
+    std::string resolvePath(const std::string & path) const;
+
+    std::string m_path;                                 /**<path of the manifest*/
+    std::vector<Step> m_steps;                          /**<files of the steps, in solving order*/
+
+};
+
+#endif
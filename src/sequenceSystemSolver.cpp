@@ -0,0 +1,67 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#include <petscksp.h>
+
+#include "sequenceSystemSolver.hpp"
+
+using namespace bitpit;
+
+/*!
+ * Constructor
+ * The preconditioner is rebuilt at every solve until setReusePreconditioner is called.
+ * \param[in] debug boolean to activate the PETSc debug output
+ */
+SequenceSystemSolver::SequenceSystemSolver(bool debug) :
+        ConfiguredSystemSolver(debug), m_reusePreconditioner(false)
+{
+
+}
+
+/*!
+ * It sets whether the next solves keep the current preconditioner, even if the matrix values have been updated
+ * \param[in] reuse true to keep the current preconditioner, false to rebuild it from the current matrix
+ */
+void SequenceSystemSolver::setReusePreconditioner(bool reuse)
+{
+    m_reusePreconditioner = reuse;
+}
+
+/*!
+ * It gets whether the next solves keep the current preconditioner
+ * \return true if the current preconditioner is kept
+ */
+bool SequenceSystemSolver::isReusePreconditioner() const
+{
+    return m_reusePreconditioner;
+}
+
+/*!
+ * It performs the ConfiguredSystemSolver actions before the KSP solve, then it passes the reuse flag to the KSP.
+ * With the flag set, the preconditioner built at the last rebuild is applied to the updated matrix.
+ */
+void SequenceSystemSolver::preKSPSolveActions()
+{
+    ConfiguredSystemSolver::preKSPSolveActions();
+
+    KSPSetReusePreconditioner(m_KSP, m_reusePreconditioner ? PETSC_TRUE : PETSC_FALSE);
+}
@@ -0,0 +1,64 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_SEQUENCESYSTEMSOLVER_HPP__
+#define __MADLINSOLV_SEQUENCESYSTEMSOLVER_HPP__
+
+#include <bitpit_LA.hpp>
+
+#include "configuredSystemSolver.hpp"
+
+using namespace bitpit;
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The sequence system solver class
+ *
+ *  This class is intended to
+ *  solve a sequence of linear systems sharing the same sparsity pattern, whose matrix values are changed
+ *  between two solves by SystemSolver::update.
+ *  PETSc rebuilds the preconditioner whenever the matrix has changed since its last setup;
+ *  this class lets the caller keep the preconditioner of a previous matrix instead, through KSPSetReusePreconditioner,
+ *  which is set before each solve. The Krylov method and the preconditioner are those of the solver options
+ *  (see ConfiguredSystemSolver class).
+ */
+class SequenceSystemSolver : public ConfiguredSystemSolver {
+
+public:
+
+    SequenceSystemSolver(bool debug = false);
+
+    void setReusePreconditioner(bool reuse);
+    bool isReusePreconditioner() const;
+
+protected:
+
+    void preKSPSolveActions() override;
+
+private:
+
+    bool m_reusePreconditioner;                         /**<true if the next solve keeps the current preconditioner*/
+
+};
+
+#endif
@@ -0,0 +1,108 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#include <cerrno>
+
+#include <sys/socket.h>
+#include <sys/types.h>
+
+#include "serverProtocol.hpp"
+
+/*!
+ * Signature opening every request and reply header
+ */
+const uint32_t ServerProtocol::MAGIC = 0x4d4c5331;
+
+/*!
+ * It gets the name of a command, for logging purposes
+ * \param[in] command the command code
+ * \return the name of the command, "UNKNOWN" if the code is not a Command
+ */
+const char * ServerProtocol::getCommandName(uint32_t command)
+{
+    switch(static_cast<Command>(command)) {
+    case Command::INFO:
+        return "INFO";
+    case Command::NEW_RHS:
+        return "NEW_RHS";
+    case Command::UPDATE_VALUES:
+        return "UPDATE_VALUES";
+    case Command::SOLVE:
+        return "SOLVE";
+    case Command::FETCH_SOLUTION:
+        return "FETCH_SOLUTION";
+    case Command::SHUTDOWN:
+        return "SHUTDOWN";
+    }
+
+    return "UNKNOWN";
+}
+
+/*!
+ * It sends a buffer on a stream socket, looping over partial sends
+ * \param[in] socket the socket descriptor
+ * \param[in] data bytes to be sent
+ * \param[in] size number of bytes to be sent
+ * \return true if all the bytes have been sent
+ */
+bool ServerProtocol::sendAll(int socket, const void * data, std::size_t size)
+{
+    const char *bytes = static_cast<const char *>(data);
+    while(size > 0) {
+        ssize_t sent = send(socket, bytes, size, MSG_NOSIGNAL);
+        if(sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if(sent <= 0) {
+            return false;
+        }
+        bytes += sent;
+        size -= static_cast<std::size_t>(sent);
+    }
+
+    return true;
+}
+
+/*!
+ * It receives a buffer from a stream socket, looping over partial receives
+ * \param[in] socket the socket descriptor
+ * \param[out] data buffer of at least size bytes
+ * \param[in] size number of bytes to be received
+ * \return true if all the bytes have been received, false if the peer closed the connection or an error occurred
+ */
+bool ServerProtocol::receiveAll(int socket, void * data, std::size_t size)
+{
+    char *bytes = static_cast<char *>(data);
+    while(size > 0) {
+        ssize_t received = recv(socket, bytes, size, 0);
+        if(received < 0 && errno == EINTR) {
+            continue;
+        }
+        if(received <= 0) {
+            return false;
+        }
+        bytes += received;
+        size -= static_cast<std::size_t>(received);
+    }
+
+    return true;
+}
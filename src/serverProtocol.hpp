@@ -0,0 +1,120 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_SERVERPROTOCOL_HPP__
+#define __MADLINSOLV_SERVERPROTOCOL_HPP__
+
+#include <cstddef>
+#include <cstdint>
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The solver server protocol class
+ *
+ *  This class is intended to
+ *  define the messages exchanged by the solver server (see SolverServer class) and its clients
+ *  (see SolverClient class) over a local UNIX-domain stream socket.
+ *  Every request is a RequestHeader followed by payloadSize bytes, every reply is a ReplyHeader
+ *  followed by payloadSize bytes. Payloads by command:
+ *  \verbatim
+ *  command          request payload                       reply payload
+ *  INFO             none                                  InfoReply (global rows and non-zeros)
+ *  NEW_RHS          global rows doubles                   none
+ *  UPDATE_VALUES    global non-zeros doubles, CSR order   none
+ *  SOLVE            none                                  SolveReply (iterations, residual and time)
+ *  FETCH_SOLUTION   none                                  global rows doubles
+ *  SHUTDOWN         none                                  none, then the server stops
+ *  \endverbatim
+ *  Numbers are in the host byte order, since client and server run on the same node.
+ *  This class depends on POSIX only, so that it is shared by the server and the client library.
+ */
+class ServerProtocol {
+
+public:
+
+    static const uint32_t MAGIC;
+
+    /*!
+     * Requests accepted by the server
+     */
+    enum class Command : uint32_t {
+        INFO = 0,                                       /**<get the sizes of the system*/
+        NEW_RHS = 1,                                    /**<replace the right-hand side*/
+        UPDATE_VALUES = 2,                              /**<replace the matrix values, keeping the pattern*/
+        SOLVE = 3,                                      /**<solve the system*/
+        FETCH_SOLUTION = 4,                             /**<get the solution*/
+        SHUTDOWN = 5                                    /**<stop the server*/
+    };
+
+    /*!
+     * Outcomes of a request
+     */
+    enum class Status : int32_t {
+        OK = 0,                                         /**<request executed*/
+        BAD_REQUEST = 1,                                /**<payload size not matching the command, the connection is closed*/
+        UNKNOWN_COMMAND = 2,                            /**<command not recognized*/
+        FAILED = 3                                      /**<request not executed*/
+    };
+
+    /*!
+     * Header of a request
+     */
+    struct RequestHeader {
+        uint32_t magic;                                 /**<MAGIC*/
+        uint32_t command;                               /**<requested Command*/
+        uint64_t payloadSize;                           /**<bytes following the header*/
+    };
+
+    /*!
+     * Header of a reply
+     */
+    struct ReplyHeader {
+        uint32_t magic;                                 /**<MAGIC*/
+        int32_t status;                                 /**<Status of the request*/
+        uint64_t payloadSize;                           /**<bytes following the header*/
+    };
+
+    /*!
+     * Payload of the INFO reply
+     */
+    struct InfoReply {
+        int64_t nRows;                                  /**<global number of rows*/
+        int64_t nNz;                                    /**<global number of non-zeros*/
+    };
+
+    /*!
+     * Payload of the SOLVE reply
+     */
+    struct SolveReply {
+        int64_t iterations;                             /**<Krylov iterations*/
+        double residual;                                /**<final residual norm*/
+        double time;                                    /**<solve time on the server [s]*/
+    };
+
+    static const char * getCommandName(uint32_t command);
+    static bool sendAll(int socket, const void * data, std::size_t size);
+    static bool receiveAll(int socket, void * data, std::size_t size);
+
+};
+
+#endif
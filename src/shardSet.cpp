@@ -0,0 +1,308 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#if ENABLE_MPI==1
+#    include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <fstream>
+
+#include <bitpit_IO.hpp>
+
+#include "shardSet.hpp"
+#include "inputFileStream.hpp"
+#include "lineIndex.hpp"
+
+using namespace bitpit;
+
+const char ShardSet::PLACEHOLDER = '*';
+
+/*!
+ * Constructor
+ * No manifest is read until readManifest is called.
+ * \param[in] dir folder of the shards and of the manifest
+ * \param[in] pattern shard file name pattern, PLACEHOLDER standing for the shard number
+ */
+ShardSet::ShardSet(const std::string & dir, const std::string & pattern) :
+        m_dir(dir), m_pattern(pattern), m_nRows(0), m_nCols(0), m_nNz(0), m_rowStarts(), m_nnzStarts()
+{
+
+}
+
+/*!
+ * It reads the manifest on the first process and broadcasts it. This method is collective.
+ * \param[in] rank MPI rank of the process
+ * \return true if the manifest has been read and its row ranges are contiguous
+ */
+bool ShardSet::readManifest(int rank)
+{
+    int isValid = 0;
+    if(rank == 0) {
+        log::cout() << "Shard manifest path: " << getManifestPath() << std::endl;
+        std::ifstream manifest(getManifestPath().c_str());
+        if(manifest.is_open()) {
+            isValid = parseManifest(manifest) ? 1 : 0;
+        }
+    }
+
+#if ENABLE_MPI==1
+    long info[5] = {isValid, static_cast<long>(m_rowStarts.size()), m_nCols, m_nNz, static_cast<long>(m_nnzStarts.size())};
+    MPI_Bcast(info, 5, MPI_LONG, 0, MPI_COMM_WORLD);
+    isValid = static_cast<int>(info[0]);
+    m_rowStarts.resize(info[1]);
+    m_nCols = info[2];
+    m_nNz = info[3];
+    m_nnzStarts.resize(info[4]);
+    MPI_Bcast(m_rowStarts.data(), static_cast<int>(m_rowStarts.size()), MPI_LONG, 0, MPI_COMM_WORLD);
+    MPI_Bcast(m_nnzStarts.data(), static_cast<int>(m_nnzStarts.size()), MPI_LONG, 0, MPI_COMM_WORLD);
+#endif
+    if(!isValid) {
+        log::cout() << "Shard manifest " << getManifestPath() << " not open or not valid!" << std::endl;
+        return false;
+    }
+    m_nRows = m_rowStarts.back();
+
+    log::cout() << "Shards = " << getShardCount() << ", nRows = " << m_nRows << std::endl;
+
+    return true;
+}
+
+/*!
+ * It reads the rows of a process from the shards overlapping them. This method is collective.
+ * Each shard header is checked against the manifest; if the process starts in the middle of a shard,
+ * it jumps to its first row through the line index of the shard, which is saved only by the first
+ * process starting in that shard.
+ * \param[in] partition the row partition among processes
+ * \param[in] rank MPI rank of the process
+ * \param[in] linesPerRow number of file lines of each row (two for the matrix, one for the vectors)
+ * \param[in] reader the function reading the rows, called once per overlapping shard in row order
+ * \return true if all the processes read their shards
+ */
+bool ShardSet::readRows(const RowPartition & partition, int rank, int linesPerRow, const RowReader & reader) const
+{
+    long begin = partition.getRowStart(rank);
+    long end = begin + partition.getRowCount(rank);
+
+    int isRead = 1;
+    for(int shard = 0; shard < getShardCount() && begin < end; ++shard) {
+        long shardBegin = m_rowStarts[shard];
+        long shardEnd = m_rowStarts[shard + 1];
+        if(shardEnd <= begin || shardBegin >= end) {
+            continue;
+        }
+
+        InputFileStream shardStream(getShardPath(shard));
+        long nShardRows = 0;
+        if(!shardStream.isOpen() || !readShardHeader(shardStream, &nShardRows) || nShardRows != shardEnd - shardBegin) {
+            log::cout() << "Shard " << getShardPath(shard) << " not open or not matching the manifest!" << std::endl;
+            isRead = 0;
+            break;
+        }
+
+        long first = std::max(begin, shardBegin);
+        long last = std::min(end, shardEnd);
+        if(first > shardBegin) {
+            bool isFirstInShard = (rank == 0 || partition.getRowStart(rank - 1) <= shardBegin);
+            LineIndex index(getShardPath(shard), linesPerRow * LineIndex::DEFAULT_STRIDE);
+            index.initializeLocal(static_cast<uint64_t>(shardStream.tellg()), isFirstInShard);
+            index.seek(shardStream, linesPerRow * (first - shardBegin));
+        }
+
+        Tokenizer tokenizer(shardStream);
+        reader(tokenizer, first - begin, last - first);
+        if(shardStream.isCorrupted()) {
+            log::cout() << "Shard " << getShardPath(shard) << " is a corrupted or truncated gzip file!" << std::endl;
+            isRead = 0;
+            break;
+        }
+    }
+
+#if ENABLE_MPI==1
+    MPI_Allreduce(MPI_IN_PLACE, &isRead, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+#endif
+
+    return isRead == 1;
+}
+
+/*!
+ * It gets the path of the manifest
+ * \return the path of the manifest
+ */
+std::string ShardSet::getManifestPath() const
+{
+    return replacePlaceholder("manifest");
+}
+
+/*!
+ * It gets the path of a shard
+ * \param[in] shard shard number
+ * \return the path of the shard
+ */
+std::string ShardSet::getShardPath(int shard) const
+{
+    return replacePlaceholder(std::to_string(shard));
+}
+
+/*!
+ * It gets the number of shards
+ * \return the number of shards
+ */
+int ShardSet::getShardCount() const
+{
+    return m_rowStarts.empty() ? 0 : static_cast<int>(m_rowStarts.size()) - 1;
+}
+
+/*!
+ * It gets the global number of rows
+ * \return the global number of rows
+ */
+long ShardSet::getRowGlobalCount() const
+{
+    return m_nRows;
+}
+
+/*!
+ * It gets the global number of columns
+ * \return the global number of columns, zero if the manifest does not give it
+ */
+long ShardSet::getColGlobalCount() const
+{
+    return m_nCols;
+}
+
+/*!
+ * It gets the global number of non-zeros
+ * \return the global number of non-zeros, zero if the manifest does not give it
+ */
+long ShardSet::getNonZeroGlobalCount() const
+{
+    return m_nNz;
+}
+
+/*!
+ * It gets the first global row of a shard
+ * \param[in] shard shard number
+ * \return the first global row of the shard
+ */
+long ShardSet::getShardRowStart(int shard) const
+{
+    return m_rowStarts[shard];
+}
+
+/*!
+ * It gets the number of rows of a shard
+ * \param[in] shard shard number
+ * \return the number of rows of the shard
+ */
+long ShardSet::getShardRowCount(int shard) const
+{
+    return m_rowStarts[shard + 1] - m_rowStarts[shard];
+}
+
+/*!
+ * It gets the partition giving one shard to each process, meaningful when there are as many shards as processes
+ * \return the partition, with the number of non-zeros of each process if the manifest gives them
+ */
+RowPartition ShardSet::getPartition() const
+{
+    return RowPartition::fromRowStarts(m_rowStarts, m_nnzStarts);
+}
+
+/*!
+ * It replaces the placeholder of the pattern and prepends the folder
+ * \param[in] replacement the string replacing the placeholder
+ * \return the file path
+ */
+std::string ShardSet::replacePlaceholder(const std::string & replacement) const
+{
+    std::string name = m_pattern;
+    std::size_t position = name.find(PLACEHOLDER);
+    if(position != std::string::npos) {
+        name.replace(position, 1, replacement);
+    }
+
+    return m_dir.empty() ? name : m_dir + "/" + name;
+}
+
+/*!
+ * It parses the manifest, checking that the shards cover contiguous row ranges
+ * \param[in] manifest the stream from the manifest file
+ * \return true if the manifest is valid
+ */
+bool ShardSet::parseManifest(std::istream & manifest)
+{
+    std::vector<std::vector<long>> lines;
+    std::string line;
+    std::getline(manifest, line);
+    while(std::getline(manifest, line)) {
+        line = utils::string::trim(line);
+        if(line.empty() || line[0] == '#') {
+            continue;
+        }
+        lines.emplace_back();
+        Tokenizer::parseLine(line.data(), line.data() + line.size(), lines.back());
+    }
+    if(lines.empty() || lines[0].size() < 2 || lines[0][0] <= 0 || static_cast<long>(lines.size()) != lines[0][0] + 1) {
+        return false;
+    }
+
+    long nShards = lines[0][0];
+    m_nCols = lines[0].size() > 2 ? lines[0][2] : 0;
+    m_nNz = lines[0].size() > 3 ? lines[0][3] : 0;
+    m_rowStarts.assign(1, 0);
+    m_nnzStarts.assign(1, 0);
+    for(long shard = 0; shard < nShards; ++shard) {
+        const std::vector<long> & range = lines[shard + 1];
+        if(range.size() < 2 || range[0] != m_rowStarts.back() || range[1] < 0) {
+            return false;
+        }
+        m_rowStarts.push_back(range[0] + range[1]);
+        if(range.size() > 2 && !m_nnzStarts.empty()) {
+            m_nnzStarts.push_back(m_nnzStarts.back() + range[2]);
+        } else {
+            m_nnzStarts.clear();
+        }
+    }
+
+    return m_rowStarts.back() == lines[0][1];
+}
+
+/*!
+ * It skips the header of a shard, title line and comments included
+ * \param[in] fileStream the stream from the shard file, left at the first body line
+ * \param[out] nRows the number of rows given by the shard header
+ * \return true if the header has been found
+ */
+bool ShardSet::readShardHeader(std::istream & fileStream, long * nRows)
+{
+    std::string line;
+    std::getline(fileStream, line);
+    while(std::getline(fileStream, line)) {
+        line = utils::string::trim(line);
+        if(line.substr(0,1) != "#") {
+            return Tokenizer::parseLong(line.data(), line.data() + line.size(), nRows) != nullptr;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,107 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_SHARDSET_HPP__
+#define __MADLINSOLV_SHARDSET_HPP__
+
+#include <functional>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "rowPartition.hpp"
+#include "tokenizer.hpp"
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The sharded input class
+ *
+ *  This class is intended to
+ *  read an input (matrix, right-hand side or initial solution) split in several ASCII files, the shards,
+ *  each one holding a contiguous range of global rows in the same format as the single file
+ *  (header with the shard sizes, then the shard rows; matrix column indices stay global).
+ *  Shard file names are given by a pattern, where the character '*' stands for the shard number
+ *  (e.g. matrixCSR.*.dat gives matrixCSR.0.dat, matrixCSR.1.dat, ...); the manifest is the file whose name
+ *  replaces '*' with "manifest" (e.g. matrixCSR.manifest.dat):
+ *  \verbatim
+ *                                  manifest file format
+ *             ------------------------------------------------------------------------
+ *  line 1     | title                                                                | ---> skipped
+ *  line 2     | number_of_shards global_rows [global_columns global_nonzeros]        | ---> header
+ *  line 3     | shard_0_first_row shard_0_rows [shard_0_nonzeros]                    | ---
+ *  ...        | ...                                                                  |   | ---> shards
+ *  line S+2   | shard_S-1_first_row shard_S-1_rows [shard_S-1_nonzeros]              | ---
+ *             ------------------------------------------------------------------------
+ *  \endverbatim
+ *  Lines starting with '#' are comments. Only the first process reads the manifest, then it is broadcast.
+ *  When the number of shards equals the number of processes, each process opens only its own shard.
+ *  Otherwise, each process opens the shards overlapping its rows and jumps to its first row through
+ *  the line index of the shard (see LineIndex class), so shards are merged or split without parsing
+ *  the rows of the other processes.
+ */
+class ShardSet {
+
+public:
+
+    /*!
+     * Function reading rows from a shard: it receives the tokenizer positioned at the first row to be read,
+     * the position of that row among the rows of the process and the number of rows to be read
+     */
+    typedef std::function<void(Tokenizer & tokenizer, long localRow, long nRows)> RowReader;
+
+    static const char PLACEHOLDER;
+
+    ShardSet(const std::string & dir, const std::string & pattern);
+
+    bool readManifest(int rank);
+    bool readRows(const RowPartition & partition, int rank, int linesPerRow, const RowReader & reader) const;
+
+    std::string getManifestPath() const;
+    std::string getShardPath(int shard) const;
+
+    int getShardCount() const;
+    long getRowGlobalCount() const;
+    long getColGlobalCount() const;
+    long getNonZeroGlobalCount() const;
+    long getShardRowStart(int shard) const;
+    long getShardRowCount(int shard) const;
+    RowPartition getPartition() const;
+
+private:
+
+    std::string replacePlaceholder(const std::string & replacement) const;
+    bool parseManifest(std::istream & manifest);
+    static bool readShardHeader(std::istream & fileStream, long * nRows);
+
+    std::string m_dir;                                  /**<folder of the shards and of the manifest*/
+    std::string m_pattern;                              /**<shard file name pattern*/
+
+    long m_nRows;                                       /**<global number of rows*/
+    long m_nCols;                                       /**<global number of columns, zero if not given*/
+    long m_nNz;                                         /**<global number of non-zeros, zero if not given*/
+    std::vector<long> m_rowStarts;                      /**<first row of each shard, followed by the global number of rows*/
+    std::vector<long> m_nnzStarts;                      /**<first non-zero of each shard, followed by the global number of non-zeros (empty if not given)*/
+
+};
+
+#endif
@@ -0,0 +1,267 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#if ENABLE_MPI==1
+#    include <mpi.h>
+#endif
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include <bitpit_IO.hpp>
+
+#include "sharedSegment.hpp"
+
+using namespace bitpit;
+
+/*!
+ * Constructor. The segment is not attached.
+ * \param[in] nProcessors the number of MPI ranks
+ * \param[in] rank        the MPI rank of the process owing the object
+ * \param[in] name        name of the segment, a leading '/' is added if missing
+ */
+SharedSegment::SharedSegment(int nProcessors, int rank, const std::string & name)
+    : m_nProcessors(nProcessors), m_rank(rank), m_name(name), m_data(nullptr), m_size(0)
+{
+    if(m_name.empty() || m_name[0] != '/') {
+        m_name = "/" + m_name;
+    }
+    std::memset(&m_header, 0, sizeof(m_header));
+}
+
+/*!
+ * Destructor. It unmaps the segment, without marking it consumed.
+ */
+SharedSegment::~SharedSegment()
+{
+    unmap();
+}
+
+/*!
+ * It attaches all the processes to the published segment.
+ * The first process waits for the segment to exist and to be in READY state, then the others map it.
+ * This method is collective.
+ * \param[in] timeout maximum time to wait for the segment [s]
+ * \return true if the segment is mapped on all the processes and its header is valid
+ */
+bool SharedSegment::attach(double timeout)
+{
+    int isReady = 0;
+    if(m_rank == 0) {
+        isReady = waitReady(timeout) ? 1 : 0;
+    }
+#if ENABLE_MPI == 1
+    MPI_Bcast(&isReady, 1, MPI_INT, 0, MPI_COMM_WORLD);
+#endif
+    if(!isReady) {
+        log::cout() << "Shared-memory segment " << m_name << " not published within " << timeout << " s" << std::endl;
+        unmap();
+        return false;
+    }
+
+    int isMapped = (m_rank == 0 || map()) ? 1 : 0;
+#if ENABLE_MPI == 1
+    MPI_Allreduce(MPI_IN_PLACE, &isMapped, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+#endif
+    if(!isMapped) {
+        log::cout() << "Shared-memory segment " << m_name << " not available on every process, all of them must run on the producer node" << std::endl;
+        unmap();
+        return false;
+    }
+
+    //The acquire load makes the parts written by the producer visible to this process
+    SharedSegmentFormat::loadState(reinterpret_cast<const SharedSegmentHeader *>(m_data));
+    std::memcpy(&m_header, m_data, sizeof(m_header));
+    std::string error;
+    if(!SharedSegmentFormat::checkHeader(m_header, m_size, &error)) {
+        log::cout() << "Shared-memory segment " << m_name << " is not valid: " << error << std::endl;
+        unmap();
+        return false;
+    }
+
+    log::cout() << "Shared-memory segment " << m_name << " attached: publication " << m_header.sequence << ", "
+            << m_size / (1024. * 1024.) << " MB, matrix " << (hasPart(Part::MATRIX) ? "yes" : "no")
+            << ", right-hand sides " << (hasPart(Part::RHS) ? "yes" : "no")
+            << ", initial solution " << (hasPart(Part::SOLUTION) ? "yes" : "no") << std::endl;
+
+    return true;
+}
+
+/*!
+ * It marks the segment consumed, once all the processes are done with it, and unmaps it.
+ * The parts must not be used anymore. This method is collective.
+ */
+void SharedSegment::release()
+{
+#if ENABLE_MPI == 1
+    MPI_Barrier(MPI_COMM_WORLD);
+#endif
+    if(m_rank == 0 && m_data != nullptr) {
+        SharedSegmentFormat::storeState(reinterpret_cast<SharedSegmentHeader *>(m_data), SharedSegmentFormat::State::CONSUMED);
+        log::cout() << "Shared-memory segment " << m_name << " consumed" << std::endl;
+    }
+    unmap();
+}
+
+/*!
+ * It checks if the segment holds a part
+ * \param[in] part the part
+ * \return true if the attached segment holds the part
+ */
+bool SharedSegment::hasPart(Part part) const
+{
+    return getData(part) != nullptr;
+}
+
+/*!
+ * It gets the first byte of a part
+ * \param[in] part the part
+ * \return a pointer to the embedded container, null if the part is absent or the segment is not attached
+ */
+const char * SharedSegment::getData(Part part) const
+{
+    if(m_data == nullptr) {
+        return nullptr;
+    }
+
+    uint64_t offset = 0;
+    switch(part) {
+    case Part::MATRIX:
+        offset = m_header.matrixOffset;
+        break;
+    case Part::RHS:
+        offset = m_header.rhsOffset;
+        break;
+    case Part::SOLUTION:
+        offset = m_header.solutionOffset;
+        break;
+    }
+
+    return (offset != 0) ? m_data + offset : nullptr;
+}
+
+/*!
+ * It gets the size of a part
+ * \param[in] part the part
+ * \return the size in bytes of the embedded container, zero if the part is absent
+ */
+std::size_t SharedSegment::getSize(Part part) const
+{
+    switch(part) {
+    case Part::MATRIX:
+        return m_header.matrixSize;
+    case Part::RHS:
+        return m_header.rhsSize;
+    case Part::SOLUTION:
+        return m_header.solutionSize;
+    }
+
+    return 0;
+}
+
+/*!
+ * It gets the name of the segment
+ * \return the POSIX name of the segment
+ */
+const std::string & SharedSegment::getName() const
+{
+    return m_name;
+}
+
+/*!
+ * It maps the whole segment read-write, the state being written on consumption
+ * \return true if the segment exists and holds at least a header
+ */
+bool SharedSegment::map()
+{
+    unmap();
+
+    int fd = shm_open(m_name.c_str(), O_RDWR, 0);
+    if(fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if(fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(SharedSegmentHeader)) {
+        close(fd);
+        return false;
+    }
+
+    void *address = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    //The mapping keeps its own reference to the segment
+    close(fd);
+    if(address == MAP_FAILED) {
+        return false;
+    }
+
+    m_data = static_cast<char *>(address);
+    m_size = static_cast<std::size_t>(info.st_size);
+
+    return true;
+}
+
+/*!
+ * It unmaps the segment, if mapped
+ */
+void SharedSegment::unmap()
+{
+    if(m_data != nullptr) {
+        munmap(m_data, m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+}
+
+/*!
+ * It waits for the segment to exist and to be published, polling with a growing interval up to 10 ms
+ * \param[in] timeout maximum time to wait [s]
+ * \return true if the segment is mapped and in READY state
+ */
+bool SharedSegment::waitReady(double timeout)
+{
+    log::cout() << "Waiting for shared-memory segment " << m_name << "..." << std::endl;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::chrono::microseconds interval(100);
+    while(true) {
+        if(m_data != nullptr || map()) {
+            const SharedSegmentHeader *header = reinterpret_cast<const SharedSegmentHeader *>(m_data);
+            if(std::memcmp(header->magic, SharedSegmentFormat::MAGIC, sizeof(SharedSegmentFormat::MAGIC)) == 0
+                    && SharedSegmentFormat::loadState(header) == SharedSegmentFormat::State::READY) {
+                //The producer may have resized the segment before publishing it
+                return map();
+            }
+        }
+
+        if(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() > timeout) {
+            return false;
+        }
+        std::this_thread::sleep_for(interval);
+        interval = std::min(interval * 2, std::chrono::microseconds(10000));
+    }
+}
@@ -0,0 +1,88 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_SHAREDSEGMENT_HPP__
+#define __MADLINSOLV_SHAREDSEGMENT_HPP__
+
+#include <cstddef>
+#include <string>
+
+#include "binaryFormat.hpp"
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The shared-memory input segment class
+ *
+ *  This class is intended to
+ *  attach the processes to the POSIX shared-memory segment through which a producer process running on the same node
+ *  hands the matrix, the right-hand sides and the initial solution over (see SharedSegmentFormat class for the layout
+ *  and the handshake), so that no file is written nor parsed.
+ *  The first process waits for the segment to be created and published, then all the processes map it and the
+ *  matrix and vector readers use its parts in place (see MatrixReader::setSharedData and VectorReader::setSharedData).
+ *  Once every part has been read, release marks the segment consumed, so that the producer may publish the next inputs.
+ *  All the processes must run on the node of the producer.
+ */
+class SharedSegment {
+
+public:
+
+    /*!
+     * Parts a segment may hold
+     */
+    enum class Part {
+        MATRIX,                                         /**<binary CSR container of the matrix*/
+        RHS,                                            /**<binary vector container of the right-hand sides*/
+        SOLUTION                                        /**<binary vector container of the initial solution*/
+    };
+
+    SharedSegment(int nProcessors, int rank, const std::string & name);
+    ~SharedSegment();
+
+    SharedSegment(SharedSegment const&) = delete;
+    SharedSegment & operator=(SharedSegment const&) = delete;
+
+    bool attach(double timeout);
+    void release();
+
+    bool hasPart(Part part) const;
+    const char * getData(Part part) const;
+    std::size_t getSize(Part part) const;
+    const std::string & getName() const;
+
+private:
+
+    bool map();
+    void unmap();
+    bool waitReady(double timeout);
+
+    int m_nProcessors;                                  /**<number of MPI processes*/
+    int m_rank;                                         /**<MPI rank of the process*/
+    std::string m_name;                                 /**<POSIX name of the segment, starting with '/'*/
+
+    char *m_data;                                       /**<first byte of the mapped segment, null if not mapped*/
+    std::size_t m_size;                                 /**<size in bytes of the mapped segment*/
+    SharedSegmentHeader m_header;                       /**<copy of the header of the published segment*/
+
+};
+
+#endif
@@ -39,7 +39,7 @@ using namespace bitpit;
  *  and calling MPI routines for parallel ones
  */
 Solver::Solver() :
-        m_matrixReader(nullptr), m_matrix(nullptr), m_rhsReader(nullptr), m_initialSolutionReader(nullptr), m_system(nullptr)
+        m_matrixReader(nullptr), m_matrix(nullptr), m_rhsReader(nullptr), m_initialSolutionReader(nullptr), m_solutionWriter(nullptr), m_system(nullptr), m_nativeSolver(nullptr)
 {
 #if ENABLE_MPI==1
     MPI_Comm_size(MPI_COMM_WORLD, &m_nProcessors);
@@ -58,7 +58,7 @@ Solver::Solver() :
  */
 Solver::Solver(int nProcessors, int rank) :
         m_nProcessors(nProcessors), m_rank(rank), m_matrixReader(nullptr), m_matrix(nullptr),
-        m_rhsReader(nullptr), m_initialSolutionReader(nullptr), m_system(nullptr)
+        m_rhsReader(nullptr), m_initialSolutionReader(nullptr), m_solutionWriter(nullptr), m_system(nullptr), m_nativeSolver(nullptr)
 {
 
 }
@@ -83,22 +83,31 @@ std::unique_ptr<SparseMatrix>& Solver::getMatrix()
 
 /*!
  * It gets the m_rhsReader member
- * @return a reference to the RhsReader unique pointer
+ * @return a reference to the right-hand side VectorReader unique pointer
  */
-std::unique_ptr<RhsReader>& Solver::getRhsReader()
+std::unique_ptr<VectorReader>& Solver::getRhsReader()
 {
     return m_rhsReader;
 }
 
 /*!
  * It gets the m_initialSolutionReader member
- * @return a reference to the InitialSolutionReader unique pointer
+ * @return a reference to the initial solution VectorReader unique pointer
  */
-std::unique_ptr<InitialSolutionReader>& Solver::getInitialSolutionReader()
+std::unique_ptr<VectorReader>& Solver::getInitialSolutionReader()
 {
     return m_initialSolutionReader;
 }
 
+/*!
+ * It gets the m_solutionWriter member
+ * @return a reference to the solution VectorWriter unique pointer
+ */
+std::unique_ptr<VectorWriter>& Solver::getSolutionWriter()
+{
+    return m_solutionWriter;
+}
+
 /*!
  * It gets the m_system member
  * @return a reference to the SystemSolver unique pointer
@@ -107,3 +116,22 @@ std::unique_ptr<SystemSolver> & Solver::getSystem()
 {
     return m_system;
 }
+
+/*!
+ * It gets the m_nativeSolver member
+ * @return a reference to the NativeKrylovSolver unique pointer
+ */
+std::unique_ptr<NativeKrylovSolver> & Solver::getNativeSolver()
+{
+    return m_nativeSolver;
+}
+
+/*!
+ * It destroys the m_matrix member.
+ * Once the system has been assembled, PETSc holds its own copy of the matrix,
+ * so the SparseMatrix filled by the readers can be released to halve the matrix memory.
+ */
+void Solver::releaseMatrix()
+{
+    m_matrix.reset();
+}
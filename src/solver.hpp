@@ -28,8 +28,9 @@
 #include <bitpit_LA.hpp>
 
 #include "matrixReader.hpp"
-#include "rhsReader.hpp"
-#include "initialSolutionReader.hpp"
+#include "nativeKrylovSolver.hpp"
+#include "vectorReader.hpp"
+#include "vectorWriter.hpp"
 
 using namespace bitpit;
 
@@ -41,6 +42,8 @@ using namespace bitpit;
  *  This class is intended to
  *  read from the disk the components of a linear system (matrix, right-hand side and initial solution guess),
  *  declare the linear system object (which containing the matrix, the right-hand side and the solution) from bitpit library
+ *  and write to the disk the solution of every right-hand side.
+ *  With the native backend, the system is held and solved by a NativeKrylovSolver in place of the bitpit one.
  */
 
 class Solver {
@@ -52,9 +55,13 @@ public:
 
     std::unique_ptr<MatrixReader> & getMatrixReader();
     std::unique_ptr<SparseMatrix> & getMatrix();
-    std::unique_ptr<RhsReader> & getRhsReader();
-    std::unique_ptr<InitialSolutionReader> & getInitialSolutionReader();
+    std::unique_ptr<VectorReader> & getRhsReader();
+    std::unique_ptr<VectorReader> & getInitialSolutionReader();
+    std::unique_ptr<VectorWriter> & getSolutionWriter();
     std::unique_ptr<SystemSolver> & getSystem();
+    std::unique_ptr<NativeKrylovSolver> & getNativeSolver();
+
+    void releaseMatrix();
 
 private:
 
@@ -63,9 +70,11 @@ private:
 
     std::unique_ptr<MatrixReader> m_matrixReader;                   /**<unique pointer to MatrixReader. It reads the matrix from disk*/
     std::unique_ptr<SparseMatrix> m_matrix;                         /**<unique pointer to SparseMatrix. It is the bitpit implementation for sparse matrices*/
-    std::unique_ptr<RhsReader> m_rhsReader;                         /**<unique pointer to RhsReader. It reads the right-hand side from disk*/
-    std::unique_ptr<InitialSolutionReader> m_initialSolutionReader; /**<unique pointer to InitialSolutionReader. It reads the initial solution guess from disk*/
+    std::unique_ptr<VectorReader> m_rhsReader;                      /**<unique pointer to VectorReader. It reads the right-hand side from disk*/
+    std::unique_ptr<VectorReader> m_initialSolutionReader;          /**<unique pointer to VectorReader. It reads the initial solution guess from disk*/
+    std::unique_ptr<VectorWriter> m_solutionWriter;                 /**<unique pointer to VectorWriter. It writes the solutions to disk*/
     std::unique_ptr<SystemSolver> m_system;                         /**<unique pointer to SystemSolver. It is the bitpit wrapper to PETSc methods for setting and solving linear systems*/
+    std::unique_ptr<NativeKrylovSolver> m_nativeSolver;             /**<unique pointer to NativeKrylovSolver. It solves the system without PETSc, null with the PETSc backend*/
 
 };
 
@@ -0,0 +1,88 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#include <sstream>
+
+#include "solverOptions.hpp"
+
+/*!
+ * \return true if no setting differs from the defaults
+ */
+bool SolverOptions::isEmpty() const
+{
+    return getPetscOptions().empty();
+}
+
+/*!
+ * \return true if the preconditioner is split in sub-domains, i.e. it is ASM, the default, or block Jacobi
+ */
+bool SolverOptions::hasSubDomains() const
+{
+    return pcType.empty() || pcType == "asm" || pcType == "bjacobi";
+}
+
+/*!
+ * It translates the settings into PETSc options database entries, the free-form options being appended last.
+ * The fill levels apply to the sub-domains of ASM and block Jacobi, to the preconditioner itself otherwise;
+ * the overlap applies to ASM only.
+ * \return the options as on the PETSc command line, empty if no setting differs from the defaults
+ */
+std::string SolverOptions::getPetscOptions() const
+{
+    std::ostringstream options;
+    options.precision(12);
+    if(!kspType.empty()) {
+        options << " -ksp_type " << kspType;
+    }
+    if(restart > 0) {
+        options << " -ksp_gmres_restart " << restart;
+    }
+    if(rtol > 0.) {
+        options << " -ksp_rtol " << rtol;
+    }
+    if(atol > 0.) {
+        options << " -ksp_atol " << atol;
+    }
+    if(maxIterations > 0) {
+        options << " -ksp_max_it " << maxIterations;
+    }
+    if(!pcType.empty()) {
+        options << " -pc_type " << pcType;
+    }
+    if(!subPCType.empty()) {
+        options << " -sub_pc_type " << subPCType;
+    }
+    if(levels >= 0) {
+        options << (hasSubDomains() ? " -sub_pc_factor_levels " : " -pc_factor_levels ") << levels;
+    }
+    if(overlap >= 0 && (pcType.empty() || pcType == "asm")) {
+        options << " -pc_asm_overlap " << overlap;
+    }
+    if(!petscOptions.empty()) {
+        options << " " << petscOptions;
+    }
+
+    std::string result = options.str();
+    std::size_t first = result.find_first_not_of(' ');
+
+    return (first == std::string::npos) ? std::string() : result.substr(first);
+}
@@ -0,0 +1,56 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_SOLVEROPTIONS_HPP__
+#define __MADLINSOLV_SOLVEROPTIONS_HPP__
+
+#include <string>
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The solver options structure
+ *
+ *  This structure collects the Krylov method and preconditioner settings of the <Solver> dictionary section.
+ *  Empty strings and non-positive numbers leave the setting to its default. The settings are translated into
+ *  PETSc options database entries, followed by the free-form PETSc options, so that the latter override the former.
+ */
+struct SolverOptions {
+
+    std::string kspType;                                /**<PETSc KSP type, empty for the bitpit default (FGMRES)*/
+    std::string pcType;                                 /**<PETSc PC type, empty for the bitpit default (ASM)*/
+    std::string subPCType;                              /**<PETSc PC type of the ASM and block Jacobi sub-domains, empty for the default (ILU)*/
+    int levels = -1;                                    /**<fill levels of the incomplete factorization, negative for the default*/
+    int overlap = -1;                                   /**<overlap of the ASM sub-domains, negative for the default*/
+    int restart = -1;                                   /**<restart length of the GMRES methods, non-positive for the default*/
+    double rtol = -1.;                                  /**<relative tolerance, non-positive for the default*/
+    double atol = -1.;                                  /**<absolute tolerance, non-positive for the default*/
+    int maxIterations = -1;                             /**<maximum number of iterations, non-positive for the default*/
+    std::string petscOptions;                           /**<free-form PETSc options, as on the command line*/
+
+    bool isEmpty() const;
+    bool hasSubDomains() const;
+    std::string getPetscOptions() const;
+
+};
+
+#endif
@@ -0,0 +1,427 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <limits>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#if ENABLE_MPI==1
+#    include <mpi.h>
+#endif
+
+#include <bitpit_IO.hpp>
+
+#include "sequenceSystemSolver.hpp"
+#include "solverServer.hpp"
+
+using namespace bitpit;
+
+/*!
+ * Constructor. It sets the row and non-zero distribution used to scatter and gather the vectors.
+ * The matrix must have been assembled and its pattern cached (see MatrixReader::setPatternCaching)
+ * for the values updates to be accepted. This method is collective.
+ * \param[in] nProcessors the number of MPI ranks
+ * \param[in] rank        the MPI rank of the process owing the object
+ * \param[in] solver      solver holding the assembled system and the matrix reader
+ * \param[in] socketPath  path of the UNIX-domain socket
+ */
+SolverServer::SolverServer(int nProcessors, int rank, Solver & solver, const std::string & socketPath)
+    : m_nProcessors(nProcessors), m_rank(rank), m_solver(solver), m_socketPath(socketPath), m_listener(-1), m_client(-1)
+{
+    std::unique_ptr<MatrixReader> & matrixReader = m_solver.getMatrixReader();
+    m_nRows = matrixReader->getNRows();
+    m_nNz = matrixReader->getNNz();
+
+    m_rowCounts = matrixReader->getPartition().getRowCounts();
+    m_rowDispls.assign(m_nProcessors, 0);
+    for(int i = 1; i < m_nProcessors; ++i) {
+        m_rowDispls[i] = m_rowDispls[i - 1] + m_rowCounts[i - 1];
+    }
+
+    long localNnz = matrixReader->getCachedNonZeroCount();
+    std::vector<long> nnzCounts(m_nProcessors, localNnz);
+#if ENABLE_MPI == 1
+    MPI_Allgather(&localNnz, 1, MPI_LONG, nnzCounts.data(), 1, MPI_LONG, MPI_COMM_WORLD);
+#endif
+    m_nnzCounts = nnzCounts;
+    m_nnzDispls.assign(m_nProcessors, 0);
+    for(int i = 1; i < m_nProcessors; ++i) {
+        m_nnzDispls[i] = m_nnzDispls[i - 1] + m_nnzCounts[i - 1];
+    }
+    m_hasPattern = (m_nnzDispls.back() + m_nnzCounts.back() == m_nNz);
+}
+
+/*!
+ * Destructor. It closes the sockets and removes the socket file.
+ */
+SolverServer::~SolverServer()
+{
+    closeClient();
+    if(m_listener >= 0) {
+        close(m_listener);
+        unlink(m_socketPath.c_str());
+    }
+}
+
+/*!
+ * It serves the requests until a SHUTDOWN request is received.
+ * The first process listens on the socket, the others wait for the requests it broadcasts.
+ * If the socket cannot be opened, the application is stopped. This method is collective.
+ */
+void SolverServer::run()
+{
+    int isListening = 0;
+    if(m_rank == 0) {
+        isListening = openSocket() ? 1 : 0;
+    }
+#if ENABLE_MPI == 1
+    MPI_Bcast(&isListening, 1, MPI_INT, 0, MPI_COMM_WORLD);
+#endif
+    if(!isListening) {
+        log::cout() << "Socket " << m_socketPath << " not open!" << std::endl;
+#if ENABLE_MPI == 1
+        MPI_Finalize();
+#endif
+        exit(1);
+    }
+    log::cout() << "Listening on " << m_socketPath << ", " << m_nRows << " rows, " << m_nNz << " non-zeros" << std::endl;
+    if(!m_hasPattern) {
+        log::cout() << "Matrix pattern not cached, values updates will be rejected" << std::endl;
+    }
+
+    long nRequests = 0;
+    double busyTime = 0.;
+    uint32_t command = static_cast<uint32_t>(ServerProtocol::Command::INFO);
+    while(command != static_cast<uint32_t>(ServerProtocol::Command::SHUTDOWN)) {
+        if(m_rank == 0) {
+            command = static_cast<uint32_t>(waitRequest());
+        }
+#if ENABLE_MPI == 1
+        MPI_Bcast(&command, 1, MPI_UINT32_T, 0, MPI_COMM_WORLD);
+#endif
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        ServerProtocol::Status status = execute(static_cast<ServerProtocol::Command>(command));
+        if(m_rank == 0) {
+            reply(status);
+        }
+        double requestTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        busyTime += requestTime;
+        ++nRequests;
+        log::cout() << "Request " << ServerProtocol::getCommandName(command) << ": status = " << static_cast<int32_t>(status)
+                << ", time = " << requestTime << " s" << std::endl;
+    }
+
+    log::cout() << "" << std::endl;
+    log::cout() << "Number of requests served = " << nRequests << ", total request time = " << busyTime << " s" << std::endl;
+}
+
+/*!
+ * It creates the listening socket, replacing a stale socket file left by a previous run.
+ * \return true if the socket is listening
+ */
+bool SolverServer::openSocket()
+{
+    sockaddr_un address;
+    if(m_socketPath.empty() || m_socketPath.size() >= sizeof(address.sun_path)) {
+        log::cout() << "Socket path must be non-empty and shorter than " << sizeof(address.sun_path) << " characters" << std::endl;
+        return false;
+    }
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, m_socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    m_listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(m_listener < 0) {
+        log::cout() << "Socket creation failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    unlink(m_socketPath.c_str());
+    if(bind(m_listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 || listen(m_listener, 16) < 0) {
+        log::cout() << "Socket bind failed: " << std::strerror(errno) << std::endl;
+        close(m_listener);
+        m_listener = -1;
+        return false;
+    }
+
+    return true;
+}
+
+/*!
+ * It closes the connection with the current client, if any.
+ */
+void SolverServer::closeClient()
+{
+    if(m_client >= 0) {
+        close(m_client);
+        m_client = -1;
+    }
+}
+
+/*!
+ * It sends the reply to the current request, with the reply payload, to the client.
+ * A client not receiving it is disconnected.
+ * \param[in] status the outcome of the request
+ */
+void SolverServer::reply(ServerProtocol::Status status)
+{
+    if(m_client < 0) {
+        return;
+    }
+
+    ServerProtocol::ReplyHeader header;
+    header.magic = ServerProtocol::MAGIC;
+    header.status = static_cast<int32_t>(status);
+    header.payloadSize = (status == ServerProtocol::Status::OK) ? m_reply.size() : 0;
+    if(!ServerProtocol::sendAll(m_client, &header, sizeof(header))
+            || !ServerProtocol::sendAll(m_client, m_reply.data(), header.payloadSize)) {
+        log::cout() << "Client disconnected before the reply" << std::endl;
+        closeClient();
+    }
+}
+
+/*!
+ * It waits for the next valid request, accepting a new client when none is connected.
+ * Its payload is stored for the execution. A request with an invalid header is rejected and its client disconnected,
+ * since the following bytes of the stream cannot be trusted.
+ * \return the command of the request
+ */
+ServerProtocol::Command SolverServer::waitRequest()
+{
+    while(true) {
+        if(m_client < 0) {
+            m_client = accept(m_listener, nullptr, nullptr);
+            if(m_client < 0) {
+                if(errno != EINTR) {
+                    log::cout() << "Socket accept failed: " << std::strerror(errno) << std::endl;
+                }
+                continue;
+            }
+            log::cout() << "Client connected" << std::endl;
+        }
+
+        ServerProtocol::RequestHeader header;
+        if(!ServerProtocol::receiveAll(m_client, &header, sizeof(header))) {
+            log::cout() << "Client disconnected" << std::endl;
+            closeClient();
+            continue;
+        }
+
+        uint64_t expectedSize;
+        if(header.magic != ServerProtocol::MAGIC || !getPayloadSize(header.command, expectedSize)
+                || header.payloadSize != expectedSize) {
+            bool isKnown = (header.magic == ServerProtocol::MAGIC && getPayloadSize(header.command, expectedSize));
+            log::cout() << "Invalid request rejected, " << (isKnown ? "payload of " + std::to_string(header.payloadSize)
+                    + " bytes for " + ServerProtocol::getCommandName(header.command) : std::string("unknown header")) << std::endl;
+            reply(isKnown ? ServerProtocol::Status::BAD_REQUEST : ServerProtocol::Status::UNKNOWN_COMMAND);
+            closeClient();
+            continue;
+        }
+
+        m_payload.resize(expectedSize / sizeof(double));
+        if(!ServerProtocol::receiveAll(m_client, m_payload.data(), expectedSize)) {
+            log::cout() << "Client disconnected" << std::endl;
+            closeClient();
+            continue;
+        }
+
+        return static_cast<ServerProtocol::Command>(header.command);
+    }
+}
+
+/*!
+ * It gets the payload size a request must have.
+ * \param[in] command the command of the request
+ * \param[out] size the payload size in bytes
+ * \return false if the command is unknown
+ */
+bool SolverServer::getPayloadSize(uint32_t command, uint64_t & size) const
+{
+    switch(static_cast<ServerProtocol::Command>(command)) {
+    case ServerProtocol::Command::NEW_RHS:
+        size = m_nRows * sizeof(double);
+        return true;
+    case ServerProtocol::Command::UPDATE_VALUES:
+        size = m_nNz * sizeof(double);
+        return true;
+    case ServerProtocol::Command::INFO:
+    case ServerProtocol::Command::SOLVE:
+    case ServerProtocol::Command::FETCH_SOLUTION:
+    case ServerProtocol::Command::SHUTDOWN:
+        size = 0;
+        return true;
+    }
+
+    return false;
+}
+
+/*!
+ * It executes a request on the resident system. The reply payload is set on the first process.
+ * This method is collective.
+ * \param[in] command the command of the request
+ * \return the outcome of the request
+ */
+ServerProtocol::Status SolverServer::execute(ServerProtocol::Command command)
+{
+    std::unique_ptr<SystemSolver> & system = m_solver.getSystem();
+    m_reply.clear();
+
+    switch(command) {
+    case ServerProtocol::Command::INFO:
+    {
+        ServerProtocol::InfoReply info;
+        info.nRows = m_nRows;
+        info.nNz = m_nNz;
+        m_reply.resize(sizeof(info));
+        std::memcpy(m_reply.data(), &info, sizeof(info));
+        return ServerProtocol::Status::OK;
+    }
+
+    case ServerProtocol::Command::NEW_RHS:
+    {
+        double *rhs = system->getRHSRawPtr();
+        scatter(m_rowCounts, m_rowDispls, rhs);
+        system->restoreRHSRawPtr(rhs);
+        return ServerProtocol::Status::OK;
+    }
+
+    case ServerProtocol::Command::UPDATE_VALUES:
+    {
+        if(!m_hasPattern) {
+            return ServerProtocol::Status::FAILED;
+        }
+        std::vector<double> values(m_nnzCounts[m_rank]);
+        scatterValues(values.data());
+        m_solver.getMatrixReader()->commitValues(values.data(), m_solver.getMatrix());
+        system->update(*(m_solver.getMatrix()));
+        m_solver.releaseMatrix();
+        return ServerProtocol::Status::OK;
+    }
+
+    case ServerProtocol::Command::SOLVE:
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        system->solve();
+        ServerProtocol::SolveReply result;
+        result.time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.iterations = system->getKSPStatus().its;
+        result.residual = static_cast<SequenceSystemSolver &>(*system).getResidualNorm();
+        log::cout() << "Solve time = " << result.time << " s, iterations = " << result.iterations
+                << ", residual = " << result.residual << std::endl;
+        m_reply.resize(sizeof(result));
+        std::memcpy(m_reply.data(), &result, sizeof(result));
+        return ServerProtocol::Status::OK;
+    }
+
+    case ServerProtocol::Command::FETCH_SOLUTION:
+    {
+        const double *solution = system->getSolutionRawReadPtr();
+        gather(m_rowCounts, m_rowDispls, solution);
+        system->restoreSolutionRawReadPtr(solution);
+        return ServerProtocol::Status::OK;
+    }
+
+    case ServerProtocol::Command::SHUTDOWN:
+        return ServerProtocol::Status::OK;
+    }
+
+    return ServerProtocol::Status::UNKNOWN_COMMAND;
+}
+
+/*!
+ * It scatters the request payload of the first process to all the processes. This method is collective.
+ * \param[in] counts number of elements of each process
+ * \param[in] displs first element of each process in the payload
+ * \param[out] local buffer of counts[rank] elements receiving the process elements
+ */
+void SolverServer::scatter(const std::vector<int> & counts, const std::vector<int> & displs, double * local)
+{
+#if ENABLE_MPI == 1
+    MPI_Scatterv(m_payload.data(), counts.data(), displs.data(), MPI_DOUBLE, local, counts[m_rank], MPI_DOUBLE,
+            0, MPI_COMM_WORLD);
+#else
+    std::copy(m_payload.begin() + displs[0], m_payload.begin() + displs[0] + counts[0], local);
+#endif
+}
+
+/*!
+ * It scatters the matrix values of the request payload of the first process to all the processes, with the non-zeros
+ * of the cached pattern. The global number of non-zeros may exceed the int displacements of MPI_Scatterv: the values
+ * are then sent to each process in messages of at most INT_MAX values. This method is collective.
+ * \param[out] local the m_nnzCounts[rank] values of the process
+ */
+void SolverServer::scatterValues(double * local)
+{
+    const long maxMessage = std::numeric_limits<int>::max();
+    if(m_nNz <= maxMessage) {
+        std::vector<int> counts(m_nnzCounts.begin(), m_nnzCounts.end());
+        std::vector<int> displs(m_nnzDispls.begin(), m_nnzDispls.end());
+        scatter(counts, displs, local);
+        return;
+    }
+
+#if ENABLE_MPI == 1
+    if(m_rank == 0) {
+        std::copy(m_payload.begin(), m_payload.begin() + m_nnzCounts[0], local);
+        for(int i = 1; i < m_nProcessors; ++i) {
+            for(long sent = 0; sent < m_nnzCounts[i]; sent += maxMessage) {
+                int count = static_cast<int>(std::min(maxMessage, m_nnzCounts[i] - sent));
+                MPI_Send(m_payload.data() + m_nnzDispls[i] + sent, count, MPI_DOUBLE, i, 0, MPI_COMM_WORLD);
+            }
+        }
+    }
+    else {
+        for(long received = 0; received < m_nnzCounts[m_rank]; received += maxMessage) {
+            int count = static_cast<int>(std::min(maxMessage, m_nnzCounts[m_rank] - received));
+            MPI_Recv(local + received, count, MPI_DOUBLE, 0, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+        }
+    }
+#else
+    std::copy(m_payload.begin(), m_payload.begin() + m_nnzCounts[0], local);
+#endif
+}
+
+/*!
+ * It gathers the elements of all the processes into the reply payload of the first process. This method is collective.
+ * \param[in] counts number of elements of each process
+ * \param[in] displs first element of each process in the reply
+ * \param[in] local the counts[rank] elements of the process
+ */
+void SolverServer::gather(const std::vector<int> & counts, const std::vector<int> & displs, const double * local)
+{
+    long nElements = displs.back() + counts.back();
+    if(m_rank == 0) {
+        m_reply.resize(nElements * sizeof(double));
+    }
+#if ENABLE_MPI == 1
+    MPI_Gatherv(local, counts[m_rank], MPI_DOUBLE, m_reply.data(), counts.data(), displs.data(), MPI_DOUBLE,
+            0, MPI_COMM_WORLD);
+#else
+    std::memcpy(m_reply.data(), local, nElements * sizeof(double));
+#endif
+}
@@ -0,0 +1,98 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_SOLVERSERVER_HPP__
+#define __MADLINSOLV_SOLVERSERVER_HPP__
+
+#include <string>
+#include <vector>
+
+#include "serverProtocol.hpp"
+#include "solver.hpp"
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The solver server class
+ *
+ *  This class is intended to
+ *  keep an assembled linear system resident and serve requests on it through a local UNIX-domain socket,
+ *  so that a client solving many systems with the same matrix pattern pays the setup (matrix read, assembly
+ *  and first preconditioner build) only once (see ServerProtocol class for the messages).
+ *  The first process listens on the socket and serves one connection at a time; every request it receives is
+ *  broadcast to all the processes, which execute it collectively:
+ *   - a new right-hand side is scattered with the row partition of the matrix;
+ *   - new matrix values are scattered with the non-zeros of the cached pattern of the matrix and copied into the
+ *     assembled PETSc matrix, whose preconditioner is then rebuilt by the next solve
+ *     (see MatrixReader::commitValues and SystemSolver::update);
+ *   - a solve starts from the solution of the previous one, i.e. the initial solution for the first solve;
+ *   - the solution is gathered on the first process and sent back.
+ *  A request with an invalid header or payload size is rejected and its connection closed.
+ *  Every request is logged with its execution time.
+ */
+class SolverServer {
+
+public:
+
+    SolverServer(int nProcessors, int rank, Solver & solver, const std::string & socketPath);
+    ~SolverServer();
+
+    SolverServer(SolverServer const&) = delete;
+    SolverServer & operator=(SolverServer const&) = delete;
+
+    void run();
+
+private:
+
+    bool openSocket();
+    void closeClient();
+    void reply(ServerProtocol::Status status);
+    ServerProtocol::Command waitRequest();
+    bool getPayloadSize(uint32_t command, uint64_t & size) const;
+
+    ServerProtocol::Status execute(ServerProtocol::Command command);
+    void scatter(const std::vector<int> & counts, const std::vector<int> & displs, double * local);
+    void scatterValues(double * local);
+    void gather(const std::vector<int> & counts, const std::vector<int> & displs, const double * local);
+
+    int m_nProcessors;                                  /**<number of MPI processes*/
+    int m_rank;                                         /**<MPI rank of the process*/
+    Solver & m_solver;                                  /**<solver holding the assembled system and the matrix reader*/
+    std::string m_socketPath;                           /**<path of the UNIX-domain socket*/
+
+    int m_listener;                                     /**<listening socket descriptor, first process only, -1 if closed*/
+    int m_client;                                       /**<connected client socket descriptor, first process only, -1 if none*/
+
+    long m_nRows;                                       /**<global number of rows*/
+    long m_nNz;                                         /**<global number of non-zeros*/
+    bool m_hasPattern;                                  /**<true if the pattern of the matrix is cached, so that its values can be updated*/
+    std::vector<int> m_rowCounts;                       /**<number of rows of each process*/
+    std::vector<int> m_rowDispls;                       /**<first global row of each process*/
+    std::vector<long> m_nnzCounts;                      /**<number of non-zeros of each process*/
+    std::vector<long> m_nnzDispls;                      /**<first global non-zero of each process*/
+
+    std::vector<double> m_payload;                      /**<payload of the current request, first process only*/
+    std::vector<char> m_reply;                          /**<payload of the current reply, first process only*/
+
+};
+
+#endif
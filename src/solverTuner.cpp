@@ -0,0 +1,205 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#if ENABLE_MPI==1
+#    include <mpi.h>
+#endif
+
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+#include <bitpit_IO.hpp>
+
+#include "solverTuner.hpp"
+
+using namespace bitpit;
+
+/*!
+ * Constructor
+ * \param[in] nProcessors number of MPI processes
+ * \param[in] rank process MPI rank
+ * \param[in] cachePath path of the decisions file, empty for no cache
+ */
+SolverTuner::SolverTuner(int nProcessors, int rank, const std::string & cachePath) :
+        m_nProcessors(nProcessors), m_rank(rank), m_cachePath(cachePath), m_fingerprint()
+{
+
+}
+
+/*!
+ * It splits a blank separated list of candidates
+ * \param[in] candidates the list, as in the dictionary
+ * \return the candidates, in the list order
+ */
+std::vector<std::string> SolverTuner::parseCandidates(const std::string & candidates)
+{
+    std::vector<std::string> parsed;
+    std::istringstream ss(candidates);
+    std::string candidate;
+    while(ss >> candidate) {
+        parsed.push_back(candidate);
+    }
+
+    return parsed;
+}
+
+/*!
+ * It gets the fingerprint of the matrix, to be computed while the matrix is read (see MatrixReader::setRowsInspector)
+ * \return a reference to the fingerprint
+ */
+MatrixFingerprint & SolverTuner::getFingerprint()
+{
+    return m_fingerprint;
+}
+
+/*!
+ * It gets the settings of a candidate: the Krylov method, the preconditioner and the sub-domain preconditioner
+ * are those of the candidate, the rest is kept from the given settings.
+ * \param[in] candidate the candidate, as ksp/pc[/subpc]
+ * \param[in] options the settings of the configured solver
+ * \return the settings of the candidate
+ */
+SolverOptions SolverTuner::getCandidateOptions(const std::string & candidate, const SolverOptions & options) const
+{
+    SolverOptions candidateOptions = options;
+    std::istringstream ss(candidate);
+    std::getline(ss, candidateOptions.kspType, '/');
+    candidateOptions.pcType.clear();
+    std::getline(ss, candidateOptions.pcType, '/');
+    candidateOptions.subPCType.clear();
+    std::getline(ss, candidateOptions.subPCType, '/');
+
+    if(m_nProcessors > 1 && (candidateOptions.pcType == "ilu" || candidateOptions.pcType == "icc")) {
+        candidateOptions.subPCType = candidateOptions.pcType;
+        candidateOptions.pcType = "bjacobi";
+    }
+
+    return candidateOptions;
+}
+
+/*!
+ * It looks the decision for the fingerprint of the matrix up in the decisions file. This method is collective.
+ * \param[out] candidate the candidate chosen for the matrix by a previous run, if any
+ * \return true if a decision has been found
+ */
+bool SolverTuner::lookup(std::string & candidate) const
+{
+    candidate.clear();
+    if(m_rank == 0 && !m_cachePath.empty()) {
+        std::ifstream decisions(m_cachePath.c_str());
+        std::string line;
+        while(std::getline(decisions, line)) {
+            std::istringstream ss(line);
+            std::string key, decision;
+            if((ss >> key >> decision) && key == m_fingerprint.getKey()) {
+                candidate = decision;
+            }
+        }
+    }
+#if ENABLE_MPI==1
+    long size = static_cast<long>(candidate.size());
+    MPI_Bcast(&size, 1, MPI_LONG, 0, MPI_COMM_WORLD);
+    candidate.resize(size);
+    if(size > 0) {
+        MPI_Bcast(&candidate[0], static_cast<int>(size), MPI_CHAR, 0, MPI_COMM_WORLD);
+    }
+#endif
+
+    if(candidate.empty()) {
+        log::cout() << "No tuned solver cached for matrix " << m_fingerprint.getKey() << std::endl;
+        return false;
+    }
+    log::cout() << "Tuned solver cached for matrix " << m_fingerprint.getKey() << ": " << candidate << std::endl;
+
+    return true;
+}
+
+/*!
+ * It runs one trial per candidate, then it sets the fastest converged candidate on the system solver.
+ * If no candidate converges, the settings of the system solver are restored.
+ * Trial times are the slowest among the processes, so that all of them make the same choice.
+ * This method is collective.
+ * \param[in] system the system solver, with the matrix assembled and the settings of the configured solver
+ * \param[in] candidates the candidates, as ksp/pc[/subpc]
+ * \param[in] maxIterations the iteration cap of every trial
+ * \param[in] solve function solving the system from the same right-hand side and initial guess at every call
+ * \return the winning candidate, empty if no candidate converged
+ */
+std::string SolverTuner::tune(ConfiguredSystemSolver & system, const std::vector<std::string> & candidates, int maxIterations,
+        const std::function<void()> & solve)
+{
+    SolverOptions options = system.getOptions();
+    std::string winner;
+    double winnerTime = std::numeric_limits<double>::max();
+    for(const std::string & candidate : candidates) {
+        log::cout() << "Trial of " << candidate << "..." << std::endl;
+        SolverOptions trialOptions = getCandidateOptions(candidate, options);
+        trialOptions.maxIterations = maxIterations;
+        system.setOptions(trialOptions);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        solve();
+        double trialTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+#if ENABLE_MPI==1
+        MPI_Allreduce(MPI_IN_PLACE, &trialTime, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+#endif
+
+        bool isConverged = (system.getKSPStatus().convergence > 0);
+        log::cout() << "Trial of " << candidate << ": time = " << trialTime << " s, iterations = " << system.getKSPStatus().its
+                << (isConverged ? ", converged" : ", not converged") << std::endl;
+        if(isConverged && trialTime < winnerTime) {
+            winner = candidate;
+            winnerTime = trialTime;
+        }
+    }
+
+    if(winner.empty()) {
+        log::cout() << "No candidate converged within " << maxIterations << " iterations, the configured solver is kept" << std::endl;
+        system.setOptions(options);
+    } else {
+        log::cout() << "Tuned solver: " << winner << " (" << winnerTime << " s)" << std::endl;
+        system.setOptions(getCandidateOptions(winner, options));
+    }
+
+    return winner;
+}
+
+/*!
+ * It appends the decision for the fingerprint of the matrix to the decisions file, on the first process only
+ * \param[in] candidate the candidate chosen for the matrix
+ */
+void SolverTuner::store(const std::string & candidate) const
+{
+    if(m_rank != 0 || m_cachePath.empty()) {
+        return;
+    }
+
+    std::ofstream decisions(m_cachePath.c_str(), std::ios::app);
+    decisions << m_fingerprint.getKey() << " " << candidate << std::endl;
+    if(decisions) {
+        log::cout() << "Tuned solver cached in " << m_cachePath << std::endl;
+    } else {
+        log::cout() << "Tuned solver could not be cached in " << m_cachePath << std::endl;
+    }
+}
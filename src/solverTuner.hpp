@@ -0,0 +1,77 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_SOLVERTUNER_HPP__
+#define __MADLINSOLV_SOLVERTUNER_HPP__
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "configuredSystemSolver.hpp"
+#include "matrixFingerprint.hpp"
+#include "solverOptions.hpp"
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The solver tuner class
+ *
+ *  This class is intended to
+ *  choose the Krylov method and the preconditioner of a matrix by running short trials of a set of candidates
+ *  on the assembled system and committing to the fastest one, i.e. the one with the shortest time to tolerance,
+ *  preconditioner setup included. Every trial is capped to a maximum number of iterations and a candidate
+ *  not converging within it is discarded.
+ *  A candidate is written as ksp/pc[/subpc], with PETSc type names, e.g. cg/jacobi, gmres/ilu, bcgs/bjacobi or gmres/gamg;
+ *  the other settings (tolerances, restart, fill levels, free-form options) are those of the configured solver.
+ *  With several processes, the sequential ILU and ICC preconditioners are tried as block Jacobi sub-domain preconditioners.
+ *  Decisions are kept in a text file, one line per matrix with the key of its fingerprint (see MatrixFingerprint class)
+ *  and the winning candidate, so that a later run on a matrix alike skips the trials. The last line of a key wins
+ *  and the file can be edited or removed at any time.
+ *  Only the first process reads and writes the decisions file.
+ */
+class SolverTuner {
+
+public:
+
+    SolverTuner(int nProcessors, int rank, const std::string & cachePath);
+
+    static std::vector<std::string> parseCandidates(const std::string & candidates);
+
+    MatrixFingerprint & getFingerprint();
+    SolverOptions getCandidateOptions(const std::string & candidate, const SolverOptions & options) const;
+
+    bool lookup(std::string & candidate) const;
+    std::string tune(ConfiguredSystemSolver & system, const std::vector<std::string> & candidates, int maxIterations,
+            const std::function<void()> & solve);
+    void store(const std::string & candidate) const;
+
+private:
+
+    int m_nProcessors;                                  /**<number of MPI processes*/
+    int m_rank;                                         /**<MPI rank of the process*/
+    std::string m_cachePath;                            /**<path of the decisions file, empty for no cache*/
+    MatrixFingerprint m_fingerprint;                    /**<fingerprint of the tuned matrix*/
+
+};
+
+#endif
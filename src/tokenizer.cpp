@@ -0,0 +1,478 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#if defined(__SSE2__)
+#    include <emmintrin.h>
+#endif
+
+#include "tokenizer.hpp"
+
+namespace {
+
+//Powers of ten exactly representable as doubles
+const double EXACT_POWERS_OF_TEN[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+const int MAX_EXACT_EXPONENT = 22;
+const uint64_t MAX_EXACT_MANTISSA = uint64_t(1) << 53;
+const int MAX_MANTISSA_DIGITS = 19;
+
+inline bool isBlank(char c)
+{
+    return (c == ' ' || c == '\t' || c == '\r');
+}
+
+inline bool isDigit(char c)
+{
+    return (static_cast<unsigned char>(c - '0') < 10);
+}
+
+/*!
+ * It converts the token with strtod, which needs a null-terminated string
+ * \param[in] begin first character of the token
+ * \param[in] end character after the last one of the token
+ * \param[out] value the converted value
+ * \return pointer to the character after the converted ones, nullptr if nothing has been converted
+ */
+const char * parseDoubleFallback(const char * begin, const char * end, double * value)
+{
+    char local[64];
+    std::string heap;
+    std::size_t length = static_cast<std::size_t>(end - begin);
+    const char *token;
+    if(length < sizeof(local)) {
+        std::memcpy(local, begin, length);
+        local[length] = '\0';
+        token = local;
+    } else {
+        heap.assign(begin, length);
+        token = heap.c_str();
+    }
+
+    char *tokenEnd;
+    *value = std::strtod(token, &tokenEnd);
+    if(tokenEnd == token) {
+        return nullptr;
+    }
+
+    return begin + (tokenEnd - token);
+}
+
+/*!
+ * It parses all the tokens of a line with the given conversion
+ * \param[in] begin first character of the line
+ * \param[in] end character after the last one of the line
+ * \param[in] parse conversion function
+ * \param[out] values the converted values are appended to this vector
+ * \return the number of converted tokens
+ */
+template<typename T>
+std::size_t parseTokens(const char * begin, const char * end, const char * (*parse)(const char *, const char *, T *), std::vector<T> & values)
+{
+    std::size_t nTokens = 0;
+    const char *cursor = begin;
+    while(true) {
+        cursor = Tokenizer::skipBlanks(cursor, end);
+        if(cursor == end) {
+            break;
+        }
+
+        T value;
+        const char *next = parse(cursor, end, &value);
+        if(next == nullptr) {
+            break;
+        }
+        values.push_back(value);
+        ++nTokens;
+        cursor = next;
+    }
+
+    return nTokens;
+}
+
+}
+
+const std::size_t Tokenizer::DEFAULT_BLOCK_SIZE = 1 << 20;
+
+/*!
+ * Constructor
+ * Nothing is read until the first line is requested.
+ * \param[in] stream stream the tokens are read from, starting at its current position
+ * \param[in] blockSize size of the blocks read from the stream
+ */
+Tokenizer::Tokenizer(std::istream & stream, std::size_t blockSize) :
+        m_stream(stream), m_buffer(blockSize > 0 ? blockSize : DEFAULT_BLOCK_SIZE), m_cursor(0), m_size(0), m_eof(false), m_consumed(0)
+{
+
+}
+
+/*!
+ * It gets the next line, without the newline character.
+ * The returned pointers are valid until the next call.
+ * \param[out] begin first character of the line
+ * \param[out] end character after the last one of the line
+ * \return false if the stream has no more lines
+ */
+bool Tokenizer::nextLine(const char ** begin, const char ** end)
+{
+    while(true) {
+        const char *data = m_buffer.data();
+        const char *lineEnd = findNewline(data + m_cursor, data + m_size);
+        if(lineEnd != data + m_size) {
+            *begin = data + m_cursor;
+            *end = lineEnd;
+            m_consumed += static_cast<uint64_t>(lineEnd - *begin) + 1;
+            m_cursor = static_cast<std::size_t>(lineEnd - data) + 1;
+            return true;
+        }
+
+        if(m_eof || !refill()) {
+            //The last line may have no newline
+            if(m_cursor < m_size) {
+                *begin = m_buffer.data() + m_cursor;
+                *end = m_buffer.data() + m_size;
+                m_consumed += m_size - m_cursor;
+                m_cursor = m_size;
+                return true;
+            }
+            return false;
+        }
+    }
+}
+
+/*!
+ * It reads the next line and converts all its tokens to integers
+ * \param[out] values the converted values are appended to this vector
+ * \return false if the stream has no more lines
+ */
+bool Tokenizer::readLine(std::vector<long> & values)
+{
+    const char *begin, *end;
+    if(!nextLine(&begin, &end)) {
+        return false;
+    }
+    parseLine(begin, end, values);
+
+    return true;
+}
+
+/*!
+ * It reads the next line and converts all its tokens to doubles
+ * \param[out] values the converted values are appended to this vector
+ * \return false if the stream has no more lines
+ */
+bool Tokenizer::readLine(std::vector<double> & values)
+{
+    const char *begin, *end;
+    if(!nextLine(&begin, &end)) {
+        return false;
+    }
+    parseLine(begin, end, values);
+
+    return true;
+}
+
+/*!
+ * It reads the first token of the next non-blank line and converts it to double
+ * \param[out] value the converted value
+ * \return false if the stream has no more values
+ */
+bool Tokenizer::readValue(double & value)
+{
+    const char *begin, *end;
+    while(nextLine(&begin, &end)) {
+        begin = skipBlanks(begin, end);
+        if(begin != end) {
+            return (parseDouble(begin, end, &value) != nullptr);
+        }
+    }
+
+    return false;
+}
+
+/*!
+ * It gets the number of bytes returned as lines so far, newline characters included.
+ * Added to the stream position at construction, it gives the offset of the next line.
+ * \return the number of consumed bytes
+ */
+uint64_t Tokenizer::getConsumedBytes() const
+{
+    return m_consumed;
+}
+
+/*!
+ * It moves the unread bytes at the beginning of the block and fills the rest of it from the stream.
+ * If the unread bytes fill the whole block (a very long line), the block is doubled.
+ * \return false if no more bytes are available
+ */
+bool Tokenizer::refill()
+{
+    std::size_t remaining = m_size - m_cursor;
+    if(m_cursor > 0) {
+        std::memmove(m_buffer.data(), m_buffer.data() + m_cursor, remaining);
+        m_cursor = 0;
+        m_size = remaining;
+    }
+    if(m_size == m_buffer.size()) {
+        m_buffer.resize(2 * m_buffer.size());
+    }
+
+    m_stream.read(m_buffer.data() + m_size, static_cast<std::streamsize>(m_buffer.size() - m_size));
+    std::size_t nRead = static_cast<std::size_t>(m_stream.gcount());
+    m_size += nRead;
+    if(!m_stream) {
+        m_eof = true;
+    }
+
+    return (nRead > 0);
+}
+
+/*!
+ * It finds the first newline character, comparing 16 bytes at a time when SSE2 is available
+ * \param[in] begin first character to be scanned
+ * \param[in] end character after the last one to be scanned
+ * \return pointer to the newline character, end if not found
+ */
+const char * Tokenizer::findNewline(const char * begin, const char * end)
+{
+#if defined(__SSE2__)
+    const __m128i newline = _mm_set1_epi8('\n');
+    while(end - begin >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline));
+        if(mask != 0) {
+            return begin + __builtin_ctz(mask);
+        }
+        begin += 16;
+    }
+#endif
+    const void *found = std::memchr(begin, '\n', static_cast<std::size_t>(end - begin));
+
+    return (found != nullptr) ? static_cast<const char *>(found) : end;
+}
+
+/*!
+ * It skips the blank characters (space, tab, carriage return) at the beginning of the range
+ * \param[in] begin first character of the range
+ * \param[in] end character after the last one of the range
+ * \return pointer to the first non-blank character, end if the range is blank
+ */
+const char * Tokenizer::skipBlanks(const char * begin, const char * end)
+{
+    while(begin != end && isBlank(*begin)) {
+        ++begin;
+    }
+
+    return begin;
+}
+
+/*!
+ * It counts the blank separated tokens of a range, without converting them
+ * \param[in] begin first character of the range
+ * \param[in] end character after the last one of the range
+ * \return the number of tokens
+ */
+long Tokenizer::countTokens(const char * begin, const char * end)
+{
+    long nTokens = 0;
+    bool inToken = false;
+    for(const char *cursor = begin; cursor != end; ++cursor) {
+        bool blank = isBlank(*cursor);
+        if(!blank && !inToken) {
+            ++nTokens;
+        }
+        inToken = !blank;
+    }
+
+    return nTokens;
+}
+
+/*!
+ * It converts the integer at the beginning of the range
+ * \param[in] begin first character of the token
+ * \param[in] end character after the last one of the range
+ * \param[out] value the converted value
+ * \return pointer to the character after the token, nullptr if the token is not an integer or overflows
+ */
+const char * Tokenizer::parseLong(const char * begin, const char * end, long * value)
+{
+    const char *cursor = begin;
+    bool negative = false;
+    if(cursor != end && (*cursor == '-' || *cursor == '+')) {
+        negative = (*cursor == '-');
+        ++cursor;
+    }
+
+    const char *digits = cursor;
+    unsigned long magnitude = 0;
+    const unsigned long limit = negative ? static_cast<unsigned long>(std::numeric_limits<long>::max()) + 1
+                                         : static_cast<unsigned long>(std::numeric_limits<long>::max());
+    while(cursor != end && isDigit(*cursor)) {
+        unsigned long digit = static_cast<unsigned long>(*cursor - '0');
+        if(magnitude > (limit - digit) / 10) {
+            return nullptr;
+        }
+        magnitude = 10 * magnitude + digit;
+        ++cursor;
+    }
+    if(cursor == digits) {
+        return nullptr;
+    }
+
+    *value = negative ? static_cast<long>(0 - magnitude) : static_cast<long>(magnitude);
+
+    return cursor;
+}
+
+/*!
+ * It converts the floating point number at the beginning of the range.
+ * Numbers with at most 19 significant digits, whose mantissa is exactly representable and whose decimal exponent
+ * is at most 22 in absolute value, are computed with a single exact product or division, i.e. correctly rounded.
+ * All the other numbers (and inf/nan) are converted by strtod.
+ * \param[in] begin first character of the token
+ * \param[in] end character after the last one of the range
+ * \param[out] value the converted value
+ * \return pointer to the character after the token, nullptr if the token is not a number
+ */
+const char * Tokenizer::parseDouble(const char * begin, const char * end, double * value)
+{
+    const char *cursor = begin;
+    bool negative = false;
+    if(cursor != end && (*cursor == '-' || *cursor == '+')) {
+        negative = (*cursor == '-');
+        ++cursor;
+    }
+
+    uint64_t mantissa = 0;
+    int nDigits = 0;
+    int exponent = 0;
+    bool hasDigits = false;
+    bool truncated = false;
+
+    //Integer part
+    while(cursor != end && isDigit(*cursor)) {
+        hasDigits = true;
+        if(nDigits < MAX_MANTISSA_DIGITS) {
+            mantissa = 10 * mantissa + static_cast<uint64_t>(*cursor - '0');
+            if(mantissa > 0) {
+                ++nDigits;
+            }
+        } else {
+            truncated = true;
+        }
+        ++cursor;
+    }
+
+    //Fractional part
+    if(cursor != end && *cursor == '.') {
+        ++cursor;
+        while(cursor != end && isDigit(*cursor)) {
+            hasDigits = true;
+            if(nDigits < MAX_MANTISSA_DIGITS) {
+                mantissa = 10 * mantissa + static_cast<uint64_t>(*cursor - '0');
+                if(mantissa > 0) {
+                    ++nDigits;
+                }
+                --exponent;
+            } else {
+                truncated = true;
+            }
+            ++cursor;
+        }
+    }
+
+    if(!hasDigits) {
+        return parseDoubleFallback(begin, end, value);
+    }
+
+    //Exponent
+    if(cursor != end && (*cursor == 'e' || *cursor == 'E')) {
+        const char *exponentBegin = cursor;
+        ++cursor;
+        bool negativeExponent = false;
+        if(cursor != end && (*cursor == '-' || *cursor == '+')) {
+            negativeExponent = (*cursor == '-');
+            ++cursor;
+        }
+        if(cursor == end || !isDigit(*cursor)) {
+            //Not an exponent, the token ends before the 'e'
+            cursor = exponentBegin;
+        } else {
+            int explicitExponent = 0;
+            while(cursor != end && isDigit(*cursor)) {
+                if(explicitExponent < 100000) {
+                    explicitExponent = 10 * explicitExponent + (*cursor - '0');
+                }
+                ++cursor;
+            }
+            exponent += negativeExponent ? -explicitExponent : explicitExponent;
+        }
+    }
+
+    if(truncated || mantissa > MAX_EXACT_MANTISSA || exponent > MAX_EXACT_EXPONENT || exponent < -MAX_EXACT_EXPONENT) {
+        if(mantissa == 0 && !truncated) {
+            *value = negative ? -0. : 0.;
+            return cursor;
+        }
+        return parseDoubleFallback(begin, cursor, value);
+    }
+
+    double result = static_cast<double>(mantissa);
+    if(exponent < 0) {
+        result /= EXACT_POWERS_OF_TEN[-exponent];
+    } else {
+        result *= EXACT_POWERS_OF_TEN[exponent];
+    }
+    *value = negative ? -result : result;
+
+    return cursor;
+}
+
+/*!
+ * It converts all the blank separated integers of a line, stopping at the first invalid token
+ * \param[in] begin first character of the line
+ * \param[in] end character after the last one of the line
+ * \param[out] values the converted values are appended to this vector
+ * \return the number of converted tokens
+ */
+std::size_t Tokenizer::parseLine(const char * begin, const char * end, std::vector<long> & values)
+{
+    return parseTokens(begin, end, &Tokenizer::parseLong, values);
+}
+
+/*!
+ * It converts all the blank separated doubles of a line, stopping at the first invalid token
+ * \param[in] begin first character of the line
+ * \param[in] end character after the last one of the line
+ * \param[out] values the converted values are appended to this vector
+ * \return the number of converted tokens
+ */
+std::size_t Tokenizer::parseLine(const char * begin, const char * end, std::vector<double> & values)
+{
+    return parseTokens(begin, end, &Tokenizer::parseDouble, values);
+}
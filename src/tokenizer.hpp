@@ -0,0 +1,83 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_TOKENIZER_HPP__
+#define __MADLINSOLV_TOKENIZER_HPP__
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <vector>
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The ASCII input tokenizer class
+ *
+ *  This class is intended to
+ *  replace iostream extraction in the ASCII readers (matrix, right-hand side and initial solution).
+ *  The stream is read in large blocks and lines are located with a SIMD scan for the newline character;
+ *  numbers are converted in place, without locale lookups nor allocations:
+ *   - integers are accumulated digit by digit, with overflow check;
+ *   - doubles with at most 19 significant digits and small decimal exponents, i.e. almost all the numbers
+ *     printed by solvers and converters, are computed exactly with a single floating point operation
+ *     (Clinger fast path); all the other ones fall back to strtod.
+ *  Tokens are separated by blanks (space, tab, carriage return); lines by the newline character.
+ *  The tokenizer reads ahead: once created, the stream position is undefined.
+ */
+class Tokenizer {
+
+public:
+
+    static const std::size_t DEFAULT_BLOCK_SIZE;
+
+    explicit Tokenizer(std::istream & stream, std::size_t blockSize = DEFAULT_BLOCK_SIZE);
+
+    bool nextLine(const char ** begin, const char ** end);
+    bool readLine(std::vector<long> & values);
+    bool readLine(std::vector<double> & values);
+    bool readValue(double & value);
+
+    uint64_t getConsumedBytes() const;
+
+    static const char * findNewline(const char * begin, const char * end);
+    static const char * skipBlanks(const char * begin, const char * end);
+    static long countTokens(const char * begin, const char * end);
+    static const char * parseLong(const char * begin, const char * end, long * value);
+    static const char * parseDouble(const char * begin, const char * end, double * value);
+    static std::size_t parseLine(const char * begin, const char * end, std::vector<long> & values);
+    static std::size_t parseLine(const char * begin, const char * end, std::vector<double> & values);
+
+private:
+
+    bool refill();
+
+    std::istream & m_stream;                            /**<stream the blocks are read from*/
+    std::vector<char> m_buffer;                         /**<current block, grown if a line does not fit*/
+    std::size_t m_cursor;                               /**<position of the first unread byte in the block*/
+    std::size_t m_size;                                 /**<number of valid bytes in the block*/
+    bool m_eof;                                         /**<true if the stream has been read completely*/
+    uint64_t m_consumed;                                /**<number of bytes returned as lines, newlines included*/
+
+};
+
+#endif
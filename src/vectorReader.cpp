@@ -0,0 +1,605 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cstring>
+
+#include <bitpit_IO.hpp>
+#include <bitpit_LA.hpp>
+
+#include "vectorReader.hpp"
+#include "binaryFormat.hpp"
+#include "collectiveReader.hpp"
+#include "inputFileStream.hpp"
+#include "mappedFile.hpp"
+#include "memoryStreamBuffer.hpp"
+#include "shardSet.hpp"
+
+using namespace bitpit;
+
+/*!
+ * Constructor
+ * It sets m_nProcessors, m_rank and the target vector to values passed from the caller
+ * File_Handler is default constructed. Row member is set to zero.
+ * \param[in] nProcessors number of MPI processes
+ * \param[in] rank process MPI rank
+ * \param[in] target system vector filled by the read method
+ */
+VectorReader::VectorReader(int nProcessors, int rank, Target target) :
+                m_nProcessors(nProcessors), m_rank(rank), m_target(target), m_fileHandler(), m_inputOptions(), m_partition(),
+                m_shardPattern(), m_sharedData(nullptr), m_sharedSize(0), m_nRows(0), m_nColumns(1)
+{
+
+}
+
+/*!
+ * Constructor
+ * It sets m_nProcessors, m_rank and the target vector to values passed from the caller
+ * File_Handler is constructed with folder, file name and extension from the caller.
+ * Row member is set to zero.
+ * \param[in] nProcessors number of MPI processes
+ * \param[in] rank process MPI rank
+ * \param[in] target system vector filled by the read method
+ * \param[in] dir_ vector folder name
+ * \param[in] name_ vector file name
+ * \param[in] app_ vector file extension
+ */
+VectorReader::VectorReader(int nProcessors, int rank, Target target, const std::string& dir_,
+        const std::string& name_, const std::string& app_) :
+                m_nProcessors(nProcessors), m_rank(rank), m_target(target), m_fileHandler(dir_,name_,app_), m_inputOptions(), m_partition(),
+                m_shardPattern(), m_sharedData(nullptr), m_sharedSize(0), m_nRows(0), m_nColumns(1)
+{
+
+}
+
+/*!
+ * It reads the vector from disk straight into the target system vector (right-hand side or solution),
+ * checking if number of elements in file header is equal to the expected one.
+ * If the file holds several columns, only the first one is kept.
+ * \param[in] system a reference to the unique pointer to the system which the user wants to fill
+ * \param[in] expectedElements number of elements the user expects in the file (header number of elements)
+ */
+void VectorReader::read(std::unique_ptr<SystemSolver> & system, int expectedElements)
+{
+    double *values = nullptr;
+    readValues(expectedElements, [this, &system, &values](long, std::vector<double *> & columns) {
+        values = (m_target == Target::RHS) ? system->getRHSRawPtr() : system->getSolutionRawPtr();
+        columns[0] = values;
+    });
+
+    if(values != nullptr) {
+        if(m_target == Target::RHS) {
+            system->restoreRHSRawPtr(values);
+        } else {
+            system->restoreSolutionRawPtr(values);
+        }
+    }
+}
+
+/*!
+ * It reads all the columns of the vector file in a single pass, each process getting its own rows of every column,
+ * checking if number of elements in file header is equal to the expected one.
+ * \param[in] expectedElements number of elements the user expects in the file (header number of elements)
+ * \param[out] columns the local rows of every column
+ */
+void VectorReader::readColumns(int expectedElements, std::vector<std::vector<double>> & columns)
+{
+    columns.clear();
+    readValues(expectedElements, [&columns](long nLocalRows, std::vector<double *> & targets) {
+        columns.assign(targets.size(), std::vector<double>(nLocalRows, 0.));
+        for(std::size_t column = 0; column < targets.size(); ++column) {
+            targets[column] = columns[column].data();
+        }
+    });
+}
+
+/*!
+ * It reads the vector from the source matching the settings and the file: shared data, shards, binary container,
+ * collective MPI-IO or independent streams
+ * \param[in] expectedElements number of elements the user expects in the file (header number of elements)
+ * \param[in] bind the function binding the columns to their destination
+ */
+void VectorReader::readValues(int expectedElements, const Binder & bind)
+{
+    if(m_sharedData != nullptr) {
+        readBinary(expectedElements, bind);
+        return;
+    }
+
+    if(!m_shardPattern.empty()) {
+        readShards(expectedElements, bind);
+        return;
+    }
+
+    if(VectorBinaryFormat::hasMagic(getPath())) {
+        readBinary(expectedElements, bind);
+        return;
+    }
+
+    if(m_inputOptions.mode == ReadMode::MPIIO) {
+        if(!InputFileStream::isCompressed(getPath())) {
+            readCollective(expectedElements, bind);
+            return;
+        }
+        log::cout() << "Compressed file, independent streams will be used instead of MPI-IO" << std::endl;
+    }
+
+    readStream(expectedElements, bind);
+}
+
+/*!
+ * It reads the vector with an independent stream per process.
+ * Uncompressed files are memory mapped, so the lines are parsed from the page cache without an intermediate file buffer.
+ * \param[in] expectedElements number of elements the user expects in the file (header number of elements)
+ * \param[in] bind the function binding the columns to their destination
+ */
+void VectorReader::readStream(int expectedElements, const Binder & bind)
+{
+    log::cout() << getLabel() << " path: " << getPath() << std::endl;
+
+    MappedFile mappedFile;
+    MemoryStreamBuffer mappedBuffer;
+    std::unique_ptr<InputFileStream> fileStream;
+    std::unique_ptr<std::istream> mappedStream;
+    std::istream *inVector = nullptr;
+    if(!InputFileStream::isCompressed(getPath()) && mappedFile.open(getPath())) {
+        mappedBuffer.reset(mappedFile.getData(), mappedFile.getSize());
+        mappedStream = std::unique_ptr<std::istream>(new std::istream(&mappedBuffer));
+        inVector = mappedStream.get();
+    } else {
+        fileStream = std::unique_ptr<InputFileStream>(new InputFileStream(getPath()));
+        if(fileStream->isOpen()) {
+            inVector = fileStream.get();
+        }
+    }
+
+    long failedRow = -1;
+    if(inVector != nullptr) {
+        readInfo(*inVector);
+        checkInfo(expectedElements);
+
+        LineIndex index(getPath());
+        index.initialize(static_cast<uint64_t>(inVector->tellg()), m_rank);
+
+        failedRow = readBody(*inVector, index, bind);
+    } else {
+        log::cout() << "File " << getPath() << " not open!" << std::endl;
+    }
+
+    int isCorrupted = (fileStream && fileStream->isCorrupted()) ? 1 : 0;
+#if ENABLE_MPI==1
+    MPI_Allreduce(MPI_IN_PLACE, &isCorrupted, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+#endif
+    if(isCorrupted) {
+        log::cout() << "File " << getPath() << " is a corrupted or truncated gzip file!" << std::endl;
+#if ENABLE_MPI==1
+        MPI_Finalize();
+#endif
+        exit(1);
+    }
+    checkRows(failedRow);
+}
+
+/*!
+ * It reads the vector with collective MPI-IO calls.
+ * Only the first process opens the file to read the header and to provide the line index,
+ * then each process loads the byte range of its own lines with a single collective read and parses it from memory.
+ * \param[in] expectedElements number of elements the user expects in the file (header number of elements)
+ * \param[in] bind the function binding the columns to their destination
+ */
+void VectorReader::readCollective(int expectedElements, const Binder & bind)
+{
+    log::cout() << getLabel() << " path: " << getPath() << " (collective MPI-IO)" << std::endl;
+
+    //Only the first process reads the header
+    int isOpen = 0;
+    uint64_t bodyOffset = 0;
+    if(m_rank == 0) {
+        InputFileStream inVector(getPath());
+        if(inVector.isOpen()) {
+            isOpen = 1;
+            readInfo(inVector);
+            bodyOffset = static_cast<uint64_t>(inVector.tellg());
+        }
+    }
+#if ENABLE_MPI==1
+    int info[3] = {isOpen, m_nRows, m_nColumns};
+    MPI_Bcast(info, 3, MPI_INT, 0, MPI_COMM_WORLD);
+    isOpen = info[0];
+    m_nRows = info[1];
+    m_nColumns = info[2];
+    MPI_Bcast(&bodyOffset, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+#endif
+    if(!isOpen) {
+        log::cout() << "File " << getPath() << " not open!" << std::endl;
+#if ENABLE_MPI==1
+        MPI_Barrier(MPI_COMM_WORLD);
+#endif
+        return;
+    }
+    checkInfo(expectedElements);
+
+    LineIndex index(getPath());
+    index.initialize(bodyOffset, m_rank);
+
+    //Load the rank lines with a collective read and parse them from memory
+    RowPartition partition = getPartition();
+    CollectiveReader reader(getPath());
+    if(!reader.readLines(index, partition.getRowStart(m_rank), partition.getRowCount(m_rank))) {
+        log::cout() << "File " << getPath() << " could not be read!" << std::endl;
+#if ENABLE_MPI==1
+        MPI_Finalize();
+#endif
+        exit(1);
+    }
+    std::istream inVector(&reader.getStreamBuffer());
+    long failedRow = readBody(inVector, index, bind);
+    reader.logBandwidth(getLabel());
+    checkRows(failedRow);
+
+#if ENABLE_MPI==1
+    MPI_Barrier(MPI_COMM_WORLD);
+#endif
+}
+
+/*!
+ * It reads the vector from shards (see ShardSet class for details).
+ * Each process opens only the shards overlapping its own lines.
+ * \param[in] expectedElements number of elements the user expects in the file (header number of elements)
+ * \param[in] bind the function binding the columns to their destination
+ */
+void VectorReader::readShards(int expectedElements, const Binder & bind)
+{
+    ShardSet shards(m_fileHandler.getDirectory(), m_shardPattern);
+    if(!shards.readManifest(m_rank)) {
+#if ENABLE_MPI==1
+        MPI_Finalize();
+#endif
+        exit(1);
+    }
+    m_nRows = static_cast<int>(shards.getRowGlobalCount());
+    m_nColumns = std::max(1, static_cast<int>(shards.getColGlobalCount()));
+    checkInfo(expectedElements);
+
+    RowPartition partition = getPartition();
+    log::cout() << getLabel() << " lines per proc = " << partition.getRowCounts() << std::endl;
+
+    std::vector<double *> columns(m_nColumns, nullptr);
+    bind(partition.getRowCount(m_rank), columns);
+    long failedRow = -1;
+    bool isRead = shards.readRows(partition, m_rank, 1, [this, &partition, &columns, &failedRow](Tokenizer & tokenizer, long localRow, long nRows) {
+        long nParsed = parseRows(tokenizer, nRows, columns, localRow);
+        if(nParsed < nRows && failedRow < 0) {
+            failedRow = partition.getRowStart(m_rank) + localRow + nParsed;
+        }
+    });
+    if(!isRead) {
+#if ENABLE_MPI==1
+        MPI_Finalize();
+#endif
+        exit(1);
+    }
+    checkRows(failedRow);
+}
+
+/*!
+ * It reads the vector from a binary vector container (see VectorBinaryFormat class for details).
+ * The file is memory mapped and each process copies only its own slice of every kept column, without any parsing.
+ * If shared data are set (see setSharedData), the container is read in place from them instead of the file.
+ * \param[in] expectedElements number of elements the user expects in the file (header number of elements)
+ * \param[in] bind the function binding the columns to their destination
+ */
+void VectorReader::readBinary(int expectedElements, const Binder & bind)
+{
+    MappedFile inFile;
+    const char *data = m_sharedData;
+    std::size_t size = m_sharedSize;
+    std::string source = "Shared-memory " + getLabel();
+    if(data == nullptr) {
+        log::cout() << getLabel() << " path: " << getPath() << " (binary)" << std::endl;
+        if(inFile.open(getPath())) {
+            data = inFile.getData();
+            size = inFile.getSize();
+        }
+        source = "File " + getPath();
+    } else {
+        log::cout() << getLabel() << " source: shared memory" << std::endl;
+    }
+
+    VectorBinaryHeader header;
+    std::string error;
+    if(data == nullptr) {
+        error = "file not open";
+    } else if(size < sizeof(VectorBinaryHeader)) {
+        error = "truncated header";
+    } else {
+        std::memcpy(&header, data, sizeof(VectorBinaryHeader));
+        VectorBinaryFormat::checkHeader(header, size, &error);
+    }
+    if(!error.empty()) {
+        log::cout() << source << " is not a valid binary vector: " << error << std::endl;
+#if ENABLE_MPI==1
+        MPI_Finalize();
+#endif
+        exit(1);
+    }
+
+    m_nRows = static_cast<int>(header.nRows);
+    m_nColumns = static_cast<int>(VectorBinaryFormat::getColumnCount(header));
+    log::cout() << "nRows = " << m_nRows << ", nColumns = " << m_nColumns << std::endl;
+    checkInfo(expectedElements);
+
+    RowPartition partition = getPartition();
+    log::cout() << getLabel() << " lines per proc = " << partition.getRowCounts() << std::endl;
+    long startRow = partition.getRowStart(m_rank);
+    long nLocalRows = partition.getRowCount(m_rank);
+
+    std::vector<double *> columns(m_nColumns, nullptr);
+    bind(nLocalRows, columns);
+    const double *fileValues = reinterpret_cast<const double *>(data + header.valuesOffset);
+    for(int column = 0; column < m_nColumns; ++column) {
+        if(columns[column] != nullptr) {
+            std::memcpy(columns[column], fileValues + static_cast<long>(column) * m_nRows + startRow, nLocalRows * sizeof(double));
+        }
+    }
+
+#if ENABLE_MPI==1
+    MPI_Barrier(MPI_COMM_WORLD);
+#endif
+}
+
+/*!
+ * It reads the vector header from file: number of rows and, optionally, number of columns
+ * \param fileStream the stream from the input vector file
+ */
+void VectorReader::readInfo(std::istream & fileStream)
+{
+    std::string line;
+    std::getline(fileStream,line);
+    while(std::getline(fileStream,line)) {
+        line = utils::string::trim(line);
+        if(line.substr(0,1) != "#") {
+            std::vector<long> sizes;
+            sizes.reserve(2);
+            Tokenizer::parseLine(line.data(), line.data() + line.size(), sizes);
+            sizes.resize(2, 1);
+            m_nRows = static_cast<int>(sizes[0]);
+            m_nColumns = std::max(1, static_cast<int>(sizes[1]));
+            break;
+        }
+    }
+    log::cout() << "nRows = " << m_nRows << ", nColumns = " << m_nColumns << std::endl;
+}
+
+/*!
+ * It checks if number of elements in file header is equal to the expected one.
+ * \param[in] expectedElements number of elements the user expects in the file (header number of elements)
+ */
+void VectorReader::checkInfo(int expectedElements)
+{
+    if(expectedElements != m_nRows) {
+        log::cout() << getLabel() << " and matrix have different number of rows. Please, check file " << getPath() << std::endl;
+#if ENABLE_MPI == 1
+        MPI_Finalize();
+#endif
+        exit(1);
+    }
+}
+
+/*!
+ * It stops the execution if any process could not parse one of its lines. This method is collective.
+ * \param[in] failedRow global row which could not be parsed by the process, -1 if all its lines have been parsed
+ */
+void VectorReader::checkRows(long failedRow)
+{
+#if ENABLE_MPI==1
+    MPI_Allreduce(MPI_IN_PLACE, &failedRow, 1, MPI_LONG, MPI_MAX, MPI_COMM_WORLD);
+#endif
+    if(failedRow >= 0) {
+        log::cout() << getLabel() << " row " << failedRow << " is missing or holds less than " << m_nColumns
+                << " values. Please, check file " << getPath() << std::endl;
+#if ENABLE_MPI==1
+        MPI_Finalize();
+#endif
+        exit(1);
+    }
+}
+
+/*!
+ * It reads the lines of the process from the body of the vector file
+ * \param[in] fileStream the stream from the input vector file
+ * \param[in] index the line index of the file body
+ * \param[in] bind the function binding the columns to their destination
+ * \return the global row which could not be parsed, -1 if all the lines of the process have been parsed
+ */
+long VectorReader::readBody(std::istream & fileStream, const LineIndex & index, const Binder & bind)
+{
+    RowPartition partition = getPartition();
+    log::cout() << getLabel() << " lines per proc = " << partition.getRowCounts() << std::endl;
+
+    std::vector<double *> columns(m_nColumns, nullptr);
+    bind(partition.getRowCount(m_rank), columns);
+
+    //jump to rank lines
+    index.seek(fileStream, partition.getRowStart(m_rank));
+    //read rank rows
+    Tokenizer tokenizer(fileStream);
+    long nParsed = parseRows(tokenizer, partition.getRowCount(m_rank), columns, 0);
+
+    return (nParsed < partition.getRowCount(m_rank)) ? partition.getRowStart(m_rank) + nParsed : -1;
+}
+
+/*!
+ * It parses consecutive lines, storing the values of the kept columns
+ * \param[in] tokenizer the tokenizer positioned at the first line
+ * \param[in] nRows number of lines to be parsed
+ * \param[in] columns first local element of the destination of each column, null for the skipped columns
+ * \param[in] localRow position of the first line among the lines of the process
+ * \return the number of parsed lines, less than nRows if the file ends or a line holds less values than the columns
+ */
+long VectorReader::parseRows(Tokenizer & tokenizer, long nRows, const std::vector<double *> & columns, long localRow)
+{
+    //A single column is the common case, one value per line
+    if(m_nColumns == 1) {
+        double value = 0.;
+        for(long i = 0; i < nRows; ++i) {
+            if(!tokenizer.readValue(value)) {
+                return i;
+            }
+            if(columns[0] != nullptr) {
+                columns[0][localRow + i] = value;
+            }
+        }
+        return nRows;
+    }
+
+    const char *begin, *end;
+    for(long i = 0; i < nRows; ++i) {
+        do {
+            if(!tokenizer.nextLine(&begin, &end)) {
+                return i;
+            }
+            begin = Tokenizer::skipBlanks(begin, end);
+        } while(begin == end);
+
+        for(int column = 0; column < m_nColumns; ++column) {
+            double value = 0.;
+            begin = Tokenizer::skipBlanks(begin, end);
+            begin = Tokenizer::parseDouble(begin, end, &value);
+            if(begin == nullptr) {
+                return i;
+            }
+            if(columns[column] != nullptr) {
+                columns[column][localRow + i] = value;
+            }
+        }
+    }
+
+    return nRows;
+}
+
+/*!
+ * It gets the name of the read vector for the log
+ * \return the name of the target vector
+ */
+std::string VectorReader::getLabel() const
+{
+    return (m_target == Target::RHS) ? "RHS" : "Initial solution";
+}
+
+/*!
+ * It gets the partition the vector file lines are read with:
+ * the matrix row partition if it has been set and it matches the file, equal rows otherwise
+ * \return the row partition among processes
+ */
+RowPartition VectorReader::getPartition() const
+{
+    if(m_partition.isEmpty() || m_partition.getRowGlobalCount() != m_nRows || m_partition.getProcessorCount() != m_nProcessors) {
+        return RowPartition::uniform(m_nRows, m_nProcessors);
+    }
+
+    return m_partition;
+}
+
+/*!
+ * It gets the global number of rows as read in the vector file header
+ * @return the global number of rows
+ */
+int VectorReader::getNRows() const
+{
+    return m_nRows;
+}
+
+/*!
+ * It gets the vector file path from the file handler
+ * @return a string containing the file path
+ */
+std::string VectorReader::getPath()
+{
+    return m_fileHandler.getPath();
+}
+
+/*!
+ * It sets a binary vector container held in memory, e.g. in a shared-memory segment (see SharedSegment class),
+ * to be read in place of the vector file. The data must outlive the reads.
+ * \param[in] data first byte of the container, null to read the file again
+ * \param[in] size size in bytes of the container
+ */
+void VectorReader::setSharedData(const char * data, std::size_t size)
+{
+    m_sharedData = data;
+    m_sharedSize = size;
+}
+
+/*!
+ * It sets the shard file name pattern, the vector is then read from shards (see ShardSet class for details)
+ * \param[in] pattern shard file name pattern, empty for a single file
+ */
+void VectorReader::setShardPattern(const std::string & pattern)
+{
+    m_shardPattern = pattern;
+}
+
+/*!
+ * It sets the row partition among processes, shared with the matrix reader
+ * \param[in] partition the row partition
+ */
+void VectorReader::setPartition(const RowPartition & partition)
+{
+    m_partition = partition;
+}
+
+/*!
+ * It sets the input settings
+ * \param[in] options input settings from the dictionary
+ */
+void VectorReader::setInputOptions(const InputOptions & options)
+{
+    m_inputOptions = options;
+}
+
+/*!
+ * It sets the vector folder name into the file handler
+ * @param dir vector folder name
+ */
+void VectorReader::setDirectory(const std::string& dir)
+{
+    m_fileHandler.setDirectory(dir);
+}
+
+/*!
+ * It sets the vector file name into the file handler
+ * @param dir vector file name
+ */
+void VectorReader::setName(const std::string& name)
+{
+    m_fileHandler.setName(name);
+}
+
+/*!
+ * It sets the vector file extension into the file handler
+ * @param dir vector file extension
+ */
+void VectorReader::setAppendix(const std::string& app)
+{
+    m_fileHandler.setAppendix(app);
+}
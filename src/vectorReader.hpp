@@ -0,0 +1,147 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_VECTORREADER_HPP__
+#define __MADLINSOLV_VECTORREADER_HPP__
+
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <bitpit_IO.hpp>
+#include <bitpit_LA.hpp>
+
+#include "inputOptions.hpp"
+#include "lineIndex.hpp"
+#include "rowPartition.hpp"
+#include "tokenizer.hpp"
+
+using namespace bitpit;
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The vector reader class
+ *
+ *  This class is intended to
+ *  read from the disk the user right-hand side or initial solution guess, i.e. one or more vectors (columns) sharing the matrix rows.
+ *  ASCII file format is serial but reading is parallel:
+ *  \verbatim
+ *                                      file format
+ *           ---------------------------------------------------------------
+ *  line 1   | title                                                       |   <-- skipped
+ *  line 2   | global_number_of_elements [number_of_columns]               |   <-- header
+ *  line 3   | element_1_column_1_value [element_1_column_2_value ...]     |   --
+ *  line 4   | element_2_column_1_value [element_2_column_2_value ...]     |     |
+ *  ...      | ...                                                         |     |---> body
+ *  line N+2 | element_N_column_1_value [element_N_column_2_value ...]     |   --
+ *           ---------------------------------------------------------------
+ *  \endverbatim
+ *  Lines starting with '#' are comments; one column is assumed if the header gives none.
+ *  All the columns are parsed in a single pass over the process lines.
+ *  Lines are distributed among the processes with the row partition of the matrix (see RowPartition class for details).
+ *  Each process jumps to its first line through a sidecar line index (see LineIndex class for details).
+ *  Uncompressed files are memory mapped and parsed in place; gzip compressed files are decompressed on the fly
+ *  (see InputFileStream class for details).
+ *  With the MPI-IO input mode, only the first process reads the header and all the processes
+ *  load their own lines with a single collective read (see CollectiveReader class for details).
+ *  The vector can also be split in shards, each process opening only its own ones (see ShardSet class for details);
+ *  the number of columns is then the global number of columns of the manifest.
+ *  The file can also be a binary vector container written by madlinsolv-convert (see VectorBinaryFormat class for details),
+ *  which is memory mapped and recognized by its signature. The same container can be read in place from a shared-memory
+ *  segment written by a co-located producer (see SharedSegment class for details).
+ *
+ *  Values are written straight at the process offset into the PETSc vector of the target (right-hand side or solution),
+ *  or into caller vectors when several columns are needed.
+ */
+class VectorReader {
+
+public:
+
+    /*!
+     * System vectors a reader fills
+     */
+    enum class Target {
+        RHS,                                            /**<right-hand side of the system*/
+        SOLUTION                                        /**<solution of the system, i.e. the initial guess*/
+    };
+
+    VectorReader(int nProcessors, int rank, Target target);
+    VectorReader(int nProcessors, int rank, Target target, const std::string & dir_, const std::string & name_, const std::string & app_);
+
+    void read(std::unique_ptr<SystemSolver> & system, int expectedElements);
+    void readColumns(int expectedElements, std::vector<std::vector<double>> & columns);
+
+    void setInputOptions(const InputOptions & options);
+    void setPartition(const RowPartition & partition);
+    void setShardPattern(const std::string & pattern);
+    void setSharedData(const char * data, std::size_t size);
+    void setDirectory(const std::string & dir);
+    void setName(const std::string & name);
+    void setAppendix(const std::string & app);
+
+    std::string getPath();
+    int getNRows() const;
+    RowPartition getPartition() const;
+
+private:
+
+    /*!
+     * Function binding the columns to their destination, once the header has been read: it receives
+     * the number of local rows and a vector with one null pointer per column, to be set to the first local
+     * element of the destination of every column to be kept
+     */
+    typedef std::function<void(long nLocalRows, std::vector<double *> & columns)> Binder;
+
+    void readValues(int expectedElements, const Binder & bind);
+    void readStream(int expectedElements, const Binder & bind);
+    void readCollective(int expectedElements, const Binder & bind);
+    void readShards(int expectedElements, const Binder & bind);
+    void readBinary(int expectedElements, const Binder & bind);
+    void readInfo(std::istream & fileStream);
+    void checkInfo(int expectedElements);
+    void checkRows(long failedRow);
+    long readBody(std::istream & fileStream, const LineIndex & index, const Binder & bind);
+    long parseRows(Tokenizer & tokenizer, long nRows, const std::vector<double *> & columns, long localRow);
+
+    std::string getLabel() const;
+
+    int m_nProcessors;                                  /**<number of MPI processes*/
+    int m_rank;                                         /**<MPI rank of the process*/
+    Target m_target;                                    /**<system vector filled by the read method*/
+
+    FileHandler m_fileHandler;                          /**<bitpit file handler*/
+    InputOptions m_inputOptions;                        /**<input settings shared by all the readers*/
+    RowPartition m_partition;                           /**<row partition shared with the matrix reader*/
+    std::string m_shardPattern;                         /**<shard file name pattern, empty for a single file*/
+    const char *m_sharedData;                           /**<binary vector container read in place of the file, null if none*/
+    std::size_t m_sharedSize;                           /**<size in bytes of the shared binary vector container*/
+
+    int m_nRows;                                        /**<number of rows as read in header file*/
+    int m_nColumns;                                     /**<number of columns as read in header file*/
+
+};
+
+#endif
@@ -0,0 +1,191 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#if ENABLE_MPI==1
+#    include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+
+#include <bitpit_IO.hpp>
+
+#include "vectorWriter.hpp"
+
+using namespace bitpit;
+
+namespace {
+
+//MPI-IO counts are int, larger ranges are written in several collective calls
+const uint64_t MAX_CHUNK_SIZE = 1 << 30;
+
+}
+
+/*!
+ * Constructor
+ * It sets m_nProcessors and m_rank to values passed from the caller
+ * File_Handler is default constructed.
+ * \param[in] nProcessors number of MPI processes
+ * \param[in] rank process MPI rank
+ */
+VectorWriter::VectorWriter(int nProcessors, int rank) :
+                m_nProcessors(nProcessors), m_rank(rank), m_fileHandler()
+{
+
+}
+
+/*!
+ * Constructor
+ * It sets m_nProcessors and m_rank to values passed from the caller
+ * File_Handler is constructed with folder, file name and extension from the caller.
+ * \param[in] nProcessors number of MPI processes
+ * \param[in] rank process MPI rank
+ * \param[in] dir_ vector folder name
+ * \param[in] name_ vector file name
+ * \param[in] app_ vector file extension
+ */
+VectorWriter::VectorWriter(int nProcessors, int rank, const std::string& dir_,
+        const std::string& name_, const std::string& app_) :
+                m_nProcessors(nProcessors), m_rank(rank), m_fileHandler(dir_,name_,app_)
+{
+
+}
+
+/*!
+ * It writes the vector to disk. The processes own consecutive blocks of rows, in rank order.
+ * Elements are printed with 17 significant digits, so that reading them back gives the same doubles.
+ * This method is collective.
+ * \param[in] values local elements of the vector
+ * \param[in] nLocalRows number of local elements
+ * \param[in] nRows global number of elements
+ * \param[in] title text of the title line
+ * \return true if the file has been written by all the processes
+ */
+bool VectorWriter::write(const double * values, long nLocalRows, long nRows, const std::string & title)
+{
+    //Format the local block, the first process leads with the title and header lines
+    std::string buffer;
+    buffer.reserve(static_cast<std::size_t>(nLocalRows) * 25 + 64);
+    if(m_rank == 0) {
+        buffer += "# " + title + "\n";
+        buffer += std::to_string(nRows) + "\n";
+    }
+    char line[32];
+    for(long row = 0; row < nLocalRows; ++row) {
+        int length = std::snprintf(line, sizeof(line), "%.17g\n", values[row]);
+        buffer.append(line, length);
+    }
+
+    uint64_t length = buffer.size();
+    bool success = true;
+
+#if ENABLE_MPI==1
+    uint64_t offset = 0;
+    MPI_Exscan(&length, &offset, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+    if(m_rank == 0) {
+        offset = 0;
+    }
+    uint64_t fileSize;
+    MPI_Allreduce(&length, &fileSize, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+
+    MPI_File fileHandle;
+    int error = MPI_File_open(MPI_COMM_WORLD, const_cast<char *>(getPath().c_str()), MPI_MODE_CREATE | MPI_MODE_WRONLY,
+            MPI_INFO_NULL, &fileHandle);
+    if(error != MPI_SUCCESS) {
+        log::cout() << "File " << getPath() << " cannot be created!" << std::endl;
+        return false;
+    }
+
+    //Drop the tail of an older longer file
+    success = (MPI_File_set_size(fileHandle, static_cast<MPI_Offset>(fileSize)) == MPI_SUCCESS);
+
+    //All the processes must take part in the same number of collective writes
+    uint64_t nChunks = (length + MAX_CHUNK_SIZE - 1) / MAX_CHUNK_SIZE;
+    uint64_t maxChunks;
+    MPI_Allreduce(&nChunks, &maxChunks, 1, MPI_UINT64_T, MPI_MAX, MPI_COMM_WORLD);
+    for(uint64_t chunk = 0; chunk < maxChunks; ++chunk) {
+        uint64_t chunkOffset = std::min(chunk * MAX_CHUNK_SIZE, length);
+        int count = static_cast<int>(std::min(MAX_CHUNK_SIZE, length - chunkOffset));
+        error = MPI_File_write_at_all(fileHandle, static_cast<MPI_Offset>(offset + chunkOffset),
+                const_cast<char *>(buffer.data() + chunkOffset), count, MPI_CHAR, MPI_STATUS_IGNORE);
+        success = success && (error == MPI_SUCCESS);
+    }
+
+    MPI_File_close(&fileHandle);
+
+    int localSuccess = success ? 1 : 0;
+    int globalSuccess;
+    MPI_Allreduce(&localSuccess, &globalSuccess, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    success = (globalSuccess == 1);
+#else
+    std::ofstream out(getPath().c_str(), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+    if(!out.is_open()) {
+        log::cout() << "File " << getPath() << " cannot be created!" << std::endl;
+        return false;
+    }
+    success = static_cast<bool>(out.write(buffer.data(), static_cast<std::streamsize>(length)));
+#endif
+
+    if(!success) {
+        log::cout() << "Writing file " << getPath() << " failed!" << std::endl;
+    }
+
+    return success;
+}
+
+/*!
+ * It sets the folder of the vector file
+ * \param[in] dir folder path
+ */
+void VectorWriter::setDirectory(const std::string & dir)
+{
+    m_fileHandler.setDirectory(dir);
+}
+
+/*!
+ * It sets the name of the vector file
+ * \param[in] name file name
+ */
+void VectorWriter::setName(const std::string & name)
+{
+    m_fileHandler.setName(name);
+}
+
+/*!
+ * It sets the extension of the vector file
+ * \param[in] app file extension
+ */
+void VectorWriter::setAppendix(const std::string & app)
+{
+    m_fileHandler.setAppendix(app);
+}
+
+/*!
+ * It gets the path of the vector file
+ * @return the path as folder/name.extension
+ */
+std::string VectorWriter::getPath()
+{
+    return m_fileHandler.getPath();
+}
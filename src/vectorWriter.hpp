@@ -0,0 +1,68 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#ifndef __MADLINSOLV_VECTORWRITER_HPP__
+#define __MADLINSOLV_VECTORWRITER_HPP__
+
+#include <string>
+
+#include <bitpit_IO.hpp>
+
+using namespace bitpit;
+
+/*!
+ *  \authors        Marco Cisternino
+ *
+ *  \brief The vector writer class
+ *
+ *  This class is intended to
+ *  write to the disk a distributed vector, e.g. the solution of the system, in the ASCII vector format read by VectorReader:
+ *  a title line, the global number of elements and one element per line, in row order.
+ *  Each process formats its own elements in memory; in parallel runs the file is written with
+ *  a single collective MPI-IO call, each process at the offset given by the sizes of the previous ones.
+ *  A written solution can therefore be read back as right-hand side or initial solution guess.
+ */
+class VectorWriter {
+
+public:
+
+    VectorWriter(int nProcessors, int rank);
+    VectorWriter(int nProcessors, int rank, const std::string & dir_, const std::string & name_, const std::string & app_);
+
+    bool write(const double * values, long nLocalRows, long nRows, const std::string & title);
+
+    void setDirectory(const std::string & dir);
+    void setName(const std::string & name);
+    void setAppendix(const std::string & app);
+
+    std::string getPath();
+
+private:
+
+    int m_nProcessors;                                  /**<number of MPI processes*/
+    int m_rank;                                         /**<MPI rank of the process*/
+
+    FileHandler m_fileHandler;                          /**<bitpit file handler*/
+
+};
+
+#endif
@@ -0,0 +1,252 @@
+/*---------------------------------------------------------------------------*\
+ *
+ *  MadLinSolv
+ *
+  *  -------------------------------------------------------------------------
+ *  License
+ *  This file is part of MadLinSolv.
+ *
+ *  MadLinSolv is free software: you can redistribute it and/or modify it
+ *  under the terms of the GNU Lesser General Public License v3 (LGPL)
+ *  as published by the Free Software Foundation.
+ *
+ *  MadLinSolv is distributed in the hope that it will be useful, but WITHOUT
+ *  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ *  FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public
+ *  License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public License
+ *  along with MadLinSolv. If not, see <http://www.gnu.org/licenses/>.
+ *
+ \*---------------------------------------------------------------------------*/
+
+#if ENABLE_MPI==1
+#    include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <bitpit_IO.hpp>
+
+#include "configuredSystemSolver.hpp"
+#include "localCSR.hpp"
+#include "nativeKrylovSolver.hpp"
+#include "solver.hpp"
+
+using namespace bitpit;
+
+namespace {
+
+/*!
+ * Matrix of a test case, in CSR format
+ */
+struct TestMatrix {
+    long nRows;                                         /**<number of rows*/
+    std::vector<long> rowPtr;                           /**<offset of each row, followed by the number of non-zeros*/
+    std::vector<long> colIdx;                           /**<column indices of the rows*/
+    std::vector<double> values;                         /**<values of the rows*/
+};
+
+/*!
+ * It builds the 5-point convection-diffusion matrix of a square grid, with upwind convection along the first direction.
+ * Without convection it is the symmetric positive definite Poisson matrix.
+ * \param[in] n number of grid points per direction
+ * \param[in] convection convection coefficient, non-negative
+ * \return the matrix
+ */
+TestMatrix buildMatrix(long n, double convection)
+{
+    TestMatrix matrix;
+    matrix.nRows = n * n;
+    matrix.rowPtr.reserve(matrix.nRows + 1);
+    matrix.rowPtr.push_back(0);
+    for(long j = 0; j < n; ++j) {
+        for(long i = 0; i < n; ++i) {
+            long row = j * n + i;
+            if(j > 0) {
+                matrix.colIdx.push_back(row - n);
+                matrix.values.push_back(-1.);
+            }
+            if(i > 0) {
+                matrix.colIdx.push_back(row - 1);
+                matrix.values.push_back(-1. - convection);
+            }
+            matrix.colIdx.push_back(row);
+            matrix.values.push_back(4. + convection);
+            if(i < n - 1) {
+                matrix.colIdx.push_back(row + 1);
+                matrix.values.push_back(-1.);
+            }
+            if(j < n - 1) {
+                matrix.colIdx.push_back(row + n);
+                matrix.values.push_back(-1.);
+            }
+            matrix.rowPtr.push_back(matrix.colIdx.size());
+        }
+    }
+
+    return matrix;
+}
+
+/*!
+ * It computes the true residual of a solution, relative to the right-hand side.
+ * \param[in] matrix the matrix
+ * \param[in] rhs the right-hand side
+ * \param[in] solution the solution
+ * \return the 2-norm of rhs - A * solution over the 2-norm of rhs
+ */
+double computeRelativeResidual(const TestMatrix & matrix, const std::vector<double> & rhs, const std::vector<double> & solution)
+{
+    double residual = 0.;
+    double reference = 0.;
+    for(long row = 0; row < matrix.nRows; ++row) {
+        double r = rhs[row];
+        for(long k = matrix.rowPtr[row]; k < matrix.rowPtr[row + 1]; ++k) {
+            r -= matrix.values[k] * solution[matrix.colIdx[k]];
+        }
+        residual += r * r;
+        reference += rhs[row] * rhs[row];
+    }
+
+    return std::sqrt(residual / reference);
+}
+
+/*!
+ * It solves the system with the native Krylov engine, from a zero initial guess.
+ * \param[in] matrix the matrix
+ * \param[in] options the Krylov method and preconditioner
+ * \param[in] rhs the right-hand side
+ * \return the solution
+ */
+std::vector<double> solveNative(const TestMatrix & matrix, const SolverOptions & options, const std::vector<double> & rhs)
+{
+    NativeKrylovSolver solver;
+    solver.setOptions(options);
+    solver.setMatrix(matrix.nRows, matrix.rowPtr.data(), matrix.colIdx.data(), matrix.values.data());
+    solver.solve(rhs.data());
+    log::cout() << "Native iterations = " << solver.getIterations() << ", residual = " << solver.getResidual() << std::endl;
+
+    return std::vector<double>(solver.getSolution(), solver.getSolution() + matrix.nRows);
+}
+
+/*!
+ * It solves the system with PETSc, through the system solver used by the runs, from a zero initial guess.
+ * \param[in] matrix the matrix
+ * \param[in] options the Krylov method and preconditioner
+ * \param[in] rhs the right-hand side
+ * \return the solution
+ */
+std::vector<double> solvePetsc(const TestMatrix & matrix, const SolverOptions & options, const std::vector<double> & rhs)
+{
+    Solver solver(1, 0);
+    solver.getSystem() = std::unique_ptr<SystemSolver>(new ConfiguredSystemSolver(false));
+    static_cast<ConfiguredSystemSolver &>(*(solver.getSystem())).setOptions(options);
+
+    LocalCSR::commit(matrix.nRows, matrix.rowPtr.data(), matrix.colIdx.data(), matrix.values.data(),
+            0, matrix.rowPtr.back(), solver.getMatrix());
+    solver.getSystem()->assembly(*(solver.getMatrix()));
+    solver.releaseMatrix();
+
+    double *values = solver.getSystem()->getRHSRawPtr();
+    std::copy(rhs.begin(), rhs.end(), values);
+    solver.getSystem()->restoreRHSRawPtr(values);
+    values = solver.getSystem()->getSolutionRawPtr();
+    std::fill(values, values + matrix.nRows, 0.);
+    solver.getSystem()->restoreSolutionRawPtr(values);
+
+    solver.getSystem()->solve();
+    log::cout() << "PETSc iterations = " << solver.getSystem()->getKSPStatus().its
+            << ", residual = " << static_cast<ConfiguredSystemSolver &>(*(solver.getSystem())).getResidualNorm() << std::endl;
+
+    const double *result = solver.getSystem()->getSolutionRawReadPtr();
+    std::vector<double> solution(result, result + matrix.nRows);
+    solver.getSystem()->restoreSolutionRawReadPtr(result);
+
+    return solution;
+}
+
+/*!
+ * It solves the system with both engines and compares their true residuals and solutions.
+ * \param[in] name the name of the case
+ * \param[in] matrix the matrix
+ * \param[in] kspType the Krylov method
+ * \return true if both engines converged to the same solution
+ */
+bool runCase(const std::string & name, const TestMatrix & matrix, const std::string & kspType)
+{
+    // Both engines restart GMRES every 30 iterations and stop on the same relative tolerance
+    SolverOptions options;
+    options.kspType = kspType;
+    options.pcType = "jacobi";
+    options.restart = 30;
+    options.rtol = 1.e-10;
+    options.maxIterations = 20000;
+
+    std::vector<double> rhs(matrix.nRows, 1.);
+
+    log::cout() << "" << std::endl;
+    log::cout() << "Case " << name << ", " << kspType << "/jacobi, rows = " << matrix.nRows << std::endl;
+    std::vector<double> nativeSolution = solveNative(matrix, options, rhs);
+    std::vector<double> petscSolution = solvePetsc(matrix, options, rhs);
+
+    double nativeResidual = computeRelativeResidual(matrix, rhs, nativeSolution);
+    double petscResidual = computeRelativeResidual(matrix, rhs, petscSolution);
+    double difference = 0.;
+    double reference = 0.;
+    for(long row = 0; row < matrix.nRows; ++row) {
+        difference = std::max(difference, std::abs(nativeSolution[row] - petscSolution[row]));
+        reference = std::max(reference, std::abs(petscSolution[row]));
+    }
+    difference /= reference;
+    log::cout() << "True relative residuals: native = " << nativeResidual << ", PETSc = " << petscResidual
+            << ", solution difference = " << difference << std::endl;
+
+    // The preconditioned PETSc norms may stop a little earlier or later than the native unpreconditioned ones
+    bool passed = nativeResidual < 1.e-8 && petscResidual < 1.e-8 && difference < 1.e-5;
+    log::cout() << "Case " << name << (passed ? " passed" : " FAILED") << std::endl;
+
+    return passed;
+}
+
+}
+
+/*!
+ * Regression test of the native Krylov engine: each method solves a matrix suited to it, then PETSc solves it with
+ * the same method, preconditioner and tolerance; the true residuals of both must be small and the solutions must agree.
+ */
+int main(int argc, char *argv[])
+{
+    int nProcessors;
+    int rank;
+
+#if ENABLE_MPI==1
+    MPI_Init(&argc, &argv);
+
+    MPI_Comm_size(MPI_COMM_WORLD, &nProcessors);
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#else
+    nProcessors = 1;
+    rank = 0;
+#endif
+
+    log::manager().initialize(log::COMBINED, "testNativeKrylov", true, ".", nProcessors, rank);
+
+    bool passed = true;
+    {
+        TestMatrix poisson = buildMatrix(40, 0.);
+        TestMatrix convection = buildMatrix(40, 2.);
+
+        passed = runCase("poisson", poisson, "cg") && passed;
+        passed = runCase("convection", convection, "bcgs") && passed;
+        passed = runCase("convection", convection, "gmres") && passed;
+    }
+
+#if ENABLE_MPI==1
+    MPI_Finalize();
+#endif
+
+    return passed ? 0 : 1;
+}